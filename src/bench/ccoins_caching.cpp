@@ -8,6 +8,7 @@
 #include <key.h>
 #include <policy/policy.h>
 #include <primitives/transaction.h>
+#include <random.h>
 #include <script/script.h>
 #include <script/signingprovider.h>
 #include <test/util/transaction_utils.h>
@@ -54,4 +55,32 @@ static void CCoinsCaching(benchmark::Bench& bench)
     });
 }
 
+// FetchCoin() and SpendCoin() on a cache holding as many coins as a large
+// -dbcache does, so that lookups miss the CPU caches and the hash map's
+// probing shows.
+static void CCoinsCachingLargeMap(benchmark::Bench& bench)
+{
+    constexpr size_t NUM_COINS{1'000'000};
+    FastRandomContext rng{/*fDeterministic=*/true};
+    CCoinsView coins_dummy;
+    CCoinsViewCache coins{&coins_dummy, /*deterministic=*/true};
+    std::vector<COutPoint> outpoints;
+    outpoints.reserve(NUM_COINS);
+    for (size_t i{0}; i < NUM_COINS; ++i) {
+        outpoints.emplace_back(Txid::FromUint256(rng.rand256()), /*nIn=*/0);
+        coins.AddCoin(outpoints.back(), Coin{CTxOut{COIN, CScript{} << OP_TRUE}, /*nHeightIn=*/1, /*fCoinBaseIn=*/false}, /*possible_overwrite=*/false);
+    }
+
+    bench.run([&] {
+        const COutPoint& outpoint{outpoints[rng.randrange(NUM_COINS)]};
+        assert(!coins.AccessCoin(outpoint).IsSpent());
+        Coin coin;
+        const bool spent{coins.SpendCoin(outpoint, &coin)};
+        assert(spent);
+        // Spending a fresh coin erases it, so this inserts it again.
+        coins.AddCoin(outpoint, std::move(coin), /*possible_overwrite=*/false);
+    });
+}
+
 BENCHMARK(CCoinsCaching);
+BENCHMARK(CCoinsCachingLargeMap);
@@ -39,6 +39,20 @@ static void DeserializeBlockTest(benchmark::Bench& bench)
     });
 }
 
+static void DeserializeBlockInArenaTest(benchmark::Bench& bench)
+{
+    DataStream stream(benchmark::data::block413567);
+    std::byte a{0};
+    stream.write({&a, 1}); // Prevent compaction
+
+    bench.unit("block").run([&] {
+        CBlock block;
+        UnserializeBlockInArena(stream, block);
+        bool rewound = stream.Rewind(benchmark::data::block413567.size());
+        assert(rewound);
+    });
+}
+
 static void DeserializeAndCheckBlockTest(benchmark::Bench& bench)
 {
     DataStream stream(benchmark::data::block413567);
@@ -61,4 +75,5 @@ static void DeserializeAndCheckBlockTest(benchmark::Bench& bench)
 }
 
 BENCHMARK(DeserializeBlockTest);
+BENCHMARK(DeserializeBlockInArenaTest);
 BENCHMARK(DeserializeAndCheckBlockTest);
@@ -86,8 +86,59 @@ static void GCSFilterMatch(benchmark::Bench& bench)
         filter.Match(GCSFilter::Element());
     });
 }
+
+static void GCSFilterMatchAny(benchmark::Bench& bench)
+{
+    auto elements = GenerateGCSTestElements();
+
+    GCSFilter filter({0, 0, BASIC_FILTER_P, BASIC_FILTER_M}, elements);
+
+    GCSFilter::ElementSet needles;
+    for (int i = 0; i < 1000; ++i) {
+        needles.insert(GCSFilter::Element(32, static_cast<unsigned char>(i)));
+    }
+
+    bench.run([&] {
+        filter.MatchAny(needles);
+    });
+}
+
+static void GCSBlockFiltersMatchAnyBatch(benchmark::Bench& bench)
+{
+    // Filters of blocks with a few thousand outputs, as scanned by scanblocks
+    // and wallet rescans.
+    std::vector<BlockFilter> filters;
+    for (int i = 0; i < 1000; ++i) {
+        GCSFilter::ElementSet elements;
+        for (int j = 0; j < 2000; ++j) {
+            GCSFilter::Element element(32);
+            element[0] = static_cast<unsigned char>(j);
+            element[1] = static_cast<unsigned char>(j >> 8);
+            element[2] = static_cast<unsigned char>(i);
+            element[3] = static_cast<unsigned char>(i >> 8);
+            elements.insert(std::move(element));
+        }
+        uint256 block_hash;
+        block_hash.data()[0] = static_cast<unsigned char>(i);
+        block_hash.data()[1] = static_cast<unsigned char>(i >> 8);
+        GCSFilter filter({block_hash.GetUint64(0), block_hash.GetUint64(1), BASIC_FILTER_P, BASIC_FILTER_M}, elements);
+        filters.emplace_back(BlockFilterType::BASIC, block_hash, filter.GetEncoded(), /*skip_decode_check=*/true);
+    }
+
+    GCSFilter::ElementSet needles;
+    for (int i = 0; i < 100; ++i) {
+        needles.insert(GCSFilter::Element(32, static_cast<unsigned char>(i)));
+    }
+
+    bench.batch(filters.size()).unit("filter").run([&] {
+        MatchAnyBlockFilters(filters, needles, /*num_threads=*/1);
+    });
+}
+
 BENCHMARK(GCSBlockFilterGetHash);
 BENCHMARK(GCSFilterConstruct);
 BENCHMARK(GCSFilterDecode);
 BENCHMARK(GCSFilterDecodeSkipCheck);
 BENCHMARK(GCSFilterMatch);
+BENCHMARK(GCSFilterMatchAny);
+BENCHMARK(GCSBlockFiltersMatchAnyBatch);
@@ -52,6 +52,20 @@ static void ReadBlockBench(benchmark::Bench& bench)
     });
 }
 
+static void ReadBlockInArenaBench(benchmark::Bench& bench)
+{
+    const auto testing_setup{MakeNoLogFileContext<const TestingSetup>(ChainType::MAIN)};
+    auto& blockman{testing_setup->m_node.chainman->m_blockman};
+    const auto& test_block{CreateTestBlock()};
+    const auto& expected_hash{test_block.GetHash()};
+    const auto& pos{blockman.WriteBlock(test_block, 413'567)};
+    bench.run([&] {
+        CBlock block;
+        const auto success{blockman.ReadBlock(block, pos, expected_hash, /*use_arena=*/true)};
+        assert(success);
+    });
+}
+
 static void ReadRawBlockBench(benchmark::Bench& bench)
 {
     const auto testing_setup{MakeNoLogFileContext<const TestingSetup>(ChainType::MAIN)};
@@ -65,4 +79,5 @@ static void ReadRawBlockBench(benchmark::Bench& bench)
 
 BENCHMARK(WriteBlockBench);
 BENCHMARK(ReadBlockBench);
+BENCHMARK(ReadBlockInArenaBench);
 BENCHMARK(ReadRawBlockBench);
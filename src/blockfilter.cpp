@@ -2,9 +2,12 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <algorithm>
+#include <exception>
 #include <mutex>
 #include <set>
 #include <string_view>
+#include <thread>
 
 #include <blockfilter.h>
 #include <crypto/siphash.h>
@@ -62,11 +65,11 @@ GCSFilter::GCSFilter(const Params& params, std::vector<unsigned char> encoded_fi
 
     // Verify that the encoded filter contains exactly N elements. If it has too much or too little
     // data, a std::ios_base::failure exception will be raised.
-    BitStreamReader bitreader{stream};
+    GolombRiceDecoder decoder{std::span{m_encoded}.subspan(GetSizeOfCompactSize(m_N))};
     for (uint64_t i = 0; i < m_N; ++i) {
-        GolombRiceDecode(bitreader, m_params.m_P);
+        decoder.Decode(m_params.m_P);
     }
-    if (!stream.empty()) {
+    if (decoder.BytesRead() != stream.size()) {
         throw std::ios_base::failure("encoded_filter contains excess data");
     }
 }
@@ -103,18 +106,13 @@ GCSFilter::GCSFilter(const Params& params, const ElementSet& elements)
 
 bool GCSFilter::MatchInternal(const uint64_t* element_hashes, size_t size) const
 {
-    SpanReader stream{m_encoded};
-
-    // Seek forward by size of N
-    uint64_t N = ReadCompactSize(stream);
-    assert(N == m_N);
-
-    BitStreamReader bitreader{stream};
+    // Skip the size of N
+    GolombRiceDecoder decoder{std::span{m_encoded}.subspan(GetSizeOfCompactSize(m_N))};
 
     uint64_t value = 0;
     size_t hashes_index = 0;
     for (uint32_t i = 0; i < m_N; ++i) {
-        uint64_t delta = GolombRiceDecode(bitreader, m_params.m_P);
+        uint64_t delta = decoder.Decode(m_params.m_P);
         value += delta;
 
         while (true) {
@@ -145,6 +143,49 @@ bool GCSFilter::MatchAny(const ElementSet& elements) const
     return MatchInternal(queries.data(), queries.size());
 }
 
+/** Smallest number of filters worth matching on a thread of its own. */
+static constexpr size_t MIN_FILTERS_PER_THREAD{16};
+
+std::vector<bool> MatchAnyBlockFilters(std::span<const BlockFilter> filters, const GCSFilter::ElementSet& elements, int num_threads)
+{
+    // Not a std::vector<bool>, whose elements cannot be written from several threads.
+    std::vector<uint8_t> matches(filters.size());
+    const auto match_range{[&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            matches[i] = filters[i].GetFilter().MatchAny(elements);
+        }
+    }};
+
+    const size_t num_ranges{std::clamp<size_t>(filters.size() / MIN_FILTERS_PER_THREAD, 1, std::max(num_threads, 1))};
+    if (num_ranges == 1) {
+        match_range(0, filters.size());
+    } else {
+        std::vector<std::thread> threads;
+        std::vector<std::exception_ptr> errors(num_ranges);
+        threads.reserve(num_ranges - 1);
+        // The calling thread matches the first range.
+        for (size_t r = 1; r < num_ranges; ++r) {
+            threads.emplace_back([&, r] {
+                try {
+                    match_range(filters.size() * r / num_ranges, filters.size() * (r + 1) / num_ranges);
+                } catch (...) {
+                    errors[r] = std::current_exception();
+                }
+            });
+        }
+        try {
+            match_range(0, filters.size() / num_ranges);
+        } catch (...) {
+            errors[0] = std::current_exception();
+        }
+        for (auto& thread : threads) thread.join();
+        for (const auto& error : errors) {
+            if (error) std::rethrow_exception(error);
+        }
+    }
+    return {matches.begin(), matches.end()};
+}
+
 const std::string& BlockFilterTypeName(BlockFilterType filter_type)
 {
     static std::string unknown_retval;
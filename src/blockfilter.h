@@ -9,6 +9,7 @@
 #include <cstdint>
 #include <ios>
 #include <set>
+#include <span>
 #include <string>
 #include <string_view>
 #include <unordered_set>
@@ -173,4 +174,11 @@ public:
     }
 };
 
+/**
+ * Check which of a batch of block filters may contain any of the given
+ * elements. Result i is filters[i].GetFilter().MatchAny(elements). The filters
+ * are split in contiguous ranges matched on up to num_threads threads.
+ */
+std::vector<bool> MatchAnyBlockFilters(std::span<const BlockFilter> filters, const GCSFilter::ElementSet& elements, int num_threads);
+
 #endif // BITCOIN_BLOCKFILTER_H
@@ -11,8 +11,12 @@
 #include <util/threadnames.h>
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <iterator>
 #include <optional>
+#include <type_traits>
+#include <variant>
 #include <vector>
 
 /**
@@ -28,6 +32,12 @@
   * the master is done adding work, it temporarily joins the worker pool
   * as an N'th worker, until all jobs are done.
   *
+  * If T defines a type T::Batch, every worker passes a pointer to its own
+  * T::Batch to the verifications it runs, which may defer part of their work
+  * to it. The batch is verified after each chunk of verifications a worker
+  * takes from the queue. If that fails, the chunk is run again without the
+  * batch to find the failing verification.
+  *
   */
 template <typename T, typename R = std::remove_cvref_t<decltype(std::declval<T>()().value())>>
 class CCheckQueue
@@ -68,10 +78,26 @@ private:
     std::vector<std::thread> m_worker_threads;
     bool m_request_stop GUARDED_BY(m_mutex){false};
 
+    //! Time each thread spent running verifications, in nanoseconds. The last
+    //! entry is for the master.
+    std::vector<std::atomic<int64_t>> m_busy_ns;
+
+    template <typename U>
+    struct CheckBatch {
+        using type = std::monostate;
+    };
+    template <typename U>
+        requires requires { typename U::Batch; }
+    struct CheckBatch<U> {
+        using type = typename U::Batch;
+    };
+    static constexpr bool HAS_BATCH{!std::is_same_v<typename CheckBatch<T>::type, std::monostate>};
+
     /** Internal function that does bulk of the verification work. If fMaster, return the final result. */
-    std::optional<R> Loop(bool fMaster) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    std::optional<R> Loop(bool fMaster, size_t thread_index) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
     {
         std::condition_variable& cond = fMaster ? m_master_cv : m_worker_cv;
+        [[maybe_unused]] typename CheckBatch<T>::type batch;
         std::vector<T> vChecks;
         vChecks.reserve(nBatchSize);
         unsigned int nNow = 0;
@@ -127,10 +153,29 @@ private:
             }
             // execute work
             if (do_work) {
-                for (T& check : vChecks) {
-                    local_result = check();
-                    if (local_result.has_value()) break;
+                const auto work_start{std::chrono::steady_clock::now()};
+                if constexpr (HAS_BATCH) {
+                    for (T& check : vChecks) {
+                        local_result = check(&batch);
+                        if (local_result.has_value()) break;
+                    }
+                    // Always verify the batch, to empty it. If it fails, a
+                    // check that failed after a deferred failure may not report
+                    // the right error, so run all of them again.
+                    if (!batch.Verify()) {
+                        for (T& check : vChecks) {
+                            local_result = check();
+                            if (local_result.has_value()) break;
+                        }
+                    }
+                } else {
+                    for (T& check : vChecks) {
+                        local_result = check();
+                        if (local_result.has_value()) break;
+                    }
                 }
+                const auto work_time{std::chrono::steady_clock::now() - work_start};
+                m_busy_ns[thread_index].fetch_add(std::chrono::nanoseconds{work_time}.count(), std::memory_order_relaxed);
             }
             vChecks.clear();
         } while (true);
@@ -142,14 +187,14 @@ public:
 
     //! Create a new check queue
     explicit CCheckQueue(unsigned int batch_size, int worker_threads_num)
-        : nBatchSize(batch_size)
+        : nBatchSize(batch_size), m_busy_ns(worker_threads_num + 1)
     {
         LogInfo("Script verification uses %d additional threads", worker_threads_num);
         m_worker_threads.reserve(worker_threads_num);
         for (int n = 0; n < worker_threads_num; ++n) {
             m_worker_threads.emplace_back([this, n]() {
                 util::ThreadRename(strprintf("scriptch.%i", n));
-                Loop(false /* worker thread */);
+                Loop(false /* worker thread */, n);
             });
         }
     }
@@ -165,7 +210,7 @@ public:
     //! its error.
     std::optional<R> Complete() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
     {
-        return Loop(true /* master thread */);
+        return Loop(true /* master thread */, m_worker_threads.size());
     }
 
     //! Add a batch of checks to the queue
@@ -198,6 +243,15 @@ public:
     }
 
     bool HasThreads() const { return !m_worker_threads.empty(); }
+
+    //! Total time each thread spent running verifications, the master last.
+    std::vector<std::chrono::nanoseconds> BusyTimes() const
+    {
+        std::vector<std::chrono::nanoseconds> busy_times;
+        busy_times.reserve(m_busy_ns.size());
+        for (const auto& busy_ns : m_busy_ns) busy_times.emplace_back(busy_ns.load(std::memory_order_relaxed));
+        return busy_times;
+    }
 };
 
 /**
@@ -10,6 +10,8 @@
 #include <uint256.h>
 #include <util/trace.h>
 
+#include <utility>
+
 TRACEPOINT_SEMAPHORE(utxocache, add);
 TRACEPOINT_SEMAPHORE(utxocache, spent);
 TRACEPOINT_SEMAPHORE(utxocache, uncache);
@@ -53,6 +55,7 @@ size_t CCoinsViewCache::DynamicMemoryUsage() const {
 CCoinsMap::iterator CCoinsViewCache::FetchCoin(const COutPoint &outpoint) const {
     const auto [ret, inserted] = cacheCoins.try_emplace(outpoint);
     if (inserted) {
+        ++m_cache_misses;
         if (auto coin{base->GetCoin(outpoint)}) {
             ret->second.coin = std::move(*coin);
             cachedCoinsUsage += ret->second.coin.DynamicMemoryUsage();
@@ -61,6 +64,10 @@ CCoinsMap::iterator CCoinsViewCache::FetchCoin(const COutPoint &outpoint) const
             cacheCoins.erase(ret);
             return cacheCoins.end();
         }
+    } else if (m_prefetched_uncounted > 0) {
+        --m_prefetched_uncounted;
+    } else {
+        ++m_cache_hits;
     }
     return ret;
 }
@@ -121,6 +128,16 @@ void CCoinsViewCache::EmplaceCoinInternalDANGER(COutPoint&& outpoint, Coin&& coi
     }
 }
 
+void CCoinsViewCache::EmplaceCoinFromBase(const COutPoint& outpoint, Coin&& coin) {
+    Assert(!coin.IsSpent());
+    const auto mem_usage{coin.DynamicMemoryUsage()};
+    if (cacheCoins.try_emplace(outpoint, std::move(coin)).second) {
+        ++m_cache_misses;
+        ++m_prefetched_uncounted;
+        cachedCoinsUsage += mem_usage;
+    }
+}
+
 void AddCoins(CCoinsViewCache& cache, const CTransaction &tx, int nHeight, bool check_for_overwrite) {
     bool fCoinbase = tx.IsCoinBase();
     const Txid& txid = tx.GetHash();
@@ -260,6 +277,7 @@ void CCoinsViewCache::Flush(bool reallocate_cache)
         ReallocateCache();
     }
     cachedCoinsUsage = 0;
+    m_prefetched_uncounted = 0;
 }
 
 void CCoinsViewCache::Sync()
@@ -276,6 +294,7 @@ void CCoinsViewCache::Reset() noexcept
 {
     cacheCoins.clear();
     cachedCoinsUsage = 0;
+    m_prefetched_uncounted = 0;
     SetBestBlock(uint256::ZERO);
 }
 
@@ -393,3 +412,104 @@ bool CCoinsViewErrorCatcher::HaveCoin(const COutPoint& outpoint) const
 {
     return ExecuteBackedWrapper<bool>([&]() { return CCoinsViewBacked::HaveCoin(outpoint); }, m_err_callbacks);
 }
+
+CCoinsViewFlushBuffer::~CCoinsViewFlushBuffer()
+{
+    if (m_write_thread.joinable()) m_write_thread.join();
+    // Owners call WaitForWrite() first to handle a failed write, so this is
+    // only reached if that failed too.
+    if (m_write_error || m_write_failed) {
+        LogError("Failed to write coins up to block %s in the background, the coins database is recovered on the next start\n",
+                 m_generation->m_best_block.ToString());
+    }
+}
+
+std::optional<Coin> CCoinsViewFlushBuffer::GetCoin(const COutPoint& outpoint) const
+{
+    if (m_generation) {
+        if (auto it{m_generation->m_coins.find(outpoint)}; it != m_generation->m_coins.end()) {
+            // Entries of the generation are newer than anything in the base view.
+            if (it->second.coin.IsSpent()) return std::nullopt;
+            return it->second.coin;
+        }
+    }
+    return base->GetCoin(outpoint);
+}
+
+bool CCoinsViewFlushBuffer::HaveCoin(const COutPoint& outpoint) const
+{
+    if (m_generation) {
+        if (auto it{m_generation->m_coins.find(outpoint)}; it != m_generation->m_coins.end()) {
+            return !it->second.coin.IsSpent();
+        }
+    }
+    return base->HaveCoin(outpoint);
+}
+
+uint256 CCoinsViewFlushBuffer::GetBestBlock() const
+{
+    if (m_generation) return m_generation->m_best_block;
+    return base->GetBestBlock();
+}
+
+void CCoinsViewFlushBuffer::BatchWrite(CoinsViewCacheCursor& cursor, const uint256& hashBlock)
+{
+    WaitForWrite();
+
+    auto generation{std::make_unique<Generation>()};
+    for (auto it{cursor.Begin()}; it != cursor.End(); it = cursor.NextAndMaybeErase(*it)) {
+        if (!it->second.IsDirty()) continue;
+        // The base view never saw a fresh coin, so there is nothing to write for it once spent.
+        if (it->second.IsFresh() && it->second.coin.IsSpent()) continue;
+        auto [itUs, inserted]{generation->m_coins.try_emplace(it->first)};
+        assert(inserted);
+        if (cursor.WillErase(*it)) {
+            itUs->second.coin = std::move(it->second.coin);
+        } else {
+            itUs->second.coin = it->second.coin;
+        }
+        generation->m_coins_usage += itUs->second.coin.DynamicMemoryUsage();
+        CCoinsCacheEntry::SetDirty(*itUs, generation->m_sentinel);
+    }
+    generation->m_best_block = hashBlock;
+
+    m_generation = std::move(generation);
+    m_write_done.store(false, std::memory_order_relaxed);
+    m_write_thread = std::thread{[this, &generation = *m_generation]() {
+        try {
+            CoinsViewCacheCursor write_cursor{generation.m_sentinel, generation.m_coins, /*will_erase=*/true};
+            base->BatchWrite(write_cursor, generation.m_best_block);
+        } catch (...) {
+            m_write_error = std::current_exception();
+        }
+        m_write_done.store(true, std::memory_order_release);
+    }};
+}
+
+void CCoinsViewFlushBuffer::WaitForWrite()
+{
+    if (m_write_thread.joinable()) m_write_thread.join();
+    if (m_write_error) {
+        // Keep the generation, as the base view may be missing part of it,
+        // and retry writing it on the next call.
+        m_write_failed = true;
+        std::rethrow_exception(std::exchange(m_write_error, nullptr));
+    }
+    if (m_write_failed) {
+        CoinsViewCacheCursor cursor{m_generation->m_sentinel, m_generation->m_coins, /*will_erase=*/true};
+        base->BatchWrite(cursor, m_generation->m_best_block);
+        m_write_failed = false;
+    }
+    m_generation.reset();
+}
+
+void CCoinsViewFlushBuffer::ReleaseWritten()
+{
+    if (m_generation && m_write_done.load(std::memory_order_acquire)) WaitForWrite();
+}
+
+size_t CCoinsViewFlushBuffer::DynamicMemoryUsage() const
+{
+    if (!m_generation) return 0;
+    return memusage::DynamicUsage(m_generation->m_coins) + m_generation->m_coins_usage;
+}
@@ -16,11 +16,15 @@
 #include <uint256.h>
 #include <util/check.h>
 #include <util/hasher.h>
+#include <util/node_hash_map.h>
 
+#include <atomic>
 #include <cassert>
 #include <cstdint>
-
+#include <exception>
 #include <functional>
+#include <memory>
+#include <thread>
 #include <unordered_map>
 
 /**
@@ -208,19 +212,16 @@ public:
 };
 
 /**
- * PoolAllocator's MAX_BLOCK_SIZE_BYTES parameter here uses sizeof the data, and adds the size
- * of 4 pointers. We do not know the exact node size used in the std::unordered_node implementation
- * because it is implementation defined. Most implementations have an overhead of 1 or 2 pointers,
- * so nodes can be connected in a linked list, and in some cases the hash value is stored as well.
- * Using an additional sizeof(void*)*4 for MAX_BLOCK_SIZE_BYTES should thus be sufficient so that
- * all implementations can allocate the nodes from the PoolAllocator.
+ * The coins cache map. Its open-addressing index keeps lookups to one probe of
+ * the control bytes and one node access in the common case, and the nodes are
+ * allocated from a PoolResource so they stay at a fixed address, as required
+ * by the linked list of flagged entries. Nodes hold exactly a CoinsCachePair.
  */
-using CCoinsMap = std::unordered_map<COutPoint,
-                                     CCoinsCacheEntry,
-                                     SaltedOutpointHasher,
-                                     std::equal_to<COutPoint>,
-                                     PoolAllocator<CoinsCachePair,
-                                                   sizeof(CoinsCachePair) + sizeof(void*) * 4>>;
+using CCoinsMap = NodeHashMap<COutPoint,
+                              CCoinsCacheEntry,
+                              SaltedOutpointHasher,
+                              std::equal_to<COutPoint>,
+                              PoolAllocator<CoinsCachePair, sizeof(CoinsCachePair)>>;
 
 using CCoinsMapMemoryResource = CCoinsMap::allocator_type::ResourceType;
 
@@ -236,6 +237,8 @@ public:
 
     virtual bool Valid() const = 0;
     virtual void Next() = 0;
+    //! Move to the first coin at or after outpoint
+    virtual void Seek(const COutPoint& outpoint) = 0;
 
     //! Get best block at the time this cursor was created
     const uint256 &GetBestBlock() const { return hashBlock; }
@@ -370,6 +373,12 @@ protected:
     /* Cached dynamic memory usage for the inner Coin objects. */
     mutable size_t cachedCoinsUsage{0};
 
+    /* Number of lookups answered from the cache, and of coins read from the base view. */
+    mutable uint64_t m_cache_hits{0};
+    mutable uint64_t m_cache_misses{0};
+    /* Prefetched coins whose first lookup is not counted as a hit yet. */
+    mutable uint64_t m_prefetched_uncounted{0};
+
     /**
      * Discard all modifications made to this cache without flushing to the base view.
      * This can be used to efficiently reuse a cache instance across multiple operations.
@@ -428,6 +437,20 @@ public:
      */
     void EmplaceCoinInternalDANGER(COutPoint&& outpoint, Coin&& coin);
 
+    /**
+     * Add a coin that the caller read from the base view, unless the cache
+     * already has an entry for the outpoint. The entry is neither dirty nor
+     * fresh, exactly as if FetchCoin() had read it.
+     *
+     * It is counted as a cache miss, and one later lookup answered from the
+     * cache is not counted as a hit, so that the counters are the same as
+     * without prefetching.
+     *
+     * Used to prefetch block inputs in parallel.
+     * @sa InputFetcher
+     */
+    void EmplaceCoinFromBase(const COutPoint& outpoint, Coin&& coin);
+
     /**
      * Spend a coin. Pass moveto in order to get the deleted data.
      * If no unspent output exists for the passed outpoint, this call
@@ -464,6 +487,12 @@ public:
     //! Calculate the size of the cache (in bytes)
     size_t DynamicMemoryUsage() const;
 
+    //! Number of coin lookups answered from the cache so far.
+    uint64_t GetCacheHits() const { return m_cache_hits; }
+
+    //! Number of coins read from the base view so far, including ones that were not found.
+    uint64_t GetCacheMisses() const { return m_cache_misses; }
+
     //! Check whether all prevouts of the transaction are present in the UTXO set represented by this view
     bool HaveInputs(const CTransaction& tx) const;
 
@@ -543,4 +572,70 @@ private:
 
 };
 
+/**
+ * Double buffer between the coins cache and the database, which lets the
+ * chainstate be written to disk without stalling block connection.
+ *
+ * BatchWrite() takes the dirty entries of the cache being flushed into an
+ * immutable generation and writes that to the base view on a background
+ * thread. Until the write has finished, lookups are answered from the
+ * generation first, so the layers above see the flushed state while the
+ * database may only hold part of it. At most one generation is pending at a
+ * time: a new BatchWrite() first waits for the previous one to finish.
+ *
+ * If the process stops during a write, the base view is left in the same
+ * state as after an interrupted synchronous write, which CCoinsViewDB records
+ * with its head blocks marker (see GetHeadBlocks()) and is recovered from by
+ * replaying blocks on startup.
+ *
+ * Only the thread that calls BatchWrite() may wait for or release a
+ * generation; lookups may come from any thread.
+ */
+class CCoinsViewFlushBuffer final : public CCoinsViewBacked
+{
+public:
+    explicit CCoinsViewFlushBuffer(CCoinsView* view) : CCoinsViewBacked(view) {}
+    //! Waits for the pending write, but cannot report its failure: call
+    //! WaitForWrite() first.
+    ~CCoinsViewFlushBuffer() override;
+
+    std::optional<Coin> GetCoin(const COutPoint& outpoint) const override;
+    bool HaveCoin(const COutPoint& outpoint) const override;
+    uint256 GetBestBlock() const override;
+    void BatchWrite(CoinsViewCacheCursor& cursor, const uint256& hashBlock) override;
+
+    //! Block until the pending write, if any, has finished and release its
+    //! generation. Rethrows the exception the write failed with, in which case
+    //! the generation is kept and written again by the next call.
+    void WaitForWrite();
+
+    //! Release the pending generation if its write has finished, without
+    //! blocking. Rethrows the exception the write failed with.
+    void ReleaseWritten();
+
+    //! Whether a generation is still being written to the base view.
+    bool IsWriting() const { return m_generation && !m_write_done.load(std::memory_order_acquire); }
+
+    //! Memory held by the pending generation.
+    size_t DynamicMemoryUsage() const;
+
+private:
+    struct Generation {
+        CCoinsMapMemoryResource m_resource{};
+        CoinsCachePair m_sentinel;
+        CCoinsMap m_coins{0, SaltedOutpointHasher{}, CCoinsMap::key_equal{}, &m_resource};
+        uint256 m_best_block;
+        size_t m_coins_usage{0};
+
+        Generation() { m_sentinel.second.SelfRef(m_sentinel); }
+    };
+
+    std::unique_ptr<Generation> m_generation;
+    std::thread m_write_thread;
+    std::atomic<bool> m_write_done{false};
+    std::exception_ptr m_write_error;
+    //! Set when writing the pending generation failed and has to be retried.
+    bool m_write_failed{false};
+};
+
 #endif // BITCOIN_COINS_H
@@ -5,9 +5,12 @@
 
 #include <compressor.h>
 
+#include <consensus/amount.h>
 #include <pubkey.h>
 #include <script/script.h>
 
+#include <algorithm>
+
 /*
  * These check for scripts for which a special case with a shorter encoding is defined.
  * They are implemented separately from the CScript test, as these test for exact byte
@@ -190,3 +193,15 @@ uint64_t DecompressAmount(uint64_t x)
     }
     return n;
 }
+
+bool IsTxCompressible(const CTransaction& tx)
+{
+    return std::ranges::all_of(tx.vout, [](const CTxOut& txout) {
+        return MoneyRange(txout.nValue) && txout.scriptPubKey.size() <= MAX_SCRIPT_SIZE;
+    });
+}
+
+bool IsBlockCompressible(const CBlock& block)
+{
+    return std::ranges::all_of(block.vtx, [](const CTransactionRef& tx) { return IsTxCompressible(*tx); });
+}
@@ -7,6 +7,7 @@
 #define BITCOIN_COMPRESSOR_H
 
 #include <prevector.h>
+#include <primitives/block.h>
 #include <primitives/transaction.h>
 #include <script/script.h>
 #include <serialize.h>
@@ -115,4 +116,100 @@ struct TxOutCompression
     FORMATTER_METHODS(CTxOut, obj) { READWRITE(Using<AmountCompression>(obj.nValue), Using<ScriptCompression>(obj.scriptPubKey)); }
 };
 
+/** Whether a transaction round trips through TxCompression. That is the case
+ *  unless an output has an amount outside of MoneyRange or a script longer than
+ *  MAX_SCRIPT_SIZE, neither of which can be in a valid block. */
+bool IsTxCompressible(const CTransaction& tx);
+
+/** Compact serializer for transactions, used for storage only.
+ *
+ *  Outputs use TxOutCompression. Version, prevout index and locktime are
+ *  VARINTs, and nSequence is stored inverted as a VARINT, so the common
+ *  values of 0xffffffff and 0xfffffffe take a single byte. A flag byte tells
+ *  whether witnesses follow the outputs.
+ *
+ *  @pre IsTxCompressible(tx)
+ */
+struct TxCompression
+{
+    template <typename Stream, typename Tx>
+    void Ser(Stream& s, const Tx& tx)
+    {
+        s << VARINT(tx.version);
+        s << uint8_t{tx.HasWitness()};
+        WriteCompactSize(s, tx.vin.size());
+        for (const CTxIn& txin : tx.vin) {
+            s << txin.prevout.hash << VARINT(txin.prevout.n) << txin.scriptSig << VARINT(~txin.nSequence);
+        }
+        WriteCompactSize(s, tx.vout.size());
+        for (const CTxOut& txout : tx.vout) {
+            s << Using<TxOutCompression>(txout);
+        }
+        if (tx.HasWitness()) {
+            for (const CTxIn& txin : tx.vin) {
+                s << txin.scriptWitness.stack;
+            }
+        }
+        s << VARINT(tx.nLockTime);
+    }
+
+    template <typename Stream>
+    void Unser(Stream& s, CMutableTransaction& tx)
+    {
+        s >> VARINT(tx.version);
+        uint8_t has_witness;
+        s >> has_witness;
+        tx.vin.clear();
+        for (uint64_t i{0}, n{ReadCompactSize(s)}; i < n; ++i) {
+            CTxIn& txin{tx.vin.emplace_back()};
+            uint32_t inv_sequence;
+            s >> txin.prevout.hash >> VARINT(txin.prevout.n) >> txin.scriptSig >> VARINT(inv_sequence);
+            txin.nSequence = ~inv_sequence;
+        }
+        tx.vout.clear();
+        for (uint64_t i{0}, n{ReadCompactSize(s)}; i < n; ++i) {
+            s >> Using<TxOutCompression>(tx.vout.emplace_back());
+        }
+        if (has_witness) {
+            for (CTxIn& txin : tx.vin) {
+                s >> txin.scriptWitness.stack;
+            }
+        }
+        s >> VARINT(tx.nLockTime);
+    }
+};
+
+/** Whether all transactions of a block round trip through TxCompression. */
+bool IsBlockCompressible(const CBlock& block);
+
+/** Compact serializer for blocks, used for storage only. The header is kept
+ *  as is, so it can still be read without decompressing the transactions.
+ *
+ *  @pre IsBlockCompressible(block)
+ */
+struct BlockCompression
+{
+    template <typename Stream>
+    void Ser(Stream& s, const CBlock& block)
+    {
+        s << static_cast<const CBlockHeader&>(block);
+        WriteCompactSize(s, block.vtx.size());
+        for (const auto& tx : block.vtx) {
+            s << Using<TxCompression>(*tx);
+        }
+    }
+
+    template <typename Stream>
+    void Unser(Stream& s, CBlock& block)
+    {
+        block.SetNull();
+        s >> static_cast<CBlockHeader&>(block);
+        for (uint64_t i{0}, n{ReadCompactSize(s)}; i < n; ++i) {
+            CMutableTransaction tx;
+            s >> Using<TxCompression>(tx);
+            block.vtx.push_back(MakeTransactionRef(std::move(tx)));
+        }
+    }
+};
+
 #endif // BITCOIN_COMPRESSOR_H
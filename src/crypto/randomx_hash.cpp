@@ -5,9 +5,14 @@
 #include <crypto/randomx_hash.h>
 
 #include <logging.h>
+#include <tinyformat.h>
 #include <util/check.h>
+#include <util/threadnames.h>
+#include <util/time.h>
 
+#include <algorithm>
 #include <cstring>
+#include <thread>
 
 // RandomX library header
 extern "C" {
@@ -21,6 +26,14 @@ extern "C" {
 RandomXContext::RandomXContext() = default;
 
 RandomXContext::~RandomXContext() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop_lanes = true;
+    }
+    m_lane_cv.notify_all();
+    for (std::thread& thread : m_lane_threads) {
+        thread.join();
+    }
     Cleanup();
 }
 
@@ -40,6 +53,10 @@ void RandomXContext::Cleanup() {
         randomx_destroy_vm(m_vm_fast);
         m_vm_fast = nullptr;
     }
+    for (randomx_vm* vm : m_vm_lanes) {
+        randomx_destroy_vm(vm);
+    }
+    m_vm_lanes.clear();
     if (m_dataset) {
         randomx_release_dataset(m_dataset);
         m_dataset = nullptr;
@@ -50,6 +67,8 @@ void RandomXContext::Cleanup() {
     }
     m_current_seed_hash = std::nullopt;
     m_fast_mode_initialized = false;
+    m_light_flags = 0;
+    m_fast_flags = 0;
 }
 
 void RandomXContext::InitLight(const uint256& seed_hash) {
@@ -69,21 +88,29 @@ void RandomXContext::InitLight(const uint256& seed_hash) {
     }
 
     // Initialize cache with seed hash
+    const auto cache_init_start{SteadyClock::now()};
     randomx_init_cache(m_cache, seed_hash.data(), 32);
+    m_cache_init_time = std::chrono::duration_cast<std::chrono::milliseconds>(SteadyClock::now() - cache_init_start);
 
     // Create or reinitialize light VM
     if (m_vm_light) {
         randomx_vm_set_cache(m_vm_light, m_cache);
     } else {
+        m_light_flags = flags | RANDOMX_FLAG_JIT;
         m_vm_light = randomx_create_vm(flags | RANDOMX_FLAG_JIT, m_cache, nullptr);
         if (!m_vm_light) {
             // Fallback without JIT
+            m_light_flags = flags;
             m_vm_light = randomx_create_vm(flags, m_cache, nullptr);
         }
         if (!m_vm_light) {
+            m_light_flags = 0;
             throw std::runtime_error("RandomX: Failed to create light VM");
         }
     }
+    for (randomx_vm* vm : m_vm_lanes) {
+        randomx_vm_set_cache(vm, m_cache);
+    }
 
     m_current_seed_hash = seed_hash;
     LogDebug(BCLog::VALIDATION, "RandomX light mode initialized with seed %s\n",
@@ -112,20 +139,25 @@ void RandomXContext::InitFast(const uint256& seed_hash) {
     LogDebug(BCLog::VALIDATION, "RandomX initializing dataset with %lu items...\n", item_count);
 
     // Initialize all items (can be parallelized but keeping simple for now)
+    const auto dataset_init_start{SteadyClock::now()};
     randomx_init_dataset(m_dataset, m_cache, 0, item_count);
+    m_dataset_init_time = std::chrono::duration_cast<std::chrono::milliseconds>(SteadyClock::now() - dataset_init_start);
 
     // Create or reinitialize fast VM
     if (m_vm_fast) {
         randomx_vm_set_dataset(m_vm_fast, m_dataset);
     } else {
+        m_fast_flags = flags | RANDOMX_FLAG_JIT | RANDOMX_FLAG_FULL_MEM;
         m_vm_fast = randomx_create_vm(flags | RANDOMX_FLAG_JIT | RANDOMX_FLAG_FULL_MEM,
                                        nullptr, m_dataset);
         if (!m_vm_fast) {
             // Fallback without JIT
+            m_fast_flags = flags | RANDOMX_FLAG_FULL_MEM;
             m_vm_fast = randomx_create_vm(flags | RANDOMX_FLAG_FULL_MEM,
                                            nullptr, m_dataset);
         }
         if (!m_vm_fast) {
+            m_fast_flags = 0;
             throw std::runtime_error("RandomX: Failed to create fast VM");
         }
     }
@@ -135,8 +167,12 @@ void RandomXContext::InitFast(const uint256& seed_hash) {
              seed_hash.GetHex());
 }
 
+void RandomXContext::WaitForBatch(std::unique_lock<std::mutex>& lock) {
+    m_batch_cv.wait(lock, [&] { return !m_batch_running; });
+}
+
 void RandomXContext::UpdateSeedHash(const uint256& seed_hash, bool fast_mode) {
-    std::lock_guard<std::mutex> lock(m_mutex);
+    std::unique_lock<std::mutex> lock(m_mutex);
 
     // Check if already initialized with this seed
     if (m_current_seed_hash && *m_current_seed_hash == seed_hash) {
@@ -145,6 +181,7 @@ void RandomXContext::UpdateSeedHash(const uint256& seed_hash, bool fast_mode) {
         }
     }
 
+    WaitForBatch(lock);
     if (fast_mode) {
         InitFast(seed_hash);
     } else {
@@ -162,6 +199,41 @@ std::optional<uint256> RandomXContext::GetCurrentSeedHash() const {
     return m_current_seed_hash;
 }
 
+static RandomXContext::VMFlags DecodeVMFlags(int flags) {
+    RandomXContext::VMFlags ret;
+    ret.jit = flags & RANDOMX_FLAG_JIT;
+    ret.large_pages = flags & RANDOMX_FLAG_LARGE_PAGES;
+    ret.hard_aes = flags & RANDOMX_FLAG_HARD_AES;
+    ret.secure = flags & RANDOMX_FLAG_SECURE;
+    return ret;
+}
+
+RandomXContext::Stats RandomXContext::GetStats() const {
+    // Sizes of the RandomX structures with the default parameters:
+    // 256 MiB cache, 64-byte dataset items and a 2 MiB scratchpad per VM.
+    static constexpr size_t CACHE_BYTES{256 << 20};
+    static constexpr size_t DATASET_ITEM_BYTES{64};
+    static constexpr size_t SCRATCHPAD_BYTES{2 << 20};
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    Stats stats;
+    stats.seed_hash = m_current_seed_hash;
+    stats.light_initialized = m_vm_light != nullptr;
+    stats.fast_initialized = m_fast_mode_initialized;
+    stats.cache_init_time = m_cache_init_time;
+    stats.dataset_init_time = m_dataset_init_time;
+    stats.batch_lanes = m_vm_lanes.size();
+    stats.light_flags = DecodeVMFlags(m_light_flags);
+    stats.fast_flags = DecodeVMFlags(m_fast_flags);
+
+    if (m_cache) stats.memory_bytes += CACHE_BYTES;
+    if (m_dataset) stats.memory_bytes += randomx_dataset_item_count() * DATASET_ITEM_BYTES;
+    const size_t num_vms{(m_vm_light ? 1U : 0U) + (m_vm_fast ? 1U : 0U) + m_vm_lanes.size()};
+    stats.memory_bytes += num_vms * SCRATCHPAD_BYTES;
+    return stats;
+}
+
 randomx_dataset* RandomXContext::GetDataset() const {
     std::lock_guard<std::mutex> lock(m_mutex);
     return m_dataset;  // May be nullptr if fast mode not initialized
@@ -173,10 +245,11 @@ randomx_cache* RandomXContext::GetCache() const {
 }
 
 uint256 RandomXContext::Hash(std::span<const unsigned char> input, const uint256& seed_hash) {
-    std::lock_guard<std::mutex> lock(m_mutex);
+    std::unique_lock<std::mutex> lock(m_mutex);
 
     // Ensure we're initialized with the correct seed
     if (!m_current_seed_hash || *m_current_seed_hash != seed_hash) {
+        WaitForBatch(lock);
         InitLight(seed_hash);
     }
 
@@ -188,10 +261,11 @@ uint256 RandomXContext::Hash(std::span<const unsigned char> input, const uint256
 }
 
 uint256 RandomXContext::HashFast(std::span<const unsigned char> input, const uint256& seed_hash) {
-    std::lock_guard<std::mutex> lock(m_mutex);
+    std::unique_lock<std::mutex> lock(m_mutex);
 
     // Ensure fast mode is initialized with the correct seed
     if (!m_fast_mode_initialized || !m_current_seed_hash || *m_current_seed_hash != seed_hash) {
+        WaitForBatch(lock);
         InitFast(seed_hash);
     }
 
@@ -202,6 +276,95 @@ uint256 RandomXContext::HashFast(std::span<const unsigned char> input, const uin
     return result;
 }
 
+std::vector<uint256> RandomXContext::HashBatch(std::span<const std::vector<unsigned char>> inputs, const uint256& seed_hash, unsigned int lanes) {
+    std::vector<uint256> results(inputs.size());
+    if (inputs.empty()) return results;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    // Only one batch uses the lanes at a time.
+    WaitForBatch(lock);
+    if (!m_current_seed_hash || *m_current_seed_hash != seed_hash) {
+        InitLight(seed_hash);
+    }
+
+    Assert(m_vm_light);
+
+    lanes = std::clamp<unsigned int>(lanes, 1, inputs.size());
+    while (m_vm_lanes.size() < lanes) {
+        randomx_flags flags = randomx_get_flags();
+        randomx_vm* vm = randomx_create_vm(flags | RANDOMX_FLAG_JIT, m_cache, nullptr);
+        if (!vm) {
+            // Fallback without JIT
+            vm = randomx_create_vm(flags, m_cache, nullptr);
+        }
+        if (!vm) {
+            // Run with the lanes we already have rather than failing validation.
+            LogDebug(BCLog::VALIDATION, "RandomX: Failed to create batch VM, using %u lanes\n", m_vm_lanes.size());
+            break;
+        }
+        m_vm_lanes.push_back(vm);
+    }
+    if (m_vm_lanes.empty()) {
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            randomx_calculate_hash(m_vm_light, inputs[i].data(), inputs[i].size(), results[i].data());
+        }
+        return results;
+    }
+    lanes = std::min<unsigned int>(lanes, m_vm_lanes.size());
+    while (m_lane_threads.size() + 1 < lanes) {
+        m_lane_threads.emplace_back(&RandomXContext::LaneThread, this, m_lane_threads.size() + 1, m_batch_id);
+    }
+
+    // Publish the batch, then hash lane 0 without holding the lock. The
+    // running batch keeps the cache from being reinitialized for another seed.
+    m_batch_running = true;
+    ++m_batch_id;
+    m_batch_inputs = inputs;
+    m_batch_results = results.data();
+    m_batch_lanes = lanes;
+    m_batch_pending = lanes - 1;
+    randomx_vm* const vm{m_vm_lanes[0]};
+    lock.unlock();
+    m_lane_cv.notify_all();
+
+    // Lane i hashes inputs i, i + lanes, i + 2 * lanes, ...
+    for (size_t i = 0; i < inputs.size(); i += lanes) {
+        randomx_calculate_hash(vm, inputs[i].data(), inputs[i].size(), results[i].data());
+    }
+
+    lock.lock();
+    m_batch_cv.wait(lock, [&] { return m_batch_pending == 0; });
+    m_batch_running = false;
+    m_batch_inputs = {};
+    m_batch_results = nullptr;
+    lock.unlock();
+    m_batch_cv.notify_all();
+    return results;
+}
+
+void RandomXContext::LaneThread(size_t lane, uint64_t last_batch_id) {
+    util::ThreadRename(strprintf("randomx.%i", lane));
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_lane_cv.wait(lock, [&] { return m_stop_lanes || m_batch_id != last_batch_id; });
+        if (m_stop_lanes) return;
+        last_batch_id = m_batch_id;
+        if (lane >= m_batch_lanes) continue;
+
+        const auto inputs{m_batch_inputs};
+        uint256* const results{m_batch_results};
+        const size_t stride{m_batch_lanes};
+        randomx_vm* const vm{m_vm_lanes[lane]};
+        lock.unlock();
+        for (size_t i = lane; i < inputs.size(); i += stride) {
+            randomx_calculate_hash(vm, inputs[i].data(), inputs[i].size(), results[i].data());
+        }
+        lock.lock();
+        if (--m_batch_pending == 0) m_batch_cv.notify_all();
+    }
+}
+
 // ============================================================================
 // RandomXMiningVM implementation - Per-thread mining VMs
 // ============================================================================
@@ -314,6 +477,10 @@ uint256 RandomXHashLight(std::span<const unsigned char> data, const uint256& see
     return RandomXContext::GetInstance().Hash(data, seed_hash);
 }
 
+std::vector<uint256> RandomXHashBatch(std::span<const std::vector<unsigned char>> inputs, const uint256& seed_hash, unsigned int lanes) {
+    return RandomXContext::GetInstance().HashBatch(inputs, seed_hash, lanes);
+}
+
 uint64_t GetRandomXSeedHeight(uint64_t block_height) {
     // Botcoin uses a fixed genesis seed for all blocks.
     // This eliminates permanent fork divergence that occurs when nodes
@@ -325,3 +492,21 @@ uint64_t GetRandomXSeedHeight(uint64_t block_height) {
     (void)block_height;
     return 0;
 }
+
+std::optional<uint64_t> GetNextRandomXSeedSwitchHeight(uint64_t block_height) {
+    // Seed switches can only happen at heights where
+    // height % RANDOMX_EPOCH_LENGTH == RANDOMX_EPOCH_LAG, starting with the
+    // second epoch.
+    uint64_t candidate;
+    if (block_height < RANDOMX_EPOCH_LENGTH + RANDOMX_EPOCH_LAG) {
+        candidate = RANDOMX_EPOCH_LENGTH + RANDOMX_EPOCH_LAG;
+    } else {
+        candidate = ((block_height - RANDOMX_EPOCH_LAG) / RANDOMX_EPOCH_LENGTH + 1) * RANDOMX_EPOCH_LENGTH + RANDOMX_EPOCH_LAG;
+    }
+
+    // With the fixed genesis seed the seed height never changes.
+    if (GetRandomXSeedHeight(candidate) == GetRandomXSeedHeight(block_height)) {
+        return std::nullopt;
+    }
+    return candidate;
+}
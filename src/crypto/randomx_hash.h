@@ -7,11 +7,15 @@
 
 #include <uint256.h>
 
+#include <chrono>
+#include <condition_variable>
 #include <cstdint>
 #include <memory>
 #include <mutex>
 #include <optional>
 #include <span>
+#include <thread>
+#include <vector>
 
 /**
  * RandomX proof-of-work hash computation for Botcoin.
@@ -40,6 +44,32 @@ struct randomx_dataset;
  */
 class RandomXContext {
 public:
+    /** RandomX flags a VM was created with. */
+    struct VMFlags {
+        bool jit{false};
+        bool large_pages{false};
+        bool hard_aes{false};
+        bool secure{false};
+    };
+
+    /** Snapshot of the context's state, for monitoring. */
+    struct Stats {
+        //! Seed the cache (and dataset, if fast mode is initialized) holds.
+        std::optional<uint256> seed_hash;
+        bool light_initialized{false};
+        bool fast_initialized{false};
+        //! Duration of the last cache (light mode) initialization.
+        std::chrono::milliseconds cache_init_time{0};
+        //! Duration of the last dataset (fast mode) initialization.
+        std::chrono::milliseconds dataset_init_time{0};
+        //! Approximate memory held by the cache, dataset and VM scratchpads.
+        size_t memory_bytes{0};
+        //! Number of light-mode VMs available to HashBatch().
+        size_t batch_lanes{0};
+        VMFlags light_flags;
+        VMFlags fast_flags;
+    };
+
     ~RandomXContext();
 
     // Singleton access
@@ -65,6 +95,21 @@ public:
      */
     uint256 HashFast(std::span<const unsigned char> input, const uint256& seed_hash);
 
+    /**
+     * Compute light-mode RandomX hashes for a batch of inputs that share one
+     * seed, spreading them over up to @p lanes VMs. All lanes share the single
+     * light-mode cache, so extra lanes only cost a VM scratchpad each. The
+     * calling thread hashes the first lane and long-lived lane threads the
+     * others; the context lock is not held while hashing, so Hash() is not
+     * blocked by a running batch unless it has to switch seeds.
+     *
+     * @param inputs    Data to hash (typically serialized 80-byte headers)
+     * @param seed_hash The seed hash shared by all inputs
+     * @param lanes     Maximum number of VMs hashing in parallel
+     * @return          One 256-bit RandomX hash per input, in input order
+     */
+    std::vector<uint256> HashBatch(std::span<const std::vector<unsigned char>> inputs, const uint256& seed_hash, unsigned int lanes);
+
     /**
      * Check if RandomX is properly initialized.
      */
@@ -84,6 +129,11 @@ public:
      */
     std::optional<uint256> GetCurrentSeedHash() const;
 
+    /**
+     * Get a snapshot of the cache/dataset state, init timings and memory use.
+     */
+    Stats GetStats() const;
+
     /**
      * Get the shared dataset for mining VMs.
      * Returns nullptr if fast mode not initialized.
@@ -108,13 +158,40 @@ private:
     void InitFast(const uint256& seed_hash);
     void Cleanup();
 
+    //! Wait until no batch is hashing with the cache, before reinitializing it.
+    void WaitForBatch(std::unique_lock<std::mutex>& lock);
+    //! Body of the thread hashing lane `lane` of each batch published after
+    //! batch `last_batch_id`.
+    void LaneThread(size_t lane, uint64_t last_batch_id);
+
     mutable std::mutex m_mutex;
     randomx_cache* m_cache{nullptr};
     randomx_vm* m_vm_light{nullptr};
     randomx_vm* m_vm_fast{nullptr};
+    //! Light-mode VMs used by HashBatch(), one per lane.
+    std::vector<randomx_vm*> m_vm_lanes;
+    //! Threads hashing lanes 1.. of a batch (lane 0 is the calling thread).
+    std::vector<std::thread> m_lane_threads;
+    //! Signalled when a batch starts or lane threads have to stop.
+    std::condition_variable m_lane_cv;
+    //! Signalled when a batch's lanes are done or the batch has finished.
+    std::condition_variable m_batch_cv;
+    //! State of the batch being hashed, guarded by m_mutex.
+    bool m_batch_running{false};
+    uint64_t m_batch_id{0};
+    std::span<const std::vector<unsigned char>> m_batch_inputs;
+    uint256* m_batch_results{nullptr};
+    size_t m_batch_lanes{0};
+    size_t m_batch_pending{0};
+    bool m_stop_lanes{false};
     randomx_dataset* m_dataset{nullptr};
     std::optional<uint256> m_current_seed_hash;
     bool m_fast_mode_initialized{false};
+    //! Flags the light and fast VMs were created with (0 if not created).
+    int m_light_flags{0};
+    int m_fast_flags{0};
+    std::chrono::milliseconds m_cache_init_time{0};
+    std::chrono::milliseconds m_dataset_init_time{0};
 };
 
 /**
@@ -195,6 +272,12 @@ uint256 RandomXHash(std::span<const unsigned char> header_data, const uint256& s
  */
 uint256 RandomXHashLight(std::span<const unsigned char> data, const uint256& seed_hash);
 
+/**
+ * Compute light-mode RandomX hashes for many inputs sharing one seed, using up
+ * to @p lanes parallel VMs. Results are returned in input order.
+ */
+std::vector<uint256> RandomXHashBatch(std::span<const std::vector<unsigned char>> inputs, const uint256& seed_hash, unsigned int lanes);
+
 /**
  * Calculate the seed height for a given block height.
  * Seed rotates every 2048 blocks with a 64-block lag.
@@ -204,6 +287,16 @@ uint256 RandomXHashLight(std::span<const unsigned char> data, const uint256& see
  */
 uint64_t GetRandomXSeedHeight(uint64_t block_height);
 
+/**
+ * Calculate the first height after block_height that uses a different seed
+ * height than block_height, i.e. the next seed rotation.
+ *
+ * @param block_height Current block height
+ * @return             Height of the next seed switch, or std::nullopt if the
+ *                     seed does not rotate after block_height
+ */
+std::optional<uint64_t> GetNextRandomXSeedSwitchHeight(uint64_t block_height);
+
 /**
  * The epoch length for seed hash rotation (blocks).
  */
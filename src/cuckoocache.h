@@ -482,6 +482,20 @@ public:
             }
         return false;
     }
+
+    /** for_each calls fn on every element in the table that is not marked
+     * for garbage collection, in table order. Threadsafe without any
+     * concurrent insert.
+     *
+     * @param fn callable taking a const Element&
+     */
+    template <typename Fn>
+    void for_each(Fn&& fn) const
+    {
+        for (uint32_t i = 0; i < size; ++i)
+            if (!collection_flags.bit_is_set(i))
+                fn(table[i]);
+    }
 };
 } // namespace CuckooCache
 
@@ -4,11 +4,13 @@
 
 #include <dbwrapper.h>
 
+#include <logdb.h>
 #include <logging.h>
 #include <random.h>
 #include <serialize.h>
 #include <span.h>
 #include <streams.h>
+#include <tinyformat.h>
 #include <util/fs.h>
 #include <util/fs_helpers.h>
 #include <util/obfuscation.h>
@@ -19,6 +21,7 @@
 #include <cstdarg>
 #include <cstdint>
 #include <cstdio>
+#include <exception>
 #include <leveldb/cache.h>
 #include <leveldb/db.h>
 #include <leveldb/env.h>
@@ -35,8 +38,33 @@
 
 static auto CharCast(const std::byte* data) { return reinterpret_cast<const char*>(data); }
 
+std::string DBEngineToString(DBEngine engine)
+{
+    switch (engine) {
+    case DBEngine::LEVELDB: return "leveldb";
+    case DBEngine::LOGDB: return "logdb";
+    }
+    assert(false);
+}
+
+std::optional<DBEngine> DBEngineFromString(std::string_view engine)
+{
+    if (engine == "leveldb") return DBEngine::LEVELDB;
+    if (engine == "logdb") return DBEngine::LOGDB;
+    return std::nullopt;
+}
+
 bool DestroyDB(const std::string& path_str)
 {
+    const fs::path path{fs::PathFromString(path_str)};
+    if (LogDB::IsLogDB(path)) {
+        try {
+            LogDB::Destroy(path);
+        } catch (const fs::filesystem_error&) {
+            return false;
+        }
+        return true;
+    }
     return leveldb::DestroyDB(path_str, {}).ok();
 }
 
@@ -154,45 +182,69 @@ static leveldb::Options GetOptions(size_t nCacheSize)
 }
 
 struct CDBBatch::WriteBatchImpl {
-    leveldb::WriteBatch batch;
+    virtual ~WriteBatchImpl() = default;
+    virtual void Put(std::span<const std::byte> key, std::span<const std::byte> value) = 0;
+    virtual void Delete(std::span<const std::byte> key) = 0;
+    virtual void Clear() = 0;
+    virtual size_t ApproximateSize() const = 0;
 };
 
-CDBBatch::CDBBatch(const CDBWrapper& _parent)
-    : parent{_parent},
-      m_impl_batch{std::make_unique<CDBBatch::WriteBatchImpl>()}
+struct CDBIterator::IteratorImpl {
+    virtual ~IteratorImpl() = default;
+    virtual bool Valid() const = 0;
+    virtual void SeekToFirst() = 0;
+    virtual void Seek(std::span<const std::byte> key) = 0;
+    virtual void Next() = 0;
+    virtual std::span<const std::byte> Key() const = 0;
+    virtual std::span<const std::byte> Value() const = 0;
+};
+
+/** Storage engine behind a CDBWrapper. Errors are thrown as dbwrapper_error. */
+class DBBackend
 {
-    Clear();
+public:
+    virtual ~DBBackend() = default;
+    virtual std::unique_ptr<CDBBatch::WriteBatchImpl> NewBatch() const = 0;
+    virtual void Write(CDBBatch::WriteBatchImpl& batch, bool sync) = 0;
+    virtual std::optional<std::string> Read(std::span<const std::byte> key) const = 0;
+    virtual bool Exists(std::span<const std::byte> key) const = 0;
+    virtual std::unique_ptr<CDBIterator::IteratorImpl> NewIterator() const = 0;
+    virtual size_t EstimateSize(std::span<const std::byte> key1, std::span<const std::byte> key2) const = 0;
+    virtual size_t DynamicMemoryUsage() const = 0;
+    virtual void Compact() = 0;
 };
 
-CDBBatch::~CDBBatch() = default;
+namespace {
 
-void CDBBatch::Clear()
+class LevelDBBackend final : public DBBackend
 {
-    m_impl_batch->batch.Clear();
-}
+    struct Batch final : public CDBBatch::WriteBatchImpl {
+        leveldb::WriteBatch batch;
 
-void CDBBatch::WriteImpl(std::span<const std::byte> key, DataStream& ssValue)
-{
-    leveldb::Slice slKey(CharCast(key.data()), key.size());
-    dbwrapper_private::GetObfuscation(parent)(ssValue);
-    leveldb::Slice slValue(CharCast(ssValue.data()), ssValue.size());
-    m_impl_batch->batch.Put(slKey, slValue);
-}
+        void Put(std::span<const std::byte> key, std::span<const std::byte> value) override
+        {
+            batch.Put(leveldb::Slice(CharCast(key.data()), key.size()), leveldb::Slice(CharCast(value.data()), value.size()));
+        }
+        void Delete(std::span<const std::byte> key) override { batch.Delete(leveldb::Slice(CharCast(key.data()), key.size())); }
+        void Clear() override { batch.Clear(); }
+        size_t ApproximateSize() const override { return batch.ApproximateSize(); }
+    };
 
-void CDBBatch::EraseImpl(std::span<const std::byte> key)
-{
-    leveldb::Slice slKey(CharCast(key.data()), key.size());
-    m_impl_batch->batch.Delete(slKey);
-}
+    struct Iterator final : public CDBIterator::IteratorImpl {
+        const std::unique_ptr<leveldb::Iterator> iter;
 
-size_t CDBBatch::ApproximateSize() const
-{
-    return m_impl_batch->batch.ApproximateSize();
-}
+        explicit Iterator(leveldb::Iterator* _iter) : iter{_iter} {}
+
+        bool Valid() const override { return iter->Valid(); }
+        void SeekToFirst() override { iter->SeekToFirst(); }
+        void Seek(std::span<const std::byte> key) override { iter->Seek(leveldb::Slice(CharCast(key.data()), key.size())); }
+        void Next() override { iter->Next(); }
+        std::span<const std::byte> Key() const override { return MakeByteSpan(iter->key()); }
+        std::span<const std::byte> Value() const override { return MakeByteSpan(iter->value()); }
+    };
 
-struct LevelDBContext {
     //! custom environment this database is using (may be nullptr in case of default environment)
-    leveldb::Env* penv;
+    leveldb::Env* penv{nullptr};
 
     //! database options used
     leveldb::Options options;
@@ -210,42 +262,344 @@ struct LevelDBContext {
     leveldb::WriteOptions syncoptions;
 
     //! the database itself
-    leveldb::DB* pdb;
+    leveldb::DB* pdb{nullptr};
+
+public:
+    LevelDBBackend(const fs::path& path, size_t cache_bytes, bool memory_only)
+    {
+        readoptions.verify_checksums = true;
+        iteroptions.verify_checksums = true;
+        iteroptions.fill_cache = false;
+        syncoptions.sync = true;
+        options = GetOptions(cache_bytes);
+        options.create_if_missing = true;
+        if (memory_only) {
+            penv = leveldb::NewMemEnv(leveldb::Env::Default());
+            options.env = penv;
+        }
+        // PathToString() return value is safe to pass to leveldb open function,
+        // because on POSIX leveldb passes the byte string directly to ::open(), and
+        // on Windows it converts from UTF-8 to UTF-16 before calling ::CreateFileW
+        // (see env_posix.cc and env_windows.cc).
+        leveldb::Status status = leveldb::DB::Open(options, fs::PathToString(path), &pdb);
+        if (!status.ok()) Release();
+        HandleError(status);
+    }
+
+    ~LevelDBBackend() override { Release(); }
+
+private:
+    void Release()
+    {
+        delete pdb;
+        pdb = nullptr;
+        delete options.filter_policy;
+        options.filter_policy = nullptr;
+        delete options.info_log;
+        options.info_log = nullptr;
+        delete options.block_cache;
+        options.block_cache = nullptr;
+        delete penv;
+        penv = nullptr;
+        options.env = nullptr;
+    }
+
+public:
+    std::unique_ptr<CDBBatch::WriteBatchImpl> NewBatch() const override { return std::make_unique<Batch>(); }
+
+    void Write(CDBBatch::WriteBatchImpl& batch, bool sync) override
+    {
+        leveldb::Status status = pdb->Write(sync ? syncoptions : writeoptions, &static_cast<Batch&>(batch).batch);
+        HandleError(status);
+    }
+
+    std::optional<std::string> Read(std::span<const std::byte> key) const override
+    {
+        leveldb::Slice slKey(CharCast(key.data()), key.size());
+        std::string strValue;
+        leveldb::Status status = pdb->Get(readoptions, slKey, &strValue);
+        if (!status.ok()) {
+            if (status.IsNotFound())
+                return std::nullopt;
+            LogError("LevelDB read failure: %s", status.ToString());
+            HandleError(status);
+        }
+        return strValue;
+    }
+
+    bool Exists(std::span<const std::byte> key) const override
+    {
+        return Read(key).has_value();
+    }
+
+    std::unique_ptr<CDBIterator::IteratorImpl> NewIterator() const override
+    {
+        return std::make_unique<Iterator>(pdb->NewIterator(iteroptions));
+    }
+
+    size_t EstimateSize(std::span<const std::byte> key1, std::span<const std::byte> key2) const override
+    {
+        leveldb::Slice slKey1(CharCast(key1.data()), key1.size());
+        leveldb::Slice slKey2(CharCast(key2.data()), key2.size());
+        uint64_t size = 0;
+        leveldb::Range range(slKey1, slKey2);
+        pdb->GetApproximateSizes(&range, 1, &size);
+        return size;
+    }
+
+    size_t DynamicMemoryUsage() const override
+    {
+        std::string memory;
+        std::optional<size_t> parsed;
+        if (!pdb->GetProperty("leveldb.approximate-memory-usage", &memory) || !(parsed = ToIntegral<size_t>(memory))) {
+            LogDebug(BCLog::LEVELDB, "Failed to get approximate-memory-usage property\n");
+            return 0;
+        }
+        return parsed.value();
+    }
+
+    void Compact() override { pdb->CompactRange(nullptr, nullptr); }
 };
 
+/** Handle a LogDB error by throwing dbwrapper_error exception. */
+[[noreturn]] void HandleLogDBError(const std::exception& e)
+{
+    const std::string errmsg{strprintf("Fatal LogDB error: %s", e.what())};
+    LogError("%s", errmsg);
+    throw dbwrapper_error(errmsg);
+}
+
+class LogDBBackend final : public DBBackend
+{
+    struct Batch final : public CDBBatch::WriteBatchImpl {
+        LogDB::Batch batch;
+
+        void Put(std::span<const std::byte> key, std::span<const std::byte> value) override { batch.Put(key, value); }
+        void Delete(std::span<const std::byte> key) override { batch.Delete(key); }
+        void Clear() override { batch.Clear(); }
+        size_t ApproximateSize() const override { return batch.ApproximateSize(); }
+    };
+
+    struct Iterator final : public CDBIterator::IteratorImpl {
+        const std::unique_ptr<LogDB::Iterator> iter;
+
+        explicit Iterator(std::unique_ptr<LogDB::Iterator> _iter) : iter{std::move(_iter)} {}
+
+        bool Valid() const override { return iter->Valid(); }
+        void SeekToFirst() override { iter->SeekToFirst(); }
+        void Seek(std::span<const std::byte> key) override { iter->Seek(key); }
+        void Next() override { iter->Next(); }
+        std::span<const std::byte> Key() const override { return iter->Key(); }
+        std::span<const std::byte> Value() const override { return iter->Value(); }
+    };
+
+    std::unique_ptr<LogDB> m_db;
+
+public:
+    explicit LogDBBackend(const fs::path& path)
+    {
+        try {
+            m_db = std::make_unique<LogDB>(path);
+        } catch (const std::runtime_error& e) {
+            HandleLogDBError(e);
+        }
+    }
+
+    std::unique_ptr<CDBBatch::WriteBatchImpl> NewBatch() const override { return std::make_unique<Batch>(); }
+
+    void Write(CDBBatch::WriteBatchImpl& batch, bool sync) override
+    {
+        try {
+            m_db->Write(static_cast<Batch&>(batch).batch, sync);
+        } catch (const std::runtime_error& e) {
+            HandleLogDBError(e);
+        }
+    }
+
+    std::optional<std::string> Read(std::span<const std::byte> key) const override { return m_db->Read(key); }
+    bool Exists(std::span<const std::byte> key) const override { return m_db->Exists(key); }
+
+    std::unique_ptr<CDBIterator::IteratorImpl> NewIterator() const override
+    {
+        return std::make_unique<Iterator>(m_db->NewIterator());
+    }
+
+    size_t EstimateSize(std::span<const std::byte> key1, std::span<const std::byte> key2) const override
+    {
+        return m_db->EstimateSize(key1, key2);
+    }
+
+    size_t DynamicMemoryUsage() const override { return m_db->DynamicMemoryUsage(); }
+
+    void Compact() override
+    {
+        try {
+            m_db->Compact();
+        } catch (const std::runtime_error& e) {
+            HandleLogDBError(e);
+        }
+    }
+};
+
+//! Name of engine in log messages.
+std::string_view EngineDisplayName(DBEngine engine)
+{
+    switch (engine) {
+    case DBEngine::LEVELDB: return "LevelDB";
+    case DBEngine::LOGDB: return "LogDB";
+    }
+    assert(false);
+}
+
+std::unique_ptr<DBBackend> OpenBackend(DBEngine engine, const fs::path& path, size_t cache_bytes)
+{
+    switch (engine) {
+    case DBEngine::LEVELDB: return std::make_unique<LevelDBBackend>(path, cache_bytes, /*memory_only=*/false);
+    case DBEngine::LOGDB: return std::make_unique<LogDBBackend>(path);
+    }
+    assert(false);
+}
+
+//! Engine of the database in path, if there is one.
+std::optional<DBEngine> DetectEngine(const fs::path& path)
+{
+    if (LogDB::IsLogDB(path)) return DBEngine::LOGDB;
+    if (fs::exists(path / "CURRENT")) return DBEngine::LEVELDB;
+    return std::nullopt;
+}
+
+//! Written to a migrated copy of a database once it is complete.
+const fs::path MIGRATION_DONE_FILE{"MIGRATED"};
+
+fs::path MigrationPath(const fs::path& path)
+{
+    return fs::PathFromString(fs::PathToString(path) + ".migrate");
+}
+
+/**
+ * Finish or discard a migration of the database in path that was interrupted.
+ * A complete copy replaces the original, anything else is removed.
+ */
+void RecoverMigration(const fs::path& path)
+{
+    const fs::path tmp_path{MigrationPath(path)};
+    if (!fs::exists(tmp_path)) return;
+    if (fs::exists(tmp_path / MIGRATION_DONE_FILE)) {
+        LogInfo("Completing interrupted migration of %s", fs::PathToString(path));
+        fs::remove_all(path);
+        fs::rename(tmp_path, path);
+        fs::remove(path / MIGRATION_DONE_FILE);
+    } else {
+        LogInfo("Removing incomplete migration of %s", fs::PathToString(path));
+        fs::remove_all(tmp_path);
+    }
+}
+
+/**
+ * Copy the database in path from one engine to another. The copy is built
+ * next to the original and only replaces it once it is complete, so the
+ * migration can be interrupted at any point.
+ */
+void MigrateDB(const fs::path& path, DBEngine from, DBEngine to, size_t cache_bytes)
+{
+    const fs::path tmp_path{MigrationPath(path)};
+    LogInfo("Migrating %s from %s to %s", fs::PathToString(path), EngineDisplayName(from), EngineDisplayName(to));
+    size_t count{0};
+    {
+        const auto source{OpenBackend(from, path, cache_bytes)};
+        const auto target{OpenBackend(to, tmp_path, cache_bytes)};
+        const auto batch{target->NewBatch()};
+        const auto it{source->NewIterator()};
+        for (it->SeekToFirst(); it->Valid(); it->Next()) {
+            batch->Put(it->Key(), it->Value());
+            ++count;
+            if (batch->ApproximateSize() > DBWRAPPER_MAX_FILE_SIZE / 2) {
+                target->Write(*batch, /*sync=*/false);
+                batch->Clear();
+            }
+        }
+        target->Write(*batch, /*sync=*/true);
+    }
+    FILE* file{fsbridge::fopen(tmp_path / MIGRATION_DONE_FILE, "wb")};
+    if (!file || !FileCommit(file)) {
+        if (file) fclose(file);
+        throw dbwrapper_error(strprintf("Failed to complete migration of %s", fs::PathToString(path)));
+    }
+    fclose(file);
+    DirectoryCommit(tmp_path);
+    fs::remove_all(path);
+    fs::rename(tmp_path, path);
+    fs::remove(path / MIGRATION_DONE_FILE);
+    LogInfo("Migrated %d entries of %s to %s", count, fs::PathToString(path), EngineDisplayName(to));
+}
+
+} // namespace
+
+CDBBatch::CDBBatch(const CDBWrapper& _parent)
+    : parent{_parent},
+      m_impl_batch{parent.Backend().NewBatch()}
+{
+    Clear();
+};
+
+CDBBatch::~CDBBatch() = default;
+
+void CDBBatch::Clear()
+{
+    m_impl_batch->Clear();
+}
+
+void CDBBatch::WriteImpl(std::span<const std::byte> key, DataStream& ssValue)
+{
+    dbwrapper_private::GetObfuscation(parent)(ssValue);
+    m_impl_batch->Put(key, ssValue);
+}
+
+void CDBBatch::EraseImpl(std::span<const std::byte> key)
+{
+    m_impl_batch->Delete(key);
+}
+
+size_t CDBBatch::ApproximateSize() const
+{
+    return m_impl_batch->ApproximateSize();
+}
+
 CDBWrapper::CDBWrapper(const DBParams& params)
-    : m_db_context{std::make_unique<LevelDBContext>()}, m_name{fs::PathToString(params.path.stem())}
-{
-    DBContext().penv = nullptr;
-    DBContext().readoptions.verify_checksums = true;
-    DBContext().iteroptions.verify_checksums = true;
-    DBContext().iteroptions.fill_cache = false;
-    DBContext().syncoptions.sync = true;
-    DBContext().options = GetOptions(params.cache_bytes);
-    DBContext().options.create_if_missing = true;
+    : m_name{fs::PathToString(params.path.stem())}
+{
+    DBEngine engine{params.memory_only ? DBEngine::LEVELDB : params.options.engine};
     if (params.memory_only) {
-        DBContext().penv = leveldb::NewMemEnv(leveldb::Env::Default());
-        DBContext().options.env = DBContext().penv;
+        m_backend = std::make_unique<LevelDBBackend>(params.path, params.cache_bytes, /*memory_only=*/true);
     } else {
+        RecoverMigration(params.path);
         if (params.wipe_data) {
-            LogInfo("Wiping LevelDB in %s", fs::PathToString(params.path));
-            leveldb::Status result = leveldb::DestroyDB(fs::PathToString(params.path), DBContext().options);
-            HandleError(result);
+            if (LogDB::IsLogDB(params.path)) {
+                LogInfo("Wiping LogDB in %s", fs::PathToString(params.path));
+                LogDB::Destroy(params.path);
+            } else {
+                LogInfo("Wiping LevelDB in %s", fs::PathToString(params.path));
+                HandleError(leveldb::DestroyDB(fs::PathToString(params.path), {}));
+            }
+        } else if (const auto existing{DetectEngine(params.path)}; existing && *existing != engine) {
+            if (params.options.migrate) {
+                MigrateDB(params.path, *existing, engine, params.cache_bytes);
+            } else {
+                LogWarning("%s is stored in %s, not %s; opening it as is. Restart with -migratedb to convert it.",
+                           fs::PathToString(params.path), EngineDisplayName(*existing), EngineDisplayName(engine));
+                engine = *existing;
+            }
         }
         TryCreateDirectories(params.path);
-        LogInfo("Opening LevelDB in %s", fs::PathToString(params.path));
+        LogInfo("Opening %s in %s", EngineDisplayName(engine), fs::PathToString(params.path));
+        m_backend = OpenBackend(engine, params.path, params.cache_bytes);
     }
-    // PathToString() return value is safe to pass to leveldb open function,
-    // because on POSIX leveldb passes the byte string directly to ::open(), and
-    // on Windows it converts from UTF-8 to UTF-16 before calling ::CreateFileW
-    // (see env_posix.cc and env_windows.cc).
-    leveldb::Status status = leveldb::DB::Open(DBContext().options, fs::PathToString(params.path), &DBContext().pdb);
-    HandleError(status);
-    LogInfo("Opened LevelDB successfully");
+    m_engine = engine;
+    LogInfo("Opened %s successfully", EngineDisplayName(engine));
 
     if (params.options.force_compact) {
         LogInfo("Starting database compaction of %s", fs::PathToString(params.path));
-        DBContext().pdb->CompactRange(nullptr, nullptr);
+        Backend().Compact();
         LogInfo("Finished database compaction of %s", fs::PathToString(params.path));
     }
 
@@ -260,19 +614,7 @@ CDBWrapper::CDBWrapper(const DBParams& params)
     LogInfo("Using obfuscation key for %s: %s", fs::PathToString(params.path), m_obfuscation.HexKey());
 }
 
-CDBWrapper::~CDBWrapper()
-{
-    delete DBContext().pdb;
-    DBContext().pdb = nullptr;
-    delete DBContext().options.filter_policy;
-    DBContext().options.filter_policy = nullptr;
-    delete DBContext().options.info_log;
-    DBContext().options.info_log = nullptr;
-    delete DBContext().options.block_cache;
-    DBContext().options.block_cache = nullptr;
-    delete DBContext().penv;
-    DBContext().options.env = nullptr;
-}
+CDBWrapper::~CDBWrapper() = default;
 
 void CDBWrapper::WriteBatch(CDBBatch& batch, bool fSync)
 {
@@ -281,8 +623,7 @@ void CDBWrapper::WriteBatch(CDBBatch& batch, bool fSync)
     if (log_memory) {
         mem_before = DynamicMemoryUsage() / 1024.0 / 1024;
     }
-    leveldb::Status status = DBContext().pdb->Write(fSync ? DBContext().syncoptions : DBContext().writeoptions, &batch.m_impl_batch->batch);
-    HandleError(status);
+    Backend().Write(*batch.m_impl_batch, fSync);
     if (log_memory) {
         double mem_after = DynamicMemoryUsage() / 1024.0 / 1024;
         LogDebug(BCLog::LEVELDB, "WriteBatch memory usage: db=%s, before=%.1fMiB, after=%.1fMiB\n",
@@ -292,52 +633,22 @@ void CDBWrapper::WriteBatch(CDBBatch& batch, bool fSync)
 
 size_t CDBWrapper::DynamicMemoryUsage() const
 {
-    std::string memory;
-    std::optional<size_t> parsed;
-    if (!DBContext().pdb->GetProperty("leveldb.approximate-memory-usage", &memory) || !(parsed = ToIntegral<size_t>(memory))) {
-        LogDebug(BCLog::LEVELDB, "Failed to get approximate-memory-usage property\n");
-        return 0;
-    }
-    return parsed.value();
+    return Backend().DynamicMemoryUsage();
 }
 
 std::optional<std::string> CDBWrapper::ReadImpl(std::span<const std::byte> key) const
 {
-    leveldb::Slice slKey(CharCast(key.data()), key.size());
-    std::string strValue;
-    leveldb::Status status = DBContext().pdb->Get(DBContext().readoptions, slKey, &strValue);
-    if (!status.ok()) {
-        if (status.IsNotFound())
-            return std::nullopt;
-        LogError("LevelDB read failure: %s", status.ToString());
-        HandleError(status);
-    }
-    return strValue;
+    return Backend().Read(key);
 }
 
 bool CDBWrapper::ExistsImpl(std::span<const std::byte> key) const
 {
-    leveldb::Slice slKey(CharCast(key.data()), key.size());
-
-    std::string strValue;
-    leveldb::Status status = DBContext().pdb->Get(DBContext().readoptions, slKey, &strValue);
-    if (!status.ok()) {
-        if (status.IsNotFound())
-            return false;
-        LogError("LevelDB read failure: %s", status.ToString());
-        HandleError(status);
-    }
-    return true;
+    return Backend().Exists(key);
 }
 
 size_t CDBWrapper::EstimateSizeImpl(std::span<const std::byte> key1, std::span<const std::byte> key2) const
 {
-    leveldb::Slice slKey1(CharCast(key1.data()), key1.size());
-    leveldb::Slice slKey2(CharCast(key2.data()), key2.size());
-    uint64_t size = 0;
-    leveldb::Range range(slKey1, slKey2);
-    DBContext().pdb->GetApproximateSizes(&range, 1, &size);
-    return size;
+    return Backend().EstimateSize(key1, key2);
 }
 
 bool CDBWrapper::IsEmpty()
@@ -347,40 +658,33 @@ bool CDBWrapper::IsEmpty()
     return !(it->Valid());
 }
 
-struct CDBIterator::IteratorImpl {
-    const std::unique_ptr<leveldb::Iterator> iter;
-
-    explicit IteratorImpl(leveldb::Iterator* _iter) : iter{_iter} {}
-};
-
 CDBIterator::CDBIterator(const CDBWrapper& _parent, std::unique_ptr<IteratorImpl> _piter) : parent(_parent),
                                                                                             m_impl_iter(std::move(_piter)) {}
 
 CDBIterator* CDBWrapper::NewIterator()
 {
-    return new CDBIterator{*this, std::make_unique<CDBIterator::IteratorImpl>(DBContext().pdb->NewIterator(DBContext().iteroptions))};
+    return new CDBIterator{*this, Backend().NewIterator()};
 }
 
 void CDBIterator::SeekImpl(std::span<const std::byte> key)
 {
-    leveldb::Slice slKey(CharCast(key.data()), key.size());
-    m_impl_iter->iter->Seek(slKey);
+    m_impl_iter->Seek(key);
 }
 
 std::span<const std::byte> CDBIterator::GetKeyImpl() const
 {
-    return MakeByteSpan(m_impl_iter->iter->key());
+    return m_impl_iter->Key();
 }
 
 std::span<const std::byte> CDBIterator::GetValueImpl() const
 {
-    return MakeByteSpan(m_impl_iter->iter->value());
+    return m_impl_iter->Value();
 }
 
 CDBIterator::~CDBIterator() = default;
-bool CDBIterator::Valid() const { return m_impl_iter->iter->Valid(); }
-void CDBIterator::SeekToFirst() { m_impl_iter->iter->SeekToFirst(); }
-void CDBIterator::Next() { m_impl_iter->iter->Next(); }
+bool CDBIterator::Valid() const { return m_impl_iter->Valid(); }
+void CDBIterator::SeekToFirst() { m_impl_iter->SeekToFirst(); }
+void CDBIterator::Next() { m_impl_iter->Next(); }
 
 namespace dbwrapper_private {
 
@@ -18,15 +18,32 @@
 #include <optional>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 
 static const size_t DBWRAPPER_PREALLOC_KEY_SIZE = 64;
 static const size_t DBWRAPPER_PREALLOC_VALUE_SIZE = 1024;
 static const size_t DBWRAPPER_MAX_FILE_SIZE = 32 << 20; // 32 MiB
 
+//! Storage engines a CDBWrapper can be backed by.
+enum class DBEngine {
+    //! LevelDB, a log-structured merge tree.
+    LEVELDB,
+    //! LogDB, an append-only log with an in-memory index (see logdb.h).
+    LOGDB,
+};
+
+std::string DBEngineToString(DBEngine engine);
+std::optional<DBEngine> DBEngineFromString(std::string_view engine);
+
 //! User-controlled performance and debug options.
 struct DBOptions {
     //! Compact database on startup.
     bool force_compact = false;
+    //! Storage engine of newly created databases.
+    DBEngine engine = DBEngine::LEVELDB;
+    //! Convert a database found on disk in another engine to `engine` when it
+    //! is opened. Without this, it is opened in the engine it was written by.
+    bool migrate = false;
 };
 
 //! Application-specific storage settings.
@@ -65,6 +82,7 @@ namespace dbwrapper_private {
 const Obfuscation& GetObfuscation(const CDBWrapper&);
 }; // namespace dbwrapper_private
 
+/** Remove the database in path_str, whichever engine it was written by. */
 bool DestroyDB(const std::string& path_str);
 
 /** Batch of changes queued to be written to a CDBWrapper */
@@ -72,10 +90,12 @@ class CDBBatch
 {
     friend class CDBWrapper;
 
+public:
+    struct WriteBatchImpl;
+
 private:
     const CDBWrapper &parent;
 
-    struct WriteBatchImpl;
     const std::unique_ptr<WriteBatchImpl> m_impl_batch;
 
     DataStream ssKey{};
@@ -133,7 +153,7 @@ public:
 
     /**
      * @param[in] _parent          Parent CDBWrapper instance.
-     * @param[in] _piter           The original leveldb iterator.
+     * @param[in] _piter           The iterator of the storage engine.
      */
     CDBIterator(const CDBWrapper& _parent, std::unique_ptr<IteratorImpl> _piter);
     ~CDBIterator();
@@ -173,18 +193,22 @@ public:
     }
 };
 
-struct LevelDBContext;
+class DBBackend;
 
 class CDBWrapper
 {
     friend const Obfuscation& dbwrapper_private::GetObfuscation(const CDBWrapper&);
+    friend class CDBBatch;
 private:
-    //! holds all leveldb-specific fields of this class
-    std::unique_ptr<LevelDBContext> m_db_context;
+    //! the storage engine holding the data
+    std::unique_ptr<DBBackend> m_backend;
 
     //! the name of this database
     std::string m_name;
 
+    //! the storage engine the database is stored in
+    DBEngine m_engine;
+
     //! optional XOR-obfuscation of the database
     Obfuscation m_obfuscation;
 
@@ -194,7 +218,7 @@ private:
     std::optional<std::string> ReadImpl(std::span<const std::byte> key) const;
     bool ExistsImpl(std::span<const std::byte> key) const;
     size_t EstimateSizeImpl(std::span<const std::byte> key1, std::span<const std::byte> key2) const;
-    auto& DBContext() const LIFETIMEBOUND { return *Assert(m_db_context); }
+    auto& Backend() const LIFETIMEBOUND { return *Assert(m_backend); }
 
 public:
     CDBWrapper(const DBParams& params);
@@ -250,9 +274,13 @@ public:
 
     void WriteBatch(CDBBatch& batch, bool fSync = false);
 
-    // Get an estimate of LevelDB memory usage (in bytes).
+    // Get an estimate of the storage engine's memory usage (in bytes).
     size_t DynamicMemoryUsage() const;
 
+    //! The storage engine the database is stored in, which is not the
+    //! requested one for a database kept in another engine.
+    DBEngine Engine() const { return m_engine; }
+
     CDBIterator* NewIterator();
 
     /**
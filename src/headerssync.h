@@ -81,6 +81,14 @@ struct CompressedHeader {
  * sufficient, we switch to downloading the headers a second time, this time
  * processing them fully, and possibly storing them in memory.
  *
+ * (Botcoin) Checking the RandomX proof-of-work of a header is far more
+ * expensive than the SHA256d check this scheme was designed around. The
+ * caller verifies it (see HasValidProofOfWork()) before handing headers to
+ * this class, and records each passing header in the ChainstateManager's
+ * PowCache, keyed by block hash and seed hash. Redownloaded headers, and the
+ * eventual AcceptBlockHeader() call, therefore find their verdict in the
+ * cache instead of paying a second and third RandomX hash.
+ *
  * To prevent an attacker from using (eg) the honest chain to convince us that
  * they have a high-work chain, but then feeding us an alternate set of
  * low-difficulty headers in the second phase, we store commitments to the
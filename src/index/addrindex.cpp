@@ -0,0 +1,340 @@
+// Copyright (c) 2026-present The Botcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/addrindex.h>
+
+#include <common/args.h>
+#include <crypto/sha256.h>
+#include <dbwrapper.h>
+#include <index/base.h>
+#include <interfaces/chain.h>
+#include <logging.h>
+#include <primitives/block.h>
+#include <primitives/transaction.h>
+#include <script/script.h>
+#include <serialize.h>
+#include <uint256.h>
+#include <undo.h>
+#include <util/check.h>
+#include <util/fs.h>
+
+#include <cstdint>
+#include <exception>
+#include <ios>
+#include <map>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+/**
+ * Each output paying to a script is stored under the key
+ * [DB_ADDR_OUTPUT, SHA256(script), height (BE), txid, vout (BE)]. Heights and
+ * output indexes are big-endian so that range scans return outputs in chain
+ * order. The value holds the amount of the output and, once spent, the input
+ * spending it.
+ */
+constexpr uint8_t DB_ADDR_OUTPUT{'a'};
+/**
+ * The totals of the outputs paying to each script are stored under the key
+ * [DB_ADDR_BALANCE, SHA256(script)], and kept up to date with its entries.
+ */
+constexpr uint8_t DB_ADDR_BALANCE{'b'};
+
+std::unique_ptr<AddrIndex> g_addrindex;
+
+namespace {
+uint256 ScriptHash(const CScript& script)
+{
+    uint256 hash;
+    CSHA256().Write(script.data(), script.size()).Finalize(hash.begin());
+    return hash;
+}
+
+struct DBKey {
+    uint256 script_hash;
+    int height{0};
+    COutPoint outpoint;
+
+    DBKey() = default;
+    DBKey(const uint256& script_hash_in, int height_in, const COutPoint& outpoint_in)
+        : script_hash{script_hash_in}, height{height_in}, outpoint{outpoint_in} {}
+
+    template <typename Stream>
+    void Serialize(Stream& s) const
+    {
+        ser_writedata8(s, DB_ADDR_OUTPUT);
+        s << script_hash;
+        ser_writedata32be(s, height);
+        s << outpoint.hash;
+        ser_writedata32be(s, outpoint.n);
+    }
+
+    template <typename Stream>
+    void Unserialize(Stream& s)
+    {
+        if (ser_readdata8(s) != DB_ADDR_OUTPUT) {
+            throw std::ios_base::failure("Invalid format for address index DB key");
+        }
+        s >> script_hash;
+        height = ser_readdata32be(s);
+        s >> outpoint.hash;
+        outpoint.n = ser_readdata32be(s);
+    }
+};
+
+struct DBVal {
+    CAmount value{0};
+    std::optional<AddrIndexEntry::Spender> spent_by;
+
+    template <typename Stream>
+    void Serialize(Stream& s) const
+    {
+        s << value << spent_by.has_value();
+        if (spent_by) s << spent_by->txid << spent_by->vin << spent_by->height;
+    }
+
+    template <typename Stream>
+    void Unserialize(Stream& s)
+    {
+        bool spent;
+        s >> value >> spent;
+        spent_by.reset();
+        if (spent) {
+            auto& spender{spent_by.emplace()};
+            s >> spender.txid >> spender.vin >> spender.height;
+        }
+    }
+};
+
+struct DBBalance {
+    AddrIndexBalance totals;
+
+    SERIALIZE_METHODS(DBBalance, obj) { READWRITE(obj.totals.received, obj.totals.balance, obj.totals.outputs, obj.totals.unspent_outputs); }
+};
+
+/** Totals of the scripts whose entries a batch changes, read on first use. */
+class BalanceBatch
+{
+    const CDBWrapper& m_db;
+    std::map<uint256, AddrIndexBalance> m_totals;
+
+    AddrIndexBalance& Get(const uint256& script_hash)
+    {
+        auto [it, inserted]{m_totals.try_emplace(script_hash)};
+        if (inserted) {
+            DBBalance stored;
+            if (m_db.Read(std::make_pair(DB_ADDR_BALANCE, script_hash), stored)) it->second = stored.totals;
+        }
+        return it->second;
+    }
+
+public:
+    explicit BalanceBatch(const CDBWrapper& db) : m_db{db} {}
+
+    void AddOutput(const uint256& script_hash, CAmount value)
+    {
+        AddrIndexBalance& totals{Get(script_hash)};
+        ++totals.outputs;
+        totals.received += value;
+        ++totals.unspent_outputs;
+        totals.balance += value;
+    }
+
+    void RemoveOutput(const uint256& script_hash, CAmount value)
+    {
+        AddrIndexBalance& totals{Get(script_hash)};
+        --totals.outputs;
+        totals.received -= value;
+        --totals.unspent_outputs;
+        totals.balance -= value;
+    }
+
+    void Spend(const uint256& script_hash, CAmount value)
+    {
+        AddrIndexBalance& totals{Get(script_hash)};
+        --totals.unspent_outputs;
+        totals.balance -= value;
+    }
+
+    void Unspend(const uint256& script_hash, CAmount value)
+    {
+        AddrIndexBalance& totals{Get(script_hash)};
+        ++totals.unspent_outputs;
+        totals.balance += value;
+    }
+
+    void Write(CDBBatch& batch) const
+    {
+        for (const auto& [script_hash, totals] : m_totals) {
+            if (totals.outputs == 0) {
+                batch.Erase(std::make_pair(DB_ADDR_BALANCE, script_hash));
+            } else {
+                batch.Write(std::make_pair(DB_ADDR_BALANCE, script_hash), DBBalance{totals});
+            }
+        }
+    }
+};
+} // namespace
+
+/** Access to the address index database (indexes/addrindex/) */
+class AddrIndex::DB : public BaseIndex::DB
+{
+public:
+    explicit DB(size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+};
+
+AddrIndex::DB::DB(size_t n_cache_size, bool f_memory, bool f_wipe) :
+    BaseIndex::DB(gArgs.GetDataDirNet() / "indexes" / "addrindex", n_cache_size, f_memory, f_wipe)
+{}
+
+/** Entries of a block in the order they have to be written, computed ahead of writing them. */
+struct AddrIndex::PreparedEntries final : PreparedBlock {
+    std::vector<std::pair<DBKey, DBVal>> entries;
+};
+
+AddrIndex::AddrIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory, bool f_wipe)
+    : BaseIndex(std::move(chain), "addrindex"), m_db(std::make_unique<AddrIndex::DB>(n_cache_size, f_memory, f_wipe))
+{}
+
+AddrIndex::~AddrIndex() = default;
+
+interfaces::Chain::NotifyOptions AddrIndex::CustomOptions()
+{
+    interfaces::Chain::NotifyOptions options;
+    options.connect_undo_data = true;
+    options.disconnect_data = true;
+    options.disconnect_undo_data = true;
+    return options;
+}
+
+std::unique_ptr<AddrIndex::PreparedBlock> AddrIndex::CustomPrepare(const interfaces::BlockInfo& block) const
+{
+    auto prepared{std::make_unique<PreparedEntries>()};
+    const CBlock& block_data{*Assert(block.data)};
+    for (size_t i = 0; i < block_data.vtx.size(); ++i) {
+        const CTransaction& tx{*block_data.vtx[i]};
+        // Record the spends before the outputs, as transactions may spend
+        // outputs of earlier transactions of the same block.
+        if (!tx.IsCoinBase()) {
+            const CTxUndo& tx_undo{Assert(block.undo_data)->vtxundo.at(i - 1)};
+            for (uint32_t j = 0; j < tx.vin.size(); ++j) {
+                const Coin& coin{tx_undo.vprevout.at(j)};
+                if (coin.out.scriptPubKey.IsUnspendable()) continue;
+                prepared->entries.emplace_back(
+                    DBKey{ScriptHash(coin.out.scriptPubKey), static_cast<int>(coin.nHeight), tx.vin[j].prevout},
+                    DBVal{coin.out.nValue, AddrIndexEntry::Spender{tx.GetHash(), j, block.height}});
+            }
+        }
+        for (uint32_t j = 0; j < tx.vout.size(); ++j) {
+            const CTxOut& out{tx.vout[j]};
+            if (out.scriptPubKey.IsUnspendable()) continue;
+            prepared->entries.emplace_back(
+                DBKey{ScriptHash(out.scriptPubKey), block.height, COutPoint{tx.GetHash(), j}},
+                DBVal{out.nValue, std::nullopt});
+        }
+    }
+    return prepared;
+}
+
+bool AddrIndex::CustomAppendPrepared(const interfaces::BlockInfo& block, PreparedBlock& prepared)
+{
+    CDBBatch batch(*m_db);
+    BalanceBatch balances{*m_db};
+    for (const auto& [key, value] : static_cast<PreparedEntries&>(prepared).entries) {
+        batch.Write(key, value);
+        if (value.spent_by) {
+            balances.Spend(key.script_hash, value.value);
+        } else {
+            balances.AddOutput(key.script_hash, value.value);
+        }
+    }
+    balances.Write(batch);
+    m_db->WriteBatch(batch);
+    return true;
+}
+
+bool AddrIndex::CustomRemove(const interfaces::BlockInfo& block)
+{
+    CDBBatch batch(*m_db);
+    BalanceBatch balances{*m_db};
+    const CBlock& block_data{*Assert(block.data)};
+    // Undo the entries in the reverse order of CustomPrepare(), so that outputs
+    // created and spent within the block end up erased.
+    for (size_t i = block_data.vtx.size(); i-- > 0;) {
+        const CTransaction& tx{*block_data.vtx[i]};
+        for (uint32_t j = 0; j < tx.vout.size(); ++j) {
+            const CTxOut& out{tx.vout[j]};
+            if (out.scriptPubKey.IsUnspendable()) continue;
+            const uint256 script_hash{ScriptHash(out.scriptPubKey)};
+            batch.Erase(DBKey{script_hash, block.height, COutPoint{tx.GetHash(), j}});
+            // Any spend of it within the block has been undone already
+            balances.RemoveOutput(script_hash, out.nValue);
+        }
+        if (!tx.IsCoinBase()) {
+            const CTxUndo& tx_undo{Assert(block.undo_data)->vtxundo.at(i - 1)};
+            for (uint32_t j = 0; j < tx.vin.size(); ++j) {
+                const Coin& coin{tx_undo.vprevout.at(j)};
+                if (coin.out.scriptPubKey.IsUnspendable()) continue;
+                const uint256 script_hash{ScriptHash(coin.out.scriptPubKey)};
+                batch.Write(DBKey{script_hash, static_cast<int>(coin.nHeight), tx.vin[j].prevout},
+                            DBVal{coin.out.nValue, std::nullopt});
+                balances.Unspend(script_hash, coin.out.nValue);
+            }
+        }
+    }
+    balances.Write(batch);
+    m_db->WriteBatch(batch);
+    return true;
+}
+
+BaseIndex::DB& AddrIndex::GetDB() const { return *m_db; }
+
+bool AddrIndex::LookUpOutputs(const CScript& script, int start_height, int end_height,
+                              const std::optional<std::pair<int, COutPoint>>& after, size_t limit,
+                              std::vector<AddrIndexEntry>& entries) const
+{
+    const uint256 script_hash{ScriptHash(script)};
+    std::unique_ptr<CDBIterator> db_it(m_db->NewIterator());
+    if (after && after->first >= start_height) {
+        db_it->Seek(DBKey{script_hash, after->first, after->second});
+        // Skip the last entry returned already
+        DBKey key;
+        if (db_it->Valid() && db_it->GetKey(key) && key.height == after->first && key.outpoint == after->second) {
+            db_it->Next();
+        }
+    } else {
+        db_it->Seek(DBKey{script_hash, start_height, COutPoint{Txid{}, 0}});
+    }
+
+    try {
+        for (; db_it->Valid() && entries.size() < limit; db_it->Next()) {
+            DBKey key;
+            if (!db_it->GetKey(key) || key.script_hash != script_hash || key.height > end_height) break;
+            DBVal value;
+            if (!db_it->GetValue(value)) {
+                LogError("Cannot read address index entry of output %s", key.outpoint.ToString());
+                return false;
+            }
+            entries.push_back({.height = key.height, .outpoint = key.outpoint, .value = value.value, .spent_by = value.spent_by});
+        }
+    } catch (const std::exception& e) {
+        LogError("Failed to read the address index: %s", e.what());
+        return false;
+    }
+    return true;
+}
+
+bool AddrIndex::LookUpBalance(const CScript& script, AddrIndexBalance& balance) const
+{
+    DBBalance stored;
+    try {
+        if (!m_db->Read(std::make_pair(DB_ADDR_BALANCE, ScriptHash(script)), stored)) stored = {};
+    } catch (const std::exception& e) {
+        LogError("Failed to read the address index: %s", e.what());
+        return false;
+    }
+    balance = stored.totals;
+    return true;
+}
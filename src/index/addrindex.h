@@ -0,0 +1,109 @@
+// Copyright (c) 2026-present The Botcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_INDEX_ADDRINDEX_H
+#define BITCOIN_INDEX_ADDRINDEX_H
+
+#include <consensus/amount.h>
+#include <index/base.h>
+#include <interfaces/chain.h>
+#include <primitives/transaction.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+class CScript;
+
+static constexpr bool DEFAULT_ADDRINDEX{false};
+
+/** An output paying to an indexed script, and the input spending it, if any. */
+struct AddrIndexEntry {
+    /// Height of the block that created the output
+    int height{0};
+    COutPoint outpoint;
+    CAmount value{0};
+
+    struct Spender {
+        Txid txid;
+        uint32_t vin{0};
+        /// Height of the block that spent the output
+        int height{0};
+    };
+    std::optional<Spender> spent_by;
+};
+
+/** Totals of the outputs paying to an indexed script. */
+struct AddrIndexBalance {
+    CAmount received{0};
+    CAmount balance{0};
+    uint64_t outputs{0};
+    uint64_t unspent_outputs{0};
+};
+
+/**
+ * AddrIndex records, for each scriptPubKey, the outputs paying to it and the
+ * inputs spending them. Entries are keyed by the SHA256 of the script followed
+ * by the height, txid and output index of the output, so that the history of
+ * a script is read in chain order with a single range scan. Its balance is
+ * kept up to date in a separate entry, so that it is read without one.
+ */
+class AddrIndex final : public BaseIndex
+{
+protected:
+    class DB;
+
+private:
+    const std::unique_ptr<DB> m_db;
+
+    struct PreparedEntries;
+
+    bool AllowPrune() const override { return true; }
+
+protected:
+    interfaces::Chain::NotifyOptions CustomOptions() override;
+
+    bool AllowParallelSync() const override { return true; }
+
+    std::unique_ptr<PreparedBlock> CustomPrepare(const interfaces::BlockInfo& block) const override;
+
+    bool CustomAppendPrepared(const interfaces::BlockInfo& block, PreparedBlock& prepared) override;
+
+    bool CustomRemove(const interfaces::BlockInfo& block) override;
+
+    BaseIndex::DB& GetDB() const override;
+
+public:
+    /// Constructs the index, which becomes available to be queried.
+    explicit AddrIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    // Destructor is declared because this class contains a unique_ptr to an incomplete type.
+    virtual ~AddrIndex() override;
+
+    /// Look up the outputs paying to a script that were created in blocks
+    /// start_height to end_height, in chain order.
+    ///
+    /// @param[in]   script        The scriptPubKey to look up.
+    /// @param[in]   start_height  Height of the first block to include.
+    /// @param[in]   end_height    Height of the last block to include.
+    /// @param[in]   after         If set, only return outputs following this (height, outpoint) position.
+    /// @param[in]   limit         Maximum number of entries to return.
+    /// @param[out]  entries       The outputs found.
+    /// @return  false if the database could not be read.
+    bool LookUpOutputs(const CScript& script, int start_height, int end_height,
+                       const std::optional<std::pair<int, COutPoint>>& after, size_t limit,
+                       std::vector<AddrIndexEntry>& entries) const;
+
+    /// Look up the totals of the outputs paying to a script, which are kept
+    /// along with its entries.
+    bool LookUpBalance(const CScript& script, AddrIndexBalance& balance) const;
+};
+
+/// The global address index, used by the address history RPCs and REST
+/// endpoints. May be null.
+extern std::unique_ptr<AddrIndex> g_addrindex;
+
+#endif // BITCOIN_INDEX_ADDRINDEX_H
@@ -30,8 +30,11 @@
 #include <validation.h>
 #include <validationinterface.h>
 
+#include <algorithm>
 #include <cassert>
 #include <compare>
+#include <condition_variable>
+#include <deque>
 #include <cstdint>
 #include <memory>
 #include <optional>
@@ -171,7 +174,7 @@ bool BaseIndex::ProcessBlock(const CBlockIndex* pindex, const CBlock* block_data
 
     CBlock block;
     if (!block_data) { // disk lookup if block data wasn't provided
-        if (!m_chainstate->m_blockman.ReadBlock(block, *pindex)) {
+        if (!m_chainstate->m_blockman.ReadBlock(block, *pindex, /*use_arena=*/true)) {
             FatalErrorf("Failed to read block %s from disk",
                         pindex->GetBlockHash().ToString());
             return false;
@@ -189,7 +192,14 @@ bool BaseIndex::ProcessBlock(const CBlockIndex* pindex, const CBlock* block_data
         block_info.undo_data = &block_undo;
     }
 
-    if (!CustomAppend(block_info)) {
+    bool appended;
+    if (AllowParallelSync()) {
+        const auto prepared{CustomPrepare(block_info)};
+        appended = prepared && CustomAppendPrepared(block_info, *prepared);
+    } else {
+        appended = CustomAppend(block_info);
+    }
+    if (!appended) {
         FatalErrorf("Failed to write block %s to index database",
                     pindex->GetBlockHash().ToString());
         return false;
@@ -198,10 +208,158 @@ bool BaseIndex::ProcessBlock(const CBlockIndex* pindex, const CBlock* block_data
     return true;
 }
 
+/**
+ * Reads blocks and runs CustomPrepare() for them on worker threads during the
+ * initial sync of an index that allows it. The blocks following the one being
+ * appended in the chain are prepared ahead, while the sync thread appends
+ * them in order.
+ */
+class BaseIndex::SyncPipeline
+{
+    struct Job {
+        const CBlockIndex* const pindex;
+        CBlock block;
+        CBlockUndo undo;
+        std::unique_ptr<PreparedBlock> prepared;
+        std::optional<std::string> error;
+        //! Set under m_mutex once the fields above are filled in
+        bool done{false};
+
+        explicit Job(const CBlockIndex* pindex_in) : pindex{pindex_in} {}
+    };
+
+    BaseIndex& m_index;
+    const interfaces::Chain::NotifyOptions m_options;
+    //! Maximum number of blocks prepared but not appended yet, bounding memory usage
+    const size_t m_max_jobs;
+
+    Mutex m_mutex;
+    std::condition_variable m_cv;
+    //! Jobs not started yet
+    std::deque<std::shared_ptr<Job>> m_todo GUARDED_BY(m_mutex);
+    bool m_stop GUARDED_BY(m_mutex){false};
+
+    //! Jobs of the blocks following the last one appended, in chain order. Only used by the sync thread.
+    std::deque<std::shared_ptr<Job>> m_jobs;
+
+    std::vector<std::thread> m_workers;
+
+    void Prepare(Job& job) const
+    {
+        const node::BlockManager& blockman{m_index.m_chainstate->m_blockman};
+        if (!blockman.ReadBlock(job.block, *job.pindex, /*use_arena=*/true)) {
+            job.error = strprintf("Failed to read block %s from disk", job.pindex->GetBlockHash().ToString());
+            return;
+        }
+        interfaces::BlockInfo block_info{kernel::MakeBlockInfo(job.pindex, &job.block)};
+        if (m_options.connect_undo_data) {
+            if (job.pindex->nHeight > 0 && !blockman.ReadBlockUndo(job.undo, *job.pindex)) {
+                job.error = strprintf("Failed to read undo block data %s from disk", job.pindex->GetBlockHash().ToString());
+                return;
+            }
+            block_info.undo_data = &job.undo;
+        }
+        job.prepared = m_index.CustomPrepare(block_info);
+        if (!job.prepared) {
+            job.error = strprintf("Failed to write block %s to index database", job.pindex->GetBlockHash().ToString());
+        }
+    }
+
+    void WorkerThread() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        while (true) {
+            std::shared_ptr<Job> job;
+            {
+                WAIT_LOCK(m_mutex, lock);
+                m_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return m_stop || !m_todo.empty(); });
+                if (m_stop) return;
+                job = std::move(m_todo.front());
+                m_todo.pop_front();
+            }
+            try {
+                Prepare(*job);
+            } catch (const std::exception& e) {
+                job->error = strprintf("Failed to prepare block %s for the index: %s", job->pindex->GetBlockHash().ToString(), e.what());
+            }
+            WITH_LOCK(m_mutex, job->done = true);
+            m_cv.notify_all();
+        }
+    }
+
+public:
+    SyncPipeline(BaseIndex& index, int num_workers)
+        : m_index{index}, m_options{index.CustomOptions()}, m_max_jobs{2 * static_cast<size_t>(num_workers) + 2}
+    {
+        for (int i{0}; i < num_workers; ++i) {
+            m_workers.emplace_back(&util::TraceThread, strprintf("%s.%d", index.GetName(), i), [this] { WorkerThread(); });
+        }
+    }
+
+    ~SyncPipeline()
+    {
+        WITH_LOCK(m_mutex, m_stop = true);
+        m_cv.notify_all();
+        for (auto& worker : m_workers) worker.join();
+    }
+
+    /// Append block pindex, the successor of the index's best block, to the index.
+    bool Process(const CBlockIndex* pindex) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        if (!m_jobs.empty() && m_jobs.front()->pindex != pindex) {
+            // The index was rewound, so the queued blocks no longer follow it
+            m_jobs.clear();
+            WITH_LOCK(m_mutex, m_todo.clear());
+        }
+
+        // Queue the blocks following pindex in the chain. Should the chain
+        // change meanwhile, the sync rewinds past the blocks of the old chain
+        // appended from the queue, as it would after appending them one by one.
+        std::vector<std::shared_ptr<Job>> queued;
+        {
+            LOCK(::cs_main);
+            const CBlockIndex* last{m_jobs.empty() ? nullptr : m_jobs.back()->pindex};
+            while (m_jobs.size() < m_max_jobs) {
+                const CBlockIndex* next{last ? m_index.m_chainstate->m_chain.Next(last) : pindex};
+                if (!next) break;
+                queued.push_back(m_jobs.emplace_back(std::make_shared<Job>(next)));
+                last = next;
+            }
+        }
+        if (!queued.empty()) {
+            WITH_LOCK(m_mutex, m_todo.insert(m_todo.end(), queued.begin(), queued.end()));
+            m_cv.notify_all();
+        }
+
+        const std::shared_ptr<Job> job{std::move(m_jobs.front())};
+        m_jobs.pop_front();
+        {
+            WAIT_LOCK(m_mutex, lock);
+            m_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return job->done; });
+        }
+        if (job->error) {
+            m_index.FatalErrorf("%s", *job->error);
+            return false;
+        }
+
+        interfaces::BlockInfo block_info{kernel::MakeBlockInfo(pindex, &job->block)};
+        if (m_options.connect_undo_data) block_info.undo_data = &job->undo;
+        if (!m_index.CustomAppendPrepared(block_info, *job->prepared)) {
+            m_index.FatalErrorf("Failed to write block %s to index database",
+                                pindex->GetBlockHash().ToString());
+            return false;
+        }
+        return true;
+    }
+};
+
 void BaseIndex::Sync()
 {
     const CBlockIndex* pindex = m_best_block_index.load();
     if (!m_synced) {
+        std::optional<SyncPipeline> pipeline;
+        if (AllowParallelSync()) {
+            pipeline.emplace(*this, std::max(1, std::clamp(m_chainstate->m_chainman.m_options.worker_threads_num, 0, MAX_SCRIPTCHECK_THREADS)));
+        }
         auto last_log_time{NodeClock::now()};
         auto last_locator_write_time{last_log_time};
         while (true) {
@@ -243,7 +401,7 @@ void BaseIndex::Sync()
             pindex = pindex_next;
 
 
-            if (!ProcessBlock(pindex)) return; // error logged internally
+            if (!(pipeline ? pipeline->Process(pindex) : ProcessBlock(pindex))) return; // error logged internally
 
             auto current_time{NodeClock::now()};
             if (current_time - last_log_time >= SYNC_LOG_INTERVAL) {
@@ -297,7 +455,7 @@ bool BaseIndex::Rewind(const CBlockIndex* current_tip, const CBlockIndex* new_ti
     for (const CBlockIndex* iter_tip = current_tip; iter_tip != new_tip; iter_tip = iter_tip->pprev) {
         interfaces::BlockInfo block_info = kernel::MakeBlockInfo(iter_tip);
         if (CustomOptions().disconnect_data) {
-            if (!m_chainstate->m_blockman.ReadBlock(block, *iter_tip)) {
+            if (!m_chainstate->m_blockman.ReadBlock(block, *iter_tip, /*use_arena=*/true)) {
                 LogError("Failed to read block %s from disk",
                          iter_tip->GetBlockHash().ToString());
                 return false;
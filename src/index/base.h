@@ -75,7 +75,14 @@ protected:
         void WriteBestBlock(CDBBatch& batch, const CBlockLocator& locator);
     };
 
+    /// Index data of a block computed by CustomPrepare().
+    struct PreparedBlock {
+        virtual ~PreparedBlock() = default;
+    };
+
 private:
+    class SyncPipeline;
+
     /// Whether the index has been initialized or not.
     std::atomic<bool> m_init{false};
     /// Whether the index is in sync with the main chain. The flag is flipped
@@ -131,6 +138,20 @@ protected:
     /// Write update index entries for a newly connected block.
     [[nodiscard]] virtual bool CustomAppend(const interfaces::BlockInfo& block) { return true; }
 
+    /// Whether the index computes the entries of a block independently of
+    /// other blocks and of its own state, in CustomPrepare(). Such indexes
+    /// are appended to with CustomPrepare() and CustomAppendPrepared() instead
+    /// of CustomAppend(), and their initial sync reads and prepares blocks on
+    /// several threads ahead of the block being appended.
+    virtual bool AllowParallelSync() const { return false; }
+
+    /// Compute the index entries of a block, possibly on a worker thread and
+    /// ahead of earlier blocks. Return nullptr on failure.
+    [[nodiscard]] virtual std::unique_ptr<PreparedBlock> CustomPrepare(const interfaces::BlockInfo& block) const { return nullptr; }
+
+    /// Write the index entries computed by CustomPrepare(), in block order.
+    [[nodiscard]] virtual bool CustomAppendPrepared(const interfaces::BlockInfo& block, PreparedBlock& prepared) { return true; }
+
     /// Virtual method called internally by Commit that can be overridden to atomically
     /// commit more index state.
     virtual bool CustomCommit(CDBBatch& batch) { return true; }
@@ -248,9 +248,21 @@ std::optional<uint256> BlockFilterIndex::ReadFilterHeader(int height, const uint
     return read_out.second.header;
 }
 
-bool BlockFilterIndex::CustomAppend(const interfaces::BlockInfo& block)
+/** Filter of a block, built ahead of chaining its header and writing it. */
+struct BlockFilterIndex::PreparedFilter final : PreparedBlock {
+    BlockFilter filter;
+
+    explicit PreparedFilter(BlockFilter&& filter_in) : filter{std::move(filter_in)} {}
+};
+
+std::unique_ptr<BlockFilterIndex::PreparedBlock> BlockFilterIndex::CustomPrepare(const interfaces::BlockInfo& block) const
+{
+    return std::make_unique<PreparedFilter>(BlockFilter(m_filter_type, *Assert(block.data), *Assert(block.undo_data)));
+}
+
+bool BlockFilterIndex::CustomAppendPrepared(const interfaces::BlockInfo& block, PreparedBlock& prepared)
 {
-    BlockFilter filter(m_filter_type, *Assert(block.data), *Assert(block.undo_data));
+    const BlockFilter& filter{static_cast<PreparedFilter&>(prepared).filter};
     const uint256& header = filter.ComputeHeader(m_last_header);
     bool res = Write(filter, block.height, header);
     if (res) m_last_header = header; // update last header
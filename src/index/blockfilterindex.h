@@ -58,6 +58,8 @@ private:
 
     bool AllowPrune() const override { return true; }
 
+    struct PreparedFilter;
+
     bool Write(const BlockFilter& filter, uint32_t block_height, const uint256& filter_header);
 
     std::optional<uint256> ReadFilterHeader(int height, const uint256& expected_block_hash);
@@ -69,7 +71,11 @@ protected:
 
     bool CustomCommit(CDBBatch& batch) override;
 
-    bool CustomAppend(const interfaces::BlockInfo& block) override;
+    bool AllowParallelSync() const override { return true; }
+
+    std::unique_ptr<PreparedBlock> CustomPrepare(const interfaces::BlockInfo& block) const override;
+
+    bool CustomAppendPrepared(const interfaces::BlockInfo& block, PreparedBlock& prepared) override;
 
     bool CustomRemove(const interfaces::BlockInfo& block) override;
 
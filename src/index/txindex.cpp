@@ -10,6 +10,7 @@
 #include <index/base.h>
 #include <index/disktxpos.h>
 #include <interfaces/chain.h>
+#include <kernel/messagestartchars.h>
 #include <logging.h>
 #include <node/blockstorage.h>
 #include <primitives/block.h>
@@ -20,11 +21,13 @@
 #include <util/fs.h>
 #include <validation.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
 #include <cstdio>
 #include <exception>
 #include <iterator>
+#include <optional>
 #include <span>
 #include <string>
 #include <utility>
@@ -73,20 +76,31 @@ TxIndex::TxIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size,
 
 TxIndex::~TxIndex() = default;
 
-bool TxIndex::CustomAppend(const interfaces::BlockInfo& block)
+/** Positions of the transactions of a block, computed ahead of writing them. */
+struct TxIndex::PreparedTxs final : PreparedBlock {
+    std::vector<std::pair<Txid, CDiskTxPos>> vPos;
+};
+
+std::unique_ptr<TxIndex::PreparedBlock> TxIndex::CustomPrepare(const interfaces::BlockInfo& block) const
 {
+    auto prepared{std::make_unique<PreparedTxs>()};
     // Exclude genesis block transaction because outputs are not spendable.
-    if (block.height == 0) return true;
+    if (block.height == 0) return prepared;
 
     assert(block.data);
     CDiskTxPos pos({block.file_number, block.data_pos}, GetSizeOfCompactSize(block.data->vtx.size()));
-    std::vector<std::pair<Txid, CDiskTxPos>> vPos;
-    vPos.reserve(block.data->vtx.size());
+    prepared->vPos.reserve(block.data->vtx.size());
     for (const auto& tx : block.data->vtx) {
-        vPos.emplace_back(tx->GetHash(), pos);
+        prepared->vPos.emplace_back(tx->GetHash(), pos);
         pos.nTxOffset += ::GetSerializeSize(TX_WITH_WITNESS(*tx));
     }
-    m_db->WriteTxs(vPos);
+    return prepared;
+}
+
+bool TxIndex::CustomAppendPrepared(const interfaces::BlockInfo& block, PreparedBlock& prepared)
+{
+    const auto& vPos{static_cast<PreparedTxs&>(prepared).vPos};
+    if (!vPos.empty()) m_db->WriteTxs(vPos);
     return true;
 }
 
@@ -99,13 +113,32 @@ bool TxIndex::FindTx(const Txid& tx_hash, uint256& block_hash, CTransactionRef&
         return false;
     }
 
-    AutoFile file{m_chainstate->m_blockman.OpenBlockFile(postx, true)};
+    // Open the file at the storage header, to tell whether the block is compressed
+    AutoFile file{m_chainstate->m_blockman.OpenBlockFile({postx.nFile, postx.nPos - node::STORAGE_HEADER_BYTES}, true)};
     if (file.IsNull()) {
         LogError("OpenBlockFile failed");
         return false;
     }
     CBlockHeader header;
     try {
+        MessageStartChars blk_start;
+        unsigned int blk_size;
+        file >> blk_start >> blk_size;
+        if (blk_size & node::COMPRESSED_BLOCK_FLAG) {
+            // Transactions of compressed blocks are not at nTxOffset, so read
+            // the whole block instead.
+            file.fclose();
+            CBlock block;
+            if (!m_chainstate->m_blockman.ReadBlock(block, postx, std::nullopt)) return false;
+            const auto it{std::ranges::find_if(block.vtx, [&](const auto& block_tx) { return block_tx->GetHash() == tx_hash; })};
+            if (it == block.vtx.end()) {
+                LogError("txid not found in block");
+                return false;
+            }
+            tx = *it;
+            block_hash = block.GetHash();
+            return true;
+        }
         file >> header;
         file.seek(postx.nTxOffset, SEEK_CUR);
         file >> TX_WITH_WITNESS(tx);
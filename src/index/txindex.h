@@ -31,10 +31,16 @@ protected:
 private:
     const std::unique_ptr<DB> m_db;
 
+    struct PreparedTxs;
+
     bool AllowPrune() const override { return false; }
 
 protected:
-    bool CustomAppend(const interfaces::BlockInfo& block) override;
+    bool AllowParallelSync() const override { return true; }
+
+    std::unique_ptr<PreparedBlock> CustomPrepare(const interfaces::BlockInfo& block) const override;
+
+    bool CustomAppendPrepared(const interfaces::BlockInfo& block, PreparedBlock& prepared) override;
 
     BaseIndex::DB& GetDB() const override;
 
@@ -0,0 +1,112 @@
+// Copyright (c) 2026-present The Botcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/txospenderindex.h>
+
+#include <common/args.h>
+#include <dbwrapper.h>
+#include <index/base.h>
+#include <interfaces/chain.h>
+#include <logging.h>
+#include <primitives/block.h>
+#include <primitives/transaction.h>
+#include <util/check.h>
+#include <util/fs.h>
+
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+/** Each spent output is stored under the key [DB_TXO_SPENDER, outpoint]. */
+constexpr uint8_t DB_TXO_SPENDER{'o'};
+
+std::unique_ptr<TxoSpenderIndex> g_txospenderindex;
+
+/** Access to the spent output index database (indexes/txospenderindex/) */
+class TxoSpenderIndex::DB : public BaseIndex::DB
+{
+public:
+    explicit DB(size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+};
+
+TxoSpenderIndex::DB::DB(size_t n_cache_size, bool f_memory, bool f_wipe) :
+    BaseIndex::DB(gArgs.GetDataDirNet() / "indexes" / "txospenderindex", n_cache_size, f_memory, f_wipe)
+{}
+
+/** Outputs spent by a block and their spenders, computed ahead of writing them. */
+struct TxoSpenderIndex::PreparedSpends final : PreparedBlock {
+    std::vector<std::pair<COutPoint, TxoSpender>> spends;
+};
+
+TxoSpenderIndex::TxoSpenderIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory, bool f_wipe)
+    : BaseIndex(std::move(chain), "txospenderindex"), m_db(std::make_unique<TxoSpenderIndex::DB>(n_cache_size, f_memory, f_wipe))
+{}
+
+TxoSpenderIndex::~TxoSpenderIndex() = default;
+
+interfaces::Chain::NotifyOptions TxoSpenderIndex::CustomOptions()
+{
+    interfaces::Chain::NotifyOptions options;
+    options.disconnect_data = true;
+    return options;
+}
+
+std::unique_ptr<TxoSpenderIndex::PreparedBlock> TxoSpenderIndex::CustomPrepare(const interfaces::BlockInfo& block) const
+{
+    auto prepared{std::make_unique<PreparedSpends>()};
+    for (const auto& tx : Assert(block.data)->vtx) {
+        if (tx->IsCoinBase()) continue;
+        for (uint32_t i = 0; i < tx->vin.size(); ++i) {
+            prepared->spends.emplace_back(tx->vin[i].prevout, TxoSpender{tx->GetHash(), i, block.height, block.hash});
+        }
+    }
+    return prepared;
+}
+
+bool TxoSpenderIndex::CustomAppendPrepared(const interfaces::BlockInfo& block, PreparedBlock& prepared)
+{
+    const auto& spends{static_cast<PreparedSpends&>(prepared).spends};
+    if (spends.empty()) return true;
+    CDBBatch batch(*m_db);
+    for (const auto& [outpoint, spender] : spends) {
+        batch.Write(std::make_pair(DB_TXO_SPENDER, outpoint), spender);
+    }
+    m_db->WriteBatch(batch);
+    return true;
+}
+
+bool TxoSpenderIndex::CustomRemove(const interfaces::BlockInfo& block)
+{
+    CDBBatch batch(*m_db);
+    for (const auto& tx : Assert(block.data)->vtx) {
+        if (tx->IsCoinBase()) continue;
+        for (const CTxIn& txin : tx->vin) {
+            batch.Erase(std::make_pair(DB_TXO_SPENDER, txin.prevout));
+        }
+    }
+    m_db->WriteBatch(batch);
+    return true;
+}
+
+BaseIndex::DB& TxoSpenderIndex::GetDB() const { return *m_db; }
+
+bool TxoSpenderIndex::FindSpenders(std::span<const COutPoint> outpoints, std::vector<std::optional<TxoSpender>>& spenders) const
+{
+    spenders.assign(outpoints.size(), std::nullopt);
+    try {
+        for (size_t i = 0; i < outpoints.size(); ++i) {
+            TxoSpender spender;
+            if (m_db->Read(std::make_pair(DB_TXO_SPENDER, outpoints[i]), spender)) {
+                spenders[i] = spender;
+            }
+        }
+    } catch (const std::exception& e) {
+        LogError("Failed to read the spent output index: %s", e.what());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,84 @@
+// Copyright (c) 2026-present The Botcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_INDEX_TXOSPENDERINDEX_H
+#define BITCOIN_INDEX_TXOSPENDERINDEX_H
+
+#include <index/base.h>
+#include <interfaces/chain.h>
+#include <primitives/transaction.h>
+#include <serialize.h>
+#include <uint256.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+
+static constexpr bool DEFAULT_TXOSPENDERINDEX{false};
+
+/** The input of a block transaction spending an output. */
+struct TxoSpender {
+    Txid txid;
+    uint32_t vin{0};
+    /// Height and hash of the block containing the spending transaction
+    int height{0};
+    uint256 block_hash;
+
+    SERIALIZE_METHODS(TxoSpender, obj) { READWRITE(obj.txid, obj.vin, obj.height, obj.block_hash); }
+};
+
+/**
+ * TxoSpenderIndex maps each output spent in the active chain to the input
+ * spending it, so that the spender of an output is found with a single
+ * database read.
+ */
+class TxoSpenderIndex final : public BaseIndex
+{
+protected:
+    class DB;
+
+private:
+    const std::unique_ptr<DB> m_db;
+
+    struct PreparedSpends;
+
+    bool AllowPrune() const override { return true; }
+
+protected:
+    interfaces::Chain::NotifyOptions CustomOptions() override;
+
+    bool AllowParallelSync() const override { return true; }
+
+    std::unique_ptr<PreparedBlock> CustomPrepare(const interfaces::BlockInfo& block) const override;
+
+    bool CustomAppendPrepared(const interfaces::BlockInfo& block, PreparedBlock& prepared) override;
+
+    bool CustomRemove(const interfaces::BlockInfo& block) override;
+
+    BaseIndex::DB& GetDB() const override;
+
+public:
+    /// Constructs the index, which becomes available to be queried.
+    explicit TxoSpenderIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    // Destructor is declared because this class contains a unique_ptr to an incomplete type.
+    virtual ~TxoSpenderIndex() override;
+
+    /// Look up the spenders of a batch of outputs.
+    ///
+    /// @param[in]   outpoints  The outputs to look up.
+    /// @param[out]  spenders   The spender of each output, or std::nullopt if
+    ///                         it is not spent in the indexed chain.
+    /// @return  false if the database could not be read.
+    bool FindSpenders(std::span<const COutPoint> outpoints, std::vector<std::optional<TxoSpender>>& spenders) const;
+};
+
+/// The global spent output index, used by the gettxspendingprevout rpc call.
+/// May be null.
+extern std::unique_ptr<TxoSpenderIndex> g_txospenderindex;
+
+#endif // BITCOIN_INDEX_TXOSPENDERINDEX_H
@@ -0,0 +1,125 @@
+// Copyright (c) 2026-present The Botcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <inputfetcher.h>
+
+#include <logging.h>
+#include <primitives/block.h>
+#include <tinyformat.h>
+#include <util/hasher.h>
+#include <util/threadnames.h>
+
+#include <algorithm>
+#include <unordered_set>
+
+InputFetcher::InputFetcher(size_t batch_size, int worker_threads_num)
+    : m_batch_size{std::max<size_t>(batch_size, 1)}
+{
+    LogInfo("Input prefetching uses %d additional threads", worker_threads_num);
+    m_worker_threads.reserve(worker_threads_num);
+    for (int n = 0; n < worker_threads_num; ++n) {
+        m_worker_threads.emplace_back([this, n]() {
+            util::ThreadRename(strprintf("inputfetch.%i", n));
+            Loop();
+        });
+    }
+}
+
+InputFetcher::~InputFetcher()
+{
+    WITH_LOCK(m_mutex, m_request_stop = true);
+    m_worker_cv.notify_all();
+    for (std::thread& t : m_worker_threads) {
+        t.join();
+    }
+}
+
+void InputFetcher::Work() noexcept
+{
+    const size_t count{m_outpoints.size()};
+    while (true) {
+        const size_t begin{m_next_index.fetch_add(m_batch_size, std::memory_order_relaxed)};
+        if (begin >= count) return;
+        const size_t end{std::min(begin + m_batch_size, count)};
+        for (size_t i{begin}; i < end; ++i) {
+            try {
+                m_coins[i] = m_db->GetCoin(m_outpoints[i]);
+            } catch (const std::exception&) {
+                // Leave the coin to be read (and the error to be handled) by ConnectBlock.
+            }
+        }
+    }
+}
+
+void InputFetcher::Loop() noexcept
+{
+    uint64_t generation{0};
+    while (true) {
+        {
+            WAIT_LOCK(m_mutex, lock);
+            m_worker_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return m_request_stop || m_generation != generation; });
+            if (m_request_stop) return;
+            generation = m_generation;
+        }
+        Work();
+        {
+            LOCK(m_mutex);
+            if (--m_active_workers == 0) m_main_cv.notify_one();
+        }
+    }
+}
+
+InputFetcher::FetchStats InputFetcher::FetchInputs(CCoinsViewCache& cache, const CCoinsView& db, const CBlock& block, const CCoinsViewCache* pending)
+{
+    FetchStats stats;
+    if (!HasThreads() || block.vtx.size() <= 1) return stats;
+    LOCK(m_control_mutex);
+
+    // Collect the prevouts that are neither created by this block nor already
+    // cached, here or in pending.
+    std::unordered_set<Txid, SaltedTxidHasher> block_txids;
+    block_txids.reserve(block.vtx.size());
+    m_outpoints.clear();
+    for (const auto& tx : block.vtx) {
+        if (!tx->IsCoinBase()) {
+            for (const CTxIn& txin : tx->vin) {
+                const COutPoint& prevout{txin.prevout};
+                if (block_txids.contains(prevout.hash)) continue;
+                ++stats.inputs;
+                if (cache.HaveCoinInCache(prevout) || (pending && pending->HaveCoinInCache(prevout))) {
+                    ++stats.cache_hits;
+                    continue;
+                }
+                m_outpoints.push_back(prevout);
+            }
+        }
+        block_txids.insert(tx->GetHash());
+    }
+    if (m_outpoints.empty()) return stats;
+
+    m_db = &db;
+    m_coins.assign(m_outpoints.size(), std::nullopt);
+    m_next_index.store(0, std::memory_order_relaxed);
+    {
+        LOCK(m_mutex);
+        m_active_workers = m_worker_threads.size();
+        ++m_generation;
+    }
+    m_worker_cv.notify_all();
+
+    // Join the workers until every outpoint has been read.
+    Work();
+    {
+        WAIT_LOCK(m_mutex, lock);
+        m_main_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return m_active_workers == 0; });
+    }
+
+    for (size_t i{0}; i < m_outpoints.size(); ++i) {
+        if (m_coins[i]) cache.EmplaceCoinFromBase(m_outpoints[i], std::move(*m_coins[i]));
+    }
+    m_db = nullptr;
+    m_outpoints.clear();
+    m_coins.clear();
+    return stats;
+}
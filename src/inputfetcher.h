@@ -0,0 +1,122 @@
+// Copyright (c) 2026-present The Botcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BOTCOIN_INPUTFETCHER_H
+#define BOTCOIN_INPUTFETCHER_H
+
+#include <coins.h>
+#include <primitives/transaction.h>
+#include <sync.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <optional>
+#include <thread>
+#include <vector>
+
+class CBlock;
+
+/**
+ * Reads the inputs of a block from the UTXO database on a pool of worker
+ * threads and inserts them into a coins cache before the block is connected.
+ *
+ * ConnectBlock() looks up every input through CCoinsViewCache::AccessCoin,
+ * which on a cache miss does one synchronous database read at a time on the
+ * validation thread. Prefetching the missing prevouts in parallel lets a cold
+ * cache (IBD, -reindex-chainstate) be bound by disk throughput rather than
+ * by the latency of single reads.
+ *
+ * Outputs created earlier in the same block and coins the cache already holds
+ * are skipped. Coins are only added to the cache if it has no entry for the
+ * outpoint yet, so a fetch never overrides a spend or modification the cache
+ * has not flushed.
+ *
+ * Like CCheckQueue, one thread (the caller of FetchInputs) hands out work and
+ * joins the workers until every input has been read.
+ */
+class InputFetcher
+{
+private:
+    //! Mutex to ensure only one block is fetched at a time
+    Mutex m_control_mutex;
+
+    //! Mutex to protect the inner state
+    Mutex m_mutex;
+
+    //! Worker threads block on this when out of work
+    std::condition_variable m_worker_cv;
+
+    //! The caller of FetchInputs() blocks on this until all workers are done
+    std::condition_variable m_main_cv;
+
+    //! Database to read coins from for the current block.
+    const CCoinsView* m_db{nullptr};
+
+    //! Outpoints to read for the current block, and the coins read for them.
+    std::vector<COutPoint> m_outpoints;
+    std::vector<std::optional<Coin>> m_coins;
+
+    //! Index of the next outpoint to be read.
+    std::atomic<size_t> m_next_index{0};
+
+    //! Incremented for every block, so workers can tell new work apart from spurious wakeups.
+    uint64_t m_generation GUARDED_BY(m_mutex){0};
+
+    //! The number of workers that have not finished the current block yet.
+    int m_active_workers GUARDED_BY(m_mutex){0};
+
+    //! The maximum number of outpoints read by a thread in one go
+    const size_t m_batch_size;
+
+    std::vector<std::thread> m_worker_threads;
+    bool m_request_stop GUARDED_BY(m_mutex){false};
+
+    /** Read outpoints from m_db until there are none left. */
+    void Work() noexcept;
+
+    /** Worker thread main loop. */
+    void Loop() noexcept EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+public:
+    //! Create a new input fetcher
+    explicit InputFetcher(size_t batch_size, int worker_threads_num);
+
+    // Since this class manages its own resources, which is a thread
+    // pool `m_worker_threads`, copy and move operations are not appropriate.
+    InputFetcher(const InputFetcher&) = delete;
+    InputFetcher& operator=(const InputFetcher&) = delete;
+    InputFetcher(InputFetcher&&) = delete;
+    InputFetcher& operator=(InputFetcher&&) = delete;
+
+    ~InputFetcher();
+
+    struct FetchStats {
+        //! Inputs of the block that do not spend outputs of the block itself
+        size_t inputs{0};
+        //! How many of those were already in the coins cache
+        size_t cache_hits{0};
+    };
+
+    /**
+     * Read the inputs of block that are not in cache from db and add them to
+     * cache. db must be the database cache is layered on, with no other
+     * caching view in between, must be safe to read from several threads at
+     * once and must not be modified for the duration of the call. Read errors are ignored;
+     * the coin is then read again, and the error handled, when the block is
+     * connected.
+     *
+     * If pending is set, it is a cache on top of cache whose changes have not
+     * been flushed to it yet, such as outputs created by earlier blocks that
+     * are still being checked. Inputs it holds are not read either.
+     *
+     * Does nothing, and returns empty stats, if the fetcher has no worker
+     * threads.
+     */
+    FetchStats FetchInputs(CCoinsViewCache& cache, const CCoinsView& db, const CBlock& block, const CCoinsViewCache* pending = nullptr) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex, !m_control_mutex);
+
+    bool HasThreads() const { return !m_worker_threads.empty(); }
+};
+
+#endif // BOTCOIN_INPUTFETCHER_H
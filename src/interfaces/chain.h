@@ -143,6 +143,13 @@ public:
     //! or std::nullopt if the block filter for this block couldn't be found.
     virtual std::optional<bool> blockFilterMatchesAny(BlockFilterType filter_type, const uint256& block_hash, const GCSFilter::ElementSet& filter_set) = 0;
 
+    //! Returns, for the given block and up to count - 1 blocks following it in
+    //! the active chain, the block hash and whether any of the elements match
+    //! the block via a BIP 157 block filter. The filters are matched on several
+    //! threads. Returns no results if the block is not in the active chain or
+    //! any of the block filters couldn't be found.
+    virtual std::vector<std::pair<uint256, bool>> blockFiltersMatchAny(BlockFilterType filter_type, const uint256& start_block, int count, const GCSFilter::ElementSet& filter_set) = 0;
+
     //! Return whether node has the block and optionally return block metadata
     //! or contents.
     virtual bool findBlock(const uint256& hash, const FoundBlock& block={}) = 0;
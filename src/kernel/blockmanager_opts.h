@@ -9,6 +9,7 @@
 #include <kernel/notifications_interface.h>
 #include <util/fs.h>
 
+#include <cstddef>
 #include <cstdint>
 
 class CChainParams;
@@ -16,6 +17,12 @@ class CChainParams;
 namespace kernel {
 
 static constexpr bool DEFAULT_XOR_BLOCKSDIR{true};
+static constexpr bool DEFAULT_PERSIST_POW_VERDICTS{true};
+static constexpr bool DEFAULT_MMAP_BLOCKSDIR{true};
+static constexpr bool DEFAULT_ASYNC_BLOCK_WRITES{true};
+static constexpr bool DEFAULT_COMPRESS_BLOCKS{false};
+static constexpr size_t DEFAULT_BLOCK_CACHE_BYTES{32 << 20};
+static constexpr bool DEFAULT_BLOCK_INDEX_IMAGE{false};
 
 /**
  * An options struct for `BlockManager`, more ergonomically referred to as
@@ -29,6 +36,18 @@ struct BlockManagerOpts {
     const fs::path blocks_dir;
     Notifications& notifications;
     DBParams block_tree_db_params;
+    //! Keep a side table of RandomX PoW verdicts next to the block tree db
+    bool persist_pow_verdicts{DEFAULT_PERSIST_POW_VERDICTS};
+    //! Serve raw block reads from memory maps of the block files
+    bool use_mmap{DEFAULT_MMAP_BLOCKSDIR};
+    //! Write block and undo data on a background thread
+    bool async_writes{DEFAULT_ASYNC_BLOCK_WRITES};
+    //! Write new blocks with BlockCompression
+    bool compress_blocks{DEFAULT_COMPRESS_BLOCKS};
+    //! Memory limit of the cache of recently read or written blocks and undo data
+    size_t block_cache_bytes{DEFAULT_BLOCK_CACHE_BYTES};
+    //! Write an image of the block index on shutdown and load it on startup
+    bool block_index_image{DEFAULT_BLOCK_INDEX_IMAGE};
 };
 
 } // namespace kernel
@@ -8,6 +8,7 @@
 #include <util/byte_units.h>
 
 #include <algorithm>
+#include <cstdint>
 
 //! Suggested default amount of cache reserved for the kernel (bytes)
 static constexpr size_t DEFAULT_KERNEL_CACHE{450_MiB};
@@ -18,6 +19,8 @@ static constexpr size_t DEFAULT_DB_CACHE_BATCH{32_MiB};
 static constexpr size_t MAX_BLOCK_DB_CACHE{2_MiB};
 //! Max memory allocated to coin DB specific cache (bytes)
 static constexpr size_t MAX_COINS_DB_CACHE{8_MiB};
+//! Minimum number of coins cache lookups to base a change of the coins database cache size on
+static constexpr uint64_t MIN_COINS_CACHE_ADAPT_LOOKUPS{100'000};
 
 namespace kernel {
 struct CacheSizes {
@@ -34,6 +37,30 @@ struct CacheSizes {
         coins = total_cache; // the rest goes to the coins cache
     }
 };
+
+/**
+ * Choose the size of the coins database (LevelDB) cache out of the total
+ * coins cache budget, based on the coins cache lookups seen since the last
+ * choice. The coins cache gets the rest of the budget.
+ *
+ * The database cache is doubled, up to a quarter of the budget, while more
+ * than 2% of the lookups miss the coins cache even though the coins cache is
+ * at least half full, and halved back towards its initial size while fewer
+ * than 0.5% do. Misses while the coins cache still has room are coins that
+ * have not been looked up yet, which no cache would have held.
+ */
+constexpr size_t AdaptCoinsDBCache(size_t coins_db, size_t initial_coins_db, size_t total_cache,
+                                   uint64_t hits, uint64_t misses, bool coins_cache_warm)
+{
+    const uint64_t lookups{hits + misses};
+    if (lookups < MIN_COINS_CACHE_ADAPT_LOOKUPS) return coins_db;
+    if (misses * 50 > lookups) {
+        if (!coins_cache_warm) return coins_db;
+        return std::max(coins_db, std::min(coins_db * 2, total_cache / 4));
+    }
+    if (misses * 200 < lookups) return std::max(coins_db / 2, initial_coins_db);
+    return coins_db;
+}
 } // namespace kernel
 
 #endif // BITCOIN_KERNEL_CACHES_H
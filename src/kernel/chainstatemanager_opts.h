@@ -9,6 +9,7 @@
 
 #include <arith_uint256.h>
 #include <dbwrapper.h>
+#include <powcache.h>
 #include <script/sigcache.h>
 #include <txdb.h>
 #include <uint256.h>
@@ -48,6 +49,7 @@ struct ChainstateManagerOpts {
     int worker_threads_num{0};
     size_t script_execution_cache_bytes{DEFAULT_SCRIPT_EXECUTION_CACHE_BYTES};
     size_t signature_cache_bytes{DEFAULT_SIGNATURE_CACHE_BYTES};
+    size_t pow_cache_bytes{DEFAULT_POW_CACHE_BYTES};
 };
 
 } // namespace kernel
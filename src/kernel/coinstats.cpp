@@ -24,6 +24,7 @@
 #include <memory>
 #include <span>
 #include <utility>
+#include <vector>
 #include <version>
 
 namespace kernel {
@@ -70,6 +71,12 @@ void RemoveCoinHash(MuHash3072& muhash, const COutPoint& outpoint, const Coin& c
     muhash.Remove(MakeUCharSpan(ss));
 }
 
+void SerializeCoinForHash(std::vector<unsigned char>& out, const COutPoint& outpoint, const Coin& coin)
+{
+    VectorWriter writer{out, out.size()};
+    TxOutSer(writer, outpoint, coin);
+}
+
 static void ApplyCoinHash(std::nullptr_t, const COutPoint& outpoint, const Coin& coin) {}
 
 //! Warning: be very careful when changing this! assumeutxo and UTXO snapshot
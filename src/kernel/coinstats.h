@@ -12,6 +12,7 @@
 #include <cstdint>
 #include <functional>
 #include <optional>
+#include <vector>
 
 class CCoinsView;
 class Coin;
@@ -77,6 +78,10 @@ uint64_t GetBogoSize(const CScript& script_pub_key);
 void ApplyCoinHash(MuHash3072& muhash, const COutPoint& outpoint, const Coin& coin);
 void RemoveCoinHash(MuHash3072& muhash, const COutPoint& outpoint, const Coin& coin);
 
+//! Append the data that is hashed for a coin to out. Hashing this data of all
+//! coins, sorted by outpoint, gives the HASH_SERIALIZED hash of a coins view.
+void SerializeCoinForHash(std::vector<unsigned char>& out, const COutPoint& outpoint, const Coin& coin);
+
 std::optional<CCoinsStats> ComputeUTXOStats(CoinStatsHashType hash_type, CCoinsView* view, node::BlockManager& blockman, const std::function<void()>& interruption_point = {});
 } // namespace kernel
 
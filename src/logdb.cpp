@@ -0,0 +1,593 @@
+// Copyright (c) 2026-present The Botcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <logdb.h>
+
+#include <crypto/common.h>
+#include <logging.h>
+#include <memusage.h>
+#include <span.h>
+#include <tinyformat.h>
+#include <util/fs_helpers.h>
+#include <util/syserror.h>
+
+#include <crc32c/crc32c.h>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const fs::path MARKER_FILE{"LOGDB"};
+const fs::path LOCK_FILE{"LOCK"};
+constexpr std::string_view SEGMENT_SUFFIX{".seg"};
+
+//! A record is the payload length and its CRC32C, followed by the payload.
+constexpr size_t RECORD_HEADER_SIZE{8};
+
+constexpr std::byte OP_DELETE{0};
+constexpr std::byte OP_PUT{1};
+
+//! Bytes a live entry is accounted for, approximating its size in the log.
+uint64_t EntryBytes(size_t key_size, size_t value_size) { return key_size + value_size + 4; }
+
+std::string_view AsStringView(std::span<const std::byte> s) { return {reinterpret_cast<const char*>(s.data()), s.size()}; }
+
+void WriteVarInt(std::vector<std::byte>& out, uint64_t n)
+{
+    while (n >= 0x80) {
+        out.push_back(std::byte(n | 0x80));
+        n >>= 7;
+    }
+    out.push_back(std::byte(n));
+}
+
+bool ReadVarInt(std::span<const std::byte> in, size_t& pos, uint64_t& n)
+{
+    n = 0;
+    for (int shift{0}; shift < 64; shift += 7) {
+        if (pos >= in.size()) return false;
+        const uint8_t b{uint8_t(in[pos++])};
+        n |= uint64_t(b & 0x7f) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+uint32_t Checksum(std::span<const std::byte> payload)
+{
+    return crc32c::Crc32c(UCharCast(payload.data()), payload.size());
+}
+
+/**
+ * Call fn(op, key, value_pos, value_size) for every operation in a record
+ * payload, where value_pos is the offset of the value within the payload.
+ * Returns false, without calling fn, if the payload is malformed.
+ */
+template <typename Fn>
+bool ForEachOp(std::span<const std::byte> payload, Fn fn)
+{
+    for (bool apply : {false, true}) {
+        size_t pos{0};
+        while (pos < payload.size()) {
+            const std::byte op{payload[pos++]};
+            uint64_t key_size;
+            if (!ReadVarInt(payload, pos, key_size) || key_size > payload.size() - pos) return false;
+            const auto key{payload.subspan(pos, key_size)};
+            pos += key_size;
+            uint64_t value_size{0};
+            const size_t value_pos{pos};
+            if (op == OP_PUT) {
+                if (!ReadVarInt(payload, pos, value_size) || value_size > payload.size() - pos) return false;
+                if (apply) fn(op, key, pos, value_size);
+                pos += value_size;
+            } else if (op == OP_DELETE) {
+                if (apply) fn(op, key, value_pos, value_size);
+            } else {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+std::optional<uint32_t> ParseSegmentId(const fs::path& filename)
+{
+    const std::string name{fs::PathToString(filename)};
+    if (name.size() != 6 + SEGMENT_SUFFIX.size() || !name.ends_with(SEGMENT_SUFFIX)) return std::nullopt;
+    uint32_t id{0};
+    for (size_t i{0}; i < 6; ++i) {
+        if (name[i] < '0' || name[i] > '9') return std::nullopt;
+        id = id * 10 + (name[i] - '0');
+    }
+    return id;
+}
+
+fs::path SegmentFilename(uint32_t id) { return fs::PathFromString(strprintf("%06u%s", id, SEGMENT_SUFFIX)); }
+
+} // namespace
+
+struct LogDB::Segment {
+    const uint32_t id;
+    const fs::path path;
+    int fd{-1};
+    const std::byte* map{nullptr};
+    size_t map_size{0};
+    //! Bytes of complete records in the segment.
+    uint64_t size{0};
+    //! Bytes taken up by live entries.
+    uint64_t live{0};
+
+    Segment(uint32_t id_in, fs::path path_in) : id{id_in}, path{std::move(path_in)} {}
+    ~Segment()
+    {
+#ifndef WIN32
+        if (map) munmap(const_cast<std::byte*>(map), map_size);
+        if (fd >= 0) close(fd);
+#endif
+    }
+
+    //! Map the first length bytes of the file, which may extend past its end.
+    void Map(size_t length)
+    {
+#ifndef WIN32
+        if (map) munmap(const_cast<std::byte*>(map), map_size);
+        map = nullptr;
+        map_size = 0;
+        if (length == 0) return;
+        void* ptr{mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0)};
+        if (ptr == MAP_FAILED) {
+            throw std::runtime_error(strprintf("Failed to map %s: %s", fs::PathToString(path), SysErrorString(errno)));
+        }
+        map = static_cast<const std::byte*>(ptr);
+        map_size = length;
+#endif
+    }
+};
+
+void LogDB::Batch::Put(std::span<const std::byte> key, std::span<const std::byte> value)
+{
+    m_payload.push_back(OP_PUT);
+    WriteVarInt(m_payload, key.size());
+    m_payload.insert(m_payload.end(), key.begin(), key.end());
+    WriteVarInt(m_payload, value.size());
+    m_payload.insert(m_payload.end(), value.begin(), value.end());
+}
+
+void LogDB::Batch::Delete(std::span<const std::byte> key)
+{
+    m_payload.push_back(OP_DELETE);
+    WriteVarInt(m_payload, key.size());
+    m_payload.insert(m_payload.end(), key.begin(), key.end());
+}
+
+size_t LogDB::Batch::ApproximateSize() const
+{
+    return RECORD_HEADER_SIZE + m_payload.size();
+}
+
+LogDB::LogDB(fs::path path, size_t segment_size)
+    : m_path{std::move(path)}, m_segment_size{segment_size}
+{
+#ifdef WIN32
+    throw std::runtime_error("LogDB is not supported on Windows");
+#else
+    TryCreateDirectories(m_path);
+    if (util::LockDirectory(m_path, LOCK_FILE) != util::LockResult::Success) {
+        throw std::runtime_error(strprintf("Cannot obtain a lock on directory %s", fs::PathToString(m_path)));
+    }
+    try {
+        if (!fs::exists(m_path / MARKER_FILE)) {
+            FILE* file{fsbridge::fopen(m_path / MARKER_FILE, "wb")};
+            if (!file || fputs("LogDB 1\n", file) < 0 || !FileCommit(file)) {
+                if (file) fclose(file);
+                throw std::runtime_error(strprintf("Failed to create %s", fs::PathToString(m_path / MARKER_FILE)));
+            }
+            fclose(file);
+            DirectoryCommit(m_path);
+        }
+
+        std::vector<uint32_t> ids;
+        for (const auto& entry : fs::directory_iterator(m_path)) {
+            if (auto id{ParseSegmentId(entry.path().filename())}) ids.push_back(*id);
+        }
+        std::sort(ids.begin(), ids.end());
+        if (ids.empty()) {
+            FILE* file{fsbridge::fopen(m_path / SegmentFilename(1), "ab")};
+            if (!file) throw std::runtime_error(strprintf("Failed to create a segment in %s", fs::PathToString(m_path)));
+            fclose(file);
+            DirectoryCommit(m_path);
+            ids.push_back(1);
+        }
+        for (const uint32_t id : ids) {
+            Replay(OpenSegment(id), id == ids.back());
+        }
+        OpenHead();
+        LogDebug(BCLog::LEVELDB, "Opened LogDB in %s: %u segments, %u keys, %u of %u bytes live",
+                 fs::PathToString(m_path), m_segments.size(), m_index.size(), m_live_bytes, m_total_bytes);
+    } catch (...) {
+        if (m_head_file) fclose(m_head_file);
+        m_segments.clear();
+        UnlockDirectory(m_path, LOCK_FILE);
+        throw;
+    }
+#endif
+}
+
+LogDB::~LogDB()
+{
+    if (m_head_file) fclose(m_head_file);
+    m_retired.clear();
+    m_segments.clear();
+    UnlockDirectory(m_path, LOCK_FILE);
+}
+
+LogDB::Segment& LogDB::OpenSegment(uint32_t id)
+{
+    auto segment{std::make_unique<Segment>(id, m_path / SegmentFilename(id))};
+#ifndef WIN32
+    segment->fd = open(fs::PathToString(segment->path).c_str(), O_RDONLY);
+    if (segment->fd < 0) {
+        throw std::runtime_error(strprintf("Failed to open %s: %s", fs::PathToString(segment->path), SysErrorString(errno)));
+    }
+#endif
+    return *m_segments.emplace(id, std::move(segment)).first->second;
+}
+
+void LogDB::Replay(Segment& segment, bool newest)
+{
+    const uint64_t file_size{fs::file_size(segment.path)};
+    segment.Map(file_size);
+    uint64_t offset{0};
+    while (file_size - offset >= RECORD_HEADER_SIZE) {
+        const uint32_t length{ReadLE32(segment.map + offset)};
+        if (length > file_size - offset - RECORD_HEADER_SIZE) break;
+        const std::span<const std::byte> payload{segment.map + offset + RECORD_HEADER_SIZE, length};
+        if (Checksum(payload) != ReadLE32(segment.map + offset + 4)) break;
+        if (!ForEachOp(payload, [](auto&&...) {})) break;
+        Apply(segment.id, offset, payload);
+        offset += RECORD_HEADER_SIZE + length;
+    }
+    if (offset != file_size) {
+        if (!newest) {
+            throw std::runtime_error(strprintf("Corrupted LogDB segment %s at offset %u", fs::PathToString(segment.path), offset));
+        }
+        LogWarning("Dropping %u bytes of incomplete data at the end of %s", file_size - offset, fs::PathToString(segment.path));
+        fs::resize_file(segment.path, offset);
+        segment.Map(offset);
+    }
+    segment.size = offset;
+    m_total_bytes += offset;
+}
+
+void LogDB::OpenHead()
+{
+    Segment& head{*m_segments.rbegin()->second};
+    m_head_file = fsbridge::fopen(head.path, "ab");
+    if (!m_head_file) {
+        throw std::runtime_error(strprintf("Failed to open %s for writing", fs::PathToString(head.path)));
+    }
+    // Map more than has been written, so appends do not need a new mapping.
+    head.Map(std::max<size_t>(head.size, m_segment_size));
+}
+
+void LogDB::KeepVersion(std::string_view key, std::optional<Location> loc)
+{
+    auto it{m_versions.find(key)};
+    if (it == m_versions.end()) {
+        it = m_versions.emplace(std::string{key}, std::vector<Version>{}).first;
+        m_versions_key_usage += memusage::DynamicUsage(it->first);
+    } else if (it->second.back().replaced > *m_snapshots.rbegin()) {
+        // Every open iterator sees this version or an older one.
+        return;
+    }
+    it->second.push_back({m_seq, loc});
+    m_version_order.push_back(it);
+}
+
+void LogDB::PruneVersions()
+{
+    if (m_snapshots.empty()) {
+        // Entries can be marked deleted more than once.
+        std::sort(m_deleted.begin(), m_deleted.end(), [](auto a, auto b) { return std::less<const Index::value_type*>{}(&*a, &*b); });
+        m_deleted.erase(std::unique(m_deleted.begin(), m_deleted.end()), m_deleted.end());
+        for (const auto it : m_deleted) {
+            if (!it->second.Deleted()) continue;
+            m_index_key_usage -= memusage::DynamicUsage(it->first);
+            m_index.erase(it);
+        }
+        m_deleted.clear();
+        m_deleted.shrink_to_fit();
+        m_versions.clear();
+        m_versions_key_usage = 0;
+        m_version_order.clear();
+        return;
+    }
+    // Drop versions replaced before the oldest iterator was created. Versions
+    // are added in sequence order, so the oldest one of each key comes first.
+    const uint64_t oldest{*m_snapshots.begin()};
+    while (!m_version_order.empty() && m_version_order.front()->second.front().replaced <= oldest) {
+        const auto it{m_version_order.front()};
+        m_version_order.pop_front();
+        it->second.erase(it->second.begin());
+        if (it->second.empty()) {
+            m_versions_key_usage -= memusage::DynamicUsage(it->first);
+            m_versions.erase(it);
+        }
+    }
+}
+
+void LogDB::Apply(uint32_t segment_id, uint64_t record_offset, std::span<const std::byte> payload)
+{
+    Segment& segment{*m_segments.at(segment_id)};
+    ++m_seq;
+    ForEachOp(payload, [&](std::byte op, std::span<const std::byte> key, size_t value_pos, uint64_t value_size) {
+        auto it{m_index.find(AsStringView(key))};
+        const bool exists{it != m_index.end() && !it->second.Deleted()};
+        if (op == OP_DELETE && !exists) return;
+        if (!m_snapshots.empty()) KeepVersion(AsStringView(key), exists ? std::optional{it->second} : std::nullopt);
+        if (exists) {
+            const uint64_t bytes{EntryBytes(it->first.size(), it->second.size)};
+            m_segments.at(it->second.segment)->live -= bytes;
+            m_live_bytes -= bytes;
+        }
+        if (op == OP_DELETE) {
+            if (m_snapshots.empty()) {
+                m_index_key_usage -= memusage::DynamicUsage(it->first);
+                m_index.erase(it);
+            } else {
+                it->second = {Location::DELETED, 0, 0};
+                m_deleted.push_back(it);
+            }
+            return;
+        }
+        const Location loc{segment_id, uint32_t(record_offset + RECORD_HEADER_SIZE + value_pos), uint32_t(value_size)};
+        if (it == m_index.end()) {
+            it = m_index.emplace(std::string{AsStringView(key)}, loc).first;
+            m_index_key_usage += memusage::DynamicUsage(it->first);
+        } else {
+            it->second = loc;
+        }
+        const uint64_t bytes{EntryBytes(key.size(), value_size)};
+        segment.live += bytes;
+        m_live_bytes += bytes;
+    });
+}
+
+void LogDB::Append(std::span<const std::byte> payload, bool sync)
+{
+    Segment& head{*m_segments.rbegin()->second};
+    const uint64_t offset{head.size};
+    if (payload.size() > std::numeric_limits<uint32_t>::max() - RECORD_HEADER_SIZE - offset) {
+        throw std::runtime_error(strprintf("Write batch of %u bytes too large for %s", payload.size(), fs::PathToString(head.path)));
+    }
+    std::array<std::byte, RECORD_HEADER_SIZE> header;
+    WriteLE32(header.data(), payload.size());
+    WriteLE32(header.data() + 4, Checksum(payload));
+    if (fwrite(header.data(), 1, header.size(), m_head_file) != header.size() ||
+        fwrite(payload.data(), 1, payload.size(), m_head_file) != payload.size() ||
+        fflush(m_head_file) != 0 ||
+        (sync && !FileCommit(m_head_file))) {
+        const std::string error{SysErrorString(errno)};
+        // Do not leave a partial record behind that later records would be appended to.
+        clearerr(m_head_file);
+        TruncateFile(m_head_file, offset);
+        throw std::runtime_error(strprintf("Failed to write to %s: %s", fs::PathToString(head.path), error));
+    }
+    head.size += RECORD_HEADER_SIZE + payload.size();
+    m_total_bytes += RECORD_HEADER_SIZE + payload.size();
+    if (head.size > head.map_size) head.Map(std::max<size_t>(head.size, 2 * head.map_size));
+    Apply(head.id, offset, payload);
+
+    if (head.size >= m_segment_size) {
+        // Start a new segment. The old head keeps a mapping of its exact size.
+        fclose(m_head_file);
+        m_head_file = nullptr;
+        head.Map(head.size);
+        const uint32_t id{head.id + 1};
+        FILE* file{fsbridge::fopen(m_path / SegmentFilename(id), "ab")};
+        if (!file) throw std::runtime_error(strprintf("Failed to create a segment in %s", fs::PathToString(m_path)));
+        fclose(file);
+        DirectoryCommit(m_path);
+        OpenSegment(id);
+        OpenHead();
+    }
+}
+
+void LogDB::CompactOldest()
+{
+    assert(m_segments.size() > 1);
+    const Segment& oldest{*m_segments.begin()->second};
+
+    Batch live;
+    for (uint64_t offset{0}; offset < oldest.size;) {
+        const uint32_t length{ReadLE32(oldest.map + offset)};
+        const uint64_t payload_offset{offset + RECORD_HEADER_SIZE};
+        const std::span<const std::byte> payload{oldest.map + payload_offset, length};
+        ForEachOp(payload, [&](std::byte op, std::span<const std::byte> key, size_t value_pos, uint64_t value_size) {
+            if (op != OP_PUT) return;
+            auto it{m_index.find(AsStringView(key))};
+            if (it == m_index.end() || it->second.segment != oldest.id || it->second.offset != payload_offset + value_pos) return;
+            live.Put(key, payload.subspan(value_pos, value_size));
+        });
+        offset = payload_offset + length;
+    }
+    const uint32_t id{oldest.id};
+    const uint64_t size{oldest.size};
+    // The moved entries must be on disk before the segment holding them goes away.
+    if (!live.Empty()) Append(live.m_payload, /*sync=*/true);
+
+    auto node{m_segments.extract(id)};
+    assert(node.mapped()->live == 0);
+    m_total_bytes -= size;
+    fs::remove(node.mapped()->path);
+    // Segments must disappear in order, or deletions in a later segment
+    // could be lost while the values they deleted come back.
+    DirectoryCommit(m_path);
+    if (!m_snapshots.empty()) m_retired.insert(std::move(node));
+    LogDebug(BCLog::LEVELDB, "Compacted LogDB segment %u in %s, moved %u bytes", id, fs::PathToString(m_path), live.m_payload.size());
+}
+
+void LogDB::MaybeCompact()
+{
+    if (m_segments.size() > 1 && (m_total_bytes - m_live_bytes) * 2 > m_total_bytes) CompactOldest();
+}
+
+std::span<const std::byte> LogDB::ValueAt(const Location& loc) const
+{
+    auto it{m_segments.find(loc.segment)};
+    const Segment& segment{it != m_segments.end() ? *it->second : *m_retired.at(loc.segment)};
+    return {segment.map + loc.offset, loc.size};
+}
+
+std::optional<std::string> LogDB::Read(std::span<const std::byte> key) const
+{
+    std::shared_lock lock{m_mutex};
+    auto it{m_index.find(AsStringView(key))};
+    if (it == m_index.end() || it->second.Deleted()) return std::nullopt;
+    return std::string{AsStringView(ValueAt(it->second))};
+}
+
+bool LogDB::Exists(std::span<const std::byte> key) const
+{
+    std::shared_lock lock{m_mutex};
+    auto it{m_index.find(AsStringView(key))};
+    return it != m_index.end() && !it->second.Deleted();
+}
+
+void LogDB::Write(const Batch& batch, bool sync)
+{
+    std::unique_lock lock{m_mutex};
+    PruneVersions();
+    if (!batch.Empty()) {
+        Append(batch.m_payload, sync);
+    } else if (sync && !FileCommit(m_head_file)) {
+        throw std::runtime_error(strprintf("Failed to sync %s", fs::PathToString(m_path)));
+    }
+    MaybeCompact();
+}
+
+std::unique_ptr<LogDB::Iterator> LogDB::NewIterator() const
+{
+    return std::unique_ptr<Iterator>{new Iterator{*this}};
+}
+
+size_t LogDB::EstimateSize(std::span<const std::byte> begin, std::span<const std::byte> end) const
+{
+    std::shared_lock lock{m_mutex};
+    size_t size{0};
+    const auto last{m_index.lower_bound(AsStringView(end))};
+    for (auto it{m_index.lower_bound(AsStringView(begin))}; it != m_index.end() && it != last; ++it) {
+        if (!it->second.Deleted()) size += EntryBytes(it->first.size(), it->second.size);
+    }
+    return size;
+}
+
+size_t LogDB::DynamicMemoryUsage() const
+{
+    std::shared_lock lock{m_mutex};
+    return memusage::DynamicUsage(m_index) + m_index_key_usage + memusage::DynamicUsage(m_deleted) +
+           memusage::DynamicUsage(m_versions) + m_versions_key_usage +
+           m_version_order.size() * (sizeof(Version) + sizeof(Versions::iterator));
+}
+
+void LogDB::Compact()
+{
+    std::unique_lock lock{m_mutex};
+    PruneVersions();
+    for (size_t n{m_segments.size() - 1}; n > 0; --n) CompactOldest();
+}
+
+bool LogDB::IsLogDB(const fs::path& path)
+{
+    return fs::exists(path / MARKER_FILE);
+}
+
+void LogDB::Destroy(const fs::path& path)
+{
+    if (!fs::exists(path)) return;
+    for (const auto& entry : fs::directory_iterator(path)) {
+        if (ParseSegmentId(entry.path().filename())) fs::remove(entry.path());
+    }
+    fs::remove(path / MARKER_FILE);
+    fs::remove(path / LOCK_FILE);
+    if (fs::is_empty(path)) fs::remove(path);
+}
+
+LogDB::Iterator::Iterator(const LogDB& db) : m_db{db}
+{
+    std::unique_lock lock{m_db.m_mutex};
+    m_seq = m_db.m_seq;
+    m_it = m_db.m_index.end();
+    m_db.m_snapshots.insert(m_seq);
+}
+
+LogDB::Iterator::~Iterator()
+{
+    std::unique_lock lock{m_db.m_mutex};
+    m_db.m_snapshots.erase(m_db.m_snapshots.find(m_seq));
+    if (m_db.m_snapshots.empty()) m_db.m_retired.clear();
+}
+
+void LogDB::Iterator::Seek(std::span<const std::byte> key)
+{
+    std::shared_lock lock{m_db.m_mutex};
+    m_it = m_db.m_index.lower_bound(AsStringView(key));
+    Settle();
+}
+
+void LogDB::Iterator::Next()
+{
+    assert(m_valid);
+    std::shared_lock lock{m_db.m_mutex};
+    ++m_it;
+    Settle();
+}
+
+void LogDB::Iterator::Settle()
+{
+    for (; m_it != m_db.m_index.end(); ++m_it) {
+        std::optional<Location> loc;
+        if (!m_it->second.Deleted()) loc = m_it->second;
+        // Keys written since the iterator was created have their value as of
+        // then in the first version replaced after it.
+        if (!m_db.m_versions.empty()) {
+            if (auto versions{m_db.m_versions.find(m_it->first)}; versions != m_db.m_versions.end()) {
+                auto version{std::find_if(versions->second.begin(), versions->second.end(), [&](const Version& v) { return v.replaced > m_seq; })};
+                if (version != versions->second.end()) loc = version->loc;
+            }
+        }
+        if (loc) {
+            m_value.assign(AsStringView(m_db.ValueAt(*loc)));
+            m_valid = true;
+            return;
+        }
+    }
+    m_valid = false;
+    m_value.clear();
+}
+
+std::span<const std::byte> LogDB::Iterator::Key() const
+{
+    return MakeByteSpan(m_it->first);
+}
+
+std::span<const std::byte> LogDB::Iterator::Value() const
+{
+    return MakeByteSpan(m_value);
+}
@@ -0,0 +1,210 @@
+// Copyright (c) 2026-present The Botcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BOTCOIN_LOGDB_H
+#define BOTCOIN_LOGDB_H
+
+#include <util/byte_units.h>
+#include <util/fs.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
+#include <shared_mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+//! Default size after which LogDB starts a new log segment
+static constexpr size_t DEFAULT_LOGDB_SEGMENT_SIZE{64_MiB};
+
+/**
+ * Key-value store made of an append-only log and an in-memory sorted index.
+ *
+ * Every write batch is appended to the newest log segment as a single
+ * checksummed record, so after a crash it is either replayed completely or
+ * not at all. The index maps each key to the location of its latest value,
+ * and values are read straight from the memory-mapped segments, so reads and
+ * iteration never wait for each other and never trigger compaction.
+ *
+ * Overwritten and deleted values are left in place until their segment is the
+ * oldest one. A write that leaves more than half of the log unused then copies
+ * the live values of the oldest segment to the head of the log and deletes the
+ * segment. As segments are only ever deleted oldest first, an old value can
+ * never reappear over a later deletion when the log is replayed. This keeps
+ * write amplification near two and bounds the work a single write can incur
+ * to one segment.
+ *
+ * Iterators see the database as of their creation. Writes made while
+ * iterators are open record the version of each key they replace once, shared
+ * by all iterators, and versions no open iterator can see are dropped on the
+ * next write. Deleted keys stay in the index as tombstones until the last
+ * iterator is closed, so iterators can hold on to their position in it.
+ *
+ * The index holds every key in memory, which is what limits the size of the
+ * data sets this engine is suited for.
+ *
+ * Not available on Windows.
+ */
+class LogDB
+{
+    struct Location {
+        uint32_t segment;
+        uint32_t offset;
+        uint32_t size;
+
+        //! Placeholder for a key deleted while iterators were open.
+        static constexpr uint32_t DELETED{std::numeric_limits<uint32_t>::max()};
+        bool Deleted() const { return segment == DELETED; }
+    };
+
+    using Index = std::map<std::string, Location, std::less<>>;
+
+public:
+    //! Changes to be applied to the database atomically.
+    class Batch
+    {
+    public:
+        void Put(std::span<const std::byte> key, std::span<const std::byte> value);
+        void Delete(std::span<const std::byte> key);
+        void Clear() { m_payload.clear(); }
+        bool Empty() const { return m_payload.empty(); }
+        //! Size of the batch in the log.
+        size_t ApproximateSize() const;
+
+    private:
+        friend class LogDB;
+        std::vector<std::byte> m_payload;
+    };
+
+    //! Iterator over the keys in the database at the time of its creation,
+    //! in lexicographic order.
+    class Iterator
+    {
+    public:
+        ~Iterator();
+
+        bool Valid() const { return m_valid; }
+        void SeekToFirst() { Seek({}); }
+        void Seek(std::span<const std::byte> key);
+        void Next();
+        std::span<const std::byte> Key() const;
+        std::span<const std::byte> Value() const;
+
+    private:
+        friend class LogDB;
+        Iterator(const LogDB& db);
+        //! Move to the first key at or after m_it that existed at m_seq.
+        void Settle();
+
+        const LogDB& m_db;
+        //! Sequence number of the last write the iterator sees.
+        uint64_t m_seq;
+        //! Current position. Index entries are not erased while iterators are open.
+        Index::const_iterator m_it;
+        bool m_valid{false};
+        std::string m_value;
+    };
+
+    /**
+     * Open the database in directory path, creating it if needed. Throws
+     * std::runtime_error if the directory cannot be locked or a segment
+     * other than the newest one is corrupt. An incomplete record at the end
+     * of the newest segment is dropped.
+     */
+    LogDB(fs::path path, size_t segment_size = DEFAULT_LOGDB_SEGMENT_SIZE);
+    ~LogDB();
+
+    LogDB(const LogDB&) = delete;
+    LogDB& operator=(const LogDB&) = delete;
+
+    std::optional<std::string> Read(std::span<const std::byte> key) const;
+    bool Exists(std::span<const std::byte> key) const;
+
+    //! Append batch to the log. If sync is set, return once it is on disk.
+    void Write(const Batch& batch, bool sync);
+
+    std::unique_ptr<Iterator> NewIterator() const;
+
+    //! Total size of the keys and values in [begin, end).
+    size_t EstimateSize(std::span<const std::byte> begin, std::span<const std::byte> end) const;
+
+    //! Approximate memory held by the index and the versions kept for iterators.
+    size_t DynamicMemoryUsage() const;
+
+    //! Rewrite all segments but the newest one, dropping every unused value.
+    void Compact();
+
+    //! Whether path holds a LogDB database.
+    static bool IsLogDB(const fs::path& path);
+
+    //! Remove the LogDB database in path.
+    static void Destroy(const fs::path& path);
+
+private:
+    struct Segment;
+
+    //! A value of a key replaced while iterators were open.
+    struct Version {
+        //! Sequence number of the write that replaced it.
+        uint64_t replaced;
+        //! Location of the value, or nullopt if the key did not exist.
+        std::optional<Location> loc;
+    };
+
+    using Versions = std::map<std::string, std::vector<Version>, std::less<>>;
+
+    const fs::path m_path;
+    const size_t m_segment_size;
+
+    mutable std::shared_mutex m_mutex;
+
+    //! Latest location of every key.
+    Index m_index;
+    size_t m_index_key_usage{0};
+    //! Keys marked deleted in the index, to erase once no iterator is open.
+    std::vector<Index::iterator> m_deleted;
+
+    //! Sequence number of the last write.
+    uint64_t m_seq{0};
+    //! Replaced values that open iterators may still see, oldest first.
+    Versions m_versions;
+    size_t m_versions_key_usage{0};
+    //! Entries of m_versions in the order versions were added to them.
+    std::deque<Versions::iterator> m_version_order;
+
+    //! Segments by id, oldest first. The last one is appended to.
+    std::map<uint32_t, std::unique_ptr<Segment>> m_segments;
+    //! Deleted segments that open iterators may still read from.
+    mutable std::map<uint32_t, std::unique_ptr<Segment>> m_retired;
+    //! Total bytes in all segments, and bytes taken up by live keys and values.
+    uint64_t m_total_bytes{0};
+    uint64_t m_live_bytes{0};
+
+    //! Sequence numbers of open iterators.
+    mutable std::multiset<uint64_t> m_snapshots;
+
+    FILE* m_head_file{nullptr};
+
+    std::span<const std::byte> ValueAt(const Location& loc) const;
+    Segment& OpenSegment(uint32_t id);
+    void OpenHead();
+    void Replay(Segment& segment, bool newest);
+    void Apply(uint32_t segment, uint64_t record_offset, std::span<const std::byte> payload);
+    void KeepVersion(std::string_view key, std::optional<Location> loc);
+    void PruneVersions();
+    void Append(std::span<const std::byte> payload, bool sync);
+    void CompactOldest();
+    void MaybeCompact();
+};
+
+#endif // BOTCOIN_LOGDB_H
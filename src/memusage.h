@@ -8,6 +8,7 @@
 #include <indirectmap.h>
 #include <prevector.h>
 #include <support/allocators/pool.h>
+#include <util/node_hash_map.h>
 
 #include <cassert>
 #include <cstdlib>
@@ -215,6 +216,29 @@ static inline size_t DynamicUsage(const std::unordered_map<Key,
     return usage_resource + usage_chunks + MallocUsage(sizeof(void*) * m.bucket_count());
 }
 
+template <class Key, class T, class Hash, class Pred, std::size_t MAX_BLOCK_SIZE_BYTES, std::size_t ALIGN_BYTES>
+static inline size_t DynamicUsage(const NodeHashMap<Key,
+                                                    T,
+                                                    Hash,
+                                                    Pred,
+                                                    PoolAllocator<std::pair<const Key, T>,
+                                                                  MAX_BLOCK_SIZE_BYTES,
+                                                                  ALIGN_BYTES>>& m)
+{
+    auto* pool_resource = m.get_allocator().resource();
+
+    // Nodes are allocated from the pool, see the std::unordered_map overload above.
+    size_t estimated_list_node_size = MallocUsage(sizeof(void*) * 3);
+    size_t usage_resource = estimated_list_node_size * pool_resource->NumAllocatedChunks();
+    size_t usage_chunks = MallocUsage(pool_resource->ChunkSizeBytes()) * pool_resource->NumAllocatedChunks();
+    // The index is a control byte per slot (plus one group's worth of copies) and a node pointer per slot.
+    size_t usage_index = 0;
+    if (m.bucket_count() > 0) {
+        usage_index = MallocUsage(m.bucket_count() + m.GROUP_WIDTH) + MallocUsage(sizeof(void*) * m.bucket_count());
+    }
+    return usage_resource + usage_chunks + usage_index;
+}
+
 } // namespace memusage
 
 #endif // BITCOIN_MEMUSAGE_H
@@ -2392,8 +2392,8 @@ void PeerManagerImpl::ProcessGetBlockData(CNode& pfrom, Peer& peer, const CInv&
         // Don't set pblock as we've sent the block
     } else {
         // Send block from disk
-        std::shared_ptr<CBlock> pblockRead = std::make_shared<CBlock>();
-        if (!m_chainman.m_blockman.ReadBlock(*pblockRead, block_pos, inv.hash)) {
+        std::shared_ptr<const CBlock> pblockRead{m_chainman.m_blockman.ReadBlock(block_pos, inv.hash)};
+        if (!pblockRead) {
             if (WITH_LOCK(m_chainman.GetMutex(), return m_chainman.m_blockman.IsBlockPruned(*pindex))) {
                 LogDebug(BCLog::NET, "Block was pruned before it could be read, %s\n", pfrom.DisconnectMsg(fLogIPs));
             } else {
@@ -2591,7 +2591,15 @@ void PeerManagerImpl::SendBlockTransactions(CNode& pfrom, Peer& peer, const CBlo
 bool PeerManagerImpl::CheckHeadersPoW(const std::vector<CBlockHeader>& headers, Peer& peer)
 {
     // Do these headers have proof-of-work matching what's claimed?
-    if (!HasValidProofOfWork(headers, m_chainparams.GetConsensus())) {
+    // Verdicts are cached, so headers already checked during the PRESYNC
+    // phase of a headers sync are not hashed again during REDOWNLOAD. The
+    // remaining headers are spread over as many RandomX lanes as we have
+    // script verification threads (-par).
+    const unsigned int pow_lanes = std::clamp(m_chainman.m_options.worker_threads_num, 0, MAX_SCRIPTCHECK_THREADS) + 1;
+    const auto time_start{SteadyClock::now()};
+    const bool valid_pow{HasValidProofOfWork(headers, m_chainparams.GetConsensus(), &m_chainman.m_pow_cache, pow_lanes)};
+    WITH_LOCK(::cs_main, m_chainman.time_pow += SteadyClock::now() - time_start);
+    if (!valid_pow) {
         Misbehaving(peer, "header with invalid proof of work");
         return false;
     }
@@ -4341,13 +4349,12 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
         }
 
         if (!block_pos.IsNull()) {
-            CBlock block;
-            const bool ret{m_chainman.m_blockman.ReadBlock(block, block_pos, req.blockhash)};
+            const auto block{m_chainman.m_blockman.ReadBlock(block_pos, req.blockhash)};
             // If height is above MAX_BLOCKTXN_DEPTH then this block cannot get
             // pruned after we release cs_main above, so this read should never fail.
-            assert(ret);
+            assert(block);
 
-            SendBlockTransactions(pfrom, *peer, block, req);
+            SendBlockTransactions(pfrom, *peer, *block, req);
             return;
         }
 
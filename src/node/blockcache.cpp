@@ -0,0 +1,116 @@
+// Copyright (c) 2026-present The Botcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <node/blockcache.h>
+
+#include <coins.h>
+#include <core_memusage.h>
+#include <memusage.h>
+#include <primitives/block.h>
+#include <undo.h>
+
+#include <iterator>
+
+namespace node {
+
+static size_t UndoUsage(const CBlockUndo& undo)
+{
+    size_t usage{memusage::DynamicUsage(undo.vtxundo)};
+    for (const CTxUndo& txundo : undo.vtxundo) {
+        usage += memusage::DynamicUsage(txundo.vprevout);
+        for (const Coin& coin : txundo.vprevout) {
+            usage += coin.DynamicMemoryUsage();
+        }
+    }
+    return usage;
+}
+
+std::shared_ptr<const CBlock> BlockCache::GetBlock(const uint256& hash)
+{
+    LOCK(m_mutex);
+    const Entry* entry{Get({hash, false})};
+    return entry ? entry->block : nullptr;
+}
+
+void BlockCache::AddBlock(const uint256& hash, std::shared_ptr<const CBlock> block)
+{
+    const size_t usage{RecursiveDynamicUsage(block)};
+    LOCK(m_mutex);
+    Add({.key = {hash, false}, .block = std::move(block), .undo = nullptr, .usage = usage});
+}
+
+std::shared_ptr<const CBlockUndo> BlockCache::GetUndo(const uint256& hash)
+{
+    LOCK(m_mutex);
+    const Entry* entry{Get({hash, true})};
+    return entry ? entry->undo : nullptr;
+}
+
+void BlockCache::AddUndo(const uint256& hash, std::shared_ptr<const CBlockUndo> undo)
+{
+    const size_t usage{memusage::DynamicUsage(undo) + UndoUsage(*undo)};
+    LOCK(m_mutex);
+    Add({.key = {hash, true}, .block = nullptr, .undo = std::move(undo), .usage = usage});
+}
+
+void BlockCache::Clear()
+{
+    LOCK(m_mutex);
+    m_entries.clear();
+    m_lru.clear();
+    m_usage = 0;
+    m_num_undos = 0;
+}
+
+BlockCache::Stats BlockCache::GetStats() const
+{
+    LOCK(m_mutex);
+    return {
+        .usage = m_usage,
+        .limit = m_max_bytes,
+        .blocks = m_entries.size() - m_num_undos,
+        .undos = m_num_undos,
+        .hits = m_hits,
+        .misses = m_misses,
+    };
+}
+
+const BlockCache::Entry* BlockCache::Get(const Key& key)
+{
+    if (!IsEnabled()) return nullptr;
+    const auto it{m_entries.find(key)};
+    if (it == m_entries.end()) {
+        ++m_misses;
+        return nullptr;
+    }
+    ++m_hits;
+    m_lru.splice(m_lru.begin(), m_lru, it->second);
+    return &*it->second;
+}
+
+void BlockCache::Add(Entry&& entry)
+{
+    // Entries that do not fit at all would only evict everything else.
+    if (entry.usage > m_max_bytes) return;
+    if (const auto it{m_entries.find(entry.key)}; it != m_entries.end()) {
+        Erase(it->second);
+    }
+    m_usage += entry.usage;
+    if (entry.key.second) ++m_num_undos;
+    m_lru.push_front(std::move(entry));
+    m_entries.emplace(m_lru.front().key, m_lru.begin());
+    while (m_usage > m_max_bytes) {
+        Erase(std::prev(m_lru.end()));
+    }
+}
+
+void BlockCache::Erase(std::list<Entry>::iterator it)
+{
+    m_usage -= it->usage;
+    if (it->key.second) --m_num_undos;
+    m_entries.erase(it->key);
+    m_lru.erase(it);
+}
+
+} // namespace node
@@ -0,0 +1,89 @@
+// Copyright (c) 2026-present The Botcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_NODE_BLOCKCACHE_H
+#define BITCOIN_NODE_BLOCKCACHE_H
+
+#include <sync.h>
+#include <uint256.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <utility>
+
+class CBlock;
+class CBlockUndo;
+
+namespace node {
+
+/**
+ * Cache of recently read or written blocks and undo data, keyed by block
+ * hash. Entries are shared with the callers, so a hit is a pointer copy. Once
+ * the memory used by the entries exceeds the limit, the least recently used
+ * ones are evicted.
+ *
+ * Thread-safe.
+ */
+class BlockCache
+{
+public:
+    struct Stats {
+        size_t usage;
+        size_t limit;
+        size_t blocks;
+        size_t undos;
+        uint64_t hits;
+        uint64_t misses;
+    };
+
+    explicit BlockCache(size_t max_bytes) : m_max_bytes{max_bytes} {}
+
+    /** Return the cached block with this hash, or nullptr. Counts as a hit or miss. */
+    std::shared_ptr<const CBlock> GetBlock(const uint256& hash) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    void AddBlock(const uint256& hash, std::shared_ptr<const CBlock> block) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /** Return the cached undo data of the block with this hash, or nullptr. Counts as a hit or miss. */
+    std::shared_ptr<const CBlockUndo> GetUndo(const uint256& hash) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    void AddUndo(const uint256& hash, std::shared_ptr<const CBlockUndo> undo) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /** Evict all entries, e.g. after the files they were read from were pruned */
+    void Clear() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    Stats GetStats() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    bool IsEnabled() const { return m_max_bytes > 0; }
+
+private:
+    //! Block hash, and whether the entry is undo data
+    using Key = std::pair<uint256, bool>;
+
+    struct Entry {
+        Key key;
+        std::shared_ptr<const CBlock> block;
+        std::shared_ptr<const CBlockUndo> undo;
+        size_t usage;
+    };
+
+    const size_t m_max_bytes;
+
+    mutable Mutex m_mutex;
+    //! Entries from most to least recently used
+    std::list<Entry> m_lru GUARDED_BY(m_mutex);
+    std::map<Key, std::list<Entry>::iterator> m_entries GUARDED_BY(m_mutex);
+    size_t m_usage GUARDED_BY(m_mutex){0};
+    size_t m_num_undos GUARDED_BY(m_mutex){0};
+    uint64_t m_hits GUARDED_BY(m_mutex){0};
+    uint64_t m_misses GUARDED_BY(m_mutex){0};
+
+    const Entry* Get(const Key& key) EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+    void Add(Entry&& entry) EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+    void Erase(std::list<Entry>::iterator it) EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+};
+
+} // namespace node
+
+#endif // BITCOIN_NODE_BLOCKCACHE_H
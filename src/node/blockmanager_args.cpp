@@ -8,10 +8,12 @@
 #include <node/blockstorage.h>
 #include <node/database_args.h>
 #include <tinyformat.h>
+#include <util/overflow.h>
 #include <util/result.h>
 #include <util/translation.h>
 #include <validation.h>
 
+#include <cstddef>
 #include <cstdint>
 
 namespace node {
@@ -35,6 +37,21 @@ util::Result<void> ApplyArgsManOptions(const ArgsManager& args, BlockManager::Op
 
     if (auto value{args.GetBoolArg("-fastprune")}) opts.fast_prune = *value;
 
+    if (auto value{args.GetBoolArg("-persistpowverdicts")}) opts.persist_pow_verdicts = *value;
+
+    if (auto value{args.GetBoolArg("-blocksmmap")}) opts.use_mmap = *value;
+
+    if (auto value{args.GetBoolArg("-asyncblockwrites")}) opts.async_writes = *value;
+
+    if (auto value{args.GetBoolArg("-compressblocks")}) opts.compress_blocks = *value;
+
+    if (auto value{args.GetIntArg("-blockcachesize")}) {
+        if (*value < 0) return util::Error{_("-blockcachesize must not be negative.")};
+        opts.block_cache_bytes = SaturatingLeftShift(static_cast<size_t>(*value), 20);
+    }
+
+    if (auto value{args.GetBoolArg("-blockindeximage")}) opts.block_index_image = *value;
+
     ReadDatabaseArgs(args, opts.block_tree_db_params.options);
 
     return {};
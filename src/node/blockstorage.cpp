@@ -6,8 +6,12 @@
 
 #include <arith_uint256.h>
 #include <chain.h>
+#include <compressor.h>
+#include <consensus/consensus.h>
 #include <consensus/params.h>
+#include <crypto/common.h>
 #include <crypto/hex_base.h>
+#include <crypto/randomx_hash.h>
 #include <dbwrapper.h>
 #include <flatfile.h>
 #include <hash.h>
@@ -17,6 +21,7 @@
 #include <kernel/notifications_interface.h>
 #include <kernel/types.h>
 #include <logging.h>
+#include <logging/timer.h>
 #include <pow.h>
 #include <primitives/block.h>
 #include <primitives/transaction.h>
@@ -31,35 +36,58 @@
 #include <util/check.h>
 #include <util/expected.h>
 #include <util/fs.h>
+#include <util/fs_helpers.h>
 #include <util/obfuscation.h>
 #include <util/overflow.h>
 #include <util/result.h>
 #include <util/signalinterrupt.h>
 #include <util/strencodings.h>
 #include <util/syserror.h>
+#include <util/threadnames.h>
 #include <util/time.h>
 #include <util/translation.h>
 #include <validation.h>
 
+#include <crc32c/crc32c.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cerrno>
 #include <compare>
 #include <cstddef>
 #include <cstdio>
+#include <cstring>
 #include <exception>
+#include <limits>
 #include <map>
+#include <memory>
 #include <optional>
 #include <ostream>
 #include <span>
 #include <stdexcept>
+#include <string_view>
 #include <system_error>
+#include <thread>
 #include <unordered_map>
 
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace kernel {
 static constexpr uint8_t DB_BLOCK_FILES{'f'};
 static constexpr uint8_t DB_BLOCK_INDEX{'b'};
 static constexpr uint8_t DB_FLAG{'F'};
 static constexpr uint8_t DB_REINDEX_FLAG{'R'};
 static constexpr uint8_t DB_LAST_BLOCK{'l'};
+static constexpr uint8_t DB_POW_VERDICT{'p'};
+static constexpr uint8_t DB_BLOCK_INDEX_IMAGE{'i'};
+//! Size at which erasing pruned PoW verdicts writes a partial batch
+static constexpr size_t MAX_POW_VERDICT_ERASE_BATCH_BYTES{16 << 20};
 // Keys used in previous version that might still be found in the DB:
 // BlockTreeDB::DB_TXINDEX_BLOCK{'T'};
 // BlockTreeDB::DB_TXINDEX{'t'}
@@ -99,9 +127,21 @@ void BlockTreeDB::WriteBatchSync(const std::vector<std::pair<int, const CBlockFi
     for (const CBlockIndex* bi : blockinfo) {
         batch.Write(std::make_pair(DB_BLOCK_INDEX, bi->GetBlockHash()), CDiskBlockIndex{bi});
     }
+    // Any image of the block index no longer matches the database
+    batch.Erase(DB_BLOCK_INDEX_IMAGE);
     WriteBatch(batch, true);
 }
 
+bool BlockTreeDB::ReadBlockIndexImageTag(uint256& tag)
+{
+    return Read(DB_BLOCK_INDEX_IMAGE, tag);
+}
+
+void BlockTreeDB::WriteBlockIndexImageTag(const uint256& tag)
+{
+    Write(DB_BLOCK_INDEX_IMAGE, tag, /*fSync=*/true);
+}
+
 void BlockTreeDB::WriteFlag(const std::string& name, bool fValue)
 {
     Write(std::make_pair(DB_FLAG, name), fValue ? uint8_t{'1'} : uint8_t{'0'});
@@ -164,6 +204,66 @@ bool BlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams, s
     return true;
 }
 
+namespace {
+struct PowVerdictKey {
+    int height{0};
+    uint256 block_hash;
+
+    template <typename Stream>
+    void Serialize(Stream& s) const
+    {
+        ser_writedata8(s, DB_POW_VERDICT);
+        ser_writedata32be(s, height);
+        s << block_hash;
+    }
+
+    template <typename Stream>
+    void Unserialize(Stream& s)
+    {
+        if (ser_readdata8(s) != DB_POW_VERDICT) {
+            throw std::ios_base::failure("Invalid format for PoW verdict key");
+        }
+        height = ser_readdata32be(s);
+        s >> block_hash;
+    }
+};
+} // namespace
+
+bool PowVerdictDB::HasVerdict(const uint256& block_hash, const uint256& seed_hash, int height)
+{
+    uint256 verified_seed;
+    return Read(PowVerdictKey{height, block_hash}, verified_seed) && verified_seed == seed_hash;
+}
+
+void PowVerdictDB::WriteVerdicts(const std::vector<PowVerdict>& verdicts)
+{
+    CDBBatch batch(*this);
+    for (const PowVerdict& verdict : verdicts) {
+        batch.Write(PowVerdictKey{verdict.height, verdict.block_hash}, verdict.seed_hash);
+    }
+    // A verdict lost in a crash only costs a RandomX hash later, so no fsync.
+    WriteBatch(batch);
+}
+
+size_t PowVerdictDB::EraseVerdictsBelow(int height)
+{
+    size_t num_erased{0};
+    CDBBatch batch(*this);
+    std::unique_ptr<CDBIterator> cursor{NewIterator()};
+    for (cursor->Seek(PowVerdictKey{}); cursor->Valid(); cursor->Next()) {
+        PowVerdictKey key;
+        if (!cursor->GetKey(key) || key.height >= height) break;
+        batch.Erase(key);
+        ++num_erased;
+        if (batch.ApproximateSize() > MAX_POW_VERDICT_ERASE_BATCH_BYTES) {
+            WriteBatch(batch);
+            batch.Clear();
+        }
+    }
+    WriteBatch(batch);
+    return num_erased;
+}
+
 std::string CBlockFileInfo::ToString() const
 {
     return strprintf("CBlockFileInfo(blocks=%u, size=%u, heights=%u...%u, time=%s...%s)", nBlocks, nSize, nHeightFirst, nHeightLast, FormatISO8601Date(nTimeFirst), FormatISO8601Date(nTimeLast));
@@ -423,7 +523,9 @@ CBlockIndex* BlockManager::InsertBlockIndex(const uint256& hash)
 
 bool BlockManager::LoadBlockIndex(const std::optional<uint256>& snapshot_blockhash)
 {
-    if (!m_block_tree_db->LoadBlockIndexGuts(
+    std::optional<std::vector<CBlockIndex*>> image_indexes;
+    if (m_opts.block_index_image) image_indexes = LoadBlockIndexImage();
+    if (!image_indexes && !m_block_tree_db->LoadBlockIndexGuts(
             GetConsensus(), [this](const uint256& hash) EXCLUSIVE_LOCKS_REQUIRED(cs_main) { return this->InsertBlockIndex(hash); }, m_interrupt)) {
         return false;
     }
@@ -452,10 +554,15 @@ bool BlockManager::LoadBlockIndex(const std::optional<uint256>& snapshot_blockha
 
     Assert(m_snapshot_height.has_value() == snapshot_blockhash.has_value());
 
-    // Calculate nChainWork
-    std::vector<CBlockIndex*> vSortedByHeight{GetAllBlockIndices()};
-    std::sort(vSortedByHeight.begin(), vSortedByHeight.end(),
-              CBlockIndexHeightOnlyComparator());
+    // Calculate nChainWork, unless the image had it
+    std::vector<CBlockIndex*> vSortedByHeight;
+    if (image_indexes) {
+        vSortedByHeight = std::move(*image_indexes);
+    } else {
+        vSortedByHeight = GetAllBlockIndices();
+        std::sort(vSortedByHeight.begin(), vSortedByHeight.end(),
+                  CBlockIndexHeightOnlyComparator());
+    }
 
     CBlockIndex* previous_index{nullptr};
     for (CBlockIndex* pindex : vSortedByHeight) {
@@ -465,7 +572,7 @@ bool BlockManager::LoadBlockIndex(const std::optional<uint256>& snapshot_blockha
             return false;
         }
         previous_index = pindex;
-        pindex->nChainWork = (pindex->pprev ? pindex->pprev->nChainWork : 0) + GetBlockProof(*pindex);
+        if (!image_indexes) pindex->nChainWork = (pindex->pprev ? pindex->pprev->nChainWork : 0) + GetBlockProof(*pindex);
         pindex->nTimeMax = (pindex->pprev ? std::max(pindex->pprev->nTimeMax, pindex->nTime) : pindex->nTime);
 
         // We can link the chain of blocks for which we've received transactions at some point, or
@@ -500,9 +607,12 @@ bool BlockManager::LoadBlockIndex(const std::optional<uint256>& snapshot_blockha
     return true;
 }
 
-void BlockManager::WriteBlockIndexDB()
+bool BlockManager::WriteBlockIndexDB()
 {
     AssertLockHeld(::cs_main);
+    // Do not persist index entries pointing to data that was not written yet,
+    // or never will be.
+    if (!WaitForPendingWrites()) return false;
     std::vector<std::pair<int, const CBlockFileInfo*>> vFiles;
     vFiles.reserve(m_dirty_fileinfo.size());
     for (std::set<int>::iterator it = m_dirty_fileinfo.begin(); it != m_dirty_fileinfo.end();) {
@@ -517,6 +627,40 @@ void BlockManager::WriteBlockIndexDB()
     }
     int max_blockfile = WITH_LOCK(cs_LastBlockFile, return this->MaxBlockfileNum());
     m_block_tree_db->WriteBatchSync(vFiles, max_blockfile, vBlocks);
+    if (m_pow_verdict_db && !m_pending_pow_verdicts.empty()) {
+        m_pow_verdict_db->WriteVerdicts(m_pending_pow_verdicts);
+    }
+    m_pending_pow_verdicts.clear();
+    return true;
+}
+
+bool BlockManager::HasPowVerdict(const uint256& block_hash, const uint256& seed_hash, int height)
+{
+    AssertLockHeld(::cs_main);
+    return m_pow_verdict_db && m_pow_verdict_db->HasVerdict(block_hash, seed_hash, height);
+}
+
+void BlockManager::AddPowVerdict(const uint256& block_hash, const uint256& seed_hash, int height)
+{
+    AssertLockHeld(::cs_main);
+    if (!m_pow_verdict_db || height < m_pow_verdicts_pruned_height) return;
+    m_pending_pow_verdicts.push_back({block_hash, seed_hash, height});
+    // Verdicts do not depend on the block index, so they can be written
+    // before it is flushed.
+    if (m_pending_pow_verdicts.size() >= MAX_PENDING_POW_VERDICTS) {
+        m_pow_verdict_db->WriteVerdicts(m_pending_pow_verdicts);
+        m_pending_pow_verdicts.clear();
+    }
+}
+
+void BlockManager::PrunePowVerdicts(int height)
+{
+    AssertLockHeld(::cs_main);
+    if (!m_pow_verdict_db || height <= m_pow_verdicts_pruned_height) return;
+    std::erase_if(m_pending_pow_verdicts, [&](const PowVerdict& verdict) { return verdict.height < height; });
+    const size_t num_erased{m_pow_verdict_db->EraseVerdictsBelow(height)};
+    m_pow_verdicts_pruned_height = height;
+    LogDebug(BCLog::BLOCKSTORAGE, "Pruned %u PoW verdicts below height %d\n", num_erased, height);
 }
 
 bool BlockManager::LoadBlockIndexDB(const std::optional<uint256>& snapshot_blockhash)
@@ -681,18 +825,15 @@ CBlockFileInfo* BlockManager::GetBlockFileInfo(size_t n)
 
 bool BlockManager::ReadBlockUndo(CBlockUndo& blockundo, const CBlockIndex& index) const
 {
-    const FlatFilePos pos{WITH_LOCK(::cs_main, return index.GetUndoPos())};
-
-    // Open history file to read
-    AutoFile file{OpenUndoFile(pos, true)};
-    if (file.IsNull()) {
-        LogError("OpenUndoFile failed for %s while reading block undo", pos.ToString());
-        return false;
+    const uint256 block_hash{index.GetBlockHash()};
+    if (const auto cached{m_block_cache.GetUndo(block_hash)}) {
+        blockundo = *cached;
+        return true;
     }
-    BufferedReader filein{std::move(file)};
 
-    try {
-        // Read block
+    const FlatFilePos pos{WITH_LOCK(::cs_main, return index.GetUndoPos())};
+
+    const auto read_undo{[&](auto& filein) {
         HashVerifier verifier{filein}; // Use HashVerifier, as reserializing may lose data, c.f. commit d3424243
 
         verifier << index.pprev->GetBlockHash();
@@ -706,16 +847,43 @@ bool BlockManager::ReadBlockUndo(CBlockUndo& blockundo, const CBlockIndex& index
             LogError("Checksum mismatch at %s while reading block undo", pos.ToString());
             return false;
         }
-    } catch (const std::exception& e) {
-        LogError("Deserialize or I/O error - %s at %s while reading block undo", e.what(), pos.ToString());
-        return false;
+        return true;
+    }};
+
+    if (const auto pending{GetPendingWrite(/*undo=*/true, pos)}) {
+        // Undo data that is still waiting to be written is read from memory
+        try {
+            SpanReader filein{std::span{pending->data}.subspan(STORAGE_HEADER_BYTES)};
+            if (!read_undo(filein)) return false;
+        } catch (const std::exception& e) {
+            LogError("Deserialize error - %s at %s while reading pending block undo", e.what(), pos.ToString());
+            return false;
+        }
+    } else {
+        // Open history file to read
+        AutoFile file{m_undo_file_seq.Open(pos, /*read_only=*/true), m_obfuscation};
+        if (file.IsNull()) {
+            LogError("OpenUndoFile failed for %s while reading block undo", pos.ToString());
+            return false;
+        }
+        BufferedReader filein{std::move(file)};
+
+        try {
+            // Read block
+            if (!read_undo(filein)) return false;
+        } catch (const std::exception& e) {
+            LogError("Deserialize or I/O error - %s at %s while reading block undo", e.what(), pos.ToString());
+            return false;
+        }
     }
 
+    if (m_block_cache.IsEnabled()) m_block_cache.AddUndo(block_hash, std::make_shared<const CBlockUndo>(blockundo));
     return true;
 }
 
 bool BlockManager::FlushUndoFile(int block_file, bool finalize)
 {
+    if (!WaitForPendingWrites(block_file)) return false;
     FlatFilePos undo_pos_old(block_file, m_blockfile_info[block_file].nUndoSize);
     if (!m_undo_file_seq.Flush(undo_pos_old, finalize)) {
         m_opts.notifications.flushError(_("Flushing undo file to disk failed. This is likely the result of an I/O error."));
@@ -739,6 +907,9 @@ bool BlockManager::FlushBlockFile(int blockfile_num, bool fFinalize, bool finali
     assert(static_cast<int>(m_blockfile_info.size()) > blockfile_num);
 
     FlatFilePos block_pos_old(blockfile_num, m_blockfile_info[blockfile_num].nSize);
+    if (!WaitForPendingWrites(blockfile_num)) return false;
+    // Finalizing truncates the file, which must not happen below a live map.
+    if (fFinalize) UnmapBlockFile(blockfile_num);
     if (!m_block_file_seq.Flush(block_pos_old, fFinalize)) {
         m_opts.notifications.flushError(_("Flushing block file to disk failed. This is likely the result of an I/O error."));
         success = false;
@@ -788,9 +959,14 @@ uint64_t BlockManager::CalculateCurrentUsage()
 
 void BlockManager::UnlinkPrunedFiles(const std::set<int>& setFilesToPrune) const
 {
+    // The cache does not know which files its entries were read from.
+    if (!setFilesToPrune.empty()) m_block_cache.Clear();
+    if (!setFilesToPrune.empty()) WITH_LOCK(m_raw_blocks_mutex, m_raw_blocks.clear());
     std::error_code ec;
     for (std::set<int>::iterator it = setFilesToPrune.begin(); it != setFilesToPrune.end(); ++it) {
         FlatFilePos pos(*it, 0);
+        (void)WaitForPendingWrites(*it);
+        UnmapBlockFile(*it);
         const bool removed_blockfile{fs::remove(m_block_file_seq.FileName(pos), ec)};
         const bool removed_undofile{fs::remove(m_undo_file_seq.FileName(pos), ec)};
         if (removed_blockfile || removed_undofile) {
@@ -799,14 +975,321 @@ void BlockManager::UnlinkPrunedFiles(const std::set<int>& setFilesToPrune) const
     }
 }
 
+struct BlockManager::MappedBlockFile {
+    const std::byte* const data;
+    const size_t size;
+
+    MappedBlockFile(const std::byte* data_in, size_t size_in) : data{data_in}, size{size_in} {}
+    MappedBlockFile(const MappedBlockFile&) = delete;
+    MappedBlockFile& operator=(const MappedBlockFile&) = delete;
+    ~MappedBlockFile()
+    {
+#ifndef WIN32
+        munmap(const_cast<std::byte*>(data), size);
+#endif
+    }
+};
+
+std::shared_ptr<const BlockManager::MappedBlockFile> BlockManager::MapBlockFile(int file_num, uint64_t min_size) const
+{
+    // Mapping all block files needs more address space than 32-bit systems have.
+    if (!m_opts.use_mmap || sizeof(void*) < 8) return nullptr;
+#ifdef WIN32
+    return nullptr;
+#else
+    LOCK(m_block_maps_mutex);
+    if (const auto it{m_block_maps.find(file_num)}; it != m_block_maps.end() && it->second->size >= min_size) {
+        return it->second;
+    }
+
+    const fs::path path{m_block_file_seq.FileName(FlatFilePos{file_num, 0})};
+    const int fd{open(path.c_str(), O_RDONLY)};
+    if (fd < 0) return nullptr;
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0 || file_stat.st_size <= 0 || static_cast<uint64_t>(file_stat.st_size) < min_size) {
+        close(fd);
+        return nullptr;
+    }
+    const size_t size{static_cast<size_t>(file_stat.st_size)};
+    void* ptr{mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0)};
+    close(fd);
+    if (ptr == MAP_FAILED) {
+        LogDebug(BCLog::BLOCKSTORAGE, "Failed to map %s, falling back to reading it: %s", fs::PathToString(path), SysErrorString(errno));
+        return nullptr;
+    }
+
+    if (m_block_maps.size() >= MAX_MAPPED_BLOCKFILES && !m_block_maps.contains(file_num)) {
+        // Peers syncing from us request blocks in ascending order, so the
+        // lowest file is the least likely to be needed again.
+        m_block_maps.erase(m_block_maps.begin());
+    }
+    auto map{std::make_shared<const MappedBlockFile>(static_cast<const std::byte*>(ptr), size)};
+    m_block_maps.insert_or_assign(file_num, map);
+    return map;
+#endif
+}
+
+void BlockManager::UnmapBlockFile(int file_num) const
+{
+    LOCK(m_block_maps_mutex);
+    m_block_maps.erase(file_num);
+}
+
+/**
+ * Block index image: a header followed by one fixed-size record per block
+ * index entry, in height order, so that parents precede their children. All
+ * integers are little-endian.
+ *
+ * Header: magic, version, record size, number of records, the tag stored in
+ * the block tree db, BlockTreeDBFingerprint() and the CRC32C of the records.
+ *
+ * Record: hash, record number of the parent (or INDEX_IMAGE_NO_PARENT),
+ * nHeight, nStatus, nTx, nFile, nDataPos, nUndoPos, the header fields other
+ * than the parent hash and nChainWork.
+ */
+static constexpr std::array<uint8_t, 8> INDEX_IMAGE_MAGIC{'b', 'l', 'k', 'i', 'n', 'd', 'e', 'x'};
+static constexpr uint32_t INDEX_IMAGE_VERSION{2};
+static constexpr size_t INDEX_IMAGE_HEADER_SIZE{96};
+static constexpr size_t INDEX_IMAGE_RECORD_SIZE{140};
+static constexpr uint32_t INDEX_IMAGE_NO_PARENT{std::numeric_limits<uint32_t>::max()};
+
+static uint256 ReadImageHash(const std::byte* ptr)
+{
+    uint256 hash;
+    std::memcpy(hash.data(), ptr, hash.size());
+    return hash;
+}
+
+static void WriteImageHash(std::byte* ptr, const uint256& hash)
+{
+    std::memcpy(ptr, hash.data(), hash.size());
+}
+
+/**
+ * Hash of the names and sizes of the files of the block tree db, which change
+ * with every write to it. Versions unaware of the block index image do not
+ * erase its tag when writing the block index. Opening the db rewrites some of
+ * its files, so this must be taken before it is opened.
+ */
+static uint256 BlockTreeDBFingerprint(const fs::path& db_path)
+{
+    std::vector<std::pair<std::string, uintmax_t>> files;
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator{db_path, ec}) {
+        const std::string name{fs::PathToString(entry.path().filename())};
+        // Written by LevelDB regardless of the data
+        if (name == "LOCK" || name == "LOG" || name == "LOG.old") continue;
+        files.emplace_back(name, entry.is_regular_file(ec) ? entry.file_size(ec) : 0);
+    }
+    std::ranges::sort(files);
+    HashWriter hasher{};
+    for (const auto& [name, size] : files) hasher << name << uint64_t{size};
+    return hasher.GetSHA256();
+}
+
+std::optional<std::vector<CBlockIndex*>> BlockManager::LoadBlockIndexImage()
+{
+    AssertLockHeld(cs_main);
+    uint256 tag;
+    if (!m_block_index.empty() || !m_block_tree_db->ReadBlockIndexImageTag(tag)) return std::nullopt;
+    const fs::path path{BlockIndexImagePath()};
+
+    std::span<const std::byte> image;
+#ifndef WIN32
+    std::optional<MappedBlockFile> map;
+    const int fd{open(path.c_str(), O_RDONLY)};
+    if (fd < 0) return std::nullopt;
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) == 0 && static_cast<uint64_t>(file_stat.st_size) >= INDEX_IMAGE_HEADER_SIZE) {
+        const size_t size{static_cast<size_t>(file_stat.st_size)};
+        if (void* ptr{mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0)}; ptr != MAP_FAILED) {
+            map.emplace(static_cast<const std::byte*>(ptr), size);
+            image = std::span{map->data, map->size};
+        }
+    }
+    close(fd);
+#else
+    std::vector<std::byte> buffer;
+    AutoFile file{fsbridge::fopen(path, "rb")};
+    if (file.IsNull()) return std::nullopt;
+    try {
+        buffer.resize(file.size());
+        file.read(buffer);
+        image = buffer;
+    } catch (const std::exception&) {
+    }
+#endif
+
+    const auto mismatch{[&](std::string_view reason) {
+        LogInfo("Block index image %s does not match the block tree db (%s), loading the db instead", fs::PathToString(path), reason);
+        return std::nullopt;
+    }};
+    if (image.size() < INDEX_IMAGE_HEADER_SIZE) return mismatch("truncated");
+    const std::byte* const header{image.data()};
+    const uint64_t count{ReadLE64(header + 16)};
+    if (!std::ranges::equal(std::as_bytes(std::span{INDEX_IMAGE_MAGIC}), image.first(8)) ||
+        ReadLE32(header + 8) != INDEX_IMAGE_VERSION || ReadLE32(header + 12) != INDEX_IMAGE_RECORD_SIZE) {
+        return mismatch("unknown format");
+    }
+    if (count > (image.size() - INDEX_IMAGE_HEADER_SIZE) / INDEX_IMAGE_RECORD_SIZE ||
+        image.size() != INDEX_IMAGE_HEADER_SIZE + count * INDEX_IMAGE_RECORD_SIZE) {
+        return mismatch("truncated");
+    }
+    if (ReadImageHash(header + 24) != tag || ReadImageHash(header + 56) != m_block_tree_fingerprint) {
+        return mismatch("outdated");
+    }
+    const auto records{image.subspan(INDEX_IMAGE_HEADER_SIZE)};
+    if (crc32c::Crc32c(UCharCast(records.data()), records.size()) != ReadLE32(header + 88)) return mismatch("bad checksum");
+
+    // Check the structure before changing m_block_index
+    for (uint64_t i{0}; i < count; ++i) {
+        const std::byte* const record{records.data() + i * INDEX_IMAGE_RECORD_SIZE};
+        const uint32_t parent{ReadLE32(record + 32)};
+        const int32_t height{static_cast<int32_t>(ReadLE32(record + 36))};
+        const bool height_ok{parent == INDEX_IMAGE_NO_PARENT ?
+                                 height == 0 :
+                                 parent < i && static_cast<int32_t>(ReadLE32(records.data() + parent * INDEX_IMAGE_RECORD_SIZE + 36)) == height - 1};
+        if (!height_ok || (i > 0 && static_cast<int32_t>(ReadLE32(record - INDEX_IMAGE_RECORD_SIZE + 36)) > height)) {
+            return mismatch("bad record");
+        }
+    }
+    // The records are consistent with the db as a whole, but check that the
+    // tip at least hashes to what it is stored under
+    if (count > 0) {
+        const std::byte* const record{records.data() + (count - 1) * INDEX_IMAGE_RECORD_SIZE};
+        const uint32_t parent{ReadLE32(record + 32)};
+        CBlockHeader tip;
+        tip.nVersion = static_cast<int32_t>(ReadLE32(record + 60));
+        if (parent != INDEX_IMAGE_NO_PARENT) tip.hashPrevBlock = ReadImageHash(records.data() + parent * INDEX_IMAGE_RECORD_SIZE);
+        tip.hashMerkleRoot = ReadImageHash(record + 64);
+        tip.nTime = ReadLE32(record + 96);
+        tip.nBits = ReadLE32(record + 100);
+        tip.nNonce = ReadLE32(record + 104);
+        if (tip.GetHash() != ReadImageHash(record)) return mismatch("bad record");
+    }
+
+    std::vector<CBlockIndex*> indexes;
+    indexes.reserve(count);
+    m_block_index.reserve(count);
+    for (uint64_t i{0}; i < count; ++i) {
+        if (m_interrupt) break;
+        const std::byte* const record{records.data() + i * INDEX_IMAGE_RECORD_SIZE};
+        CBlockIndex* pindex{InsertBlockIndex(ReadImageHash(record))};
+        const uint32_t parent{ReadLE32(record + 32)};
+        pindex->pprev = parent == INDEX_IMAGE_NO_PARENT ? nullptr : indexes[parent];
+        pindex->nHeight = static_cast<int>(ReadLE32(record + 36));
+        pindex->nStatus = ReadLE32(record + 40);
+        pindex->nTx = ReadLE32(record + 44);
+        pindex->nFile = static_cast<int>(ReadLE32(record + 48));
+        pindex->nDataPos = ReadLE32(record + 52);
+        pindex->nUndoPos = ReadLE32(record + 56);
+        pindex->nVersion = static_cast<int32_t>(ReadLE32(record + 60));
+        pindex->hashMerkleRoot = ReadImageHash(record + 64);
+        pindex->nTime = ReadLE32(record + 96);
+        pindex->nBits = ReadLE32(record + 100);
+        pindex->nNonce = ReadLE32(record + 104);
+        pindex->nChainWork = UintToArith256(ReadImageHash(record + 108));
+        indexes.push_back(pindex);
+    }
+    if (m_interrupt || m_block_index.size() != count) {
+        // Duplicate hashes leave fewer entries than records
+        m_block_index.clear();
+        if (m_interrupt) return std::nullopt;
+        return mismatch("duplicate entries");
+    }
+    LogInfo("Loaded %d block index entries from image %s", count, fs::PathToString(path));
+    return indexes;
+}
+
+void BlockManager::WriteBlockIndexImage()
+{
+    AssertLockHeld(::cs_main);
+    if (!m_opts.block_index_image || m_opts.block_tree_db_params.memory_only) return;
+    // The image must match the block tree db exactly
+    if (!m_dirty_blockindex.empty() || !m_dirty_fileinfo.empty()) return;
+    const fs::path path{BlockIndexImagePath()};
+    const fs::path temppath{path + ".new"};
+    LOG_TIME_MILLIS_WITH_CATEGORY(strprintf("writing block index image %s", fs::PathToString(path)), BCLog::BLOCKSTORAGE);
+
+    std::vector<CBlockIndex*> indexes{GetAllBlockIndices()};
+    std::ranges::sort(indexes, CBlockIndexHeightOnlyComparator());
+    std::unordered_map<const CBlockIndex*, uint32_t> record_nums;
+    record_nums.reserve(indexes.size());
+
+    const uint256 tag{GetRandHash()};
+    std::array<std::byte, INDEX_IMAGE_HEADER_SIZE> header{};
+    std::ranges::copy(std::as_bytes(std::span{INDEX_IMAGE_MAGIC}), header.begin());
+    WriteLE32(header.data() + 8, INDEX_IMAGE_VERSION);
+    WriteLE32(header.data() + 12, INDEX_IMAGE_RECORD_SIZE);
+    WriteLE64(header.data() + 16, indexes.size());
+    WriteImageHash(header.data() + 24, tag);
+    // The fingerprint covers the tag, so write that first. Until the image is
+    // renamed into place, the old one carries an older tag and is not loaded.
+    m_block_tree_db->WriteBlockIndexImageTag(tag);
+    WriteImageHash(header.data() + 56, BlockTreeDBFingerprint(m_opts.block_tree_db_params.path));
+
+    AutoFile file{fsbridge::fopen(temppath, "wb")};
+    if (file.IsNull()) {
+        LogWarning("Failed to open %s for writing the block index image", fs::PathToString(temppath));
+        return;
+    }
+    try {
+        file.write(header);
+        uint32_t crc{0};
+        std::vector<std::byte> buffer;
+        for (const CBlockIndex* pindex : indexes) {
+            const size_t pos{buffer.size()};
+            buffer.resize(pos + INDEX_IMAGE_RECORD_SIZE);
+            std::byte* const record{buffer.data() + pos};
+            WriteImageHash(record, pindex->GetBlockHash());
+            WriteLE32(record + 32, pindex->pprev ? record_nums.at(pindex->pprev) : INDEX_IMAGE_NO_PARENT);
+            WriteLE32(record + 36, static_cast<uint32_t>(pindex->nHeight));
+            WriteLE32(record + 40, pindex->nStatus);
+            WriteLE32(record + 44, pindex->nTx);
+            WriteLE32(record + 48, static_cast<uint32_t>(pindex->nFile));
+            WriteLE32(record + 52, pindex->nDataPos);
+            WriteLE32(record + 56, pindex->nUndoPos);
+            WriteLE32(record + 60, static_cast<uint32_t>(pindex->nVersion));
+            WriteImageHash(record + 64, pindex->hashMerkleRoot);
+            WriteLE32(record + 96, pindex->nTime);
+            WriteLE32(record + 100, pindex->nBits);
+            WriteLE32(record + 104, pindex->nNonce);
+            WriteImageHash(record + 108, ArithToUint256(pindex->nChainWork));
+            record_nums.emplace(pindex, record_nums.size());
+            if (buffer.size() >= (1 << 20) || record_nums.size() == indexes.size()) {
+                crc = crc32c::Extend(crc, UCharCast(buffer.data()), buffer.size());
+                file.write(buffer);
+                buffer.clear();
+            }
+        }
+        WriteLE32(header.data() + 88, crc);
+        file.seek(0, SEEK_SET);
+        file.write(header);
+        if (!file.Commit()) throw std::ios_base::failure("commit failed");
+    } catch (const std::exception& e) {
+        LogWarning("Failed to write the block index image %s: %s", fs::PathToString(temppath), e.what());
+        (void)file.fclose();
+        fs::remove(temppath);
+        return;
+    }
+    if (file.fclose() != 0 || !RenameOver(temppath, path)) {
+        LogWarning("Failed to write the block index image %s", fs::PathToString(path));
+        fs::remove(temppath);
+        return;
+    }
+}
+
 AutoFile BlockManager::OpenBlockFile(const FlatFilePos& pos, bool fReadOnly) const
 {
+    // Readers of the file expect all data written so far to be there
+    if (fReadOnly) (void)WaitForPendingWrites(pos.nFile);
     return AutoFile{m_block_file_seq.Open(pos, fReadOnly), m_obfuscation};
 }
 
 /** Open an undo file (rev?????.dat) */
 AutoFile BlockManager::OpenUndoFile(const FlatFilePos& pos, bool fReadOnly) const
 {
+    if (fReadOnly) (void)WaitForPendingWrites(pos.nFile);
     return AutoFile{m_undo_file_seq.Open(pos, fReadOnly), m_obfuscation};
 }
 
@@ -964,32 +1447,24 @@ bool BlockManager::WriteBlockUndo(const CBlockUndo& blockundo, BlockValidationSt
             return false;
         }
 
-        // Open history file to append
-        AutoFile file{OpenUndoFile(pos)};
-        if (file.IsNull()) {
-            LogError("OpenUndoFile failed for %s while writing block undo", pos.ToString());
-            return FatalError(m_opts.notifications, state, _("Failed to write undo data."));
-        }
+        std::vector<unsigned char> data;
+        data.reserve(blockundo_size + UNDO_DATA_DISK_OVERHEAD);
         {
-            BufferedWriter fileout{file};
-
-            // Write index header
-            fileout << GetParams().MessageStart() << blockundo_size;
-            pos.nPos += STORAGE_HEADER_BYTES;
-            {
-                // Calculate checksum
-                HashWriter hasher{};
-                hasher << block.pprev->GetBlockHash() << blockundo;
-                // Write undo data & checksum
-                fileout << blockundo << hasher.GetHash();
-            }
-            // BufferedWriter will flush pending data to file when fileout goes out of scope.
+            // Calculate checksum
+            HashWriter hasher{};
+            hasher << block.pprev->GetBlockHash() << blockundo;
+            // Index header, undo data & checksum
+            VectorWriter{data, 0, GetParams().MessageStart(), blockundo_size, blockundo, hasher.GetHash()};
         }
+        PendingWrite write{.undo = true, .pos = pos, .data = std::move(data)};
+        pos.nPos += STORAGE_HEADER_BYTES;
 
-        // Make sure that the file is closed before we call `FlushUndoFile`.
-        if (file.fclose() != 0) {
-            LogError("Failed to close block undo file %s: %s", pos.ToString(), SysErrorString(errno));
-            return FatalError(m_opts.notifications, state, _("Failed to close block undo file."));
+        if (m_block_writer.joinable()) {
+            // The write completes later, possibly only when the block index
+            // is next written, which fails if the write did.
+            QueueWrite(std::move(write));
+        } else if (!WriteToDisk(write)) {
+            return FatalError(m_opts.notifications, state, _("Failed to write undo data."));
         }
 
         // rev files are written in block height order, whereas blk files are written as blocks come in (often out of order)
@@ -1009,6 +1484,8 @@ bool BlockManager::WriteBlockUndo(const CBlockUndo& blockundo, BlockValidationSt
         } else if (pos.nFile == cursor.file_num && block.nHeight > cursor.undo_height) {
             cursor.undo_height = block.nHeight;
         }
+        if (m_block_cache.IsEnabled()) m_block_cache.AddUndo(block.GetBlockHash(), std::make_shared<const CBlockUndo>(blockundo));
+
         // update nUndoPos in block index
         block.nUndoPos = pos.nPos;
         block.nStatus |= BLOCK_HAVE_UNDO;
@@ -1018,19 +1495,67 @@ bool BlockManager::WriteBlockUndo(const CBlockUndo& blockundo, BlockValidationSt
     return true;
 }
 
-bool BlockManager::ReadBlock(CBlock& block, const FlatFilePos& pos, const std::optional<uint256>& expected_hash) const
+/** Copy of a block to keep in the block cache. It shares the transactions, but not the flags of checks done on the original. */
+static std::shared_ptr<const CBlock> CopyForCache(const CBlock& block)
+{
+    auto copy{std::make_shared<CBlock>(static_cast<const CBlockHeader&>(block))};
+    copy->vtx = block.vtx;
+    return copy;
+}
+
+bool BlockManager::ReadBlock(CBlock& block, const FlatFilePos& pos, const std::optional<uint256>& expected_hash, bool use_arena) const
+{
+    if (expected_hash) {
+        if (const auto cached{m_block_cache.GetBlock(*expected_hash)}) {
+            block = *cached;
+            return true;
+        }
+    }
+    if (!ReadBlockFromDisk(block, pos, expected_hash, use_arena)) return false;
+    if (expected_hash && !use_arena && m_block_cache.IsEnabled()) {
+        m_block_cache.AddBlock(*expected_hash, CopyForCache(block));
+    }
+    return true;
+}
+
+std::shared_ptr<const CBlock> BlockManager::ReadBlock(const FlatFilePos& pos, const uint256& hash) const
+{
+    // Callers may check the block, which sets its mutable flags, so neither
+    // hand out nor keep the cached block itself.
+    if (const auto cached{m_block_cache.GetBlock(hash)}) return CopyForCache(*cached);
+    auto block{std::make_shared<CBlock>()};
+    if (!ReadBlockFromDisk(*block, pos, hash, /*use_arena=*/false)) return nullptr;
+    if (m_block_cache.IsEnabled()) m_block_cache.AddBlock(hash, CopyForCache(*block));
+    return block;
+}
+
+std::shared_ptr<const CBlock> BlockManager::ReadBlock(const CBlockIndex& index) const
+{
+    const FlatFilePos block_pos{WITH_LOCK(cs_main, return index.GetBlockPos())};
+    return ReadBlock(block_pos, index.GetBlockHash());
+}
+
+bool BlockManager::ReadBlockFromDisk(CBlock& block, const FlatFilePos& pos, const std::optional<uint256>& expected_hash, bool use_arena) const
 {
     block.SetNull();
 
     // Open history file to read
-    const auto block_data{ReadRawBlock(pos)};
+    bool compressed{false};
+    const auto block_data{ReadStoredBlock(pos, compressed)};
     if (!block_data) {
         return false;
     }
 
     try {
         // Read block
-        SpanReader{*block_data} >> TX_WITH_WITNESS(block);
+        SpanReader reader{*block_data};
+        if (compressed) {
+            reader >> Using<BlockCompression>(block);
+        } else if (use_arena) {
+            UnserializeBlockInArena(reader, block);
+        } else {
+            reader >> TX_WITH_WITNESS(block);
+        }
     } catch (const std::exception& e) {
         LogError("Deserialize or I/O error - %s at %s while reading block", e.what(), pos.ToString());
         return false;
@@ -1058,14 +1583,61 @@ bool BlockManager::ReadBlock(CBlock& block, const FlatFilePos& pos, const std::o
     return true;
 }
 
-bool BlockManager::ReadBlock(CBlock& block, const CBlockIndex& index) const
+bool BlockManager::ReadBlock(CBlock& block, const CBlockIndex& index, bool use_arena) const
 {
     const FlatFilePos block_pos{WITH_LOCK(cs_main, return index.GetBlockPos())};
-    return ReadBlock(block, block_pos, index.GetBlockHash());
+    return ReadBlock(block, block_pos, index.GetBlockHash(), use_arena);
 }
 
 BlockManager::ReadRawBlockResult BlockManager::ReadRawBlock(const FlatFilePos& pos, std::optional<std::pair<size_t, size_t>> block_part) const
 {
+    std::shared_ptr<const std::vector<std::byte>> raw;
+    {
+        LOCK(m_raw_blocks_mutex);
+        const auto it{std::ranges::find(m_raw_blocks, pos, &decltype(m_raw_blocks)::value_type::first)};
+        if (it != m_raw_blocks.end()) {
+            raw = it->second;
+            std::rotate(it, std::next(it), m_raw_blocks.end());
+        }
+    }
+
+    if (!raw) {
+        bool compressed{false};
+        auto block_data{ReadStoredBlock(pos, compressed, block_part)};
+        if (!block_data || !compressed) return block_data;
+
+        // Compressed blocks are converted back to the network serialization as
+        // a whole, and the requested part is taken from that.
+        CBlock block;
+        try {
+            SpanReader{*block_data} >> Using<BlockCompression>(block);
+        } catch (const std::exception& e) {
+            LogError("Decompressing block failed: %s for %s while reading raw block", e.what(), pos.ToString());
+            return util::Unexpected{ReadRawError::IO};
+        }
+        DataStream stream;
+        stream << TX_WITH_WITNESS(block);
+        raw = std::make_shared<const std::vector<std::byte>>(stream.begin(), stream.end());
+
+        LOCK(m_raw_blocks_mutex);
+        if (m_raw_blocks.size() >= MAX_RAW_BLOCKS_CACHED) m_raw_blocks.pop_front();
+        m_raw_blocks.emplace_back(pos, raw);
+    }
+
+    std::span<const std::byte> data{*raw};
+    if (block_part) {
+        const auto [offset, size]{*block_part};
+        if (size == 0 || SaturatingAdd(offset, size) > data.size()) {
+            return util::Unexpected{ReadRawError::BadPartRange}; // Avoid logging - offset/size come from untrusted REST input
+        }
+        data = data.subspan(offset, size);
+    }
+    return std::vector<std::byte>(data.begin(), data.end());
+}
+
+BlockManager::ReadRawBlockResult BlockManager::ReadStoredBlock(const FlatFilePos& pos, bool& compressed, std::optional<std::pair<size_t, size_t>> block_part) const
+{
+    compressed = false;
     if (pos.nPos < STORAGE_HEADER_BYTES) {
         // If nPos is less than STORAGE_HEADER_BYTES, we can't read the header that precedes the block data
         // This would cause an unsigned integer underflow when trying to position the file cursor
@@ -1073,8 +1645,30 @@ BlockManager::ReadRawBlockResult BlockManager::ReadRawBlock(const FlatFilePos& p
         LogError("Failed for %s while reading raw block storage header", pos.ToString());
         return util::Unexpected{ReadRawError::IO};
     }
-    AutoFile filein{OpenBlockFile({pos.nFile, pos.nPos - STORAGE_HEADER_BYTES}, /*fReadOnly=*/true)};
-    if (filein.IsNull()) {
+    // Blocks that are still waiting to be written are read from memory
+    if (const auto pending{GetPendingWrite(/*undo=*/false, pos)}) {
+        MessageStartChars blk_start;
+        unsigned int blk_size;
+        SpanReader{pending->data} >> blk_start >> blk_size;
+        compressed = (blk_size & COMPRESSED_BLOCK_FLAG) != 0;
+        std::span<const unsigned char> data{std::span{pending->data}.subspan(STORAGE_HEADER_BYTES)};
+        if (block_part && !compressed) {
+            const auto [offset, size]{*block_part};
+            if (size == 0 || SaturatingAdd(offset, size) > data.size()) {
+                return util::Unexpected{ReadRawError::BadPartRange}; // Avoid logging - offset/size come from untrusted REST input
+            }
+            data = data.subspan(offset, size);
+        }
+        const auto bytes{std::as_bytes(data)};
+        return std::vector<std::byte>(bytes.begin(), bytes.end());
+    }
+
+    const uint64_t header_pos{pos.nPos - STORAGE_HEADER_BYTES};
+    // Copy out of a memory map of the file if possible, which saves opening
+    // the file and going through the stdio buffer for every block.
+    auto map{MapBlockFile(pos.nFile, pos.nPos)};
+    AutoFile filein{map ? nullptr : m_block_file_seq.Open({pos.nFile, static_cast<unsigned int>(header_pos)}, /*read_only=*/true), m_obfuscation};
+    if (!map && filein.IsNull()) {
         LogError("OpenBlockFile failed for %s while reading raw block", pos.ToString());
         return util::Unexpected{ReadRawError::IO};
     }
@@ -1083,7 +1677,14 @@ BlockManager::ReadRawBlockResult BlockManager::ReadRawBlock(const FlatFilePos& p
         MessageStartChars blk_start;
         unsigned int blk_size;
 
-        filein >> blk_start >> blk_size;
+        if (map) {
+            std::array<std::byte, STORAGE_HEADER_BYTES> header;
+            std::memcpy(header.data(), map->data + header_pos, header.size());
+            m_obfuscation(header, header_pos);
+            SpanReader{header} >> blk_start >> blk_size;
+        } else {
+            filein >> blk_start >> blk_size;
+        }
 
         if (blk_start != GetParams().MessageStart()) {
             LogError("Block magic mismatch for %s: %s versus expected %s while reading raw block",
@@ -1091,21 +1692,36 @@ BlockManager::ReadRawBlockResult BlockManager::ReadRawBlock(const FlatFilePos& p
             return util::Unexpected{ReadRawError::IO};
         }
 
+        compressed = (blk_size & COMPRESSED_BLOCK_FLAG) != 0;
+        blk_size &= ~COMPRESSED_BLOCK_FLAG;
+
         if (blk_size > MAX_SIZE) {
             LogError("Block data is larger than maximum deserialization size for %s: %s versus %s while reading raw block",
                 pos.ToString(), blk_size, MAX_SIZE);
             return util::Unexpected{ReadRawError::IO};
         }
 
-        if (block_part) {
+        uint64_t data_pos{pos.nPos};
+        if (block_part && !compressed) {
             const auto [offset, size]{*block_part};
             if (size == 0 || SaturatingAdd(offset, size) > blk_size) {
                 return util::Unexpected{ReadRawError::BadPartRange}; // Avoid logging - offset/size come from untrusted REST input
             }
-            filein.seek(offset, SEEK_CUR);
+            if (!map) filein.seek(offset, SEEK_CUR);
+            data_pos += offset;
             blk_size = size;
         }
 
+        if (map) {
+            // The block may have been written after the file was mapped.
+            if (data_pos + blk_size > map->size) map = MapBlockFile(pos.nFile, data_pos + blk_size);
+            if (!map) throw std::ios_base::failure("block extends past the end of the file");
+            const std::byte* begin{map->data + data_pos};
+            std::vector<std::byte> data(begin, begin + blk_size);
+            m_obfuscation(data, data_pos);
+            return data;
+        }
+
         std::vector<std::byte> data(blk_size); // Zeroing of memory is intentional here
         filein.read(data);
         return data;
@@ -1117,35 +1733,118 @@ BlockManager::ReadRawBlockResult BlockManager::ReadRawBlock(const FlatFilePos& p
 
 FlatFilePos BlockManager::WriteBlock(const CBlock& block, int nHeight)
 {
-    const unsigned int block_size{static_cast<unsigned int>(GetSerializeSize(TX_WITH_WITNESS(block)))};
+    // Serialize the block behind room for the index header, which needs its size.
+    const bool compress{m_opts.compress_blocks && IsBlockCompressible(block)};
+    std::vector<unsigned char> data;
+    VectorWriter writer{data, STORAGE_HEADER_BYTES};
+    if (compress) {
+        writer << Using<BlockCompression>(block);
+    } else {
+        data.reserve(STORAGE_HEADER_BYTES + GetSerializeSize(TX_WITH_WITNESS(block)));
+        writer << TX_WITH_WITNESS(block);
+    }
+    const unsigned int block_size{static_cast<unsigned int>(data.size() - STORAGE_HEADER_BYTES)};
     FlatFilePos pos{FindNextBlockPos(block_size + STORAGE_HEADER_BYTES, nHeight, block.GetBlockTime())};
     if (pos.IsNull()) {
         LogError("FindNextBlockPos failed for %s while writing block", pos.ToString());
         return FlatFilePos();
     }
-    AutoFile file{OpenBlockFile(pos, /*fReadOnly=*/false)};
-    if (file.IsNull()) {
-        LogError("OpenBlockFile failed for %s while writing block", pos.ToString());
+    // Index header
+    VectorWriter{data, 0, GetParams().MessageStart(), compress ? block_size | COMPRESSED_BLOCK_FLAG : block_size};
+    PendingWrite write{.undo = false, .pos = pos, .data = std::move(data)};
+    pos.nPos += STORAGE_HEADER_BYTES;
+    if (m_block_cache.IsEnabled()) m_block_cache.AddBlock(block.GetHash(), CopyForCache(block));
+
+    if (m_block_writer.joinable()) {
+        QueueWrite(std::move(write));
+    } else if (!WriteToDisk(write)) {
         m_opts.notifications.fatalError(_("Failed to write block."));
         return FlatFilePos();
     }
-    {
-        BufferedWriter fileout{file};
 
-        // Write index header
-        fileout << GetParams().MessageStart() << block_size;
-        pos.nPos += STORAGE_HEADER_BYTES;
-        // Write block
-        fileout << TX_WITH_WITNESS(block);
-    }
+    return pos;
+}
 
+bool BlockManager::WriteToDisk(const PendingWrite& write) const
+{
+    const FlatFileSeq& file_seq{write.undo ? m_undo_file_seq : m_block_file_seq};
+    AutoFile file{file_seq.Open(write.pos, /*read_only=*/false), m_obfuscation};
+    if (file.IsNull()) {
+        LogError("Failed to open %s file for %s while writing", write.undo ? "undo" : "block", write.pos.ToString());
+        return false;
+    }
+    try {
+        file.write(std::as_bytes(std::span{write.data}));
+    } catch (const std::exception& e) {
+        LogError("Failed to write %s file at %s: %s", write.undo ? "undo" : "block", write.pos.ToString(), e.what());
+        return false;
+    }
     if (file.fclose() != 0) {
-        LogError("Failed to close block file %s: %s", pos.ToString(), SysErrorString(errno));
-        m_opts.notifications.fatalError(_("Failed to close file when writing block."));
-        return FlatFilePos();
+        LogError("Failed to close %s file %s: %s", write.undo ? "undo" : "block", write.pos.ToString(), SysErrorString(errno));
+        return false;
     }
+    return true;
+}
 
-    return pos;
+void BlockManager::QueueWrite(PendingWrite&& write)
+{
+    auto pending{std::make_shared<const PendingWrite>(std::move(write))};
+    const PendingWriteKey key{pending->undo, pending->pos.nFile, pending->pos.nPos + STORAGE_HEADER_BYTES};
+    {
+        WAIT_LOCK(m_write_mutex, lock);
+        // Bound the memory used by pending data, by waiting for the disk.
+        m_write_done_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_write_mutex) {
+            return m_pending_writes.empty() || m_pending_write_bytes + pending->data.size() <= MAX_PENDING_BLOCK_WRITE_BYTES;
+        });
+        m_pending_write_bytes += pending->data.size();
+        m_pending_writes.insert_or_assign(key, pending);
+        m_write_queue.push_back(std::move(pending));
+    }
+    m_write_queued_cv.notify_one();
+}
+
+std::shared_ptr<const BlockManager::PendingWrite> BlockManager::GetPendingWrite(bool undo, const FlatFilePos& pos) const
+{
+    LOCK(m_write_mutex);
+    const auto it{m_pending_writes.find(PendingWriteKey{undo, pos.nFile, pos.nPos})};
+    return it == m_pending_writes.end() ? nullptr : it->second;
+}
+
+bool BlockManager::WaitForPendingWrites(std::optional<int> file_num) const
+{
+    WAIT_LOCK(m_write_mutex, lock);
+    m_write_done_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_write_mutex) {
+        return std::ranges::none_of(m_pending_writes, [&](const auto& entry) {
+            return !file_num || std::get<1>(entry.first) == *file_num;
+        });
+    });
+    return !m_write_failed;
+}
+
+void BlockManager::BlockWriterThread()
+{
+    while (true) {
+        std::shared_ptr<const PendingWrite> write;
+        {
+            WAIT_LOCK(m_write_mutex, lock);
+            m_write_queued_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_write_mutex) { return m_stop_writer || !m_write_queue.empty(); });
+            // Only stop once everything is written.
+            if (m_write_queue.empty()) return;
+            write = std::move(m_write_queue.front());
+            m_write_queue.pop_front();
+        }
+        const bool written{WriteToDisk(*write)};
+        if (!written) {
+            m_opts.notifications.fatalError(write->undo ? _("Failed to write undo data.") : _("Failed to write block."));
+        }
+        {
+            LOCK(m_write_mutex);
+            if (!written) m_write_failed = true;
+            m_pending_writes.erase(PendingWriteKey{write->undo, write->pos.nFile, write->pos.nPos + STORAGE_HEADER_BYTES});
+            m_pending_write_bytes -= write->data.size();
+        }
+        m_write_done_cv.notify_all();
+    }
 }
 
 static auto InitBlocksdirXorKey(const BlockManager::Options& opts)
@@ -1211,10 +1910,23 @@ BlockManager::BlockManager(const util::SignalInterrupt& interrupt, Options opts)
       m_opts{std::move(opts)},
       m_block_file_seq{FlatFileSeq{m_opts.blocks_dir, "blk", m_opts.fast_prune ? 0x4000 /* 16kB */ : BLOCKFILE_CHUNK_SIZE}},
       m_undo_file_seq{FlatFileSeq{m_opts.blocks_dir, "rev", UNDOFILE_CHUNK_SIZE}},
+      m_block_cache{m_opts.block_cache_bytes},
       m_interrupt{interrupt}
 {
+    if (m_opts.block_index_image && !m_opts.block_tree_db_params.memory_only) {
+        m_block_tree_fingerprint = BlockTreeDBFingerprint(m_opts.block_tree_db_params.path);
+    }
     m_block_tree_db = std::make_unique<BlockTreeDB>(m_opts.block_tree_db_params);
 
+    if (m_opts.persist_pow_verdicts) {
+        // Deliberately never wiped: verdicts stay valid across -reindex.
+        DBParams pow_verdict_db_params{m_opts.block_tree_db_params};
+        pow_verdict_db_params.path = pow_verdict_db_params.path.parent_path() / "powverdicts";
+        pow_verdict_db_params.cache_bytes = 0;
+        pow_verdict_db_params.wipe_data = false;
+        m_pow_verdict_db = std::make_unique<PowVerdictDB>(pow_verdict_db_params);
+    }
+
     if (m_opts.block_tree_db_params.wipe_data) {
         m_block_tree_db->WriteReindexing(true);
         m_blockfiles_indexed = false;
@@ -1223,6 +1935,22 @@ BlockManager::BlockManager(const util::SignalInterrupt& interrupt, Options opts)
             CleanupBlockRevFiles();
         }
     }
+
+    if (m_opts.async_writes) {
+        m_block_writer = std::thread([this] {
+            util::ThreadRename("blockwrite");
+            BlockWriterThread();
+        });
+    }
+}
+
+BlockManager::~BlockManager()
+{
+    if (m_block_writer.joinable()) {
+        WITH_LOCK(m_write_mutex, m_stop_writer = true);
+        m_write_queued_cv.notify_one();
+        m_block_writer.join();
+    }
 }
 
 class ImportingNow
@@ -1242,6 +1970,202 @@ public:
     }
 };
 
+std::optional<uint256> ReindexPowPrefetcher::FindAncestor(uint256 hash, int height)
+{
+    for (auto it{m_headers.find(hash)}; it != m_headers.end() && it->second.height > height; it = m_headers.find(hash)) {
+        hash = it->second.prev;
+    }
+    if (const auto it{m_headers.find(hash)}; it != m_headers.end()) {
+        return it->second.height == height ? std::optional{hash} : std::nullopt;
+    }
+    const CBlockIndex* pindex{m_chainman.m_blockman.LookupBlockIndex(hash)};
+    const CBlockIndex* ancestor{pindex ? pindex->GetAncestor(height) : nullptr};
+    return ancestor ? std::optional{ancestor->GetBlockHash()} : std::nullopt;
+}
+
+std::optional<uint256> ReindexPowPrefetcher::PlaceHeader(const CBlockHeader& header, const uint256& hash)
+{
+    int height;
+    uint256 seed;
+    if (hash == m_chainman.GetConsensus().hashGenesisBlock) {
+        height = 0;
+        seed = GetNextRandomXSeedHash(nullptr);
+    } else if (const auto it{m_headers.find(header.hashPrevBlock)}; it != m_headers.end()) {
+        height = it->second.height + 1;
+        const uint64_t seed_height{GetRandomXSeedHeight(height)};
+        if (seed_height == GetRandomXSeedHeight(it->second.height)) {
+            seed = it->second.seed;
+        } else if (seed_height == 0) {
+            seed = GetNextRandomXSeedHash(nullptr);
+        } else if (const auto seed_block{FindAncestor(header.hashPrevBlock, seed_height)}) {
+            seed = *seed_block;
+        } else {
+            return std::nullopt;
+        }
+    } else if (const CBlockIndex* pindex_prev{m_chainman.m_blockman.LookupBlockIndex(header.hashPrevBlock)}) {
+        height = pindex_prev->nHeight + 1;
+        seed = GetNextRandomXSeedHash(pindex_prev);
+    } else {
+        // Out of order, its parent has not been seen yet
+        return std::nullopt;
+    }
+    m_headers.try_emplace(hash, ScannedHeader{header.hashPrevBlock, height, seed});
+    m_max_height = std::max(m_max_height, height);
+    return seed;
+}
+
+void ReindexPowPrefetcher::VerifyBatch()
+{
+    std::vector<PendingHeader> pending{std::move(m_unplaced)};
+    m_unplaced.clear();
+    for (const CBlockHeader& header : m_batch) {
+        pending.push_back({header, header.GetHash(), /*carried=*/false});
+    }
+    m_batch.clear();
+
+    std::map<uint256, std::vector<CBlockHeader>> by_seed;
+    {
+        LOCK(::cs_main);
+        // LoadExternalBlockFile does not check the proof of work of known headers.
+        std::erase_if(pending, [&](const PendingHeader& p) { return m_chainman.m_blockman.LookupBlockIndex(p.hash) != nullptr; });
+        // Children may come before their parents, so place headers until no
+        // more can be.
+        for (size_t num_placed{1}; num_placed > 0;) {
+            num_placed = 0;
+            std::erase_if(pending, [&](const PendingHeader& p) {
+                const auto seed{PlaceHeader(p.header, p.hash)};
+                if (!seed) return false;
+                ++num_placed;
+                if (!m_chainman.m_blockman.HasPowVerdict(p.hash, *seed, m_headers.at(p.hash).height) &&
+                    !m_chainman.m_pow_cache.Get(m_chainman.m_pow_cache.ComputeEntry(p.hash, *seed))) {
+                    by_seed[*seed].push_back(p.header);
+                }
+                return true;
+            });
+        }
+    }
+    // The parents of the rest may be in the next batch. Headers that already
+    // waited for one are left to LoadExternalBlockFile.
+    for (PendingHeader& p : pending) {
+        if (p.carried) continue;
+        p.carried = true;
+        m_unplaced.push_back(std::move(p));
+    }
+
+    const Consensus::Params& consensus{m_chainman.GetConsensus()};
+    std::vector<PowVerdict> verdicts;
+    const auto time_start{SteadyClock::now()};
+    for (const auto& [seed, headers] : by_seed) {
+        const std::vector<uint256> pow_hashes{GetBlockPoWHashes(headers, seed, m_lanes)};
+        for (size_t i{0}; i < headers.size(); ++i) {
+            if (CheckProofOfWorkImpl(pow_hashes[i], headers[i].nBits, consensus)) {
+                const uint256 hash{headers[i].GetHash()};
+                verdicts.push_back({hash, seed, m_headers.at(hash).height});
+            }
+        }
+    }
+    const auto time_pow{SteadyClock::now() - time_start};
+    {
+        // Persist the verdicts as well, like accepting the headers would have.
+        LOCK(::cs_main);
+        m_chainman.time_pow += time_pow;
+        for (const PowVerdict& verdict : verdicts) {
+            m_chainman.m_blockman.AddPowVerdict(verdict.block_hash, verdict.seed_hash, verdict.height);
+            m_chainman.m_pow_cache.Set(m_chainman.m_pow_cache.ComputeEntry(verdict.block_hash, verdict.seed_hash));
+        }
+    }
+    if (!verdicts.empty()) {
+        LogDebug(BCLog::REINDEX, "Verified the proof of work of %u blocks ahead of -reindex\n", verdicts.size());
+    }
+
+    // Forget headers that are too old to be a parent or seed block of the
+    // ones still to come. They are in the block index by then.
+    if (m_headers.size() > 4 * RANDOMX_EPOCH_LENGTH) {
+        std::erase_if(m_headers, [&](const auto& entry) { return entry.second.height < m_max_height - 2 * int{RANDOMX_EPOCH_LENGTH}; });
+    }
+}
+
+void ReindexPowPrefetcher::ScanFile(int file_num)
+{
+    AutoFile file{m_chainman.m_blockman.OpenBlockFile(FlatFilePos{file_num, 0}, /*fReadOnly=*/true)};
+    if (file.IsNull()) return;
+    const MessageStartChars& message_start{m_chainman.GetParams().MessageStart()};
+    BufferedFile blkdat{file, 2 * MAX_BLOCK_SERIALIZED_SIZE, MAX_BLOCK_SERIALIZED_SIZE + 8};
+    uint64_t next{blkdat.GetPos()};
+    while (!blkdat.eof() && !m_stop && !m_chainman.m_interrupt) {
+        CBlockHeader header;
+        try {
+            blkdat.SetPos(next);
+            next++;
+            blkdat.SetLimit();
+            // Same framing as in LoadExternalBlockFile
+            MessageStartChars buf;
+            blkdat.FindByte(std::byte(message_start[0]));
+            next = blkdat.GetPos() + 1;
+            blkdat >> buf;
+            if (buf != message_start) continue;
+            unsigned int size;
+            blkdat >> size;
+            // Compressed blocks start with the header as well
+            size &= ~COMPRESSED_BLOCK_FLAG;
+            if (size < 80 || size > MAX_BLOCK_SERIALIZED_SIZE) continue;
+            const uint64_t block_pos{blkdat.GetPos()};
+            blkdat >> header;
+            next = block_pos + size;
+            blkdat.SkipTo(next);
+        } catch (const std::ios_base::failure&) {
+            // End of the file, or data that does not frame a block. Either
+            // way LoadExternalBlockFile deals with it.
+            break;
+        }
+        m_batch.push_back(header);
+        if (m_batch.size() >= BATCH_SIZE) {
+            VerifyBatch();
+            WaitForBestHeader();
+        }
+    }
+    if (!m_batch.empty()) VerifyBatch();
+}
+
+void ReindexPowPrefetcher::WaitForBestHeader()
+{
+    while (!m_stop && !m_chainman.m_interrupt) {
+        const int best_height{WITH_LOCK(::cs_main, return m_chainman.m_best_header ? m_chainman.m_best_header->nHeight : -1)};
+        if (m_max_height <= best_height + MAX_LOOKAHEAD) return;
+        UninterruptibleSleep(100ms);
+    }
+}
+
+ReindexPowPrefetcher::ReindexPowPrefetcher(ChainstateManager& chainman, int total_files)
+    : m_chainman{chainman},
+      m_total_files{total_files},
+      m_lanes{static_cast<unsigned int>(std::clamp(chainman.m_options.worker_threads_num, 0, MAX_SCRIPTCHECK_THREADS)) + 1}
+{
+    m_thread = std::thread([this] {
+        util::ThreadRename("reindexpow");
+        try {
+            for (int file_num{0}; file_num < m_total_files && !m_stop && !m_chainman.m_interrupt; ++file_num) {
+                ScanFile(file_num);
+            }
+        } catch (const std::exception& e) {
+            // Only a speedup, LoadExternalBlockFile checks the proof of work
+            // of the remaining blocks itself.
+            LogWarning("Stopped verifying proof of work ahead of -reindex: %s", e.what());
+        }
+    });
+}
+
+ReindexPowPrefetcher::~ReindexPowPrefetcher()
+{
+    m_stop = true;
+    Wait();
+}
+
+void ReindexPowPrefetcher::Wait()
+{
+    if (m_thread.joinable()) m_thread.join();
+}
+
 void ImportBlocks(ChainstateManager& chainman, std::span<const fs::path> import_paths)
 {
     ImportingNow imp{chainman.m_blockman.m_importing};
@@ -1257,6 +2181,9 @@ void ImportBlocks(ChainstateManager& chainman, std::span<const fs::path> import_
         // parent hash -> child disk position, multiple children can have the same parent.
         std::multimap<uint256, FlatFilePos> blocks_with_unknown_parent;
 
+        // Verify proof of work ahead of accepting the blocks
+        ReindexPowPrefetcher pow_prefetcher{chainman, total_files};
+
         for (int nFile{0}; nFile < total_files; ++nFile) {
             FlatFilePos pos(nFile, 0);
             AutoFile file{chainman.m_blockman.OpenBlockFile(pos, /*fReadOnly=*/true)};
@@ -13,6 +13,7 @@
 #include <kernel/chainparams.h>
 #include <kernel/cs_main.h>
 #include <kernel/messagestartchars.h>
+#include <node/blockcache.h>
 #include <primitives/block.h>
 #include <serialize.h>
 #include <streams.h>
@@ -26,8 +27,10 @@
 #include <algorithm>
 #include <array>
 #include <atomic>
+#include <condition_variable>
 #include <cstddef>
 #include <cstdint>
+#include <deque>
 #include <functional>
 #include <iosfwd>
 #include <limits>
@@ -37,6 +40,8 @@
 #include <set>
 #include <span>
 #include <string>
+#include <thread>
+#include <tuple>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -106,14 +111,47 @@ public:
     void ReadReindexing(bool& fReindexing);
     void WriteFlag(const std::string& name, bool fValue);
     bool ReadFlag(const std::string& name, bool& fValue);
+    //! Tag of the block index image that matches the database, which any block index write erases
+    bool ReadBlockIndexImageTag(uint256& tag);
+    void WriteBlockIndexImageTag(const uint256& tag);
     bool LoadBlockIndexGuts(const Consensus::Params& consensusParams, std::function<CBlockIndex*(const uint256&)> insertBlockIndex, const util::SignalInterrupt& interrupt)
         EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
 };
+
+/** A header that passed its RandomX proof-of-work check. */
+struct PowVerdict {
+    uint256 block_hash;
+    uint256 seed_hash;
+    int height;
+};
+
+/**
+ * Side table of RandomX proof-of-work verdicts: (height, block hash) -> seed
+ * hash the header was successfully verified with.
+ *
+ * It lives next to, but outside of, the block tree database so that it
+ * survives -reindex, which wipes the block index and feeds every stored block
+ * back through AcceptBlockHeader().
+ *
+ * Entries are keyed by height first, so that the ones below a height can be
+ * erased with a single range scan.
+ */
+class PowVerdictDB : public CDBWrapper
+{
+public:
+    using CDBWrapper::CDBWrapper;
+    bool HasVerdict(const uint256& block_hash, const uint256& seed_hash, int height);
+    void WriteVerdicts(const std::vector<PowVerdict>& verdicts);
+    //! Erase the verdicts of headers below height, and return how many there were.
+    size_t EraseVerdictsBelow(int height);
+};
 } // namespace kernel
 
 namespace node {
 using kernel::CBlockFileInfo;
 using kernel::BlockTreeDB;
+using kernel::PowVerdict;
+using kernel::PowVerdictDB;
 
 /** The pre-allocation chunk size for blk?????.dat files (since 0.8) */
 static const unsigned int BLOCKFILE_CHUNK_SIZE = 0x1000000; // 16 MiB
@@ -125,9 +163,24 @@ static const unsigned int MAX_BLOCKFILE_SIZE = 0x8000000; // 128 MiB
 /** Size of header written by WriteBlock before a serialized CBlock (8 bytes) */
 static constexpr uint32_t STORAGE_HEADER_BYTES{std::tuple_size_v<MessageStartChars> + sizeof(unsigned int)};
 
+/** Set in the size field of the storage header when the block is serialized with BlockCompression */
+static constexpr uint32_t COMPRESSED_BLOCK_FLAG{uint32_t{1} << 31};
+
 /** Total overhead when writing undo data: header (8 bytes) plus checksum (32 bytes) */
 static constexpr uint32_t UNDO_DATA_DISK_OVERHEAD{STORAGE_HEADER_BYTES + uint256::size()};
 
+/** The maximum number of block files kept memory mapped for ReadRawBlock */
+static constexpr size_t MAX_MAPPED_BLOCKFILES{256};
+
+/** The number of compressed blocks ReadRawBlock keeps in the network serialization */
+static constexpr size_t MAX_RAW_BLOCKS_CACHED{8};
+
+/** The maximum size of serialized block and undo data waiting to be written by the block writer thread */
+static constexpr size_t MAX_PENDING_BLOCK_WRITE_BYTES{64 << 20};
+
+/** Number of PoW verdicts kept in memory before they are written out without waiting for WriteBlockIndexDB() */
+static constexpr size_t MAX_PENDING_POW_VERDICTS{10000};
+
 // Because validation code takes pointers to the map's CBlockIndex objects, if
 // we ever switch to another associative container, we need to either use a
 // container that has stable addressing (true of all std associative
@@ -203,10 +256,25 @@ private:
     bool LoadBlockIndex(const std::optional<uint256>& snapshot_blockhash)
         EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
-    /** Return false if block file or undo file flushing fails. */
+    /**
+     * Load the block index from the image written by WriteBlockIndexImage(),
+     * if there is one matching the block tree db. Return its entries, which
+     * are in height order and have nChainWork set.
+     */
+    std::optional<std::vector<CBlockIndex*>> LoadBlockIndexImage() EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+
+    fs::path BlockIndexImagePath() const { return m_opts.block_tree_db_params.path + ".img"; }
+
+    //! Fingerprint of the block tree db files as found on startup, which a
+    //! block index image must carry to be loaded.
+    uint256 m_block_tree_fingerprint;
+
+    /** Return false if block file or undo file flushing fails, or a write to
+     *  them by the block writer thread did. */
     [[nodiscard]] bool FlushBlockFile(int blockfile_num, bool fFinalize, bool finalize_undo);
 
-    /** Return false if undo file flushing fails. */
+    /** Return false if undo file flushing fails, or a write to it by the
+     *  block writer thread did. */
     [[nodiscard]] bool FlushUndoFile(int block_file, bool finalize = false);
 
     /**
@@ -287,6 +355,83 @@ private:
 
     const Obfuscation m_obfuscation;
 
+    /** A read-only memory map of a block file, unmapped on destruction. */
+    struct MappedBlockFile;
+
+    mutable Mutex m_block_maps_mutex;
+    /**
+     * Memory maps of block files, used by ReadRawBlock. A map covers the file
+     * as it was when mapped, and is replaced when a block past its end is
+     * requested. Readers hold on to a map while copying out of it, so it is
+     * only unmapped once no longer in use.
+     */
+    mutable std::map<int, std::shared_ptr<const MappedBlockFile>> m_block_maps GUARDED_BY(m_block_maps_mutex);
+
+    /**
+     * Return a memory map of block file file_num that covers at least its
+     * first min_size bytes, or nullptr if mapping is disabled, unsupported on
+     * this platform, or failed.
+     */
+    std::shared_ptr<const MappedBlockFile> MapBlockFile(int file_num, uint64_t min_size) const EXCLUSIVE_LOCKS_REQUIRED(!m_block_maps_mutex);
+    /** Drop the memory map of a block file that is about to be truncated or deleted */
+    void UnmapBlockFile(int file_num) const EXCLUSIVE_LOCKS_REQUIRED(!m_block_maps_mutex);
+
+    mutable Mutex m_raw_blocks_mutex;
+    /**
+     * Compressed blocks recently read by ReadRawBlock, converted back to the
+     * network serialization, least recently used first. A new block is
+     * typically requested by many peers at once, and is then only converted
+     * once.
+     */
+    mutable std::deque<std::pair<FlatFilePos, std::shared_ptr<const std::vector<std::byte>>>> m_raw_blocks GUARDED_BY(m_raw_blocks_mutex);
+
+    /**
+     * Serialized block or undo data as it is stored on disk (storage header,
+     * payload and, for undo data, its checksum), before obfuscation.
+     */
+    struct PendingWrite {
+        const bool undo;
+        //! Position of the storage header
+        const FlatFilePos pos;
+        const std::vector<unsigned char> data;
+    };
+    //! Key of a pending write in m_pending_writes: whether it is undo data, its file and payload position
+    using PendingWriteKey = std::tuple<bool, int, unsigned int>;
+
+    mutable Mutex m_write_mutex;
+    //! Signaled when a write is queued, or when the block writer thread should stop
+    std::condition_variable m_write_queued_cv;
+    //! Signaled when the block writer thread completes a write
+    mutable std::condition_variable m_write_done_cv;
+    //! Writes for the block writer thread, in the order they were queued
+    std::deque<std::shared_ptr<const PendingWrite>> m_write_queue GUARDED_BY(m_write_mutex);
+    //! Writes that are queued or in progress. Reads of their data are served from here.
+    std::map<PendingWriteKey, std::shared_ptr<const PendingWrite>> m_pending_writes GUARDED_BY(m_write_mutex);
+    size_t m_pending_write_bytes GUARDED_BY(m_write_mutex){0};
+    bool m_stop_writer GUARDED_BY(m_write_mutex){false};
+    //! Set for good once the block writer thread fails a write. The block
+    //! index may then refer to data that is not on disk, so it is no longer
+    //! persisted, and neither are the block and undo files flushed.
+    bool m_write_failed GUARDED_BY(m_write_mutex){false};
+    //! Writes block and undo data when m_opts.async_writes is set
+    std::thread m_block_writer;
+
+    /** Write block or undo data, on the calling thread. Returns false on failure. */
+    bool WriteToDisk(const PendingWrite& write) const;
+    /** Hand block or undo data to the block writer thread, waiting if too much data is pending already */
+    void QueueWrite(PendingWrite&& write) EXCLUSIVE_LOCKS_REQUIRED(!m_write_mutex);
+    /** Return the pending write of the block or undo data whose payload starts at pos, if any */
+    std::shared_ptr<const PendingWrite> GetPendingWrite(bool undo, const FlatFilePos& pos) const EXCLUSIVE_LOCKS_REQUIRED(!m_write_mutex);
+    void BlockWriterThread() EXCLUSIVE_LOCKS_REQUIRED(!m_write_mutex);
+
+    /**
+     * Read a block as it is stored, which is either the network serialization
+     * or, if compressed is set on return, the BlockCompression serialization.
+     * block_part only applies to the network serialization, and is ignored
+     * for compressed blocks.
+     */
+    util::Expected<std::vector<std::byte>, ReadRawError> ReadStoredBlock(const FlatFilePos& pos, bool& compressed, std::optional<std::pair<size_t, size_t>> block_part = std::nullopt) const;
+
     /**
      * Map from external index name to oldest block that must not be pruned.
      *
@@ -302,6 +447,12 @@ private:
     const FlatFileSeq m_block_file_seq;
     const FlatFileSeq m_undo_file_seq;
 
+    //! Recently read or written blocks and undo data
+    mutable BlockCache m_block_cache;
+
+    /** Read a block from disk, bypassing m_block_cache */
+    bool ReadBlockFromDisk(CBlock& block, const FlatFilePos& pos, const std::optional<uint256>& expected_hash, bool use_arena) const;
+
 protected:
     std::vector<CBlockFileInfo> m_blockfile_info;
 
@@ -316,6 +467,7 @@ public:
     using ReadRawBlockResult = util::Expected<std::vector<std::byte>, ReadRawError>;
 
     explicit BlockManager(const util::SignalInterrupt& interrupt, Options opts);
+    ~BlockManager();
 
     const util::SignalInterrupt& m_interrupt;
     std::atomic<bool> m_importing{false};
@@ -354,7 +506,39 @@ public:
 
     std::unique_ptr<BlockTreeDB> m_block_tree_db GUARDED_BY(::cs_main);
 
-    void WriteBlockIndexDB() EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
+    //! Persisted RandomX PoW verdicts; null if disabled with -persistpowverdicts=0.
+    std::unique_ptr<PowVerdictDB> m_pow_verdict_db GUARDED_BY(::cs_main);
+
+    //! Verdicts not yet written to m_pow_verdict_db (written by WriteBlockIndexDB,
+    //! or once MAX_PENDING_POW_VERDICTS have accumulated).
+    std::vector<PowVerdict> m_pending_pow_verdicts GUARDED_BY(::cs_main);
+
+    //! Verdicts of headers below this height have been pruned, and are not added again.
+    int m_pow_verdicts_pruned_height GUARDED_BY(::cs_main){0};
+
+    /** Whether the header with this hash and height is known to pass its RandomX PoW check under seed_hash. */
+    bool HasPowVerdict(const uint256& block_hash, const uint256& seed_hash, int height) EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
+
+    /** Record that the header with this hash and height passed its RandomX
+     *  PoW check under seed_hash. Only call this after actually hashing it, as
+     *  every call ends up as a database write. */
+    void AddPowVerdict(const uint256& block_hash, const uint256& seed_hash, int height) EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
+
+    /** Forget the verdicts of headers below height, so that the verdicts
+     *  database does not grow by an entry per header forever. */
+    void PrunePowVerdicts(int height) EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
+
+    /** Return false, without writing anything, if a block or undo write of
+     *  the block writer thread failed. */
+    [[nodiscard]] bool WriteBlockIndexDB() EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
+
+    /**
+     * If enabled, write the block index to a flat image for the next startup
+     * to load instead of the block tree db. The image is only used as long as
+     * the db is not written to again, so call this on shutdown, after the last
+     * WriteBlockIndexDB().
+     */
+    void WriteBlockIndexImage() EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
     bool LoadBlockIndexDB(const std::optional<uint256>& snapshot_blockhash)
         EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
 
@@ -464,16 +648,107 @@ public:
      */
     void UnlinkPrunedFiles(const std::set<int>& setFilesToPrune) const;
 
-    /** Functions for disk access for blocks */
-    bool ReadBlock(CBlock& block, const FlatFilePos& pos, const std::optional<uint256>& expected_hash) const;
-    bool ReadBlock(CBlock& block, const CBlockIndex& index) const;
-    ReadRawBlockResult ReadRawBlock(const FlatFilePos& pos, std::optional<std::pair<size_t, size_t>> block_part = std::nullopt) const;
+    /**
+     * Functions for disk access for blocks. With use_arena, the transactions
+     * are allocated together (see UnserializeBlockInArena), which is cheaper
+     * for callers that discard the block after looking at it.
+     *
+     * Blocks and undo data read by hash are served from the block cache when
+     * possible, and added to it otherwise. use_arena reads are not added, so
+     * that scanning the chain does not evict the recent blocks.
+     */
+    bool ReadBlock(CBlock& block, const FlatFilePos& pos, const std::optional<uint256>& expected_hash, bool use_arena = false) const;
+    bool ReadBlock(CBlock& block, const CBlockIndex& index, bool use_arena = false) const;
+    /** Read a block, sharing its transactions with the block cache instead of copying them. Returns nullptr on failure. */
+    std::shared_ptr<const CBlock> ReadBlock(const FlatFilePos& pos, const uint256& hash) const;
+    std::shared_ptr<const CBlock> ReadBlock(const CBlockIndex& index) const;
+    /**
+     * Read a block in the network serialization, or the given part of it.
+     * Uncompressed blocks are copied from disk as they are. Compressed ones
+     * (see -compressblocks) have to be decoded and serialized again as a
+     * whole, which costs about as much as deserializing the block. The
+     * MAX_RAW_BLOCKS_CACHED most recent of those are kept for later reads.
+     */
+    ReadRawBlockResult ReadRawBlock(const FlatFilePos& pos, std::optional<std::pair<size_t, size_t>> block_part = std::nullopt) const EXCLUSIVE_LOCKS_REQUIRED(!m_raw_blocks_mutex);
 
     bool ReadBlockUndo(CBlockUndo& blockundo, const CBlockIndex& index) const;
 
+    BlockCache::Stats GetBlockCacheStats() const { return m_block_cache.GetStats(); }
+
+    /**
+     * Wait until the block writer thread has written all data queued so far,
+     * or only that of the given file number. Return false if any write of the
+     * block writer thread has failed, even one to another file.
+     */
+    [[nodiscard]] bool WaitForPendingWrites(std::optional<int> file_num = std::nullopt) const EXCLUSIVE_LOCKS_REQUIRED(!m_write_mutex);
+
     void CleanupBlockRevFiles() const;
 };
 
+/**
+ * Verifies the RandomX proof of work of the blocks in the block files ahead
+ * of -reindex, on a background thread and spread over parallel RandomX VMs.
+ * Valid verdicts go into the PoW cache, so LoadExternalBlockFile, which
+ * accepts the blocks one by one in file order, does not hash them again.
+ *
+ * The seed hash of a block depends on its ancestors, so the scanner keeps
+ * the headers it has seen to place later ones in the chain before they are
+ * in the block index. A header whose parent comes later in the files waits
+ * for it until the end of the next batch. Blocks it still cannot place are
+ * left to LoadExternalBlockFile. A misplaced block only costs a cache miss,
+ * as verdicts commit to the seed hash they were checked with.
+ */
+class ReindexPowPrefetcher
+{
+    //! Headers verified per batch
+    static constexpr size_t BATCH_SIZE{1024};
+    //! How far ahead of the best header the scanner may run, so that its
+    //! verdicts are not evicted from the PoW cache before they are used
+    static constexpr int MAX_LOOKAHEAD{50'000};
+
+    struct ScannedHeader {
+        uint256 prev;
+        int height;
+        uint256 seed;
+    };
+
+    struct PendingHeader {
+        CBlockHeader header;
+        uint256 hash;
+        //! Whether it was carried over from the previous batch
+        bool carried;
+    };
+
+    ChainstateManager& m_chainman;
+    const int m_total_files;
+    const unsigned int m_lanes;
+    std::atomic<bool> m_stop{false};
+    //! Headers scanned recently, by hash
+    std::unordered_map<uint256, ScannedHeader, BlockHasher> m_headers;
+    int m_max_height{-1};
+    std::vector<CBlockHeader> m_batch;
+    //! Headers of the previous batch that could not be placed yet
+    std::vector<PendingHeader> m_unplaced;
+    std::thread m_thread;
+
+    //! Hash of the ancestor at the given height of a scanned header
+    std::optional<uint256> FindAncestor(uint256 hash, int height) EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
+    //! Place a header in the chain and return its seed hash, or nullopt if
+    //! its parent or seed block is not known yet
+    std::optional<uint256> PlaceHeader(const CBlockHeader& header, const uint256& hash) EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
+    void VerifyBatch();
+    void ScanFile(int file_num);
+    void WaitForBestHeader();
+
+public:
+    ReindexPowPrefetcher(ChainstateManager& chainman, int total_files);
+    //! Stops scanning early
+    ~ReindexPowPrefetcher();
+
+    //! Wait until all block files have been scanned
+    void Wait();
+};
+
 // Calls ActivateBestChain() even if no blocks are imported.
 void ImportBlocks(ChainstateManager& chainman, std::span<const fs::path> import_paths);
 } // namespace node
@@ -6,7 +6,9 @@
 
 #include <common/args.h>
 #include <common/system.h>
+#include <index/addrindex.h>
 #include <index/txindex.h>
+#include <index/txospenderindex.h>
 #include <kernel/caches.h>
 #include <logging.h>
 #include <node/interface_ui.h>
@@ -20,6 +22,10 @@
 // a meaningful difference: https://github.com/bitcoin/bitcoin/pull/8273#issuecomment-229601991
 //! Max memory allocated to tx index DB specific cache in bytes.
 static constexpr size_t MAX_TX_INDEX_CACHE{1024_MiB};
+//! Max memory allocated to address index DB specific cache in bytes.
+static constexpr size_t MAX_ADDR_INDEX_CACHE{1024_MiB};
+//! Max memory allocated to spent output index DB specific cache in bytes.
+static constexpr size_t MAX_TXOSPENDER_INDEX_CACHE{1024_MiB};
 //! Max memory allocated to all block filter index caches combined in bytes.
 static constexpr size_t MAX_FILTER_INDEX_CACHE{1024_MiB};
 //! Maximum dbcache size on 32-bit systems.
@@ -44,6 +50,10 @@ CacheSizes CalculateCacheSizes(const ArgsManager& args, size_t n_indexes)
     IndexCacheSizes index_sizes;
     index_sizes.tx_index = std::min(total_cache / 8, args.GetBoolArg("-txindex", DEFAULT_TXINDEX) ? MAX_TX_INDEX_CACHE : 0);
     total_cache -= index_sizes.tx_index;
+    index_sizes.addr_index = std::min(total_cache / 8, args.GetBoolArg("-addrindex", DEFAULT_ADDRINDEX) ? MAX_ADDR_INDEX_CACHE : 0);
+    total_cache -= index_sizes.addr_index;
+    index_sizes.txospender_index = std::min(total_cache / 8, args.GetBoolArg("-txospenderindex", DEFAULT_TXOSPENDERINDEX) ? MAX_TXOSPENDER_INDEX_CACHE : 0);
+    total_cache -= index_sizes.txospender_index;
     if (n_indexes > 0) {
         size_t max_cache = std::min(total_cache / 8, MAX_FILTER_INDEX_CACHE);
         index_sizes.filter_index = max_cache / n_indexes;
@@ -14,5 +14,10 @@ void ReadDatabaseArgs(const ArgsManager& args, DBOptions& options)
     // databases), but it'd be easy to parse database-specific options by adding
     // a database_type string or enum parameter to this function.
     if (auto value = args.GetBoolArg("-forcecompactdb")) options.force_compact = *value;
+    // Validated in AppInitParameterInteraction.
+    if (auto value = args.GetArg("-dbengine")) {
+        if (auto engine = DBEngineFromString(*value)) options.engine = *engine;
+    }
+    if (auto value = args.GetBoolArg("-migratedb")) options.migrate = *value;
 }
 } // namespace node
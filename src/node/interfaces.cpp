@@ -583,6 +583,34 @@ public:
         if (index == nullptr || !block_filter_index->LookupFilter(index, filter)) return std::nullopt;
         return filter.GetFilter().MatchAny(filter_set);
     }
+    std::vector<std::pair<uint256, bool>> blockFiltersMatchAny(BlockFilterType filter_type, const uint256& start_block, int count, const GCSFilter::ElementSet& filter_set) override
+    {
+        const BlockFilterIndex* block_filter_index{GetBlockFilterIndex(filter_type)};
+        if (!block_filter_index || count < 1) return {};
+
+        // Do not ask for the filters of blocks the index has not reached yet
+        const int index_height{block_filter_index->GetSummary().best_block_height};
+        const CBlockIndex* start_index;
+        const CBlockIndex* stop_index;
+        {
+            LOCK(::cs_main);
+            const CChain& active{chainman().ActiveChain()};
+            start_index = chainman().m_blockman.LookupBlockIndex(start_block);
+            if (!start_index || !active.Contains(start_index) || start_index->nHeight > index_height) return {};
+            stop_index = active[std::min({start_index->nHeight + count - 1, active.Height(), index_height})];
+        }
+        std::vector<BlockFilter> filters;
+        if (!block_filter_index->LookupFilterRange(start_index->nHeight, stop_index, filters)) return {};
+
+        const int num_threads{std::max(1, std::clamp(chainman().m_options.worker_threads_num, 0, MAX_SCRIPTCHECK_THREADS))};
+        const std::vector<bool> matches{MatchAnyBlockFilters(filters, filter_set, num_threads)};
+        std::vector<std::pair<uint256, bool>> result;
+        result.reserve(filters.size());
+        for (size_t i = 0; i < filters.size(); ++i) {
+            result.emplace_back(filters[i].GetBlockHash(), matches[i]);
+        }
+        return result;
+    }
     bool findBlock(const uint256& hash, const FoundBlock& block) override
     {
         WAIT_LOCK(cs_main, lock);
@@ -0,0 +1,125 @@
+// Copyright (c) 2026-present The Botcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <node/validation_cache_persist.h>
+
+#include <common/args.h>
+#include <logging.h>
+#include <random.h>
+#include <script/sigcache.h>
+#include <serialize.h>
+#include <streams.h>
+#include <uint256.h>
+#include <util/fs.h>
+#include <util/fs_helpers.h>
+#include <util/obfuscation.h>
+#include <util/syserror.h>
+#include <util/time.h>
+#include <validation.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+using fsbridge::FopenFn;
+
+namespace node {
+
+static const uint64_t VALIDATION_CACHE_DUMP_VERSION{2};
+
+bool ShouldPersistValidationCache(const ArgsManager& argsman)
+{
+    return argsman.GetBoolArg("-persistvalidationcache", DEFAULT_PERSIST_VALIDATION_CACHE);
+}
+
+fs::path ValidationCachePath(const ArgsManager& argsman)
+{
+    return argsman.GetDataDirNet() / "validationcache.dat";
+}
+
+bool LoadValidationCache(ValidationCache& validation_cache, const fs::path& load_path, FopenFn mockable_fopen_function)
+{
+    AutoFile file{mockable_fopen_function(load_path, "rb")};
+    if (file.IsNull()) {
+        LogInfo("Failed to open validation cache file. Continuing anyway.");
+        return false;
+    }
+
+    uint256 signature_nonce;
+    std::vector<uint256> signature_entries;
+    try {
+        uint64_t version;
+        file >> version;
+        if (version != VALIDATION_CACHE_DUMP_VERSION) {
+            return false;
+        }
+        Obfuscation obfuscation;
+        file >> obfuscation;
+        file.SetObfuscation(obfuscation);
+
+        file >> signature_nonce >> signature_entries;
+    } catch (const std::exception& e) {
+        LogInfo("Failed to deserialize validation cache data on file: %s. Continuing anyway.", e.what());
+        return false;
+    }
+
+    validation_cache.m_signature_cache.Restore(signature_nonce, signature_entries);
+
+    LogInfo("Imported validation cache from file: %u signature cache entries", signature_entries.size());
+    return true;
+}
+
+bool DumpValidationCache(ValidationCache& validation_cache, const fs::path& dump_path, FopenFn mockable_fopen_function, bool skip_file_commit)
+{
+    auto start = SteadyClock::now();
+
+    auto [signature_nonce, signature_entries]{validation_cache.m_signature_cache.GetEntries()};
+
+    auto mid = SteadyClock::now();
+
+    const fs::path file_fspath{dump_path + ".new"};
+    AutoFile file{mockable_fopen_function(file_fspath, "wb")};
+    if (file.IsNull()) {
+        return false;
+    }
+
+    try {
+        file << VALIDATION_CACHE_DUMP_VERSION;
+
+        const Obfuscation obfuscation{FastRandomContext{}.randbytes<Obfuscation::KEY_SIZE>()};
+        file << obfuscation;
+        file.SetObfuscation(obfuscation);
+
+        LogInfo("Writing %u signature cache entries to file...", signature_entries.size());
+        file << signature_nonce << signature_entries;
+
+        if (!skip_file_commit && !file.Commit()) {
+            (void)file.fclose();
+            throw std::runtime_error("Commit failed");
+        }
+        if (file.fclose() != 0) {
+            throw std::runtime_error(
+                strprintf("Error closing %s: %s", fs::PathToString(file_fspath), SysErrorString(errno)));
+        }
+        if (!RenameOver(dump_path + ".new", dump_path)) {
+            throw std::runtime_error("Rename failed");
+        }
+        auto last = SteadyClock::now();
+
+        LogInfo("Dumped validation cache: %.3fs to copy, %.3fs to dump, %d bytes dumped to file",
+                Ticks<SecondsDouble>(mid - start),
+                Ticks<SecondsDouble>(last - mid),
+                fs::file_size(dump_path));
+    } catch (const std::exception& e) {
+        LogInfo("Failed to dump validation cache: %s. Continuing anyway.", e.what());
+        (void)file.fclose();
+        return false;
+    }
+    return true;
+}
+
+} // namespace node
@@ -0,0 +1,41 @@
+// Copyright (c) 2026-present The Botcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_NODE_VALIDATION_CACHE_PERSIST_H
+#define BITCOIN_NODE_VALIDATION_CACHE_PERSIST_H
+
+#include <util/fs.h>
+
+class ArgsManager;
+class ValidationCache;
+
+namespace node {
+
+/**
+ * Default for -persistvalidationcache, indicating whether the node should
+ * save the signature cache on shutdown and load it on start
+ */
+static constexpr bool DEFAULT_PERSIST_VALIDATION_CACHE{false};
+
+bool ShouldPersistValidationCache(const ArgsManager& argsman);
+fs::path ValidationCachePath(const ArgsManager& argsman);
+
+/** Dump the signature cache, including the nonce its entries are salted
+ *  with, to a file. The script execution cache is not dumped: each of its
+ *  entries skips all script checks of a transaction, which is too much to
+ *  trust to a file. */
+bool DumpValidationCache(ValidationCache& validation_cache, const fs::path& dump_path,
+                         fsbridge::FopenFn mockable_fopen_function = fsbridge::fopen,
+                         bool skip_file_commit = false);
+
+/** Restore the signature cache from a file written by DumpValidationCache().
+ *  The restored entries are only looked up; the cache keeps the fresh nonce
+ *  it was created with for new ones. Must be called before the cache is
+ *  used. */
+bool LoadValidationCache(ValidationCache& validation_cache, const fs::path& load_path,
+                         fsbridge::FopenFn mockable_fopen_function = fsbridge::fopen);
+
+} // namespace node
+
+#endif // BITCOIN_NODE_VALIDATION_CACHE_PERSIST_H
@@ -256,34 +256,51 @@ uint256 GetBlockPoWHash(const CBlockHeader& header, const uint256& seed_hash)
     return RandomXHash(MakeUCharSpan(ss), seed_hash);
 }
 
-bool CheckBlockProofOfWork(const CBlockHeader& header, const CBlockIndex* pindexPrev, const Consensus::Params& params)
+uint256 GetNextRandomXSeedHash(const CBlockIndex* pindexPrev)
 {
-    // Get the seed hash for this block's epoch
     // If pindexPrev is null, we're checking genesis (use genesis seed)
-    uint256 seed_hash;
-    if (pindexPrev) {
-        // Get seed hash based on the block height we're validating (pindexPrev->nHeight + 1)
-        uint64_t block_height = static_cast<uint64_t>(pindexPrev->nHeight + 1);
-        uint64_t seed_height = GetRandomXSeedHeight(block_height);
-
-        if (seed_height == 0) {
-            seed_hash = Hash(std::string("Botcoin Genesis Seed"));
-        } else {
-            const CBlockIndex* seed_block = pindexPrev;
-            while (seed_block && seed_block->nHeight > static_cast<int>(seed_height)) {
-                seed_block = seed_block->pprev;
-            }
-            if (seed_block && seed_block->nHeight == static_cast<int>(seed_height)) {
-                seed_hash = seed_block->GetBlockHash();
-            } else {
-                seed_hash = Hash(std::string("Botcoin Genesis Seed"));
-            }
-        }
-    } else {
-        // Genesis block
-        seed_hash = Hash(std::string("Botcoin Genesis Seed"));
+    if (!pindexPrev) {
+        return Hash(std::string("Botcoin Genesis Seed"));
     }
 
+    // Get seed hash based on the block height we're validating (pindexPrev->nHeight + 1)
+    uint64_t block_height = static_cast<uint64_t>(pindexPrev->nHeight + 1);
+    uint64_t seed_height = GetRandomXSeedHeight(block_height);
+
+    if (seed_height == 0) {
+        return Hash(std::string("Botcoin Genesis Seed"));
+    }
+
+    const CBlockIndex* seed_block = pindexPrev;
+    while (seed_block && seed_block->nHeight > static_cast<int>(seed_height)) {
+        seed_block = seed_block->pprev;
+    }
+    if (seed_block && seed_block->nHeight == static_cast<int>(seed_height)) {
+        return seed_block->GetBlockHash();
+    }
+    return Hash(std::string("Botcoin Genesis Seed"));
+}
+
+std::vector<uint256> GetBlockPoWHashes(std::span<const CBlockHeader> headers, const uint256& seed_hash, unsigned int lanes)
+{
+    // Serialize all headers up front so the RandomX lanes only hash
+    std::vector<std::vector<unsigned char>> serialized;
+    serialized.reserve(headers.size());
+    for (const CBlockHeader& header : headers) {
+        DataStream ss{};
+        ss << header;
+        const auto bytes{MakeUCharSpan(ss)};
+        serialized.emplace_back(bytes.begin(), bytes.end());
+    }
+
+    return RandomXHashBatch(serialized, seed_hash, lanes);
+}
+
+bool CheckBlockProofOfWork(const CBlockHeader& header, const CBlockIndex* pindexPrev, const Consensus::Params& params)
+{
+    // Get the seed hash for this block's epoch
+    const uint256 seed_hash{GetNextRandomXSeedHash(pindexPrev)};
+
     // Compute RandomX PoW hash
     uint256 pow_hash = GetBlockPoWHash(header, seed_hash);
 
@@ -9,6 +9,8 @@
 #include <consensus/params.h>
 
 #include <cstdint>
+#include <span>
+#include <vector>
 
 class CBlockHeader;
 class CBlockIndex;
@@ -43,6 +45,15 @@ bool CheckProofOfWorkImpl(uint256 hash, unsigned int nBits, const Consensus::Par
  */
 uint256 GetRandomXSeedHash(const CBlockIndex* pindex);
 
+/**
+ * Get the RandomX seed hash for a block building on top of pindexPrev.
+ * If pindexPrev is null, the block is the genesis block and uses the genesis seed.
+ *
+ * @param pindexPrev Parent of the block to get the seed hash for
+ * @return           The seed hash for RandomX
+ */
+uint256 GetNextRandomXSeedHash(const CBlockIndex* pindexPrev);
+
 /**
  * Compute the RandomX PoW hash for a block header.
  *
@@ -52,6 +63,17 @@ uint256 GetRandomXSeedHash(const CBlockIndex* pindex);
  */
 uint256 GetBlockPoWHash(const CBlockHeader& header, const uint256& seed_hash);
 
+/**
+ * Compute the RandomX PoW hashes for a batch of block headers sharing one
+ * seed, spread over up to `lanes` parallel RandomX VMs.
+ *
+ * @param headers     The block headers to hash
+ * @param seed_hash   The seed hash for these blocks' epoch
+ * @param lanes       Maximum number of headers hashed in parallel
+ * @return            The RandomX hashes, in the same order as headers
+ */
+std::vector<uint256> GetBlockPoWHashes(std::span<const CBlockHeader> headers, const uint256& seed_hash, unsigned int lanes);
+
 /**
  * Check whether a block satisfies the RandomX proof-of-work requirement.
  * This is the main PoW validation function for Botcoin.
@@ -0,0 +1,45 @@
+// Copyright (c) 2026-present The Botcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <powcache.h>
+
+#include <logging.h>
+#include <random.h>
+
+#include <mutex>
+#include <shared_mutex>
+
+PowCache::PowCache(const size_t max_size_bytes)
+{
+    // Pad the nonce to 64 bytes, like SignatureCache, so the salted prefix
+    // fills a whole SHA256 block and later entries only hash their own data.
+    static constexpr unsigned char PADDING_POW[32] = {'P'};
+    const uint256 nonce{GetRandHash()};
+    m_salted_hasher.Write(nonce.begin(), 32);
+    m_salted_hasher.Write(PADDING_POW, 32);
+
+    const auto [num_elems, approx_size_bytes] = m_valid.setup_bytes(max_size_bytes);
+    LogInfo("Using %zu MiB out of %zu MiB requested for proof-of-work cache, able to store %zu elements",
+            approx_size_bytes >> 20, max_size_bytes >> 20, num_elems);
+}
+
+uint256 PowCache::ComputeEntry(const uint256& block_hash, const uint256& seed_hash) const
+{
+    uint256 entry;
+    CSHA256 hasher = m_salted_hasher;
+    hasher.Write(block_hash.begin(), 32).Write(seed_hash.begin(), 32).Finalize(entry.begin());
+    return entry;
+}
+
+bool PowCache::Get(const uint256& entry)
+{
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    return m_valid.contains(entry, /*erase=*/false);
+}
+
+void PowCache::Set(const uint256& entry)
+{
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+    m_valid.insert(entry);
+}
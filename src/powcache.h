@@ -0,0 +1,54 @@
+// Copyright (c) 2026-present The Botcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BOTCOIN_POWCACHE_H
+#define BOTCOIN_POWCACHE_H
+
+#include <crypto/sha256.h>
+#include <cuckoocache.h>
+#include <uint256.h>
+#include <util/hasher.h>
+
+#include <cstddef>
+#include <shared_mutex>
+
+// 8MiB holds roughly 250000 header verdicts. A headers sync reuses the PRESYNC
+// verdict of a header only while it is still cached, so once a sync covers
+// more headers than that, the oldest verdicts are evicted and those headers
+// are hashed again during REDOWNLOAD.
+static constexpr size_t DEFAULT_POW_CACHE_BYTES{8 << 20};
+
+/**
+ * Valid proof-of-work cache, to avoid computing the (expensive) RandomX hash
+ * of a block header more than once. Without it a header is hashed once during
+ * headers PRESYNC, again during REDOWNLOAD and a third time when it is
+ * accepted into the block index.
+ *
+ * Only positive verdicts are stored, and only after the RandomX hash has been
+ * checked against the header's own nBits target. Entries commit to both the
+ * block hash and the RandomX seed hash, so a verdict is never reused under a
+ * different epoch key.
+ */
+class PowCache
+{
+private:
+    //! Entries are SHA256(nonce || 'P' || 31 zero bytes || block hash || seed hash):
+    CSHA256 m_salted_hasher;
+    CuckooCache::cache<uint256, SignatureCacheHasher> m_valid;
+    std::shared_mutex m_mutex;
+
+public:
+    explicit PowCache(size_t max_size_bytes);
+
+    PowCache(const PowCache&) = delete;
+    PowCache& operator=(const PowCache&) = delete;
+
+    uint256 ComputeEntry(const uint256& block_hash, const uint256& seed_hash) const;
+
+    bool Get(const uint256& entry);
+
+    void Set(const uint256& entry);
+};
+
+#endif // BOTCOIN_POWCACHE_H
@@ -6,12 +6,16 @@
 #ifndef BITCOIN_PRIMITIVES_BLOCK_H
 #define BITCOIN_PRIMITIVES_BLOCK_H
 
+#include <consensus/consensus.h>
 #include <primitives/transaction.h>
 #include <serialize.h>
+#include <support/allocators/monotonic.h>
 #include <uint256.h>
 #include <util/time.h>
 
+#include <algorithm>
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -109,6 +113,35 @@ public:
     std::string ToString() const;
 };
 
+/**
+ * Deserialize a block with witness data, like `s >> TX_WITH_WITNESS(block)`,
+ * but allocate all of its transactions from a single MonotonicResource
+ * instead of with one make_shared each. The memory is released at once when
+ * the last of these transactions is destroyed.
+ *
+ * Only use this for blocks that are read, validated and discarded: a single
+ * transaction kept around (by the mempool, a wallet, ...) keeps the memory of
+ * all transactions of the block alive.
+ */
+template <typename Stream>
+void UnserializeBlockInArena(Stream& s, CBlock& block)
+{
+    // Bytes taken by each transaction, including the shared_ptr control block.
+    static constexpr size_t TX_ALLOC_BYTES{sizeof(CTransaction) + 64};
+    // Do not size the arena beyond what a valid block can hold.
+    static constexpr uint64_t MAX_BLOCK_TXS{MAX_BLOCK_WEIGHT / MIN_TRANSACTION_WEIGHT};
+
+    block.SetNull();
+    s >> static_cast<CBlockHeader&>(block);
+    const uint64_t tx_count{ReadCompactSize(s)};
+    const size_t expected_txs{static_cast<size_t>(std::clamp<uint64_t>(tx_count, 1, MAX_BLOCK_TXS))};
+    MonotonicAllocator<CTransaction> alloc{std::make_shared<MonotonicResource>(expected_txs * TX_ALLOC_BYTES)};
+    block.vtx.reserve(expected_txs);
+    for (uint64_t i = 0; i < tx_count; ++i) {
+        block.vtx.push_back(std::allocate_shared<const CTransaction>(alloc, deserialize, TX_WITH_WITNESS, s));
+    }
+}
+
 /** Describes a place in the block chain to another node such that if the
  * other node doesn't have the same branch, it can find a recent common trunk.
  * The further back it is, the further before the fork it may be.
@@ -6,6 +6,7 @@
 #include <pubkey.h>
 
 #include <hash.h>
+#include <schnorrsig_batch/schnorrsig_batch.h>
 #include <secp256k1.h>
 #include <secp256k1_ellswift.h>
 #include <secp256k1_extrakeys.h>
@@ -241,6 +242,36 @@ bool XOnlyPubKey::VerifySchnorr(const uint256& msg, std::span<const unsigned cha
     return secp256k1_schnorrsig_verify(secp256k1_context_static, sigbytes.data(), msg.begin(), 32, &pubkey);
 }
 
+SchnorrSignatureBatch::~SchnorrSignatureBatch()
+{
+    schnorrsig_batch_destroy(m_batch);
+}
+
+bool SchnorrSignatureBatch::Add(const XOnlyPubKey& pubkey, const uint256& msg, std::span<const unsigned char> sigbytes)
+{
+    assert(sigbytes.size() == 64);
+    if (!m_batch) {
+        m_batch = schnorrsig_batch_create(MAX_SIGS, m_seed.begin());
+        assert(m_batch);
+    }
+    if (!schnorrsig_batch_add(m_batch, sigbytes.data(), msg.begin(), 32, pubkey.data())) {
+        m_failed = true;
+        return false;
+    }
+    return true;
+}
+
+bool SchnorrSignatureBatch::Verify()
+{
+    const bool valid{!m_failed && (!m_batch || schnorrsig_batch_verify(m_batch))};
+    if (m_failed && m_batch) {
+        // Empty the batch.
+        (void)schnorrsig_batch_verify(m_batch);
+    }
+    m_failed = false;
+    return valid;
+}
+
 static const HashWriter HASHER_TAPTWEAK{TaggedHash("TapTweak")};
 
 uint256 XOnlyPubKey::ComputeTapTweakHash(const uint256* merkle_root) const
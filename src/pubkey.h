@@ -16,6 +16,8 @@
 #include <optional>
 #include <vector>
 
+struct schnorrsig_batch_struct;
+
 const unsigned int BIP32_EXTKEY_SIZE = 74;
 const unsigned int BIP32_EXTKEY_WITH_VERSION_SIZE = 78;
 
@@ -304,6 +306,36 @@ public:
     SERIALIZE_METHODS(XOnlyPubKey, obj) { READWRITE(obj.m_keydata); }
 };
 
+/** Verifier of BIP340 signatures that checks many of them at once, which takes
+ *  considerably less time than checking them one at a time. */
+class SchnorrSignatureBatch
+{
+public:
+    //! Number of signatures held before they are checked to make room for more
+    static constexpr size_t MAX_SIGS{128};
+
+    /** seed must be secret and random. Memory for the signatures is only
+     *  allocated once the first one is added. */
+    explicit SchnorrSignatureBatch(const uint256& seed) : m_seed{seed} {}
+    ~SchnorrSignatureBatch();
+
+    SchnorrSignatureBatch(const SchnorrSignatureBatch&) = delete;
+    SchnorrSignatureBatch& operator=(const SchnorrSignatureBatch&) = delete;
+
+    /** Add a signature of msg by pubkey. sigbytes must be exactly 64 bytes.
+     *  Returns false if the signature is invalid regardless of the others. */
+    bool Add(const XOnlyPubKey& pubkey, const uint256& msg, std::span<const unsigned char> sigbytes);
+
+    /** Whether all signatures added since the last call are valid. Empties
+     *  the batch. */
+    bool Verify();
+
+private:
+    const uint256 m_seed;
+    schnorrsig_batch_struct* m_batch{nullptr};
+    bool m_failed{false};
+};
+
 /** An ElligatorSwift-encoded public key. */
 struct EllSwiftPubKey
 {
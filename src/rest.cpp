@@ -42,6 +42,8 @@ using util::SplitString;
 
 static const size_t MAX_GETUTXOS_OUTPOINTS = 15; //allow a max of 15 outpoints to be queried at once
 static constexpr unsigned int MAX_REST_HEADERS_RESULTS = 2000;
+//! Maximum number of outpoints in a txospenders request; the URI length bounds it anyway.
+static constexpr size_t MAX_REST_TXOSPENDERS_OUTPOINTS{100};
 
 static const struct {
     RESTResponseFormat rf;
@@ -779,6 +781,122 @@ static bool rest_deploymentinfo(const std::any& context, HTTPRequest* req, const
 
 }
 
+/**
+ * Reply with the result of an RPC method, or with the error it throws: a
+ * server error for RPC_INTERNAL_ERROR and a bad request for anything else.
+ */
+static bool RESTReplyRPC(HTTPRequest* req, const RPCHelpMan& rpc, const JSONRPCRequest& request)
+{
+    UniValue result;
+    try {
+        result = rpc.HandleRequest(request);
+    } catch (const UniValue& error) {
+        const bool internal{error.find_value("code").getInt<int>() == RPC_INTERNAL_ERROR};
+        return RESTERR(req, internal ? HTTP_INTERNAL_SERVER_ERROR : HTTP_BAD_REQUEST, error.find_value("message").get_str());
+    }
+    req->WriteHeader("Content-Type", "application/json");
+    req->WriteReply(HTTP_OK, result.write() + "\n");
+    return true;
+}
+
+RPCHelpMan getaddresshistory();
+RPCHelpMan getaddressbalance();
+
+/** Serve getaddresshistory (with the start_height, end_height, count and cursor query parameters) or getaddressbalance. */
+static bool rest_address(const std::any& context, HTTPRequest* req, const std::string& uri_part, bool history)
+{
+    if (!CheckWarmup(req)) return false;
+
+    std::string address;
+    const RESTResponseFormat rf = ParseDataFormat(address, uri_part);
+    if (address.empty() || address.find('/') != std::string::npos) {
+        return RESTERR(req, HTTP_BAD_REQUEST, strprintf("Invalid URI format. Expected /rest/%s/<address>.json", history ? "addresshistory" : "addressbalance"));
+    }
+
+    switch (rf) {
+    case RESTResponseFormat::JSON: {
+        JSONRPCRequest jsonRequest;
+        jsonRequest.context = context;
+        jsonRequest.params = UniValue(UniValue::VARR);
+        jsonRequest.params.push_back(address);
+        if (history) {
+            try {
+                for (const char* name : {"start_height", "end_height", "count"}) {
+                    const auto raw{req->GetQueryParameter(name)};
+                    if (!raw) {
+                        jsonRequest.params.push_back(UniValue{});
+                        continue;
+                    }
+                    const auto value{ToIntegral<int>(*raw)};
+                    if (!value) return RESTERR(req, HTTP_BAD_REQUEST, strprintf("Invalid %s: %s", name, *raw));
+                    jsonRequest.params.push_back(*value);
+                }
+                if (const auto cursor{req->GetQueryParameter("cursor")}) jsonRequest.params.push_back(*cursor);
+            } catch (const std::runtime_error& e) {
+                return RESTERR(req, HTTP_BAD_REQUEST, e.what());
+            }
+        }
+
+        return RESTReplyRPC(req, history ? getaddresshistory() : getaddressbalance(), jsonRequest);
+    }
+    default: {
+        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: json)");
+    }
+    }
+}
+
+static bool rest_address_history(const std::any& context, HTTPRequest* req, const std::string& uri_part)
+{
+    return rest_address(context, req, uri_part, /*history=*/true);
+}
+
+static bool rest_address_balance(const std::any& context, HTTPRequest* req, const std::string& uri_part)
+{
+    return rest_address(context, req, uri_part, /*history=*/false);
+}
+
+RPCHelpMan gettxspendingprevout();
+
+static bool rest_txospenders(const std::any& context, HTTPRequest* req, const std::string& uri_part)
+{
+    if (!CheckWarmup(req)) return false;
+
+    std::string param;
+    const RESTResponseFormat rf = ParseDataFormat(param, uri_part);
+    const std::vector<std::string> uri_parts{SplitString(param, '/')};
+    if (param.empty() || uri_parts.size() > MAX_REST_TXOSPENDERS_OUTPOINTS) {
+        return RESTERR(req, HTTP_BAD_REQUEST, strprintf("Invalid URI format. Expected /rest/txospenders/<txid>-<n>/<txid>-<n>/.../.json with 1 to %u outpoints", MAX_REST_TXOSPENDERS_OUTPOINTS));
+    }
+
+    switch (rf) {
+    case RESTResponseFormat::JSON: {
+        UniValue outputs(UniValue::VARR);
+        for (const auto& part : uri_parts) {
+            const auto txid_out{util::Split<std::string_view>(part, '-')};
+            const auto txid{txid_out.size() == 2 ? Txid::FromHex(txid_out[0]) : std::nullopt};
+            const auto output{txid_out.size() == 2 ? ToIntegral<uint32_t>(txid_out[1]) : std::nullopt};
+            if (!txid || !output) {
+                return RESTERR(req, HTTP_BAD_REQUEST, "Parse error");
+            }
+            UniValue outpoint(UniValue::VOBJ);
+            outpoint.pushKV("txid", txid->GetHex());
+            outpoint.pushKV("vout", *output);
+            outputs.push_back(std::move(outpoint));
+        }
+
+        JSONRPCRequest jsonRequest;
+        jsonRequest.context = context;
+        jsonRequest.params = UniValue(UniValue::VARR);
+        jsonRequest.params.push_back(std::move(outputs));
+
+        return RESTReplyRPC(req, gettxspendingprevout(), jsonRequest);
+    }
+    default: {
+        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: json)");
+    }
+    }
+}
+
 static bool rest_mempool(const std::any& context, HTTPRequest* req, const std::string& str_uri_part)
 {
     if (!CheckWarmup(req))
@@ -1156,6 +1274,9 @@ static const struct {
     {"/rest/deploymentinfo", rest_deploymentinfo},
     {"/rest/blockhashbyheight/", rest_blockhash_by_height},
     {"/rest/spenttxouts/", rest_spent_txouts},
+    {"/rest/addresshistory/", rest_address_history},
+    {"/rest/addressbalance/", rest_address_balance},
+    {"/rest/txospenders/", rest_txospenders},
 };
 
 void StartREST(const std::any& context)
@@ -5,6 +5,7 @@
 
 #include <rpc/blockchain.h>
 
+#include <addresstype.h>
 #include <blockfilter.h>
 #include <chain.h>
 #include <chainparams.h>
@@ -16,13 +17,16 @@
 #include <consensus/params.h>
 #include <consensus/validation.h>
 #include <core_io.h>
+#include <dbwrapper.h>
 #include <deploymentinfo.h>
 #include <deploymentstatus.h>
 #include <flatfile.h>
 #include <hash.h>
+#include <index/addrindex.h>
 #include <index/blockfilterindex.h>
 #include <index/coinstatsindex.h>
 #include <interfaces/mining.h>
+#include <key_io.h>
 #include <kernel/coinstats.h>
 #include <logging/timer.h>
 #include <net.h>
@@ -48,7 +52,9 @@
 #include <util/check.h>
 #include <util/fs.h>
 #include <util/strencodings.h>
+#include <util/string.h>
 #include <util/syserror.h>
+#include <util/threadnames.h>
 #include <util/translation.h>
 #include <validation.h>
 #include <validationinterface.h>
@@ -56,13 +62,17 @@
 
 #include <cstdint>
 
+#include <algorithm>
 #include <condition_variable>
 #include <iterator>
+#include <limits>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <optional>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <vector>
 
 using kernel::CCoinsStats;
@@ -75,16 +85,13 @@ using node::NodeContext;
 using node::SnapshotMetadata;
 using util::MakeUnorderedList;
 
-std::tuple<std::unique_ptr<CCoinsViewCursor>, CCoinsStats, const CBlockIndex*>
-PrepareUTXOSnapshot(
-    Chainstate& chainstate,
-    const std::function<void()>& interruption_point = {})
+std::pair<std::vector<std::unique_ptr<CCoinsViewCursor>>, const CBlockIndex*>
+PrepareUTXOSnapshot(Chainstate& chainstate)
     EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
 
 UniValue WriteUTXOSnapshot(
     Chainstate& chainstate,
-    CCoinsViewCursor* pcursor,
-    CCoinsStats* maybe_stats,
+    std::vector<std::unique_ptr<CCoinsViewCursor>> cursors,
     const CBlockIndex* tip,
     AutoFile&& afile,
     const fs::path& path,
@@ -669,7 +676,7 @@ static CBlock GetBlockChecked(BlockManager& blockman, const CBlockIndex& blockin
         CheckBlockDataAvailability(blockman, blockindex, /*check_for_undo=*/false);
     }
 
-    if (!blockman.ReadBlock(block, blockindex)) {
+    if (!blockman.ReadBlock(block, blockindex, /*use_arena=*/true)) {
         // Block not found on disk. This shouldn't normally happen unless the block was
         // pruned right after we released the lock above.
         throw JSONRPCError(RPC_MISC_ERROR, "Block not found on disk");
@@ -2601,6 +2608,7 @@ static RPCHelpMan scanblocks()
         UniValue blocks(UniValue::VARR);
         const int amount_per_chunk = 10000;
         std::vector<BlockFilter> filters;
+        const int num_match_threads{std::max(1, std::clamp(chainman.m_options.worker_threads_num, 0, MAX_SCRIPTCHECK_THREADS))};
         int start_block_height = start_index->nHeight; // for progress reporting
         const int total_blocks_to_process = stop_block->nHeight - start_block_height;
 
@@ -2624,9 +2632,11 @@ static RPCHelpMan scanblocks()
                     stop_block;
 
             if (index->LookupFilterRange(start_block, end_range, filters)) {
-                for (const BlockFilter& filter : filters) {
-                    // compare the elements-set with each filter
-                    if (filter.GetFilter().MatchAny(needle_set)) {
+                // compare the elements-set with each filter
+                const std::vector<bool> matches{MatchAnyBlockFilters(filters, needle_set, num_match_threads)};
+                for (size_t i = 0; i < filters.size(); ++i) {
+                    const BlockFilter& filter{filters[i]};
+                    if (matches[i]) {
                         if (filter_false_positives) {
                             // Double check the filter matches by scanning the block
                             const CBlockIndex& blockindex = *CHECK_NONFATAL(WITH_LOCK(cs_main, return chainman.m_blockman.LookupBlockIndex(filter.GetBlockHash())));
@@ -2979,6 +2989,180 @@ static RPCHelpMan getblockfilter()
     };
 }
 
+//! Maximum number of outputs returned by one getaddresshistory call.
+static constexpr int MAX_ADDRESS_HISTORY_RESULTS{10000};
+
+/** Decode an address, or a hex-encoded scriptPubKey, to the script to look up in the address index. */
+static CScript ParseAddrIndexScript(const std::string& str)
+{
+    const CTxDestination dest{DecodeDestination(str)};
+    if (IsValidDestination(dest)) return GetScriptForDestination(dest);
+    if (IsHex(str)) {
+        const auto data{ParseHex(str)};
+        return CScript(data.begin(), data.end());
+    }
+    throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Invalid address or scriptPubKey: " + str);
+}
+
+static AddrIndex& EnsureSyncedAddrIndex()
+{
+    if (!g_addrindex) {
+        throw JSONRPCError(RPC_MISC_ERROR, "Address index not enabled. Use -addrindex to enable it.");
+    }
+    if (!g_addrindex->BlockUntilSyncedToCurrentChain()) {
+        throw JSONRPCError(RPC_MISC_ERROR, strprintf("Unable to get data because addrindex is still syncing. Current height: %d", g_addrindex->GetSummary().best_block_height));
+    }
+    return *g_addrindex;
+}
+
+RPCHelpMan getaddresshistory()
+{
+    return RPCHelpMan{
+        "getaddresshistory",
+        "Returns the outputs paying to an address or scriptPubKey, and the inputs spending them, in chain order.\n"
+        "Requires -addrindex. Results are paginated: pass the \"next\" value of a result as cursor to get the following outputs.\n",
+        {
+            {"address", RPCArg::Type::STR, RPCArg::Optional::NO, "The address, or hex-encoded scriptPubKey, to look up"},
+            {"start_height", RPCArg::Type::NUM, RPCArg::Default{0}, "Height of the first block whose outputs to return"},
+            {"end_height", RPCArg::Type::NUM, RPCArg::DefaultHint{"the height of the chain tip"}, "Height of the last block whose outputs to return"},
+            {"count", RPCArg::Type::NUM, RPCArg::Default{1000}, strprintf("Maximum number of outputs to return (1-%d)", MAX_ADDRESS_HISTORY_RESULTS)},
+            {"cursor", RPCArg::Type::STR, RPCArg::Optional::OMITTED, "The \"next\" value of the previous page of results"},
+        },
+        RPCResult{
+            RPCResult::Type::OBJ, "", "",
+            {
+                {RPCResult::Type::NUM, "height", "The height the address index is synced to"},
+                {RPCResult::Type::ARR, "outputs", "",
+                {
+                    {RPCResult::Type::OBJ, "", "",
+                    {
+                        {RPCResult::Type::NUM, "height", "The height of the block that created the output"},
+                        {RPCResult::Type::STR_HEX, "txid", "The id of the transaction that created the output"},
+                        {RPCResult::Type::NUM, "vout", "The index of the output"},
+                        {RPCResult::Type::STR_AMOUNT, "value", "The value in " + CURRENCY_UNIT},
+                        {RPCResult::Type::OBJ, "spent_by", /*optional=*/true, "The input spending the output, if spent",
+                        {
+                            {RPCResult::Type::STR_HEX, "txid", "The id of the spending transaction"},
+                            {RPCResult::Type::NUM, "vin", "The index of the spending input"},
+                            {RPCResult::Type::NUM, "height", "The height of the block that spent the output"},
+                        }},
+                    }},
+                }},
+                {RPCResult::Type::STR, "next", /*optional=*/true, "Cursor of the next page of results, if any"},
+            }},
+        RPCExamples{
+            HelpExampleCli("getaddresshistory", "\"" + EXAMPLE_ADDRESS[0] + "\"") +
+            HelpExampleCli("getaddresshistory", "\"" + EXAMPLE_ADDRESS[0] + "\" 100000 200000 100") +
+            HelpExampleRpc("getaddresshistory", "\"" + EXAMPLE_ADDRESS[0] + "\", 100000, 200000, 100")
+        },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    const CScript script{ParseAddrIndexScript(self.Arg<std::string>("address"))};
+    const int start_height{self.Arg<int>("start_height")};
+    const int end_height{self.MaybeArg<int>("end_height").value_or(std::numeric_limits<int>::max())};
+    const int count{self.Arg<int>("count")};
+    if (start_height < 0 || end_height < start_height) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid height range");
+    }
+    if (count < 1 || count > MAX_ADDRESS_HISTORY_RESULTS) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("count must be between 1 and %d", MAX_ADDRESS_HISTORY_RESULTS));
+    }
+
+    // The cursor is formatted as "height:txid:vout".
+    std::optional<std::pair<int, COutPoint>> after;
+    if (const auto cursor{self.MaybeArg<std::string_view>("cursor")}) {
+        const auto parts{util::SplitString(*cursor, ':')};
+        const auto height{parts.size() == 3 ? ToIntegral<int>(parts[0]) : std::nullopt};
+        const auto txid{parts.size() == 3 ? Txid::FromHex(parts[1]) : std::nullopt};
+        const auto vout{parts.size() == 3 ? ToIntegral<uint32_t>(parts[2]) : std::nullopt};
+        if (!height || !txid || !vout) {
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid cursor");
+        }
+        after.emplace(*height, COutPoint{*txid, *vout});
+    }
+
+    AddrIndex& index{EnsureSyncedAddrIndex()};
+    const int index_height{index.GetSummary().best_block_height};
+    // Look up one more output than requested to tell whether there is a next page.
+    std::vector<AddrIndexEntry> entries;
+    if (!index.LookUpOutputs(script, start_height, end_height, after, count + 1, entries)) {
+        throw JSONRPCError(RPC_INTERNAL_ERROR, "Unable to read the address index");
+    }
+
+    UniValue outputs(UniValue::VARR);
+    for (size_t i = 0; i < entries.size() && i < static_cast<size_t>(count); ++i) {
+        const AddrIndexEntry& entry{entries[i]};
+        UniValue output(UniValue::VOBJ);
+        output.pushKV("height", entry.height);
+        output.pushKV("txid", entry.outpoint.hash.GetHex());
+        output.pushKV("vout", entry.outpoint.n);
+        output.pushKV("value", ValueFromAmount(entry.value));
+        if (entry.spent_by) {
+            UniValue spent_by(UniValue::VOBJ);
+            spent_by.pushKV("txid", entry.spent_by->txid.GetHex());
+            spent_by.pushKV("vin", entry.spent_by->vin);
+            spent_by.pushKV("height", entry.spent_by->height);
+            output.pushKV("spent_by", std::move(spent_by));
+        }
+        outputs.push_back(std::move(output));
+    }
+
+    UniValue ret(UniValue::VOBJ);
+    ret.pushKV("height", index_height);
+    ret.pushKV("outputs", std::move(outputs));
+    if (entries.size() > static_cast<size_t>(count)) {
+        const AddrIndexEntry& last{entries[count - 1]};
+        ret.pushKV("next", strprintf("%d:%s:%d", last.height, last.outpoint.hash.GetHex(), last.outpoint.n));
+    }
+    return ret;
+},
+    };
+}
+
+RPCHelpMan getaddressbalance()
+{
+    return RPCHelpMan{
+        "getaddressbalance",
+        "Returns the totals of the confirmed outputs paying to an address or scriptPubKey.\n"
+        "Requires -addrindex.\n",
+        {
+            {"address", RPCArg::Type::STR, RPCArg::Optional::NO, "The address, or hex-encoded scriptPubKey, to look up"},
+        },
+        RPCResult{
+            RPCResult::Type::OBJ, "", "",
+            {
+                {RPCResult::Type::NUM, "height", "The height the address index is synced to"},
+                {RPCResult::Type::STR_AMOUNT, "balance", "The total value of the unspent outputs in " + CURRENCY_UNIT},
+                {RPCResult::Type::STR_AMOUNT, "received", "The total value of all outputs in " + CURRENCY_UNIT},
+                {RPCResult::Type::NUM, "unspent_outputs", "The number of unspent outputs"},
+                {RPCResult::Type::NUM, "outputs", "The number of outputs"},
+            }},
+        RPCExamples{
+            HelpExampleCli("getaddressbalance", "\"" + EXAMPLE_ADDRESS[0] + "\"") +
+            HelpExampleRpc("getaddressbalance", "\"" + EXAMPLE_ADDRESS[0] + "\"")
+        },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    const CScript script{ParseAddrIndexScript(self.Arg<std::string>("address"))};
+
+    AddrIndex& index{EnsureSyncedAddrIndex()};
+    const int index_height{index.GetSummary().best_block_height};
+    AddrIndexBalance balance;
+    if (!index.LookUpBalance(script, balance)) {
+        throw JSONRPCError(RPC_INTERNAL_ERROR, "Unable to read the address index");
+    }
+
+    UniValue ret(UniValue::VOBJ);
+    ret.pushKV("height", index_height);
+    ret.pushKV("balance", ValueFromAmount(balance.balance));
+    ret.pushKV("received", ValueFromAmount(balance.received));
+    ret.pushKV("unspent_outputs", balance.unspent_outputs);
+    ret.pushKV("outputs", balance.outputs);
+    return ret;
+},
+    };
+}
+
 /**
  * RAII class that disables the network in its constructor and enables it in its
  * destructor.
@@ -3025,7 +3209,7 @@ static RPCHelpMan dumptxoutset()
     return RPCHelpMan{
         "dumptxoutset",
         "Write the serialized UTXO set to a file. This can be used in loadtxoutset afterwards if this snapshot height is supported in the chainparams as well.\n\n"
-        "Unless the \"latest\" type is requested, the node will roll back to the requested height and network activity will be suspended during this process. "
+        "Unless the \"latest\" type is requested, the node will roll back to the requested height and network activity will be suspended until the UTXO set at that height has been captured, before it is written to the file. "
         "Because of this it is discouraged to interact with the node in any other way during the execution of this call to avoid inconsistent results and race conditions, particularly RPCs that interact with blockstorage.\n\n"
         "This call may take several minutes. Make sure to use no RPC timeout (bitcoin-cli -rpcclienttimeout=0)",
         {
@@ -3135,13 +3319,13 @@ static RPCHelpMan dumptxoutset()
     }
 
     Chainstate* chainstate;
-    std::unique_ptr<CCoinsViewCursor> cursor;
-    CCoinsStats stats;
+    std::vector<std::unique_ptr<CCoinsViewCursor>> cursors;
+    bool roll_forward_early;
     {
         // Lock the chainstate before calling PrepareUtxoSnapshot, to be able
-        // to get a UTXO database cursor while the chain is pointing at the
+        // to get UTXO database cursors while the chain is pointing at the
         // target block. After that, release the lock while calling
-        // WriteUTXOSnapshot. The cursor will remain valid and be used by
+        // WriteUTXOSnapshot. The cursors will remain valid and be used by
         // WriteUTXOSnapshot to write a consistent snapshot even if the
         // chainstate changes.
         LOCK(node.chainman->GetMutex());
@@ -3156,13 +3340,23 @@ static RPCHelpMan dumptxoutset()
             LogWarning("dumptxoutset failed to roll back to requested height, reverting to tip.\n");
             throw JSONRPCError(RPC_MISC_ERROR, "Could not roll back to requested height.");
         } else {
-            std::tie(cursor, stats, tip) = PrepareUTXOSnapshot(*chainstate, node.rpc_interruption_point);
+            std::tie(cursors, tip) = PrepareUTXOSnapshot(*chainstate);
         }
+        // LogDB keeps the versions of the coins that open cursors may still
+        // see in memory, and would have to keep every coin the blocks rolled
+        // forward change. Only roll forward once the cursors are done then.
+        roll_forward_early = chainstate->CoinsDB().Engine() != DBEngine::LOGDB;
+    }
+
+    // Otherwise the chain can be rolled forward and the network resumed right
+    // away, as the cursors keep seeing the UTXO set at the target block.
+    if (roll_forward_early) {
+        temporary_rollback.reset();
+        disable_network.reset();
     }
 
     UniValue result = WriteUTXOSnapshot(*chainstate,
-                                        cursor.get(),
-                                        &stats,
+                                        std::move(cursors),
                                         tip,
                                         std::move(afile),
                                         path,
@@ -3176,24 +3370,22 @@ static RPCHelpMan dumptxoutset()
     };
 }
 
-std::tuple<std::unique_ptr<CCoinsViewCursor>, CCoinsStats, const CBlockIndex*>
-PrepareUTXOSnapshot(
-    Chainstate& chainstate,
-    const std::function<void()>& interruption_point)
+std::pair<std::vector<std::unique_ptr<CCoinsViewCursor>>, const CBlockIndex*>
+PrepareUTXOSnapshot(Chainstate& chainstate)
 {
-    std::unique_ptr<CCoinsViewCursor> pcursor;
-    std::optional<CCoinsStats> maybe_stats;
+    std::vector<std::unique_ptr<CCoinsViewCursor>> cursors;
     const CBlockIndex* tip;
 
     {
         // We need to lock cs_main to ensure that the coinsdb isn't written to
-        // between (i) flushing coins cache to disk (coinsdb), (ii) getting stats
-        // based upon the coinsdb, and (iii) constructing a cursor to the
-        // coinsdb for use in WriteUTXOSnapshot.
+        // between (i) flushing coins cache to disk (coinsdb) and (ii)
+        // constructing the cursors to the coinsdb for use in
+        // WriteUTXOSnapshot.
         //
         // Cursors returned by leveldb iterate over snapshots, so the contents
-        // of the pcursor will not be affected by simultaneous writes during
-        // use below this block.
+        // of the cursors will not be affected by simultaneous writes during
+        // use below this block. As nothing writes to the coinsdb while they
+        // are constructed, all of them see the same snapshot.
         //
         // See discussion here:
         //   https://github.com/bitcoin/bitcoin/pull/15606#discussion_r274479369
@@ -3202,22 +3394,166 @@ PrepareUTXOSnapshot(
 
         chainstate.ForceFlushStateToDisk(/*wipe_cache=*/false);
 
-        maybe_stats = GetUTXOStats(&chainstate.CoinsDB(), chainstate.m_blockman, CoinStatsHashType::HASH_SERIALIZED, interruption_point);
-        if (!maybe_stats) {
-            throw JSONRPCError(RPC_INTERNAL_ERROR, "Unable to read UTXO set");
+        const int num_cursors{std::max(1, std::clamp(chainstate.m_chainman.m_options.worker_threads_num, 0, MAX_SCRIPTCHECK_THREADS))};
+        for (int i{0}; i < num_cursors; ++i) {
+            cursors.push_back(chainstate.CoinsDB().Cursor());
         }
-
-        pcursor = chainstate.CoinsDB().Cursor();
-        tip = CHECK_NONFATAL(chainstate.m_blockman.LookupBlockIndex(maybe_stats->hashBlock));
+        tip = CHECK_NONFATAL(chainstate.m_blockman.LookupBlockIndex(cursors.front()->GetBestBlock()));
     }
 
-    return {std::move(pcursor), *CHECK_NONFATAL(maybe_stats), tip};
+    return {std::move(cursors), tip};
 }
 
+/**
+ * Serializes the coins of a UTXO database snapshot on several threads.
+ *
+ * The key space is split into shards by txid prefix, so the coins of a txid
+ * are never split up. Each worker thread serializes whole shards with its own
+ * cursor, and the shards are taken in key order, which yields the same
+ * snapshot data as iterating over the database in one pass.
+ */
+class CoinsSnapshotSerializer
+{
+public:
+    struct Shard {
+        //! Coins as they are written to the snapshot
+        DataStream data;
+        //! The data hashed for the coins, see kernel::SerializeCoinForHash
+        std::vector<unsigned char> hash_data;
+        uint64_t coins_count{0};
+        //! Set if the database could not be read
+        std::optional<std::string> error;
+    };
+
+    explicit CoinsSnapshotSerializer(std::vector<std::unique_ptr<CCoinsViewCursor>> cursors)
+        : m_cursors{std::move(cursors)}, m_max_shards{2 * m_cursors.size() + 2}
+    {
+        for (size_t i{0}; i < m_cursors.size(); ++i) {
+            m_workers.emplace_back([this, i] {
+                util::ThreadRename(strprintf("dumptxout.%d", i));
+                WorkerThread(*m_cursors[i]);
+            });
+        }
+    }
+
+    ~CoinsSnapshotSerializer()
+    {
+        WITH_LOCK(m_mutex, m_stop = true);
+        m_cv.notify_all();
+        for (auto& worker : m_workers) worker.join();
+    }
+
+    //! Return the next shard in key order, or nullptr after the last one.
+    std::unique_ptr<Shard> Take() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        std::unique_ptr<Shard> shard;
+        {
+            WAIT_LOCK(m_mutex, lock);
+            if (m_next_take == NUM_SHARDS) return nullptr;
+            m_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return m_done.contains(m_next_take); });
+            shard = std::move(m_done.extract(m_next_take++).mapped());
+        }
+        m_cv.notify_all();
+        return shard;
+    }
+
+private:
+    //! The shard of a txid is given by its first bits in key order.
+    static constexpr int SHARD_BITS{12};
+    static constexpr uint32_t NUM_SHARDS{1 << SHARD_BITS};
+
+    static uint32_t ShardOf(const Txid& txid)
+    {
+        return ((std::to_integer<uint32_t>(txid.data()[0]) << 8) | std::to_integer<uint32_t>(txid.data()[1])) >> (16 - SHARD_BITS);
+    }
+
+    const std::vector<std::unique_ptr<CCoinsViewCursor>> m_cursors;
+    //! Maximum number of shards serialized but not taken yet, bounding memory usage
+    const size_t m_max_shards;
+
+    Mutex m_mutex;
+    std::condition_variable m_cv;
+    std::map<uint32_t, std::unique_ptr<Shard>> m_done GUARDED_BY(m_mutex);
+    uint32_t m_next_shard GUARDED_BY(m_mutex){0};
+    uint32_t m_next_take GUARDED_BY(m_mutex){0};
+    bool m_stop GUARDED_BY(m_mutex){false};
+
+    std::vector<std::thread> m_workers;
+
+    static void SerializeShard(CCoinsViewCursor& cursor, uint32_t index, Shard& shard)
+    {
+        // To reduce space the serialization format of the snapshot avoids
+        // duplication of tx hashes. The code takes advantage of the guarantee by
+        // leveldb that keys are lexicographically sorted.
+        // In the coins vector we collect all coins that belong to a certain tx hash
+        // (key.hash) and when we have them all (key.hash != last_hash) we write
+        // them to the shard using the below lambda function.
+        // See also https://github.com/bitcoin/bitcoin/issues/25675
+        Txid last_hash;
+        std::vector<std::pair<uint32_t, Coin>> coins;
+        auto write_coins = [&]() {
+            shard.data << last_hash;
+            WriteCompactSize(shard.data, coins.size());
+            for (const auto& [n, coin] : coins) {
+                WriteCompactSize(shard.data, n);
+                shard.data << coin;
+                ++shard.coins_count;
+            }
+            // The UTXO set hash covers the coins of a txid by output index,
+            // which is not the key order for large indexes.
+            if (!std::ranges::is_sorted(coins, {}, [](const auto& entry) { return entry.first; })) {
+                std::ranges::sort(coins, {}, [](const auto& entry) { return entry.first; });
+            }
+            for (const auto& [n, coin] : coins) {
+                kernel::SerializeCoinForHash(shard.hash_data, COutPoint{last_hash, n}, coin);
+            }
+        };
+
+        uint256 start;
+        start.data()[0] = static_cast<uint8_t>(index >> (SHARD_BITS - 8));
+        start.data()[1] = static_cast<uint8_t>(index << (16 - SHARD_BITS));
+        COutPoint key;
+        Coin coin;
+        for (cursor.Seek(COutPoint{Txid::FromUint256(start), 0}); cursor.Valid(); cursor.Next()) {
+            if (!cursor.GetKey(key) || ShardOf(key.hash) != index) break;
+            if (!cursor.GetValue(coin)) continue;
+            if (key.hash != last_hash && !coins.empty()) {
+                write_coins();
+                coins.clear();
+            }
+            last_hash = key.hash;
+            coins.emplace_back(key.n, std::move(coin));
+        }
+        if (!coins.empty()) write_coins();
+    }
+
+    void WorkerThread(CCoinsViewCursor& cursor) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        while (true) {
+            uint32_t index;
+            {
+                WAIT_LOCK(m_mutex, lock);
+                m_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) {
+                    return m_stop || m_next_shard == NUM_SHARDS || m_next_shard < m_next_take + m_max_shards;
+                });
+                if (m_stop || m_next_shard == NUM_SHARDS) return;
+                index = m_next_shard++;
+            }
+            auto shard{std::make_unique<Shard>()};
+            try {
+                SerializeShard(cursor, index, *shard);
+            } catch (const std::exception& e) {
+                shard->error = e.what();
+            }
+            WITH_LOCK(m_mutex, m_done.emplace(index, std::move(shard)));
+            m_cv.notify_all();
+        }
+    }
+};
+
 UniValue WriteUTXOSnapshot(
     Chainstate& chainstate,
-    CCoinsViewCursor* pcursor,
-    CCoinsStats* maybe_stats,
+    std::vector<std::unique_ptr<CCoinsViewCursor>> cursors,
     const CBlockIndex* tip,
     AutoFile&& afile,
     const fs::path& path,
@@ -3228,55 +3564,32 @@ UniValue WriteUTXOSnapshot(
         tip->nHeight, tip->GetBlockHash().ToString(),
         fs::PathToString(path), fs::PathToString(temppath)));
 
-    SnapshotMetadata metadata{chainstate.m_chainman.GetParams().MessageStart(), tip->GetBlockHash(), maybe_stats->coins_count};
+    // The number of coins is only known once they are written, so the
+    // metadata is written again at the end.
+    SnapshotMetadata metadata{chainstate.m_chainman.GetParams().MessageStart(), tip->GetBlockHash(), /*coins_count=*/0};
 
     afile << metadata;
 
-    COutPoint key;
-    Txid last_hash;
-    Coin coin;
-    unsigned int iter{0};
+    // Hash the coins as they are written, in the same order as
+    // ComputeUTXOStats does for CoinStatsHashType::HASH_SERIALIZED.
+    HashWriter hasher{};
     size_t written_coins_count{0};
-    std::vector<std::pair<uint32_t, Coin>> coins;
-
-    // To reduce space the serialization format of the snapshot avoids
-    // duplication of tx hashes. The code takes advantage of the guarantee by
-    // leveldb that keys are lexicographically sorted.
-    // In the coins vector we collect all coins that belong to a certain tx hash
-    // (key.hash) and when we have them all (key.hash != last_hash) we write
-    // them to file using the below lambda function.
-    // See also https://github.com/bitcoin/bitcoin/issues/25675
-    auto write_coins_to_file = [&](AutoFile& afile, const Txid& last_hash, const std::vector<std::pair<uint32_t, Coin>>& coins, size_t& written_coins_count) {
-        afile << last_hash;
-        WriteCompactSize(afile, coins.size());
-        for (const auto& [n, coin] : coins) {
-            WriteCompactSize(afile, n);
-            afile << coin;
-            ++written_coins_count;
-        }
-    };
-
-    pcursor->GetKey(key);
-    last_hash = key.hash;
-    while (pcursor->Valid()) {
-        if (iter % 5000 == 0) interruption_point();
-        ++iter;
-        if (pcursor->GetKey(key) && pcursor->GetValue(coin)) {
-            if (key.hash != last_hash) {
-                write_coins_to_file(afile, last_hash, coins, written_coins_count);
-                last_hash = key.hash;
-                coins.clear();
+    {
+        CoinsSnapshotSerializer serializer{std::move(cursors)};
+        while (const auto shard{serializer.Take()}) {
+            interruption_point();
+            if (shard->error) {
+                throw JSONRPCError(RPC_INTERNAL_ERROR, strprintf("Unable to read UTXO set: %s", *shard->error));
             }
-            coins.emplace_back(key.n, coin);
+            afile.write(MakeByteSpan(shard->data));
+            hasher.write(std::as_bytes(std::span{shard->hash_data}));
+            written_coins_count += shard->coins_count;
         }
-        pcursor->Next();
     }
 
-    if (!coins.empty()) {
-        write_coins_to_file(afile, last_hash, coins, written_coins_count);
-    }
-
-    CHECK_NONFATAL(written_coins_count == maybe_stats->coins_count);
+    metadata.m_coins_count = written_coins_count;
+    afile.seek(0, SEEK_SET);
+    afile << metadata;
 
     if (afile.fclose() != 0) {
         throw std::ios_base::failure(
@@ -3288,7 +3601,7 @@ UniValue WriteUTXOSnapshot(
     result.pushKV("base_hash", tip->GetBlockHash().ToString());
     result.pushKV("base_height", tip->nHeight);
     result.pushKV("path", path.utf8string());
-    result.pushKV("txoutset_hash", maybe_stats->hashSerialized.ToString());
+    result.pushKV("txoutset_hash", hasher.GetHash().ToString());
     result.pushKV("nchaintx", tip->m_chain_tx_count);
     return result;
 }
@@ -3300,10 +3613,9 @@ UniValue CreateUTXOSnapshot(
     const fs::path& path,
     const fs::path& tmppath)
 {
-    auto [cursor, stats, tip]{WITH_LOCK(::cs_main, return PrepareUTXOSnapshot(chainstate, node.rpc_interruption_point))};
+    auto [cursors, tip]{WITH_LOCK(::cs_main, return PrepareUTXOSnapshot(chainstate))};
     return WriteUTXOSnapshot(chainstate,
-                             cursor.get(),
-                             &stats,
+                             std::move(cursors),
                              tip,
                              std::move(afile),
                              path,
@@ -3401,7 +3713,10 @@ const std::vector<RPCResult> RPCHelpForChainstate{
     {RPCResult::Type::NUM, "verificationprogress", "progress towards the network tip"},
     {RPCResult::Type::STR_HEX, "snapshot_blockhash", /*optional=*/true, "the base block of the snapshot this chainstate is based on, if any"},
     {RPCResult::Type::NUM, "coins_db_cache_bytes", "size of the coinsdb cache"},
+    {RPCResult::Type::BOOL, "coins_db_cache_adaptive", "whether the size of the coinsdb cache adapts to the coinstip cache hit rate (false with -dbengine=logdb, which has no such cache)"},
     {RPCResult::Type::NUM, "coins_tip_cache_bytes", "size of the coinstip cache"},
+    {RPCResult::Type::NUM, "coins_tip_cache_hits", "number of coin lookups answered from the coinstip cache"},
+    {RPCResult::Type::NUM, "coins_tip_cache_misses", "number of coins read from the coinsdb because they were not in the coinstip cache"},
     {RPCResult::Type::BOOL, "validated", "whether the chainstate is fully validated. True if all blocks in the chainstate were validated, false if the chain is based on a snapshot and the snapshot has not yet been validated."},
 };
 
@@ -3444,7 +3759,10 @@ return RPCHelpMan{
         data.pushKV("difficulty", GetDifficulty(*tip));
         data.pushKV("verificationprogress", chainman.GuessVerificationProgress(tip));
         data.pushKV("coins_db_cache_bytes",  cs.m_coinsdb_cache_size_bytes);
+        data.pushKV("coins_db_cache_adaptive", cs.CoinsDBCacheAdaptive());
         data.pushKV("coins_tip_cache_bytes", cs.m_coinstip_cache_size_bytes);
+        data.pushKV("coins_tip_cache_hits", cs.CoinsTip().GetCacheHits());
+        data.pushKV("coins_tip_cache_misses", cs.CoinsTip().GetCacheMisses());
         if (cs.m_from_snapshot_blockhash) {
             data.pushKV("snapshot_blockhash", cs.m_from_snapshot_blockhash->ToString());
         }
@@ -3464,6 +3782,134 @@ return RPCHelpMan{
     };
 }
 
+//! Upper bounds of the buckets of the getblockvalidationstats histogram, in milliseconds
+static constexpr std::array<int64_t, 16> BLOCK_VALIDATION_HISTOGRAM_BOUNDS_MS{
+    1, 2, 4, 8, 16, 32, 64, 128, 256, 512, 1024, 2048, 4096, 8192, 16384, 32768};
+
+static UniValue BlockValidationProfileToJSON(const BlockValidationProfile& profile)
+{
+    const auto to_ms{[](auto duration) { return Ticks<MillisecondsDouble>(duration); }};
+    UniValue obj{UniValue::VOBJ};
+    obj.pushKV("hash", profile.hash.GetHex());
+    obj.pushKV("height", profile.height);
+    obj.pushKV("txs", profile.tx_count);
+    obj.pushKV("inputs", profile.input_count);
+    obj.pushKV("pipelined", profile.pipelined);
+    obj.pushKV("pow_ms", to_ms(profile.pow));
+    obj.pushKV("read_ms", to_ms(profile.read));
+    obj.pushKV("fetch_ms", to_ms(profile.fetch));
+    obj.pushKV("fetch_inputs", profile.fetch_stats.inputs);
+    if (profile.fetch_stats.inputs > 0) {
+        obj.pushKV("fetch_cache_hit_ratio", double(profile.fetch_stats.cache_hits) / profile.fetch_stats.inputs);
+    }
+    obj.pushKV("check_ms", to_ms(profile.check));
+    obj.pushKV("forks_ms", to_ms(profile.forks));
+    obj.pushKV("connect_ms", to_ms(profile.connect));
+    obj.pushKV("verify_ms", to_ms(profile.verify));
+    UniValue busy{UniValue::VARR};
+    for (const auto& thread_busy : profile.script_check_busy) busy.push_back(to_ms(thread_busy));
+    obj.pushKV("script_check_busy_ms", std::move(busy));
+    obj.pushKV("undo_ms", to_ms(profile.undo));
+    obj.pushKV("index_ms", to_ms(profile.index));
+    obj.pushKV("flush_ms", to_ms(profile.flush));
+    obj.pushKV("chainstate_ms", to_ms(profile.chainstate));
+    obj.pushKV("post_connect_ms", to_ms(profile.post_connect));
+    obj.pushKV("notify_ms", to_ms(profile.notify));
+    obj.pushKV("total_ms", to_ms(profile.total));
+    return obj;
+}
+
+static RPCHelpMan getblockvalidationstats()
+{
+    return RPCHelpMan{
+        "getblockvalidationstats",
+        "Returns how long the phases of connecting the most recently connected blocks took, and a histogram\n"
+        "of the total time of up to the last " + util::ToString(MAX_BLOCK_VALIDATION_PROFILES) + " blocks.\n"
+        "Blocks connected to a background chainstate are included.\n",
+        {
+            {"nblocks", RPCArg::Type::NUM, RPCArg::Default{10}, "The number of most recently connected blocks to return the phases of"},
+        },
+        RPCResult{
+            RPCResult::Type::OBJ, "", "",
+            {
+                {RPCResult::Type::ARR, "blocks", "The most recently connected blocks, oldest first", {
+                    {RPCResult::Type::OBJ, "", "", {
+                        {RPCResult::Type::STR_HEX, "hash", "The block hash"},
+                        {RPCResult::Type::NUM, "height", "The block height"},
+                        {RPCResult::Type::NUM, "txs", "The number of transactions"},
+                        {RPCResult::Type::NUM, "inputs", "The number of inputs, excluding the coinbase's"},
+                        {RPCResult::Type::BOOL, "pipelined", "Whether the script checks were left running while later blocks were connected"},
+                        {RPCResult::Type::NUM, "pow_ms", "Time spent computing RandomX hashes of headers since the previous block was connected, including those checked during headers sync and ahead of -reindex"},
+                        {RPCResult::Type::NUM, "read_ms", "Time spent reading the block from disk"},
+                        {RPCResult::Type::NUM, "fetch_ms", "Time spent reading inputs into the coins cache ahead of connecting the block"},
+                        {RPCResult::Type::NUM, "fetch_inputs", "The number of inputs not spending outputs of the block itself, 0 if there are no input fetcher threads"},
+                        {RPCResult::Type::NUM, "fetch_cache_hit_ratio", /*optional=*/true, "The share of those inputs that were already in the coins cache"},
+                        {RPCResult::Type::NUM, "check_ms", "Time spent on sanity checks"},
+                        {RPCResult::Type::NUM, "forks_ms", "Time spent on fork checks"},
+                        {RPCResult::Type::NUM, "connect_ms", "Time spent connecting the transactions"},
+                        {RPCResult::Type::NUM, "verify_ms", "Time from the start of connecting the transactions until their scripts were verified"},
+                        {RPCResult::Type::ARR, "script_check_busy_ms", "Time each script check thread spent running checks, the thread connecting the block last", {
+                            {RPCResult::Type::NUM, "", ""},
+                        }},
+                        {RPCResult::Type::NUM, "undo_ms", "Time spent writing the undo data"},
+                        {RPCResult::Type::NUM, "index_ms", "Time spent updating the block index"},
+                        {RPCResult::Type::NUM, "flush_ms", "Time spent flushing the block's changes into the coins cache"},
+                        {RPCResult::Type::NUM, "chainstate_ms", "Time spent writing the chainstate to disk"},
+                        {RPCResult::Type::NUM, "post_connect_ms", "Time spent updating the mempool and the chain tip"},
+                        {RPCResult::Type::NUM, "notify_ms", "Time spent queueing the block connected notification"},
+                        {RPCResult::Type::NUM, "total_ms", "The total time"},
+                    }},
+                }},
+                {RPCResult::Type::NUM, "histogram_blocks", "The number of blocks in the histogram"},
+                {RPCResult::Type::ARR, "histogram", "The number of blocks by total time", {
+                    {RPCResult::Type::OBJ, "", "", {
+                        {RPCResult::Type::NUM, "min_ms", "The lower bound of the total time, inclusive"},
+                        {RPCResult::Type::NUM, "max_ms", /*optional=*/true, "The upper bound of the total time, exclusive. Omitted for the last bucket"},
+                        {RPCResult::Type::NUM, "count", "The number of blocks"},
+                    }},
+                }},
+            }},
+        RPCExamples{
+            HelpExampleCli("getblockvalidationstats", "")
+            + HelpExampleRpc("getblockvalidationstats", "100")
+        },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    ChainstateManager& chainman = EnsureAnyChainman(request.context);
+    const int nblocks{self.Arg<int>("nblocks")};
+    if (nblocks < 0) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid block count: should be at least 0");
+    }
+    const std::vector<BlockValidationProfile> profiles{WITH_LOCK(cs_main, return chainman.GetBlockValidationProfiles())};
+
+    UniValue blocks{UniValue::VARR};
+    for (auto it{profiles.end() - std::min<size_t>(nblocks, profiles.size())}; it != profiles.end(); ++it) {
+        blocks.push_back(BlockValidationProfileToJSON(*it));
+    }
+
+    std::array<int64_t, BLOCK_VALIDATION_HISTOGRAM_BOUNDS_MS.size() + 1> counts{};
+    for (const auto& profile : profiles) {
+        const auto total_ms{Ticks<std::chrono::milliseconds>(profile.total)};
+        counts[std::upper_bound(BLOCK_VALIDATION_HISTOGRAM_BOUNDS_MS.begin(), BLOCK_VALIDATION_HISTOGRAM_BOUNDS_MS.end(), total_ms) - BLOCK_VALIDATION_HISTOGRAM_BOUNDS_MS.begin()]++;
+    }
+    UniValue histogram{UniValue::VARR};
+    for (size_t i{0}; i < counts.size(); ++i) {
+        UniValue bucket{UniValue::VOBJ};
+        bucket.pushKV("min_ms", i == 0 ? 0 : BLOCK_VALIDATION_HISTOGRAM_BOUNDS_MS[i - 1]);
+        if (i < BLOCK_VALIDATION_HISTOGRAM_BOUNDS_MS.size()) bucket.pushKV("max_ms", BLOCK_VALIDATION_HISTOGRAM_BOUNDS_MS[i]);
+        bucket.pushKV("count", counts[i]);
+        histogram.push_back(std::move(bucket));
+    }
+
+    UniValue ret{UniValue::VOBJ};
+    ret.pushKV("blocks", std::move(blocks));
+    ret.pushKV("histogram_blocks", profiles.size());
+    ret.pushKV("histogram", std::move(histogram));
+    return ret;
+},
+    };
+}
+
 
 void RegisterBlockchainRPCCommands(CRPCTable& t)
 {
@@ -3489,9 +3935,12 @@ void RegisterBlockchainRPCCommands(CRPCTable& t)
         {"blockchain", &scanblocks},
         {"blockchain", &getdescriptoractivity},
         {"blockchain", &getblockfilter},
+        {"blockchain", &getaddresshistory},
+        {"blockchain", &getaddressbalance},
         {"blockchain", &dumptxoutset},
         {"blockchain", &loadtxoutset},
         {"blockchain", &getchainstates},
+        {"blockchain", &getblockvalidationstats},
         {"hidden", &invalidateblock},
         {"hidden", &reconsiderblock},
         {"blockchain", &waitfornewblock},
@@ -151,6 +151,10 @@ static const CRPCConvertParam vRPCConvertParams[] =
     { "getblock", 1, "verbose" },
     { "getblockheader", 1, "verbose" },
     { "getchaintxstats", 0, "nblocks" },
+    { "getblockvalidationstats", 0, "nblocks" },
+    { "getaddresshistory", 1, "start_height" },
+    { "getaddresshistory", 2, "end_height" },
+    { "getaddresshistory", 3, "count" },
     { "gettransaction", 1, "include_watchonly" },
     { "gettransaction", 2, "verbose" },
     { "getrawtransaction", 1, "verbosity" },
@@ -313,6 +317,8 @@ static const CRPCConvertParam vRPCConvertParams[] =
     { "getmempoolancestors", 1, "verbose" },
     { "getmempooldescendants", 1, "verbose" },
     { "gettxspendingprevout", 0, "outputs" },
+    { "gettxspendingprevout", 1, "options" },
+    { "gettxspendingprevout", 1, "mempool_only" },
     { "bumpfee", 1, "options" },
     { "bumpfee", 1, "conf_target"},
     { "bumpfee", 1, "fee_rate"},
@@ -11,6 +11,7 @@
 #include <common/args.h>
 #include <consensus/validation.h>
 #include <core_io.h>
+#include <index/txospenderindex.h>
 #include <kernel/mempool_entry.h>
 #include <net_processing.h>
 #include <netbase.h>
@@ -772,10 +773,11 @@ static RPCHelpMan getmempoolentry()
     };
 }
 
-static RPCHelpMan gettxspendingprevout()
+RPCHelpMan gettxspendingprevout()
 {
     return RPCHelpMan{"gettxspendingprevout",
-        "Scans the mempool to find transactions spending any of the given outputs",
+        "Scans the mempool to find transactions spending any of the given outputs.\n"
+        "With -txospenderindex, outputs not spent in the mempool are also looked up in the blocks of the active chain.",
         {
             {"outputs", RPCArg::Type::ARR, RPCArg::Optional::NO, "The transaction outputs that we want to check, and within each, the txid (string) vout (numeric).",
                 {
@@ -787,6 +789,11 @@ static RPCHelpMan gettxspendingprevout()
                     },
                 },
             },
+            {"options", RPCArg::Type::OBJ_NAMED_PARAMS, RPCArg::Optional::OMITTED, "",
+                {
+                    {"mempool_only", RPCArg::Type::BOOL, RPCArg::DefaultHint{"true unless -txospenderindex is enabled"}, "Only look for spending transactions in the mempool"},
+                },
+                RPCArgOptions{.oneline_description="options"}},
         },
         RPCResult{
             RPCResult::Type::ARR, "", "",
@@ -795,7 +802,10 @@ static RPCHelpMan gettxspendingprevout()
                 {
                     {RPCResult::Type::STR_HEX, "txid", "the transaction id of the checked output"},
                     {RPCResult::Type::NUM, "vout", "the vout value of the checked output"},
-                    {RPCResult::Type::STR_HEX, "spendingtxid", /*optional=*/true, "the transaction id of the mempool transaction spending this output (omitted if unspent)"},
+                    {RPCResult::Type::STR_HEX, "spendingtxid", /*optional=*/true, "the transaction id of the mempool or block transaction spending this output (omitted if unspent)"},
+                    {RPCResult::Type::NUM, "vin", /*optional=*/true, "the index of the spending input (only for outputs spent in a block)"},
+                    {RPCResult::Type::STR_HEX, "blockhash", /*optional=*/true, "the hash of the block containing the spending transaction (only for outputs spent in a block)"},
+                    {RPCResult::Type::NUM, "height", /*optional=*/true, "the height of the block containing the spending transaction (only for outputs spent in a block)"},
                 }},
             }
         },
@@ -831,12 +841,38 @@ static RPCHelpMan gettxspendingprevout()
                 prevouts.emplace_back(txid, nOutput);
             }
 
+            const UniValue options{request.params[1].isNull() ? UniValue::VOBJ : request.params[1]};
+            const bool mempool_only{options.exists("mempool_only") ? options["mempool_only"].get_bool() : !g_txospenderindex};
+            std::vector<std::optional<TxoSpender>> block_spenders;
+            if (!mempool_only) {
+                if (!g_txospenderindex) {
+                    throw JSONRPCError(RPC_MISC_ERROR, "Spent output index not enabled. Use -txospenderindex to enable it.");
+                }
+                if (!g_txospenderindex->BlockUntilSyncedToCurrentChain()) {
+                    throw JSONRPCError(RPC_MISC_ERROR, strprintf("Unable to get data because txospenderindex is still syncing. Current height: %d", g_txospenderindex->GetSummary().best_block_height));
+                }
+                if (!g_txospenderindex->FindSpenders(prevouts, block_spenders)) {
+                    throw JSONRPCError(RPC_INTERNAL_ERROR, "Unable to read the spent output index");
+                }
+                // The index may have followed a reorg after the lookup, so
+                // only report spenders in blocks still in the active chain
+                ChainstateManager& chainman = EnsureAnyChainman(request.context);
+                LOCK(::cs_main);
+                const CChain& active_chain{chainman.ActiveChain()};
+                for (auto& spender : block_spenders) {
+                    if (!spender) continue;
+                    const CBlockIndex* pindex{active_chain[spender->height]};
+                    if (!pindex || pindex->GetBlockHash() != spender->block_hash) spender.reset();
+                }
+            }
+
             const CTxMemPool& mempool = EnsureAnyMemPool(request.context);
             LOCK(mempool.cs);
 
             UniValue result{UniValue::VARR};
 
-            for (const COutPoint& prevout : prevouts) {
+            for (size_t i = 0; i < prevouts.size(); ++i) {
+                const COutPoint& prevout{prevouts[i]};
                 UniValue o(UniValue::VOBJ);
                 o.pushKV("txid", prevout.hash.ToString());
                 o.pushKV("vout", prevout.n);
@@ -844,6 +880,11 @@ static RPCHelpMan gettxspendingprevout()
                 const CTransaction* spendingTx = mempool.GetConflictTx(prevout);
                 if (spendingTx != nullptr) {
                     o.pushKV("spendingtxid", spendingTx->GetHash().ToString());
+                } else if (!block_spenders.empty() && block_spenders[i]) {
+                    o.pushKV("spendingtxid", block_spenders[i]->txid.ToString());
+                    o.pushKV("vin", block_spenders[i]->vin);
+                    o.pushKV("blockhash", block_spenders[i]->block_hash.GetHex());
+                    o.pushKV("height", block_spenders[i]->height);
                 }
 
                 result.push_back(std::move(o));
@@ -15,6 +15,7 @@
 #include <consensus/params.h>
 #include <consensus/validation.h>
 #include <core_io.h>
+#include <crypto/randomx_hash.h>
 #include <deploymentinfo.h>
 #include <deploymentstatus.h>
 #include <interfaces/mining.h>
@@ -511,6 +512,108 @@ static RPCHelpMan getmininginfo()
     };
 }
 
+static std::vector<RPCResult> RandomXInfoDescription()
+{
+    const auto flags_doc{[](const std::string& name, const std::string& mode) {
+        return RPCResult{RPCResult::Type::OBJ, name, "RandomX flags in effect for the " + mode + " VM",
+        {
+            {RPCResult::Type::BOOL, "jit", "Whether the JIT compiler is used"},
+            {RPCResult::Type::BOOL, "large_pages", "Whether large pages are used"},
+            {RPCResult::Type::BOOL, "hard_aes", "Whether hardware AES is used"},
+            {RPCResult::Type::BOOL, "secure", "Whether W^X JIT pages are used"},
+        }};
+    }};
+    return {
+        {RPCResult::Type::NUM, "height", "The current block height"},
+        {RPCResult::Type::NUM, "seed_height", "Height of the seed block used for the next block"},
+        {RPCResult::Type::STR_HEX, "seed_hash", "Seed hash used for the next block"},
+        {RPCResult::Type::OBJ, "next_seed", /*optional=*/true, "The next seed rotation (only present if the seed rotates after the current height)",
+        {
+            {RPCResult::Type::NUM, "activation_height", "First height using the next seed"},
+            {RPCResult::Type::NUM, "blocks_until_rotation", "Blocks remaining until the next seed is used"},
+            {RPCResult::Type::NUM, "seed_height", "Height of the next seed block"},
+            {RPCResult::Type::STR_HEX, "seed_hash", /*optional=*/true, "Next seed hash (only present once the seed block is in the active chain)"},
+        }},
+        {RPCResult::Type::STR_HEX, "loaded_seed_hash", /*optional=*/true, "Seed hash the RandomX cache currently holds (only present if initialized)"},
+        {RPCResult::Type::BOOL, "light_initialized", "Whether the light-mode cache and VM are initialized"},
+        {RPCResult::Type::BOOL, "fast_initialized", "Whether the fast-mode dataset and VM are initialized"},
+        {RPCResult::Type::BOOL, "dataset_ready", "Whether the fast-mode dataset is initialized for the seed used by the next block"},
+        {RPCResult::Type::NUM, "cache_init_ms", "Duration of the last cache initialization in milliseconds"},
+        {RPCResult::Type::NUM, "dataset_init_ms", "Duration of the last dataset initialization in milliseconds"},
+        {RPCResult::Type::NUM, "memory_bytes", "Approximate memory held by the RandomX cache, dataset and VMs"},
+        {RPCResult::Type::NUM, "batch_lanes", "Number of light-mode VMs used for parallel header validation"},
+        flags_doc("light_flags", "light-mode"),
+        flags_doc("fast_flags", "fast-mode"),
+    };
+}
+
+static UniValue RandomXFlagsToJSON(const RandomXContext::VMFlags& flags)
+{
+    UniValue obj(UniValue::VOBJ);
+    obj.pushKV("jit", flags.jit);
+    obj.pushKV("large_pages", flags.large_pages);
+    obj.pushKV("hard_aes", flags.hard_aes);
+    obj.pushKV("secure", flags.secure);
+    return obj;
+}
+
+static UniValue RandomXInfoToJSON(ChainstateManager& chainman)
+{
+    LOCK(cs_main);
+    const CChain& active_chain{chainman.ActiveChain()};
+    const CBlockIndex* tip{CHECK_NONFATAL(active_chain.Tip())};
+    const uint64_t height{static_cast<uint64_t>(tip->nHeight)};
+    const uint256 seed_hash{GetNextRandomXSeedHash(tip)};
+
+    UniValue obj(UniValue::VOBJ);
+    obj.pushKV("height", height);
+    obj.pushKV("seed_height", GetRandomXSeedHeight(height + 1));
+    obj.pushKV("seed_hash", seed_hash.GetHex());
+
+    if (const auto switch_height{GetNextRandomXSeedSwitchHeight(height + 1)}) {
+        const uint64_t next_seed_height{GetRandomXSeedHeight(*switch_height)};
+        UniValue next(UniValue::VOBJ);
+        next.pushKV("activation_height", *switch_height);
+        next.pushKV("blocks_until_rotation", *switch_height - height);
+        next.pushKV("seed_height", next_seed_height);
+        if (next_seed_height <= height) {
+            next.pushKV("seed_hash", active_chain[next_seed_height]->GetBlockHash().GetHex());
+        }
+        obj.pushKV("next_seed", std::move(next));
+    }
+
+    const RandomXContext::Stats stats{RandomXContext::GetInstance().GetStats()};
+    if (stats.seed_hash) obj.pushKV("loaded_seed_hash", stats.seed_hash->GetHex());
+    obj.pushKV("light_initialized", stats.light_initialized);
+    obj.pushKV("fast_initialized", stats.fast_initialized);
+    obj.pushKV("dataset_ready", stats.fast_initialized && stats.seed_hash == seed_hash);
+    obj.pushKV("cache_init_ms", Ticks<std::chrono::milliseconds>(stats.cache_init_time));
+    obj.pushKV("dataset_init_ms", Ticks<std::chrono::milliseconds>(stats.dataset_init_time));
+    obj.pushKV("memory_bytes", stats.memory_bytes);
+    obj.pushKV("batch_lanes", stats.batch_lanes);
+    obj.pushKV("light_flags", RandomXFlagsToJSON(stats.light_flags));
+    obj.pushKV("fast_flags", RandomXFlagsToJSON(stats.fast_flags));
+    return obj;
+}
+
+static RPCHelpMan getrandomxinfo()
+{
+    return RPCHelpMan{
+        "getrandomxinfo",
+        "Returns the state of the RandomX cache and dataset, the seed schedule and the next seed rotation.\n",
+        {},
+        RPCResult{RPCResult::Type::OBJ, "", "", RandomXInfoDescription()},
+        RPCExamples{
+            HelpExampleCli("getrandomxinfo", "")
+            + HelpExampleRpc("getrandomxinfo", "")
+        },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    return RandomXInfoToJSON(EnsureAnyChainman(request.context));
+},
+    };
+}
+
 static RPCHelpMan getinternalmininginfo()
 {
     return RPCHelpMan{
@@ -530,6 +633,7 @@ static RPCHelpMan getinternalmininginfo()
                 {RPCResult::Type::NUM, "templates", "Number of templates created"},
                 {RPCResult::Type::NUM, "uptime", "Seconds since miner started"},
                 {RPCResult::Type::BOOL, "fast_mode", "Whether using RandomX fast mode (2GB)"},
+                {RPCResult::Type::OBJ, "randomx", "RandomX state, as returned by getrandomxinfo", RandomXInfoDescription()},
             }
         },
         RPCExamples{
@@ -563,6 +667,7 @@ static RPCHelpMan getinternalmininginfo()
     obj.pushKV("uptime", uptime);
     
     obj.pushKV("fast_mode", miner.IsFastMode());
+    obj.pushKV("randomx", RandomXInfoToJSON(EnsureChainman(node)));
     
     return obj;
 },
@@ -1213,6 +1318,7 @@ void RegisterMiningRPCCommands(CRPCTable& t)
         {"mining", &getnetworkhashps},
         {"mining", &getmininginfo},
         {"mining", &getinternalmininginfo},
+        {"mining", &getrandomxinfo},
         {"mining", &prioritisetransaction},
         {"mining", &getprioritisedtransactions},
         {"mining", &getblocktemplate},
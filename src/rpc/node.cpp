@@ -7,15 +7,18 @@
 
 #include <chainparams.h>
 #include <httpserver.h>
+#include <index/addrindex.h>
 #include <index/blockfilterindex.h>
 #include <index/coinstatsindex.h>
 #include <index/txindex.h>
+#include <index/txospenderindex.h>
 #include <interfaces/chain.h>
 #include <interfaces/echo.h>
 #include <interfaces/init.h>
 #include <interfaces/ipc.h>
 #include <kernel/cs_main.h>
 #include <logging.h>
+#include <node/blockstorage.h>
 #include <node/context.h>
 #include <rpc/server.h>
 #include <rpc/server_util.h>
@@ -26,6 +29,7 @@
 #include <util/any.h>
 #include <util/check.h>
 #include <util/time.h>
+#include <validation.h>
 
 #include <cstdint>
 #ifdef HAVE_MALLOC_INFO
@@ -166,6 +170,15 @@ static RPCHelpMan getmemoryinfo()
                                 {RPCResult::Type::NUM, "chunks_used", "Number allocated chunks"},
                                 {RPCResult::Type::NUM, "chunks_free", "Number unused chunks"},
                             }},
+                            {RPCResult::Type::OBJ, "blockcache", /*optional=*/true, "Information about the cache of recently read or written blocks and undo data",
+                            {
+                                {RPCResult::Type::NUM, "usage", "Number of bytes used"},
+                                {RPCResult::Type::NUM, "limit", "Maximum number of bytes to use (see -blockcachesize)"},
+                                {RPCResult::Type::NUM, "blocks", "Number of cached blocks"},
+                                {RPCResult::Type::NUM, "undos", "Number of cached block undo data"},
+                                {RPCResult::Type::NUM, "hits", "Number of reads served from the cache"},
+                                {RPCResult::Type::NUM, "misses", "Number of reads that went to disk"},
+                            }},
                         }
                     },
                     RPCResult{"mode \"mallocinfo\"",
@@ -182,6 +195,18 @@ static RPCHelpMan getmemoryinfo()
     if (mode == "stats") {
         UniValue obj(UniValue::VOBJ);
         obj.pushKV("locked", RPCLockedMemoryInfo());
+        const NodeContext& node_context{EnsureAnyNodeContext(request.context)};
+        if (node_context.chainman) {
+            const auto stats{node_context.chainman->m_blockman.GetBlockCacheStats()};
+            UniValue cache(UniValue::VOBJ);
+            cache.pushKV("usage", stats.usage);
+            cache.pushKV("limit", stats.limit);
+            cache.pushKV("blocks", stats.blocks);
+            cache.pushKV("undos", stats.undos);
+            cache.pushKV("hits", stats.hits);
+            cache.pushKV("misses", stats.misses);
+            obj.pushKV("blockcache", std::move(cache));
+        }
         return obj;
     } else if (mode == "mallocinfo") {
 #ifdef HAVE_MALLOC_INFO
@@ -393,6 +418,14 @@ static RPCHelpMan getindexinfo()
         result.pushKVs(SummaryToJSON(g_txindex->GetSummary(), index_name));
     }
 
+    if (g_addrindex) {
+        result.pushKVs(SummaryToJSON(g_addrindex->GetSummary(), index_name));
+    }
+
+    if (g_txospenderindex) {
+        result.pushKVs(SummaryToJSON(g_txospenderindex->GetSummary(), index_name));
+    }
+
     if (g_coin_stats_index) {
         result.pushKVs(SummaryToJSON(g_coin_stats_index->GetSummary(), index_name));
     }
@@ -0,0 +1,224 @@
+// Copyright (c) 2026-present The Botcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "schnorrsig_batch.h"
+
+/* The internals of libsecp256k1 are header-only static functions, so this
+ * translation unit compiles its own copies of the ones it needs. Only the
+ * precomputed tables come from the library itself, which is why
+ * ECMULT_WINDOW_SIZE must match the one it was built with. */
+#if defined(__GNUC__)
+#pragma GCC diagnostic ignored "-Wunused-function"
+#endif
+
+#include "../secp256k1/src/assumptions.h"
+#include "../secp256k1/src/util.h"
+#include "../secp256k1/src/field_impl.h"
+#include "../secp256k1/src/scalar_impl.h"
+#include "../secp256k1/src/group_impl.h"
+#include "../secp256k1/src/ecmult_impl.h"
+#include "../secp256k1/src/hash_impl.h"
+#include "../secp256k1/src/int128_impl.h"
+#include "../secp256k1/src/scratch_impl.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* A batch of n signatures (r_i, s_i) with public keys P_i and challenges e_i
+ * is valid if
+ *
+ *   sum(a_i*R_i) + sum(a_i*e_i*P_i) - sum(a_i*s_i)*G = infinity
+ *
+ * where R_i is the point with x coordinate r_i and even y, and the a_i are
+ * secret random factors. Without them, the errors of invalid signatures could
+ * be made to cancel out. The points and their factors are kept in pairs, with
+ * a_i*R_i at index 2*i and a_i*e_i*P_i at index 2*i + 1. */
+struct schnorrsig_batch_struct {
+    secp256k1_scratch* scratch;
+    secp256k1_scalar* scalars;
+    secp256k1_ge* points;
+    size_t max_sigs;
+    /* Number of signatures in the batch. */
+    size_t len;
+    /* Sum of a_i*s_i of the signatures in the batch. */
+    secp256k1_scalar sum_s;
+    /* Secret from which the a_i are derived, and the number of a_i derived. */
+    unsigned char seed[32];
+    uint64_t counter;
+    /* Whether all signatures verified so far are valid. */
+    int result;
+};
+
+static int schnorrsig_batch_ecmult_callback(secp256k1_scalar* sc, secp256k1_ge* pt, size_t idx, void* data)
+{
+    const schnorrsig_batch* batch = (const schnorrsig_batch*)data;
+    *sc = batch->scalars[idx];
+    *pt = batch->points[idx];
+    return 1;
+}
+
+/* The BIP340 challenge e = hash_BIP0340/challenge(r || P || msg). */
+static void schnorrsig_batch_challenge(secp256k1_scalar* e, const unsigned char* r32, const unsigned char* msg, size_t msglen, const unsigned char* pubkey32)
+{
+    static const unsigned char tag[] = {'B', 'I', 'P', '0', '3', '4', '0', '/', 'c', 'h', 'a', 'l', 'l', 'e', 'n', 'g', 'e'};
+    secp256k1_sha256 sha;
+    unsigned char buf[32];
+
+    secp256k1_sha256_initialize_tagged(&sha, tag, sizeof(tag));
+    secp256k1_sha256_write(&sha, r32, 32);
+    secp256k1_sha256_write(&sha, pubkey32, 32);
+    secp256k1_sha256_write(&sha, msg, msglen);
+    secp256k1_sha256_finalize(&sha, buf);
+    secp256k1_scalar_set_b32(e, buf, NULL);
+}
+
+/* Derive a_i as SHA256(seed || i). */
+static void schnorrsig_batch_randomizer(secp256k1_scalar* a, schnorrsig_batch* batch)
+{
+    secp256k1_sha256 sha;
+    unsigned char counter[8];
+    unsigned char buf[32];
+
+    secp256k1_write_be64(counter, batch->counter++);
+    secp256k1_sha256_initialize(&sha);
+    secp256k1_sha256_write(&sha, batch->seed, sizeof(batch->seed));
+    secp256k1_sha256_write(&sha, counter, sizeof(counter));
+    secp256k1_sha256_finalize(&sha, buf);
+    secp256k1_sha256_clear(&sha);
+    secp256k1_scalar_set_b32(a, buf, NULL);
+    secp256k1_memclear_explicit(buf, sizeof(buf));
+}
+
+/* Verify the signatures in the batch, fold the outcome into batch->result and
+ * empty the batch. */
+static void schnorrsig_batch_flush(schnorrsig_batch* batch)
+{
+    secp256k1_scalar neg_sum_s;
+    secp256k1_gej rj;
+
+    if (batch->result && batch->len > 0) {
+        secp256k1_scalar_negate(&neg_sum_s, &batch->sum_s);
+        batch->result = secp256k1_ecmult_multi_var(&default_error_callback, batch->scratch, &rj, &neg_sum_s, schnorrsig_batch_ecmult_callback, batch, 2 * batch->len) &&
+                        secp256k1_gej_is_infinity(&rj);
+    }
+    batch->len = 0;
+    secp256k1_scalar_set_int(&batch->sum_s, 0);
+}
+
+schnorrsig_batch* schnorrsig_batch_create(size_t max_sigs, const unsigned char* aux_rand32)
+{
+    schnorrsig_batch* batch;
+    size_t n_points;
+    size_t strauss_size;
+    size_t pippenger_size;
+
+    VERIFY_CHECK(aux_rand32 != NULL);
+
+    if (max_sigs == 0 || max_sigs > ECMULT_MAX_POINTS_PER_BATCH / 2) {
+        return NULL;
+    }
+    n_points = 2 * max_sigs;
+
+    batch = (schnorrsig_batch*)checked_malloc(&default_error_callback, sizeof(*batch));
+    if (batch == NULL) {
+        return NULL;
+    }
+    batch->scalars = (secp256k1_scalar*)checked_malloc(&default_error_callback, n_points * sizeof(secp256k1_scalar));
+    batch->points = (secp256k1_ge*)checked_malloc(&default_error_callback, n_points * sizeof(secp256k1_ge));
+    /* Make room for all points at once with either multiplication algorithm. */
+    strauss_size = secp256k1_strauss_scratch_size(n_points) + STRAUSS_SCRATCH_OBJECTS * ALIGNMENT;
+    pippenger_size = secp256k1_pippenger_scratch_size(n_points, secp256k1_pippenger_bucket_window(n_points)) + PIPPENGER_SCRATCH_OBJECTS * ALIGNMENT;
+    batch->scratch = secp256k1_scratch_create(&default_error_callback, strauss_size > pippenger_size ? strauss_size : pippenger_size);
+    if (batch->scalars == NULL || batch->points == NULL || batch->scratch == NULL) {
+        schnorrsig_batch_destroy(batch);
+        return NULL;
+    }
+
+    batch->max_sigs = max_sigs;
+    batch->len = 0;
+    secp256k1_scalar_set_int(&batch->sum_s, 0);
+    memcpy(batch->seed, aux_rand32, sizeof(batch->seed));
+    batch->counter = 0;
+    batch->result = 1;
+    return batch;
+}
+
+void schnorrsig_batch_destroy(schnorrsig_batch* batch)
+{
+    if (batch == NULL) {
+        return;
+    }
+    if (batch->scratch != NULL) {
+        secp256k1_scratch_destroy(&default_error_callback, batch->scratch);
+    }
+    free(batch->scalars);
+    free(batch->points);
+    secp256k1_memclear_explicit(batch->seed, sizeof(batch->seed));
+    free(batch);
+}
+
+int schnorrsig_batch_add(schnorrsig_batch* batch, const unsigned char* sig64, const unsigned char* msg, size_t msglen, const unsigned char* pubkey32)
+{
+    secp256k1_scalar s;
+    secp256k1_scalar e;
+    secp256k1_scalar a;
+    secp256k1_fe rx;
+    secp256k1_fe px;
+    secp256k1_ge r;
+    secp256k1_ge pk;
+    int overflow;
+
+    VERIFY_CHECK(batch != NULL);
+    VERIFY_CHECK(sig64 != NULL);
+    VERIFY_CHECK(msg != NULL || msglen == 0);
+    VERIFY_CHECK(pubkey32 != NULL);
+
+    if (!batch->result) {
+        return 1;
+    }
+
+    /* Reject what secp256k1_xonly_pubkey_parse and secp256k1_schnorrsig_verify
+     * reject. */
+    if (!secp256k1_fe_set_b32_limit(&px, pubkey32) || !secp256k1_ge_set_xo_var(&pk, &px, 0) ||
+        !secp256k1_fe_set_b32_limit(&rx, &sig64[0]) || !secp256k1_ge_set_xo_var(&r, &rx, 0)) {
+        batch->result = 0;
+        return 0;
+    }
+    secp256k1_scalar_set_b32(&s, &sig64[32], &overflow);
+    if (overflow) {
+        batch->result = 0;
+        return 0;
+    }
+
+    schnorrsig_batch_challenge(&e, &sig64[0], msg, msglen, pubkey32);
+
+    if (batch->len == batch->max_sigs) {
+        schnorrsig_batch_flush(batch);
+        if (!batch->result) {
+            return 1;
+        }
+    }
+
+    schnorrsig_batch_randomizer(&a, batch);
+    batch->scalars[2 * batch->len] = a;
+    batch->points[2 * batch->len] = r;
+    secp256k1_scalar_mul(&batch->scalars[2 * batch->len + 1], &e, &a);
+    batch->points[2 * batch->len + 1] = pk;
+    secp256k1_scalar_mul(&s, &s, &a);
+    secp256k1_scalar_add(&batch->sum_s, &batch->sum_s, &s);
+    batch->len++;
+    return 1;
+}
+
+int schnorrsig_batch_verify(schnorrsig_batch* batch)
+{
+    int result;
+
+    VERIFY_CHECK(batch != NULL);
+
+    schnorrsig_batch_flush(batch);
+    result = batch->result;
+    batch->result = 1;
+    return result;
+}
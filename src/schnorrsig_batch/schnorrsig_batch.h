@@ -0,0 +1,59 @@
+// Copyright (c) 2026-present The Botcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_SCHNORRSIG_BATCH_SCHNORRSIG_BATCH_H
+#define BITCOIN_SCHNORRSIG_BATCH_SCHNORRSIG_BATCH_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Batch verification of BIP340 Schnorr signatures.
+ *
+ *  Signatures added to a batch are checked together with a single
+ *  multi-scalar multiplication, which takes considerably less time than
+ *  verifying them one at a time. A batch that contains only valid signatures
+ *  always verifies. A batch that contains an invalid signature fails to verify,
+ *  except with negligible probability, but does not indicate which of its
+ *  signatures is invalid.
+ *
+ *  This is built on the internals of libsecp256k1, which has no batch
+ *  verification of its own, but kept outside of its subtree. A batch may be
+ *  used by one thread at a time only.
+ */
+typedef struct schnorrsig_batch_struct schnorrsig_batch;
+
+/** Create a batch, or return NULL if max_sigs is 0 or too large.
+ *
+ *  max_sigs is the number of signatures the batch holds before it verifies
+ *  them internally to make room for more. Memory usage is proportional to it.
+ *  aux_rand32 must be 32 bytes of fresh, secret randomness. The signatures are
+ *  weighted with factors derived from it, without which invalid signatures
+ *  could be crafted to verify together.
+ */
+schnorrsig_batch* schnorrsig_batch_create(size_t max_sigs, const unsigned char* aux_rand32);
+
+/** Destroy a batch. Does nothing if batch is NULL. */
+void schnorrsig_batch_destroy(schnorrsig_batch* batch);
+
+/** Add the 64-byte signature sig64 of msg by the 32-byte x-only public key
+ *  pubkey32 to a batch.
+ *
+ *  Returns 0 if the signature or the public key is invalid regardless of the
+ *  others in the batch, which then fails to verify, and 1 otherwise.
+ */
+int schnorrsig_batch_add(schnorrsig_batch* batch, const unsigned char* sig64, const unsigned char* msg, size_t msglen, const unsigned char* pubkey32);
+
+/** Verify all signatures added to a batch since it was created or last
+ *  verified, and empty it. Returns 1 if they are all correct, 0 otherwise.
+ */
+int schnorrsig_batch_verify(schnorrsig_batch* batch);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BITCOIN_SCHNORRSIG_BATCH_SCHNORRSIG_BATCH_H
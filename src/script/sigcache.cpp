@@ -15,21 +15,26 @@
 
 #include <mutex>
 #include <shared_mutex>
+#include <utility>
 #include <vector>
 
-SignatureCache::SignatureCache(const size_t max_size_bytes)
+//! Initialize the salted hashers of a signature cache with its nonce.
+static void SetupSaltedHashers(const uint256& nonce, CSHA256& hasher_ecdsa, CSHA256& hasher_schnorr)
 {
-    uint256 nonce = GetRandHash();
     // We want the nonce to be 64 bytes long to force the hasher to process
     // this chunk, which makes later hash computations more efficient. We
     // just write our 32-byte entropy, and then pad with 'E' for ECDSA and
     // 'S' for Schnorr (followed by 0 bytes).
     static constexpr unsigned char PADDING_ECDSA[32] = {'E'};
     static constexpr unsigned char PADDING_SCHNORR[32] = {'S'};
-    m_salted_hasher_ecdsa.Write(nonce.begin(), 32);
-    m_salted_hasher_ecdsa.Write(PADDING_ECDSA, 32);
-    m_salted_hasher_schnorr.Write(nonce.begin(), 32);
-    m_salted_hasher_schnorr.Write(PADDING_SCHNORR, 32);
+    hasher_ecdsa.Reset().Write(nonce.begin(), 32).Write(PADDING_ECDSA, 32);
+    hasher_schnorr.Reset().Write(nonce.begin(), 32).Write(PADDING_SCHNORR, 32);
+}
+
+SignatureCache::SignatureCache(const size_t max_size_bytes)
+    : m_nonce{GetRandHash()}
+{
+    SetupSaltedHashers(m_nonce, m_salted_hasher_ecdsa, m_salted_hasher_schnorr);
 
     const auto [num_elems, approx_size_bytes] = setValid.setup_bytes(max_size_bytes);
     LogInfo("Using %zu MiB out of %zu MiB requested for signature cache, able to store %zu elements",
@@ -60,12 +65,54 @@ void SignatureCache::Set(const uint256& entry)
     setValid.insert(entry);
 }
 
+bool SignatureCache::GetRestored(const CSHA256& salted_hasher, const uint256& hash, std::span<const unsigned char> pubkey, std::span<const unsigned char> sig, const bool erase)
+{
+    std::shared_lock<std::shared_mutex> lock(cs_sigcache);
+    if (!m_has_restored) return false;
+    uint256 entry;
+    CSHA256 hasher = salted_hasher;
+    hasher.Write(hash.begin(), 32).Write(pubkey.data(), pubkey.size()).Write(sig.data(), sig.size()).Finalize(entry.begin());
+    return m_restored.contains(entry, erase);
+}
+
+bool SignatureCache::GetRestoredECDSA(const uint256& hash, const std::vector<unsigned char>& vchSig, const CPubKey& pubkey, const bool erase)
+{
+    return GetRestored(m_restored_hasher_ecdsa, hash, pubkey, vchSig, erase);
+}
+
+bool SignatureCache::GetRestoredSchnorr(const uint256& hash, std::span<const unsigned char> sig, const XOnlyPubKey& pubkey, const bool erase)
+{
+    return GetRestored(m_restored_hasher_schnorr, hash, pubkey, sig, erase);
+}
+
+std::pair<uint256, std::vector<uint256>> SignatureCache::GetEntries()
+{
+    std::vector<uint256> entries;
+    std::shared_lock<std::shared_mutex> lock(cs_sigcache);
+    setValid.for_each([&](const uint256& entry) { entries.push_back(entry); });
+    return {m_nonce, std::move(entries)};
+}
+
+void SignatureCache::Restore(const uint256& nonce, std::span<const uint256> entries)
+{
+    std::unique_lock<std::shared_mutex> lock(cs_sigcache);
+    SetupSaltedHashers(nonce, m_restored_hasher_ecdsa, m_restored_hasher_schnorr);
+    m_restored.setup(entries.size());
+    for (const uint256& entry : entries) m_restored.insert(entry);
+    m_has_restored = !entries.empty();
+}
+
 bool CachingTransactionSignatureChecker::VerifyECDSASignature(const std::vector<unsigned char>& vchSig, const CPubKey& pubkey, const uint256& sighash) const
 {
     uint256 entry;
     m_signature_cache.ComputeEntryECDSA(entry, sighash, vchSig, pubkey);
     if (m_signature_cache.Get(entry, !store))
         return true;
+    if (m_signature_cache.GetRestoredECDSA(sighash, vchSig, pubkey, !store)) {
+        // Carry it over to this run's entries, so it is dumped again.
+        if (store) m_signature_cache.Set(entry);
+        return true;
+    }
     if (!TransactionSignatureChecker::VerifyECDSASignature(vchSig, pubkey, sighash))
         return false;
     if (store)
@@ -78,7 +125,31 @@ bool CachingTransactionSignatureChecker::VerifySchnorrSignature(std::span<const
     uint256 entry;
     m_signature_cache.ComputeEntrySchnorr(entry, sighash, sig, pubkey);
     if (m_signature_cache.Get(entry, !store)) return true;
+    if (m_signature_cache.GetRestoredSchnorr(sighash, sig, pubkey, !store)) {
+        if (store) m_signature_cache.Set(entry);
+        return true;
+    }
+    if (m_deferred) {
+        if (!m_deferred->m_batch.Add(pubkey, sighash, sig)) return false;
+        if (store) m_deferred->m_cache_entries.emplace_back(&m_signature_cache, entry);
+        return true;
+    }
     if (!TransactionSignatureChecker::VerifySchnorrSignature(sig, pubkey, sighash)) return false;
     if (store) m_signature_cache.Set(entry);
     return true;
 }
+
+DeferredSignatureChecks::DeferredSignatureChecks()
+    : m_batch{GetRandHash()}
+{
+}
+
+bool DeferredSignatureChecks::Verify()
+{
+    const bool valid{m_batch.Verify()};
+    if (valid) {
+        for (const auto& [signature_cache, entry] : m_cache_entries) signature_cache->Set(entry);
+    }
+    m_cache_entries.clear();
+    return valid;
+}
@@ -9,6 +9,7 @@
 #include <consensus/amount.h>
 #include <crypto/sha256.h>
 #include <cuckoocache.h>
+#include <pubkey.h>
 #include <script/interpreter.h>
 #include <span.h>
 #include <uint256.h>
@@ -16,11 +17,10 @@
 
 #include <cstddef>
 #include <shared_mutex>
+#include <utility>
 #include <vector>
 
-class CPubKey;
 class CTransaction;
-class XOnlyPubKey;
 
 // DoS prevention: limit cache size to 32MiB (over 1000000 entries on 64-bit
 // systems). Due to how we count cache size, actual memory usage is slightly
@@ -41,10 +41,20 @@ private:
     //! Entries are SHA256(nonce || 'E' or 'S' || 31 zero bytes || signature hash || public key || signature):
     CSHA256 m_salted_hasher_ecdsa;
     CSHA256 m_salted_hasher_schnorr;
+    //! Secret the salted hashers are initialized with, fresh on every start
+    uint256 m_nonce;
     typedef CuckooCache::cache<uint256, SignatureCacheHasher> map_type;
     map_type setValid;
+    //! Entries restored from a previous run, salted with the nonce of that
+    //! run. They are only looked up, never added to.
+    CSHA256 m_restored_hasher_ecdsa;
+    CSHA256 m_restored_hasher_schnorr;
+    map_type m_restored;
+    bool m_has_restored{false};
     std::shared_mutex cs_sigcache;
 
+    bool GetRestored(const CSHA256& salted_hasher, const uint256& hash, std::span<const unsigned char> pubkey, std::span<const unsigned char> sig, bool erase);
+
 public:
     SignatureCache(size_t max_size_bytes);
 
@@ -58,6 +68,44 @@ public:
     bool Get(const uint256& entry, bool erase);
 
     void Set(const uint256& entry);
+
+    /** Whether a signature is among the entries restored from a previous run.
+     *  Cheap if there are none. */
+    bool GetRestoredECDSA(const uint256& hash, const std::vector<unsigned char>& vchSig, const CPubKey& pubkey, bool erase);
+    bool GetRestoredSchnorr(const uint256& hash, std::span<const unsigned char> sig, const XOnlyPubKey& pubkey, bool erase);
+
+    //! Return the nonce and the entries that are not marked for erasure.
+    std::pair<uint256, std::vector<uint256>> GetEntries();
+
+    /** Look up entries that a previous run returned from GetEntries(), along
+     *  with the nonce they were computed with. New entries keep using this
+     *  run's own nonce. Must only be called before the cache is used. */
+    void Restore(const uint256& nonce, std::span<const uint256> entries);
+};
+
+/**
+ * BIP340 signature checks deferred by CachingTransactionSignatureChecker, to
+ * be verified together.
+ *
+ * A Schnorr signature that does not verify always fails the script it is in,
+ * so the script can run on as if the signature was valid, and fail later
+ * when the batch it was added to does not verify.
+ */
+class DeferredSignatureChecks
+{
+public:
+    DeferredSignatureChecks();
+
+    /** Verify the deferred signatures, and add those that were to be stored
+     *  to their signature caches. Empties the batch. */
+    bool Verify();
+
+private:
+    friend class CachingTransactionSignatureChecker;
+
+    SchnorrSignatureBatch m_batch;
+    //! Signature cache entries to add once the batch is verified
+    std::vector<std::pair<SignatureCache*, uint256>> m_cache_entries;
 };
 
 class CachingTransactionSignatureChecker : public TransactionSignatureChecker
@@ -65,9 +113,12 @@ class CachingTransactionSignatureChecker : public TransactionSignatureChecker
 private:
     bool store;
     SignatureCache& m_signature_cache;
+    DeferredSignatureChecks* m_deferred;
 
 public:
-    CachingTransactionSignatureChecker(const CTransaction* txToIn, unsigned int nInIn, const CAmount& amountIn, bool storeIn, SignatureCache& signature_cache, PrecomputedTransactionData& txdataIn) : TransactionSignatureChecker(txToIn, nInIn, amountIn, txdataIn, MissingDataBehavior::ASSERT_FAIL), store(storeIn), m_signature_cache(signature_cache)  {}
+    /** If deferred is set, Schnorr signatures missing from the signature
+     *  cache are added to it rather than verified. */
+    CachingTransactionSignatureChecker(const CTransaction* txToIn, unsigned int nInIn, const CAmount& amountIn, bool storeIn, SignatureCache& signature_cache, PrecomputedTransactionData& txdataIn, DeferredSignatureChecks* deferred = nullptr) : TransactionSignatureChecker(txToIn, nInIn, amountIn, txdataIn, MissingDataBehavior::ASSERT_FAIL), store(storeIn), m_signature_cache(signature_cache), m_deferred(deferred) {}
 
     bool VerifyECDSASignature(const std::vector<unsigned char>& vchSig, const CPubKey& vchPubKey, const uint256& sighash) const override;
     bool VerifySchnorrSignature(std::span<const unsigned char> sig, const XOnlyPubKey& pubkey, const uint256& sighash) const override;
@@ -0,0 +1,205 @@
+// Copyright (c) 2026-present The Botcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_SUPPORT_ALLOCATORS_MONOTONIC_H
+#define BITCOIN_SUPPORT_ALLOCATORS_MONOTONIC_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+/**
+ * A memory resource similar to std::pmr::monotonic_buffer_resource. It has
+ * the following properties:
+ *
+ * * Allocations are carved out of large chunks by bumping a pointer. A new
+ *   chunk is allocated when the current one is exhausted. Allocations larger
+ *   than a chunk get a chunk of their own.
+ *
+ * * Deallocation is a no-op. All memory is released at once when the resource
+ *   is destroyed.
+ *
+ * This suits groups of objects that are created together and die together,
+ * such as the transactions of a block that is read, validated and discarded:
+ * they are allocated without going through malloc for every object, are
+ * laid out next to each other, and are freed with a single call per chunk.
+ *
+ * MonotonicResource is not thread-safe. It is intended to be used by
+ * MonotonicAllocator, which shares ownership of it.
+ */
+class MonotonicResource final
+{
+    /**
+     * Alignment of every chunk, and the maximum alignment that can be served.
+     */
+    static constexpr std::size_t ALIGN_BYTES{alignof(std::max_align_t)};
+
+    /**
+     * Size in bytes to allocate per chunk
+     */
+    const std::size_t m_chunk_size_bytes;
+
+    /**
+     * Contains all allocated chunks and their sizes, used to free the data in the destructor.
+     */
+    std::vector<std::pair<std::byte*, std::size_t>> m_allocated_chunks{};
+
+    /**
+     * Points to the beginning of available memory for carving out allocations.
+     */
+    std::byte* m_available_memory_it{nullptr};
+
+    /**
+     * Points to the end of available memory for carving out allocations.
+     */
+    std::byte* m_available_memory_end{nullptr};
+
+    std::byte* AllocateChunk(std::size_t bytes)
+    {
+        void* storage = ::operator new (bytes, std::align_val_t{ALIGN_BYTES});
+        auto* chunk = new (storage) std::byte[bytes];
+        m_allocated_chunks.emplace_back(chunk, bytes);
+        return chunk;
+    }
+
+public:
+    /**
+     * Construct a new MonotonicResource object which allocates the first chunk.
+     */
+    explicit MonotonicResource(std::size_t chunk_size_bytes)
+        : m_chunk_size_bytes(std::max(chunk_size_bytes, ALIGN_BYTES))
+    {
+        m_available_memory_it = AllocateChunk(m_chunk_size_bytes);
+        m_available_memory_end = m_available_memory_it + m_chunk_size_bytes;
+    }
+
+    /**
+     * Disable copy & move semantics, these are not supported for the resource.
+     */
+    MonotonicResource(const MonotonicResource&) = delete;
+    MonotonicResource& operator=(const MonotonicResource&) = delete;
+    MonotonicResource(MonotonicResource&&) = delete;
+    MonotonicResource& operator=(MonotonicResource&&) = delete;
+
+    /**
+     * Deallocates all memory allocated associated with the memory resource.
+     */
+    ~MonotonicResource()
+    {
+        for (const auto& [chunk, bytes] : m_allocated_chunks) {
+            std::destroy(chunk, chunk + bytes);
+            ::operator delete ((void*)chunk, std::align_val_t{ALIGN_BYTES});
+        }
+    }
+
+    /**
+     * Allocates a block of bytes from the current chunk, starting a new chunk
+     * if it does not fit.
+     */
+    void* Allocate(std::size_t bytes, std::size_t alignment)
+    {
+        assert(alignment <= ALIGN_BYTES && (alignment & (alignment - 1)) == 0);
+        if (bytes > m_chunk_size_bytes) {
+            // Too large to share a chunk; keep carving from the current one afterwards.
+            return AllocateChunk(bytes);
+        }
+        const auto misalignment{reinterpret_cast<std::uintptr_t>(m_available_memory_it) & (alignment - 1)};
+        const std::size_t padding{misalignment == 0 ? 0 : alignment - misalignment};
+        if (static_cast<std::ptrdiff_t>(padding + bytes) > m_available_memory_end - m_available_memory_it) {
+            // slow path, only happens when a new chunk needs to be allocated
+            m_available_memory_it = AllocateChunk(m_chunk_size_bytes);
+            m_available_memory_end = m_available_memory_it + m_chunk_size_bytes;
+            return std::exchange(m_available_memory_it, m_available_memory_it + bytes);
+        }
+        return std::exchange(m_available_memory_it, m_available_memory_it + padding + bytes) + padding;
+    }
+
+    /**
+     * Memory is only released when the resource is destroyed.
+     */
+    void Deallocate(void*, std::size_t, std::size_t) noexcept {}
+
+    /**
+     * Number of allocated chunks
+     */
+    [[nodiscard]] std::size_t NumAllocatedChunks() const
+    {
+        return m_allocated_chunks.size();
+    }
+
+    /**
+     * Size in bytes to allocate per chunk
+     */
+    [[nodiscard]] std::size_t ChunkSizeBytes() const
+    {
+        return m_chunk_size_bytes;
+    }
+};
+
+/**
+ * Forwards all allocations to a MonotonicResource, and shares ownership of
+ * it. The resource, and so all memory allocated from it, stays alive as long
+ * as any copy of the allocator does. For std::allocate_shared that includes
+ * the copy stored with every object, so the objects can safely outlive
+ * whatever created the resource.
+ */
+template <class T>
+class MonotonicAllocator
+{
+    std::shared_ptr<MonotonicResource> m_resource;
+
+    template <typename U>
+    friend class MonotonicAllocator;
+
+public:
+    using value_type = T;
+
+    explicit MonotonicAllocator(std::shared_ptr<MonotonicResource> resource) noexcept
+        : m_resource(std::move(resource))
+    {
+    }
+
+    MonotonicAllocator(const MonotonicAllocator& other) noexcept = default;
+    MonotonicAllocator& operator=(const MonotonicAllocator& other) noexcept = default;
+
+    template <class U>
+    MonotonicAllocator(const MonotonicAllocator<U>& other) noexcept
+        : m_resource(other.m_resource)
+    {
+    }
+
+    /**
+     * Forwards each call to the resource.
+     */
+    T* allocate(size_t n)
+    {
+        return static_cast<T*>(m_resource->Allocate(n * sizeof(T), alignof(T)));
+    }
+
+    /**
+     * Forwards each call to the resource.
+     */
+    void deallocate(T* p, size_t n) noexcept
+    {
+        m_resource->Deallocate(p, n * sizeof(T), alignof(T));
+    }
+
+    MonotonicResource* resource() const noexcept
+    {
+        return m_resource.get();
+    }
+};
+
+template <class T1, class T2>
+bool operator==(const MonotonicAllocator<T1>& a, const MonotonicAllocator<T2>& b) noexcept
+{
+    return a.resource() == b.resource();
+}
+
+#endif // BITCOIN_SUPPORT_ALLOCATORS_MONOTONIC_H
@@ -0,0 +1,121 @@
+// Copyright (c) 2026-present The Botcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <addresstype.h>
+#include <chain.h>
+#include <consensus/validation.h>
+#include <index/addrindex.h>
+#include <interfaces/chain.h>
+#include <script/script.h>
+#include <sync.h>
+#include <test/util/setup_common.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <limits>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(addrindex_tests)
+
+BOOST_FIXTURE_TEST_CASE(addrindex_history_and_reorg, TestChain100Setup)
+{
+    AddrIndex addrindex(interfaces::MakeChain(m_node), 1 << 20, true);
+    BOOST_REQUIRE(addrindex.Init());
+    addrindex.Sync();
+
+    const CScript coinbase_script{CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG};
+    constexpr int max_height{std::numeric_limits<int>::max()};
+
+    // The totals kept by the index match those of the history of a script
+    const auto check_balance{[&](const CScript& script) {
+        std::vector<AddrIndexEntry> history;
+        BOOST_REQUIRE(addrindex.LookUpOutputs(script, 0, max_height, std::nullopt, 1000, history));
+        AddrIndexBalance expected;
+        for (const AddrIndexEntry& entry : history) {
+            ++expected.outputs;
+            expected.received += entry.value;
+            if (!entry.spent_by) {
+                ++expected.unspent_outputs;
+                expected.balance += entry.value;
+            }
+        }
+        AddrIndexBalance balance;
+        BOOST_REQUIRE(addrindex.LookUpBalance(script, balance));
+        BOOST_CHECK_EQUAL(balance.outputs, expected.outputs);
+        BOOST_CHECK_EQUAL(balance.received, expected.received);
+        BOOST_CHECK_EQUAL(balance.unspent_outputs, expected.unspent_outputs);
+        BOOST_CHECK_EQUAL(balance.balance, expected.balance);
+    }};
+    check_balance(coinbase_script);
+
+    // All coinbase outputs of the test chain pay to the same script.
+    std::vector<AddrIndexEntry> entries;
+    BOOST_REQUIRE(addrindex.LookUpOutputs(coinbase_script, 0, max_height, std::nullopt, 1000, entries));
+    BOOST_REQUIRE_EQUAL(entries.size(), m_coinbase_txns.size());
+    for (size_t i = 0; i < entries.size(); ++i) {
+        BOOST_CHECK_EQUAL(entries[i].height, static_cast<int>(i) + 1);
+        BOOST_CHECK(entries[i].outpoint == COutPoint(m_coinbase_txns[i]->GetHash(), 0));
+        BOOST_CHECK(!entries[i].spent_by);
+    }
+
+    // Pages and height ranges resume where the previous lookup stopped.
+    std::vector<AddrIndexEntry> page;
+    BOOST_REQUIRE(addrindex.LookUpOutputs(coinbase_script, 10, 20, std::nullopt, 5, page));
+    BOOST_REQUIRE_EQUAL(page.size(), 5U);
+    BOOST_CHECK_EQUAL(page.front().height, 10);
+    const std::pair<int, COutPoint> after{page.back().height, page.back().outpoint};
+    page.clear();
+    BOOST_REQUIRE(addrindex.LookUpOutputs(coinbase_script, 10, 20, after, 100, page));
+    BOOST_REQUIRE_EQUAL(page.size(), 6U);
+    BOOST_CHECK_EQUAL(page.front().height, 15);
+    BOOST_CHECK_EQUAL(page.back().height, 20);
+
+    // Spend the first coinbase output to another script.
+    const CScript dest_script{GetScriptForDestination(WitnessV0KeyHash(coinbaseKey.GetPubKey()))};
+    const CMutableTransaction spend{CreateValidMempoolTransaction(m_coinbase_txns[0], 0, 1, coinbaseKey, dest_script, 1 * COIN, /*submit=*/false)};
+    CreateAndProcessBlock({spend}, coinbase_script);
+    BOOST_REQUIRE(addrindex.BlockUntilSyncedToCurrentChain());
+
+    entries.clear();
+    BOOST_REQUIRE(addrindex.LookUpOutputs(coinbase_script, 0, 1, std::nullopt, 1000, entries));
+    BOOST_REQUIRE_EQUAL(entries.size(), 1U);
+    BOOST_REQUIRE(entries[0].spent_by);
+    BOOST_CHECK(entries[0].spent_by->txid == spend.GetHash());
+    BOOST_CHECK_EQUAL(entries[0].spent_by->vin, 0U);
+    BOOST_CHECK_EQUAL(entries[0].spent_by->height, 101);
+
+    AddrIndexBalance balance;
+    BOOST_REQUIRE(addrindex.LookUpBalance(dest_script, balance));
+    BOOST_CHECK_EQUAL(balance.balance, 1 * COIN);
+    BOOST_CHECK_EQUAL(balance.unspent_outputs, 1U);
+    check_balance(coinbase_script);
+    check_balance(dest_script);
+
+    // Reorging the block out reverts the spend and removes its outputs. The
+    // index rewinds once the block of the new chain is connected.
+    {
+        BlockValidationState state;
+        CBlockIndex* tip{WITH_LOCK(::cs_main, return m_node.chainman->ActiveChain().Tip())};
+        BOOST_REQUIRE(m_node.chainman->ActiveChainstate().InvalidateBlock(state, tip));
+    }
+    CreateAndProcessBlock({}, coinbase_script);
+    BOOST_REQUIRE(addrindex.BlockUntilSyncedToCurrentChain());
+
+    entries.clear();
+    BOOST_REQUIRE(addrindex.LookUpOutputs(coinbase_script, 0, max_height, std::nullopt, 1000, entries));
+    BOOST_CHECK_EQUAL(entries.size(), m_coinbase_txns.size() + 1);
+    BOOST_CHECK(!entries.front().spent_by);
+    BOOST_REQUIRE(addrindex.LookUpBalance(dest_script, balance));
+    BOOST_CHECK_EQUAL(balance.outputs, 0U);
+    check_balance(coinbase_script);
+
+    // It is not safe to stop and destroy the index until it finishes handling
+    // the last notification, see txindex_tests.
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+
+    addrindex.Stop();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
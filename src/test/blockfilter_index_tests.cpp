@@ -14,11 +14,13 @@
 #include <node/miner.h>
 #include <pow.h>
 #include <test/util/blockfilter.h>
+#include <test/util/logging.h>
 #include <test/util/setup_common.h>
 #include <validation.h>
 
 #include <boost/test/unit_test.hpp>
 #include <future>
+#include <map>
 
 using node::BlockAssembler;
 using node::BlockManager;
@@ -394,4 +396,142 @@ BOOST_FIXTURE_TEST_CASE(index_reorg_crash, BuildChainTestingSetup)
     index.Stop();
 }
 
+/** Index of the block hashes by height, synced in parallel or sequentially. */
+class IndexPipelineReorg : public BaseIndex
+{
+private:
+    struct PreparedHash : PreparedBlock {
+        uint256 hash;
+    };
+
+    std::unique_ptr<BaseIndex::DB> m_db;
+    const bool m_parallel;
+    //! Height at which appending waits for m_blocker once, after signalling m_blocked
+    int m_blocking_height{-1};
+    std::promise<void> m_blocked;
+    std::shared_future<void> m_blocker;
+    //! Height at which preparing a block fails
+    int m_failing_height{-1};
+
+public:
+    //! Only accessed by the sync thread until it is stopped
+    std::map<int, uint256> m_entries;
+
+    IndexPipelineReorg(std::unique_ptr<interfaces::Chain> chain, std::string name, bool parallel)
+        : BaseIndex(std::move(chain), name), m_parallel{parallel}
+    {
+        const fs::path path = gArgs.GetDataDirNet() / "index" / fs::u8path(name);
+        fs::create_directories(path);
+        m_db = std::make_unique<BaseIndex::DB>(path / "db", /*n_cache_size=*/0, /*f_memory=*/true, /*f_wipe=*/false);
+    }
+
+    std::future<void> BlockAt(int height, std::shared_future<void> blocker)
+    {
+        m_blocking_height = height;
+        m_blocker = std::move(blocker);
+        return m_blocked.get_future();
+    }
+
+    void FailAt(int height) { m_failing_height = height; }
+
+    bool AllowPrune() const override { return false; }
+    BaseIndex::DB& GetDB() const override { return *m_db; }
+    interfaces::Chain::NotifyOptions CustomOptions() override { return {.disconnect_data = true}; }
+    bool AllowParallelSync() const override { return m_parallel; }
+
+    std::unique_ptr<PreparedBlock> CustomPrepare(const interfaces::BlockInfo& block) const override
+    {
+        if (block.height == m_failing_height) throw std::runtime_error{"test failure"};
+        if (!block.data || block.data->GetHash() != block.hash) return nullptr;
+        auto prepared{std::make_unique<PreparedHash>()};
+        prepared->hash = block.hash;
+        return prepared;
+    }
+
+    bool CustomAppendPrepared(const interfaces::BlockInfo& block, PreparedBlock& prepared) override
+    {
+        if (block.height == m_blocking_height) {
+            m_blocking_height = -1;
+            m_blocked.set_value();
+            m_blocker.wait();
+        }
+        const uint256& hash{static_cast<PreparedHash&>(prepared).hash};
+        return hash == block.hash && m_entries.emplace(block.height, hash).second;
+    }
+
+    bool CustomAppend(const interfaces::BlockInfo& block) override
+    {
+        return m_entries.emplace(block.height, block.hash).second;
+    }
+
+    bool CustomRemove(const interfaces::BlockInfo& block) override
+    {
+        if (!block.data || block.data->GetHash() != block.hash) return false;
+        const auto it{m_entries.find(block.height)};
+        if (it == m_entries.end() || it->second != block.hash || std::next(it) != m_entries.end()) return false;
+        m_entries.erase(it);
+        return true;
+    }
+};
+
+BOOST_FIXTURE_TEST_CASE(index_pipeline_reorg, BuildChainTestingSetup)
+{
+    const int tip_height{WITH_LOCK(cs_main, return m_node.chainman->ActiveChain().Height())};
+    const int blocking_height{tip_height - 4};
+
+    // Block the sync thread while it appends a block whose successors are
+    // prepared ahead
+    std::promise<void> promise;
+    IndexPipelineReorg index(interfaces::MakeChain(m_node), "pipelined", /*parallel=*/true);
+    std::future<void> blocked{index.BlockAt(blocking_height, promise.get_future().share())};
+    BOOST_REQUIRE(index.Init());
+    BOOST_REQUIRE(index.StartBackgroundSync());
+    BOOST_REQUIRE(blocked.wait_for(5s) == std::future_status::ready);
+
+    // Replace the blocks from the one being appended onwards, so that the
+    // index is rewound past it and the prepared blocks are dropped
+    std::vector<std::shared_ptr<CBlock>> fork;
+    const CBlockIndex* fork_point{WITH_LOCK(cs_main, return m_node.chainman->ActiveChain()[blocking_height - 1])};
+    BOOST_REQUIRE(BuildChain(fork_point, GetScriptForDestination(PKHash(GenerateRandomKey().GetPubKey())), 6, fork));
+    for (const auto& block : fork) {
+        BOOST_REQUIRE(m_node.chainman->ProcessNewBlock(block, /*force_processing=*/true, /*min_pow_checked=*/true, nullptr));
+    }
+    BOOST_REQUIRE_EQUAL(WITH_LOCK(cs_main, return m_node.chainman->ActiveChain().Tip()->GetBlockHash()), fork.back()->GetHash());
+
+    promise.set_value();
+    index.Stop();
+
+    // The result is the same as syncing one block at a time
+    IndexPipelineReorg sequential_index(interfaces::MakeChain(m_node), "sequential", /*parallel=*/false);
+    BOOST_REQUIRE(sequential_index.Init());
+    BOOST_REQUIRE(sequential_index.StartBackgroundSync());
+    sequential_index.Stop();
+
+    BOOST_CHECK(index.m_entries == sequential_index.m_entries);
+    LOCK(cs_main);
+    const CChain& chain{m_node.chainman->ActiveChain()};
+    BOOST_REQUIRE_EQUAL(index.m_entries.size(), static_cast<size_t>(chain.Height() + 1));
+    for (const auto& [height, hash] : index.m_entries) {
+        BOOST_CHECK_EQUAL(hash, chain[height]->GetBlockHash());
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(index_pipeline_error, BuildChainTestingSetup)
+{
+    const int failing_height{50};
+    IndexPipelineReorg index(interfaces::MakeChain(m_node), "pipelined", /*parallel=*/true);
+    index.FailAt(failing_height);
+    BOOST_REQUIRE(index.Init());
+    {
+        ASSERT_DEBUG_LOG("for the index: test failure");
+        BOOST_REQUIRE(index.StartBackgroundSync());
+        // The sync stops at the block that failed, even with later blocks prepared
+        index.Stop();
+    }
+    BOOST_CHECK_EQUAL(m_node.exit_status.load(), EXIT_FAILURE);
+    BOOST_REQUIRE_EQUAL(index.m_entries.size(), static_cast<size_t>(failing_height));
+    BOOST_CHECK_EQUAL(index.m_entries.rbegin()->first, failing_height - 1);
+    BOOST_CHECK(!index.BlockUntilSyncedToCurrentChain());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -12,6 +12,7 @@
 #include <streams.h>
 #include <undo.h>
 #include <univalue.h>
+#include <util/golombrice.h>
 #include <util/strencodings.h>
 
 #include <boost/test/unit_test.hpp>
@@ -41,6 +42,38 @@ BOOST_AUTO_TEST_CASE(gcsfilter_test)
     }
 }
 
+BOOST_AUTO_TEST_CASE(golombrice_decoder_test)
+{
+    for (const uint8_t P : {0, 1, 19, 56, 57, 62}) {
+        const uint64_t remainder_mask{P == 0 ? 0 : ~uint64_t{0} >> (64 - P)};
+        std::vector<uint64_t> values;
+        for (int i = 0; i < 200; ++i) {
+            // Keep the quotients small enough for the unary encoding
+            values.push_back((uint64_t{0x9E3779B97F4A7C15} * (i + 1) & remainder_mask) | (uint64_t(i % 7) << P));
+        }
+
+        std::vector<unsigned char> encoded;
+        {
+            VectorWriter stream{encoded, 0};
+            BitStreamWriter bitwriter{stream};
+            for (const uint64_t value : values) GolombRiceEncode(bitwriter, P, value);
+            bitwriter.Flush();
+        }
+
+        SpanReader stream{encoded};
+        BitStreamReader bitreader{stream};
+        GolombRiceDecoder decoder{encoded};
+        for (const uint64_t value : values) {
+            BOOST_CHECK_EQUAL(GolombRiceDecode(bitreader, P), value);
+            BOOST_CHECK_EQUAL(decoder.Decode(P), value);
+        }
+        BOOST_CHECK_EQUAL(decoder.BytesRead(), encoded.size());
+
+        // Decoding past the padding bits runs out of data.
+        BOOST_CHECK_THROW(for (int i = 0; i < 64; ++i) decoder.Decode(P), std::ios_base::failure);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(gcsfilter_default_constructor)
 {
     GCSFilter filter;
@@ -176,6 +209,41 @@ BOOST_AUTO_TEST_CASE(blockfilters_json_test)
     }
 }
 
+BOOST_AUTO_TEST_CASE(blockfilter_match_any_batch)
+{
+    GCSFilter::ElementSet needles;
+    for (int i = 0; i < 10; ++i) {
+        needles.insert(GCSFilter::Element(32, static_cast<unsigned char>(i)));
+    }
+
+    std::vector<BlockFilter> filters;
+    std::vector<bool> expected;
+    for (int i = 0; i < 100; ++i) {
+        GCSFilter::ElementSet elements;
+        for (int j = 0; j < 50; ++j) {
+            GCSFilter::Element element(32);
+            element[0] = static_cast<unsigned char>(i);
+            element[1] = static_cast<unsigned char>(j);
+            element[2] = 0xff;
+            elements.insert(std::move(element));
+        }
+        // Every third filter contains one of the needles.
+        if (i % 3 == 0) elements.insert(GCSFilter::Element(32, static_cast<unsigned char>(i % 10)));
+
+        uint256 block_hash;
+        block_hash.data()[0] = static_cast<unsigned char>(i);
+        GCSFilter filter({block_hash.GetUint64(0), block_hash.GetUint64(1), BASIC_FILTER_P, BASIC_FILTER_M}, elements);
+        filters.emplace_back(BlockFilterType::BASIC, block_hash, filter.GetEncoded(), /*skip_decode_check=*/false);
+        expected.push_back(filters.back().GetFilter().MatchAny(needles));
+        if (i % 3 == 0) BOOST_CHECK(expected.back());
+    }
+
+    for (const int num_threads : {0, 1, 2, 3, 16}) {
+        BOOST_CHECK(MatchAnyBlockFilters(filters, needles, num_threads) == expected);
+    }
+    BOOST_CHECK(MatchAnyBlockFilters({}, needles, 4).empty());
+}
+
 BOOST_AUTO_TEST_CASE(blockfilter_type_names)
 {
     BOOST_CHECK_EQUAL(BlockFilterTypeName(BlockFilterType::BASIC), "basic");
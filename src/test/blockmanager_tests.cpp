@@ -2,16 +2,23 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <arith_uint256.h>
 #include <chain.h>
 #include <chainparams.h>
 #include <clientversion.h>
+#include <core_memusage.h>
+#include <crypto/common.h>
 #include <node/blockstorage.h>
 #include <node/context.h>
 #include <node/kernel_notifications.h>
+#include <pow.h>
 #include <script/solver.h>
 #include <primitives/block.h>
 #include <util/chaintype.h>
 #include <validation.h>
+#include <validationinterface.h>
+
+#include <crc32c/crc32c.h>
 
 #include <boost/test/unit_test.hpp>
 #include <test/util/logging.h>
@@ -22,6 +29,7 @@ using node::STORAGE_HEADER_BYTES;
 using node::BlockManager;
 using node::KernelNotifications;
 using node::MAX_BLOCKFILE_SIZE;
+using node::ReindexPowPrefetcher;
 
 // use BasicTestingSetup here for the data directory configuration, setup, and cleanup
 BOOST_FIXTURE_TEST_SUITE(blockmanager_tests, BasicTestingSetup)
@@ -282,4 +290,539 @@ BOOST_AUTO_TEST_CASE(blockmanager_flush_block_file)
     BOOST_CHECK_EQUAL(read_block.nVersion, 2);
 }
 
+BOOST_AUTO_TEST_CASE(blockmanager_read_raw_block_mmap)
+{
+    KernelNotifications notifications{Assert(m_node.shutdown_request), m_node.exit_status, *Assert(m_node.warnings)};
+    node::BlockManager::Options blockman_opts{
+        .chainparams = Params(),
+        .blocks_dir = m_args.GetBlocksDirPath(),
+        .notifications = notifications,
+        .block_tree_db_params = DBParams{
+            .path = m_args.GetDataDirNet() / "blocks" / "index",
+            .cache_bytes = 0,
+        },
+    };
+    BOOST_REQUIRE(blockman_opts.use_mmap);
+    // Use small block files
+    blockman_opts.fast_prune = true;
+
+    CBlock block1;
+    block1.nVersion = 1;
+    CBlock block2;
+    block2.nVersion = 2;
+    const auto expected1{[&] { DataStream s; s << TX_WITH_WITNESS(block1); return s; }()};
+    const auto expected2{[&] { DataStream s; s << TX_WITH_WITNESS(block2); return s; }()};
+
+    FlatFilePos pos1, pos2;
+    {
+        BlockManager blockman{*Assert(m_node.shutdown_signal), blockman_opts};
+        pos1 = blockman.WriteBlock(block1, /*nHeight=*/1);
+        auto raw1{blockman.ReadRawBlock(pos1)};
+        BOOST_REQUIRE(raw1);
+        BOOST_CHECK(std::ranges::equal(*raw1, expected1));
+
+        // A block written after the file was mapped is read as well
+        pos2 = blockman.WriteBlock(block2, /*nHeight=*/2);
+        auto raw2{blockman.ReadRawBlock(pos2)};
+        BOOST_REQUIRE(raw2);
+        BOOST_CHECK(std::ranges::equal(*raw2, expected2));
+        auto part{blockman.ReadRawBlock(pos2, std::pair{4, 32})};
+        BOOST_REQUIRE(part);
+        BOOST_CHECK(std::ranges::equal(*part, std::span{expected2}.subspan(4, 32)));
+
+        // Moving on to the next file finalizes (truncates) this one, which
+        // drops its map. It is mapped again on demand.
+        while (blockman.WriteBlock(block2, /*nHeight=*/2).nFile == pos1.nFile) {}
+        raw1 = blockman.ReadRawBlock(pos1);
+        BOOST_REQUIRE(raw1);
+        BOOST_CHECK(std::ranges::equal(*raw1, expected1));
+    }
+
+    // Reading through the file gives the same result
+    blockman_opts.use_mmap = false;
+    {
+        BlockManager blockman{*Assert(m_node.shutdown_signal), blockman_opts};
+        auto raw2{blockman.ReadRawBlock(pos2)};
+        BOOST_REQUIRE(raw2);
+        BOOST_CHECK(std::ranges::equal(*raw2, expected2));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(blockmanager_async_writes)
+{
+    KernelNotifications notifications{Assert(m_node.shutdown_request), m_node.exit_status, *Assert(m_node.warnings)};
+    node::BlockManager::Options blockman_opts{
+        .chainparams = Params(),
+        .blocks_dir = m_args.GetBlocksDirPath(),
+        .notifications = notifications,
+        .block_tree_db_params = DBParams{
+            .path = m_args.GetDataDirNet() / "blocks" / "index",
+            .cache_bytes = 0,
+        },
+    };
+    BOOST_REQUIRE(blockman_opts.async_writes);
+
+    std::vector<CBlock> blocks(10);
+    std::vector<FlatFilePos> positions;
+    {
+        BlockManager blockman{*Assert(m_node.shutdown_signal), blockman_opts};
+        for (size_t i{0}; i < blocks.size(); ++i) {
+            blocks[i].nVersion = i;
+            positions.push_back(blockman.WriteBlock(blocks[i], /*nHeight=*/i + 1));
+            // Blocks can be read right away, whether written yet or not
+            CBlock read_block;
+            BOOST_CHECK(blockman.ReadBlock(read_block, positions.back(), blocks[i].GetHash()));
+        }
+
+        // Opening the file for reading waits for the pending writes to it
+        AutoFile file{blockman.OpenBlockFile(positions.back(), /*fReadOnly=*/true)};
+        CBlock read_block;
+        file >> TX_WITH_WITNESS(read_block);
+        BOOST_CHECK_EQUAL(read_block.GetHash(), blocks.back().GetHash());
+    }
+
+    // Everything was written before the block manager went away
+    blockman_opts.async_writes = false;
+    {
+        BlockManager blockman{*Assert(m_node.shutdown_signal), blockman_opts};
+        for (size_t i{0}; i < blocks.size(); ++i) {
+            CBlock read_block;
+            BOOST_CHECK(blockman.ReadBlock(read_block, positions[i], blocks[i].GetHash()));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(blockmanager_compressed_blocks)
+{
+    KernelNotifications notifications{Assert(m_node.shutdown_request), m_node.exit_status, *Assert(m_node.warnings)};
+    node::BlockManager::Options blockman_opts{
+        .chainparams = Params(),
+        .blocks_dir = m_args.GetBlocksDirPath(),
+        .notifications = notifications,
+        .block_tree_db_params = DBParams{
+            .path = m_args.GetDataDirNet() / "blocks" / "index",
+            .cache_bytes = 0,
+        },
+    };
+    blockman_opts.compress_blocks = true;
+
+    CBlock block;
+    for (int i{0}; i < 10; ++i) {
+        CMutableTransaction tx;
+        tx.vin.emplace_back(COutPoint{Txid::FromUint256(m_rng.rand256()), 0});
+        tx.vin[0].scriptWitness.stack = {m_rng.randbytes(72), m_rng.randbytes(33)};
+        tx.vout.emplace_back(i * COIN, CScript() << OP_DUP << OP_HASH160 << m_rng.randbytes(20) << OP_EQUALVERIFY << OP_CHECKSIG);
+        block.vtx.push_back(MakeTransactionRef(tx));
+    }
+    DataStream expected;
+    expected << TX_WITH_WITNESS(block);
+
+    // A block that does not round trip through the compression is stored as is
+    CBlock uncompressible{block};
+    CMutableTransaction tx;
+    tx.vout.emplace_back(-1, CScript{});
+    uncompressible.vtx.push_back(MakeTransactionRef(tx));
+
+    const auto check_stored{[&](BlockManager& blockman, const FlatFilePos& pos, bool compressed) {
+        AutoFile file{blockman.OpenBlockFile({pos.nFile, pos.nPos - STORAGE_HEADER_BYTES}, /*fReadOnly=*/true)};
+        MessageStartChars blk_start;
+        unsigned int blk_size;
+        file >> blk_start >> blk_size;
+        BOOST_CHECK_EQUAL((blk_size & node::COMPRESSED_BLOCK_FLAG) != 0, compressed);
+    }};
+    const auto check_read{[&](BlockManager& blockman, const FlatFilePos& pos) {
+        CBlock read_block;
+        BOOST_CHECK(blockman.ReadBlock(read_block, pos, block.GetHash()));
+        BOOST_CHECK_EQUAL(read_block.vtx.back()->GetWitnessHash(), block.vtx.back()->GetWitnessHash());
+        // Raw reads return the network serialization
+        const auto raw{blockman.ReadRawBlock(pos)};
+        BOOST_REQUIRE(raw);
+        BOOST_CHECK(std::ranges::equal(*raw, expected));
+        // A compressed block is only converted once, parts come from the same conversion
+        const auto part{blockman.ReadRawBlock(pos, std::pair{size_t{80}, size_t{20}})};
+        BOOST_REQUIRE(part);
+        BOOST_CHECK(std::ranges::equal(*part, std::span{expected}.subspan(80, 20)));
+        BOOST_CHECK_EQUAL(blockman.ReadRawBlock(pos, std::pair{size_t{1}, expected.size()}).error(), node::ReadRawError::BadPartRange);
+    }};
+
+    FlatFilePos pos, uncompressible_pos;
+    {
+        BlockManager blockman{*Assert(m_node.shutdown_signal), blockman_opts};
+        pos = blockman.WriteBlock(block, /*nHeight=*/1);
+        uncompressible_pos = blockman.WriteBlock(uncompressible, /*nHeight=*/2);
+        check_read(blockman, pos);
+        // The compressed block takes less space than its network serialization
+        BOOST_CHECK_LT(uncompressible_pos.nPos - pos.nPos, expected.size() + STORAGE_HEADER_BYTES);
+        check_stored(blockman, pos, /*compressed=*/true);
+        check_stored(blockman, uncompressible_pos, /*compressed=*/false);
+        CBlock read_block;
+        BOOST_CHECK(blockman.ReadBlock(read_block, uncompressible_pos, uncompressible.GetHash()));
+    }
+
+    // Compressed blocks stay readable when the option is turned off
+    blockman_opts.compress_blocks = false;
+    {
+        BlockManager blockman{*Assert(m_node.shutdown_signal), blockman_opts};
+        check_read(blockman, pos);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(blockmanager_block_cache)
+{
+    KernelNotifications notifications{Assert(m_node.shutdown_request), m_node.exit_status, *Assert(m_node.warnings)};
+    node::BlockManager::Options blockman_opts{
+        .chainparams = Params(),
+        .blocks_dir = m_args.GetBlocksDirPath(),
+        .notifications = notifications,
+        .block_tree_db_params = DBParams{
+            .path = m_args.GetDataDirNet() / "blocks" / "index",
+            .cache_bytes = 0,
+        },
+    };
+    std::vector<CBlock> blocks(3);
+    for (size_t i{0}; i < blocks.size(); ++i) {
+        blocks[i].nVersion = i;
+        CMutableTransaction tx;
+        tx.vout.emplace_back(COIN, CScript() << m_rng.randbytes(1000));
+        blocks[i].vtx.push_back(MakeTransactionRef(tx));
+    }
+    // Room for about two of the blocks
+    blockman_opts.block_cache_bytes = 2 * RecursiveDynamicUsage(std::make_shared<const CBlock>(blocks[0])) + 100;
+    BlockManager blockman{*Assert(m_node.shutdown_signal), blockman_opts};
+
+    std::vector<FlatFilePos> positions;
+    for (const CBlock& block : blocks) {
+        positions.push_back(blockman.WriteBlock(block, /*nHeight=*/1));
+    }
+    auto stats{blockman.GetBlockCacheStats()};
+    BOOST_CHECK_EQUAL(stats.blocks, 2U);
+    BOOST_CHECK_LE(stats.usage, stats.limit);
+
+    // The transactions of the most recently written block are shared from
+    // the cache, but each reader gets a block of its own to check
+    const auto cached{blockman.ReadBlock(positions[2], blocks[2].GetHash())};
+    const auto cached_again{blockman.ReadBlock(positions[2], blocks[2].GetHash())};
+    BOOST_REQUIRE(cached && cached_again);
+    BOOST_CHECK(cached != cached_again);
+    BOOST_CHECK(cached->vtx[0] == blocks[2].vtx[0]);
+    BOOST_CHECK(cached_again->vtx[0] == blocks[2].vtx[0]);
+    cached->fChecked = true;
+    BOOST_CHECK(!cached_again->fChecked);
+    stats = blockman.GetBlockCacheStats();
+    BOOST_CHECK_EQUAL(stats.hits, 2U);
+    BOOST_CHECK_EQUAL(stats.misses, 0U);
+
+    // The first one was evicted, and is cached again once read from disk
+    CBlock read_block;
+    BOOST_CHECK(blockman.ReadBlock(read_block, positions[0], blocks[0].GetHash()));
+    BOOST_CHECK_EQUAL(read_block.GetHash(), blocks[0].GetHash());
+    BOOST_CHECK(read_block.vtx[0] != blocks[0].vtx[0]);
+    BOOST_CHECK(blockman.ReadBlock(read_block, positions[0], blocks[0].GetHash()));
+    stats = blockman.GetBlockCacheStats();
+    BOOST_CHECK_EQUAL(stats.hits, 3U);
+    BOOST_CHECK_EQUAL(stats.misses, 1U);
+
+    // Reads that discard the block do not fill the cache
+    BOOST_CHECK(blockman.ReadBlock(read_block, positions[1], blocks[1].GetHash(), /*use_arena=*/true));
+    BOOST_CHECK(blockman.ReadBlock(read_block, positions[1], blocks[1].GetHash(), /*use_arena=*/true));
+    BOOST_CHECK_EQUAL(blockman.GetBlockCacheStats().misses, 3U);
+}
+
+BOOST_AUTO_TEST_CASE(blockmanager_pow_verdicts)
+{
+    KernelNotifications notifications{Assert(m_node.shutdown_request), m_node.exit_status, *Assert(m_node.warnings)};
+    node::BlockManager::Options blockman_opts{
+        .chainparams = Params(),
+        .blocks_dir = m_args.GetBlocksDirPath(),
+        .notifications = notifications,
+        .block_tree_db_params = DBParams{
+            .path = m_args.GetDataDirNet() / "blocks" / "index",
+            .cache_bytes = 0,
+        },
+    };
+    const uint256 block_hash{m_rng.rand256()};
+    const uint256 seed_hash{m_rng.rand256()};
+    const uint256 first_hash{m_rng.rand256()};
+
+    {
+        BlockManager blockman{*Assert(m_node.shutdown_signal), blockman_opts};
+        LOCK(::cs_main);
+        BOOST_CHECK(!blockman.HasPowVerdict(block_hash, seed_hash, 1));
+        blockman.AddPowVerdict(block_hash, seed_hash, 1);
+        // Verdicts are only persisted together with the block index
+        BOOST_CHECK(!blockman.HasPowVerdict(block_hash, seed_hash, 1));
+        BOOST_CHECK(blockman.WriteBlockIndexDB());
+        BOOST_CHECK(blockman.HasPowVerdict(block_hash, seed_hash, 1));
+        BOOST_CHECK(!blockman.HasPowVerdict(block_hash, m_rng.rand256(), 1));
+
+        // Pending verdicts are written out once too many have accumulated
+        blockman.AddPowVerdict(first_hash, seed_hash, 2);
+        for (size_t i{2}; i < node::MAX_PENDING_POW_VERDICTS; ++i) {
+            blockman.AddPowVerdict(m_rng.rand256(), seed_hash, 3);
+        }
+        BOOST_CHECK_EQUAL(blockman.m_pending_pow_verdicts.size(), node::MAX_PENDING_POW_VERDICTS - 1);
+        BOOST_CHECK(!blockman.HasPowVerdict(first_hash, seed_hash, 2));
+        blockman.AddPowVerdict(m_rng.rand256(), seed_hash, 3);
+        BOOST_CHECK(blockman.m_pending_pow_verdicts.empty());
+        BOOST_CHECK(blockman.HasPowVerdict(first_hash, seed_hash, 2));
+        // Verdicts are looked up by height as well
+        BOOST_CHECK(!blockman.HasPowVerdict(first_hash, seed_hash, 1));
+    }
+
+    // Verdicts survive a -reindex, which wipes the block tree db
+    blockman_opts.block_tree_db_params.wipe_data = true;
+    {
+        BlockManager blockman{*Assert(m_node.shutdown_signal), blockman_opts};
+        LOCK(::cs_main);
+        BOOST_CHECK(blockman.HasPowVerdict(block_hash, seed_hash, 1));
+
+        // Pruning erases the verdicts below the height, written or pending,
+        // and later ones below it are not added again
+        const uint256 pending_hash{m_rng.rand256()};
+        blockman.AddPowVerdict(pending_hash, seed_hash, 2);
+        blockman.PrunePowVerdicts(3);
+        BOOST_CHECK(blockman.m_pending_pow_verdicts.empty());
+        BOOST_CHECK(!blockman.HasPowVerdict(block_hash, seed_hash, 1));
+        BOOST_CHECK(!blockman.HasPowVerdict(first_hash, seed_hash, 2));
+        blockman.AddPowVerdict(m_rng.rand256(), seed_hash, 2);
+        BOOST_CHECK(blockman.m_pending_pow_verdicts.empty());
+        const uint256 kept_hash{m_rng.rand256()};
+        blockman.AddPowVerdict(kept_hash, seed_hash, 3);
+        BOOST_CHECK(blockman.WriteBlockIndexDB());
+        BOOST_CHECK(blockman.HasPowVerdict(kept_hash, seed_hash, 3));
+    }
+
+    // ...and are ignored when disabled
+    blockman_opts.persist_pow_verdicts = false;
+    {
+        BlockManager blockman{*Assert(m_node.shutdown_signal), blockman_opts};
+        LOCK(::cs_main);
+        BOOST_CHECK(!blockman.HasPowVerdict(block_hash, seed_hash, 1));
+        blockman.AddPowVerdict(block_hash, seed_hash, 1);
+        BOOST_CHECK(blockman.m_pending_pow_verdicts.empty());
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(blockmanager_block_index_image)
+{
+    KernelNotifications notifications{Assert(m_node.shutdown_request), m_node.exit_status, *Assert(m_node.warnings)};
+    node::BlockManager::Options blockman_opts{
+        .chainparams = Params(),
+        .blocks_dir = m_args.GetBlocksDirPath(),
+        .notifications = notifications,
+        .block_tree_db_params = DBParams{
+            .path = m_args.GetDataDirNet() / "blocks" / "index",
+            .cache_bytes = 0,
+        },
+        .block_index_image = true,
+    };
+
+    // A chain of 10 headers with a fork of 3 off height 5
+    std::map<uint256, std::pair<uint256, arith_uint256>> expected;
+    {
+        BlockManager blockman{*Assert(m_node.shutdown_signal), blockman_opts};
+        LOCK(::cs_main);
+        CBlockIndex* best_header{nullptr};
+        CBlockHeader header;
+        header.nBits = Params().GenesisBlock().nBits;
+        std::vector<CBlockIndex*> chain;
+        for (int i{0}; i < 13; ++i) {
+            header.hashPrevBlock = i == 0 ? uint256{} : chain[i == 10 ? 5 : i - 1]->GetBlockHash();
+            header.nNonce = i;
+            CBlockIndex* pindex{blockman.AddToBlockIndex(header, best_header)};
+            chain.push_back(pindex);
+            expected.emplace(pindex->GetBlockHash(), std::make_pair(header.hashPrevBlock, pindex->nChainWork));
+        }
+        BOOST_CHECK(blockman.WriteBlockIndexDB());
+        blockman.WriteBlockIndexImage();
+    }
+
+    const auto check_loaded{[&](BlockManager& blockman) EXCLUSIVE_LOCKS_REQUIRED(::cs_main) {
+        BOOST_CHECK_EQUAL(blockman.m_block_index.size(), expected.size());
+        for (const auto& [hash, entry] : expected) {
+            const CBlockIndex* pindex{blockman.LookupBlockIndex(hash)};
+            BOOST_REQUIRE(pindex);
+            BOOST_CHECK_EQUAL(pindex->pprev ? pindex->pprev->GetBlockHash() : uint256{}, entry.first);
+            BOOST_CHECK(pindex->nChainWork == entry.second);
+            BOOST_CHECK(pindex->IsValid(BLOCK_VALID_TREE));
+        }
+    }};
+
+    {
+        BlockManager blockman{*Assert(m_node.shutdown_signal), blockman_opts};
+        LOCK(::cs_main);
+        {
+            ASSERT_DEBUG_LOG("Loaded 13 block index entries from image");
+            BOOST_REQUIRE(blockman.LoadBlockIndexDB(std::nullopt));
+        }
+        check_loaded(blockman);
+        blockman.WriteBlockIndexImage();
+    }
+
+    // A corrupt image is ignored
+    {
+        FILE* file{fsbridge::fopen(blockman_opts.block_tree_db_params.path + ".img", "r+b")};
+        BOOST_REQUIRE(file);
+        BOOST_REQUIRE_EQUAL(std::fseek(file, 100, SEEK_SET), 0);
+        std::fputc(0xff, file);
+        BOOST_REQUIRE_EQUAL(std::fclose(file), 0);
+    }
+    {
+        BlockManager blockman{*Assert(m_node.shutdown_signal), blockman_opts};
+        LOCK(::cs_main);
+        {
+            ASSERT_DEBUG_LOG("does not match the block tree db (bad checksum)");
+            BOOST_REQUIRE(blockman.LoadBlockIndexDB(std::nullopt));
+        }
+        check_loaded(blockman);
+        blockman.WriteBlockIndexImage();
+    }
+
+    // So is one whose tip does not hash to the hash it is stored under, even
+    // with a valid checksum
+    {
+        const fs::path path{blockman_opts.block_tree_db_params.path + ".img"};
+        std::vector<std::byte> image(fs::file_size(path));
+        FILE* file{fsbridge::fopen(path, "r+b")};
+        BOOST_REQUIRE(file);
+        BOOST_REQUIRE_EQUAL(std::fread(image.data(), 1, image.size(), file), image.size());
+        std::byte* const tip_nonce{image.data() + image.size() - 140 + 104};
+        WriteLE32(tip_nonce, ReadLE32(tip_nonce) + 1);
+        WriteLE32(image.data() + 88, crc32c::Crc32c(UCharCast(image.data() + 96), image.size() - 96));
+        BOOST_REQUIRE_EQUAL(std::fseek(file, 0, SEEK_SET), 0);
+        BOOST_REQUIRE_EQUAL(std::fwrite(image.data(), 1, image.size(), file), image.size());
+        BOOST_REQUIRE_EQUAL(std::fclose(file), 0);
+    }
+    {
+        BlockManager blockman{*Assert(m_node.shutdown_signal), blockman_opts};
+        LOCK(::cs_main);
+        {
+            ASSERT_DEBUG_LOG("does not match the block tree db (bad record)");
+            BOOST_REQUIRE(blockman.LoadBlockIndexDB(std::nullopt));
+        }
+        check_loaded(blockman);
+        blockman.WriteBlockIndexImage();
+    }
+
+    // Any write to the db makes the image outdated, including those of
+    // versions that do not know to erase its tag
+    {
+        BlockManager blockman{*Assert(m_node.shutdown_signal), blockman_opts};
+        LOCK(::cs_main);
+        blockman.m_block_tree_db->WriteFlag("unknown", true);
+    }
+    {
+        BlockManager blockman{*Assert(m_node.shutdown_signal), blockman_opts};
+        LOCK(::cs_main);
+        {
+            ASSERT_DEBUG_LOG("does not match the block tree db (outdated)");
+            BOOST_REQUIRE(blockman.LoadBlockIndexDB(std::nullopt));
+        }
+        check_loaded(blockman);
+    }
+
+    // Writing the block index erases the tag of the image
+    {
+        BlockManager blockman{*Assert(m_node.shutdown_signal), blockman_opts};
+        LOCK(::cs_main);
+        BOOST_REQUIRE(blockman.LoadBlockIndexDB(std::nullopt));
+        BOOST_CHECK(blockman.WriteBlockIndexDB());
+    }
+    {
+        BlockManager blockman{*Assert(m_node.shutdown_signal), blockman_opts};
+        LOCK(::cs_main);
+        uint256 tag;
+        BOOST_CHECK(!blockman.m_block_tree_db->ReadBlockIndexImageTag(tag));
+        BOOST_REQUIRE(blockman.LoadBlockIndexDB(std::nullopt));
+        check_loaded(blockman);
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(blockmanager_reindex_pow_prefetch, TestChain100Setup)
+{
+    // The blocks on disk, with the seed hashes their proof of work was checked with
+    std::vector<std::pair<CBlock, uint256>> blocks;
+    CBlock bad_block;
+    uint256 bad_seed_hash;
+    {
+        ChainstateManager& chainman{*Assert(m_node.chainman)};
+        LOCK(::cs_main);
+        for (const CBlockIndex* pindex{chainman.ActiveChain().Genesis()}; pindex; pindex = chainman.ActiveChain().Next(pindex)) {
+            CBlock block;
+            BOOST_REQUIRE(chainman.m_blockman.ReadBlock(block, *pindex));
+            blocks.emplace_back(block, GetNextRandomXSeedHash(pindex->pprev));
+        }
+        bad_block = CreateBlock({}, CScript{} << OP_TRUE, chainman.ActiveChainstate());
+        bad_seed_hash = GetNextRandomXSeedHash(chainman.ActiveChain().Tip());
+        while (CheckProofOfWork(GetBlockPoWHash(bad_block, bad_seed_hash), bad_block.nBits, chainman.GetConsensus())) {
+            ++bad_block.nNonce;
+        }
+        chainman.ActiveChainstate().ForceFlushStateToDisk();
+    }
+
+    // Restart with -reindex
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    WITH_LOCK(::cs_main, m_node.chainman->ResetChainstates());
+    m_node.chainman.reset();
+    m_args.ForceSetArg("-reindex", "1");
+    m_make_chainman();
+    LoadVerifyActivateChainstate();
+    ChainstateManager& chainman{*Assert(m_node.chainman)};
+    BOOST_CHECK(!chainman.m_blockman.m_blockfiles_indexed);
+
+    // Rewrite the blocks out of order: block 3 before block 2, and block 50
+    // after block 100. The block that fails its proof of work goes into a
+    // file of its own.
+    std::vector<const CBlock*> order;
+    for (const auto& [block, seed_hash] : blocks) order.push_back(&block);
+    std::swap(order[2], order[3]);
+    std::rotate(order.begin() + 50, order.begin() + 51, order.end());
+    const auto write_file{[&](int file_num, const std::vector<const CBlock*>& file_blocks) {
+        AutoFile file{chainman.m_blockman.OpenBlockFile(FlatFilePos{file_num, 0}, /*fReadOnly=*/false)};
+        BOOST_REQUIRE(!file.IsNull());
+        for (const CBlock* block : file_blocks) {
+            file << chainman.GetParams().MessageStart() << uint32_t(GetSerializeSize(TX_WITH_WITNESS(*block))) << TX_WITH_WITNESS(*block);
+        }
+        BOOST_REQUIRE_EQUAL(file.fclose(), 0);
+    }};
+    write_file(0, order);
+    write_file(1, {&bad_block});
+
+    {
+        ReindexPowPrefetcher prefetcher{chainman, /*total_files=*/2};
+        prefetcher.Wait();
+    }
+    {
+        LOCK(::cs_main);
+        // Except for the genesis block, which is not checked
+        for (size_t i{1}; i < blocks.size(); ++i) {
+            BOOST_CHECK(chainman.m_blockman.HasPowVerdict(blocks[i].first.GetHash(), blocks[i].second, int(i)));
+        }
+        BOOST_CHECK(!chainman.m_blockman.HasPowVerdict(bad_block.GetHash(), bad_seed_hash, int(blocks.size())));
+    }
+
+    // Reindex the files like ImportBlocks does. None of the valid blocks is
+    // hashed again.
+    std::multimap<uint256, FlatFilePos> blocks_with_unknown_parent;
+    const auto time_pow{WITH_LOCK(::cs_main, return chainman.time_pow)};
+    {
+        FlatFilePos pos{0, 0};
+        AutoFile file{chainman.m_blockman.OpenBlockFile(pos, /*fReadOnly=*/true)};
+        chainman.LoadExternalBlockFile(file, &pos, &blocks_with_unknown_parent);
+    }
+    BOOST_CHECK(WITH_LOCK(::cs_main, return chainman.time_pow) == time_pow);
+    {
+        FlatFilePos pos{1, 0};
+        AutoFile file{chainman.m_blockman.OpenBlockFile(pos, /*fReadOnly=*/true)};
+        chainman.LoadExternalBlockFile(file, &pos, &blocks_with_unknown_parent);
+    }
+    BOOST_REQUIRE(chainman.ActivateBestChains());
+
+    LOCK(::cs_main);
+    BOOST_CHECK_EQUAL(chainman.ActiveHeight(), 100);
+    BOOST_CHECK_EQUAL(chainman.ActiveTip()->GetBlockHash(), blocks.back().first.GetHash());
+    BOOST_CHECK(!chainman.m_blockman.LookupBlockIndex(bad_block.GetHash()));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
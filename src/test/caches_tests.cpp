@@ -2,6 +2,7 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or https://opensource.org/license/mit.
 
+#include <kernel/caches.h>
 #include <node/caches.h>
 #include <util/byte_units.h>
 
@@ -41,4 +42,31 @@ BOOST_AUTO_TEST_CASE(oversized_dbcache_warning)
     }
 }
 
+BOOST_AUTO_TEST_CASE(adapt_coins_db_cache)
+{
+    using kernel::AdaptCoinsDBCache;
+    constexpr size_t total{1024_MiB};
+    constexpr size_t initial{MAX_COINS_DB_CACHE};
+
+    // Too few lookups to decide on.
+    BOOST_CHECK_EQUAL(AdaptCoinsDBCache(initial, initial, total, /*hits=*/1'000, /*misses=*/1'000, /*coins_cache_warm=*/true), initial);
+
+    // Frequent misses in a warm coins cache double the coinsdb cache, up to a quarter of the total.
+    BOOST_CHECK_EQUAL(AdaptCoinsDBCache(initial, initial, total, 900'000, 100'000, true), 2 * initial);
+    BOOST_CHECK_EQUAL(AdaptCoinsDBCache(200_MiB, initial, total, 900'000, 100'000, true), total / 4);
+    BOOST_CHECK_EQUAL(AdaptCoinsDBCache(total / 4, initial, total, 900'000, 100'000, true), total / 4);
+    BOOST_CHECK_EQUAL(AdaptCoinsDBCache(initial, initial, 16_MiB, 900'000, 100'000, true), initial);
+
+    // Misses while the coins cache is still filling up are not the coinsdb cache's to fix.
+    BOOST_CHECK_EQUAL(AdaptCoinsDBCache(initial, initial, total, 900'000, 100'000, false), initial);
+
+    // In between, nothing changes.
+    BOOST_CHECK_EQUAL(AdaptCoinsDBCache(64_MiB, initial, total, 990'000, 10'000, true), 64_MiB);
+
+    // Rare misses halve the coinsdb cache, but not below its initial size.
+    BOOST_CHECK_EQUAL(AdaptCoinsDBCache(64_MiB, initial, total, 999'000, 1'000, true), 32_MiB);
+    BOOST_CHECK_EQUAL(AdaptCoinsDBCache(12_MiB, initial, total, 999'000, 1'000, false), initial);
+    BOOST_CHECK_EQUAL(AdaptCoinsDBCache(initial, initial, total, 1'000'000, 0, true), initial);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
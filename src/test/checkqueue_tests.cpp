@@ -135,6 +135,23 @@ struct FrozenCleanupCheck {
     }
 };
 
+/** Check that defers its failure to the batch of the worker running it. */
+struct BatchedCheck {
+    struct Batch {
+        bool m_valid{true};
+        bool Verify() { return std::exchange(m_valid, true); }
+    };
+    static std::atomic<size_t> n_batched_calls;
+    bool m_fails{false};
+    std::optional<int> operator()(Batch* batch = nullptr) const
+    {
+        if (!batch) return m_fails ? std::make_optional<int>(1) : std::nullopt;
+        n_batched_calls.fetch_add(1, std::memory_order_relaxed);
+        if (m_fails) batch->m_valid = false;
+        return std::nullopt;
+    }
+};
+
 // Static Allocations
 std::mutex FrozenCleanupCheck::m{};
 std::atomic<uint64_t> FrozenCleanupCheck::nFrozen{0};
@@ -143,6 +160,7 @@ Mutex UniqueCheck::m;
 std::unordered_multiset<size_t> UniqueCheck::results;
 std::atomic<size_t> FakeCheckCheckCompletion::n_calls{0};
 std::atomic<size_t> MemoryCheck::fake_allocated_memory{0};
+std::atomic<size_t> BatchedCheck::n_batched_calls{0};
 
 // Queue Typedefs
 typedef CCheckQueue<FakeCheckCheckCompletion> Correct_Queue;
@@ -151,6 +169,7 @@ typedef CCheckQueue<FixedCheck> Fixed_Queue;
 typedef CCheckQueue<UniqueCheck> Unique_Queue;
 typedef CCheckQueue<MemoryCheck> Memory_Queue;
 typedef CCheckQueue<FrozenCleanupCheck> FrozenCleanup_Queue;
+typedef CCheckQueue<BatchedCheck> Batched_Queue;
 
 
 /** This test case checks that the CCheckQueue works properly
@@ -259,6 +278,29 @@ BOOST_AUTO_TEST_CASE(test_CheckQueue_Recovers_From_Failure)
     }
 }
 
+// Test that failures deferred to the batches of the workers are caught, and
+// are attributed to a check by running the checks again without a batch. A
+// queue without workers (-par=1) batches the checks on the master thread.
+BOOST_AUTO_TEST_CASE(test_CheckQueue_Batch)
+{
+    for (const int threads : {0, SCRIPT_CHECK_THREADS}) {
+        auto batched_queue = std::make_unique<Batched_Queue>(QUEUE_BATCH_SIZE, threads);
+        for (auto times = 0; times < 10; ++times) {
+            for (const bool fails : {true, false}) {
+                BatchedCheck::n_batched_calls = 0;
+                CCheckQueueControl<BatchedCheck> control(*batched_queue);
+                std::vector<BatchedCheck> vChecks(1000);
+                if (fails) vChecks[m_rng.randrange(vChecks.size())].m_fails = true;
+                control.Add(std::move(vChecks));
+                const auto result{control.Complete()};
+                BOOST_REQUIRE_EQUAL(result.has_value(), fails);
+                if (fails) BOOST_CHECK_EQUAL(*result, 1);
+                if (!fails) BOOST_CHECK_EQUAL(BatchedCheck::n_batched_calls, 1000U);
+            }
+        }
+    }
+}
+
 // Test that unique checks are actually all called individually, rather than
 // just one check being called repeatedly. Test that checks are not called
 // more than once as well
@@ -6,6 +6,7 @@
 #include <clientversion.h>
 #include <coins.h>
 #include <streams.h>
+#include <test/util/logging.h>
 #include <test/util/poolresourcetester.h>
 #include <test/util/random.h>
 #include <test/util/setup_common.h>
@@ -14,7 +15,10 @@
 #include <undo.h>
 #include <util/strencodings.h>
 
+#include <future>
 #include <map>
+#include <set>
+#include <stdexcept>
 #include <string>
 #include <variant>
 #include <vector>
@@ -1055,6 +1059,40 @@ BOOST_FIXTURE_TEST_CASE(ccoins_flush_behavior, FlushTest)
     }
 }
 
+BOOST_AUTO_TEST_CASE(ccoins_db_cursor_seek)
+{
+    CCoinsViewDB base{{.path = "test", .cache_bytes = 1 << 23, .memory_only = true}, {}};
+    CCoinsViewCache cache{&base};
+    std::set<COutPoint> outpoints;
+    for (int i{0}; i < 100; ++i) {
+        const COutPoint outpoint{Txid::FromUint256(m_rng.rand256()), static_cast<uint32_t>(m_rng.randrange(3))};
+        cache.AddCoin(outpoint, Coin{CTxOut{1, CScript{} << OP_TRUE}, 1, false}, /*possible_overwrite=*/true);
+        outpoints.insert(outpoint);
+    }
+    cache.SetBestBlock(m_rng.rand256());
+    cache.Flush();
+
+    const auto cursor{base.Cursor()};
+    COutPoint key;
+    for (const COutPoint& outpoint : outpoints) {
+        // Seeking to a coin finds it, and seeking just past it finds the next one.
+        cursor->Seek(outpoint);
+        BOOST_REQUIRE(cursor->Valid() && cursor->GetKey(key));
+        BOOST_CHECK(key == outpoint);
+        cursor->Seek(COutPoint{outpoint.hash, outpoint.n + 1});
+        const auto next{outpoints.upper_bound(outpoint)};
+        if (next == outpoints.end()) {
+            BOOST_CHECK(!cursor->Valid());
+        } else {
+            BOOST_REQUIRE(cursor->GetKey(key));
+            BOOST_CHECK(key == *next);
+        }
+    }
+    cursor->Seek(COutPoint{Txid{}, 0});
+    BOOST_REQUIRE(cursor->GetKey(key));
+    BOOST_CHECK(key == *outpoints.begin());
+}
+
 BOOST_AUTO_TEST_CASE(coins_resource_is_used)
 {
     CCoinsMapMemoryResource resource;
@@ -1116,6 +1154,26 @@ BOOST_AUTO_TEST_CASE(ccoins_emplace_duplicate_keeps_usage_balanced)
     BOOST_CHECK(cache.AccessCoin(outpoint) == coin1);
 }
 
+BOOST_AUTO_TEST_CASE(ccoins_prefetch_keeps_hit_counters)
+{
+    CCoinsView root;
+    CCoinsViewCacheTest cache{&root};
+
+    const COutPoint outpoint{Txid::FromUint256(m_rng.rand256()), m_rng.rand32()};
+    const Coin coin{CTxOut{m_rng.randrange(10), CScript{} << m_rng.randbytes(CScriptBase::STATIC_SIZE + 1)}, 1, false};
+
+    // A prefetched coin counts as the miss its first lookup would have been.
+    cache.EmplaceCoinFromBase(outpoint, Coin{coin});
+    cache.EmplaceCoinFromBase(outpoint, Coin{coin});
+    BOOST_CHECK_EQUAL(cache.GetCacheMisses(), 1U);
+    BOOST_CHECK(cache.AccessCoin(outpoint) == coin);
+    BOOST_CHECK_EQUAL(cache.GetCacheHits(), 0U);
+    BOOST_CHECK(cache.AccessCoin(outpoint) == coin);
+    BOOST_CHECK_EQUAL(cache.GetCacheHits(), 1U);
+    BOOST_CHECK_EQUAL(cache.GetCacheMisses(), 1U);
+    cache.SelfTest();
+}
+
 BOOST_AUTO_TEST_CASE(ccoins_reset_guard)
 {
     CCoinsViewTest root{m_rng};
@@ -1159,4 +1217,108 @@ BOOST_AUTO_TEST_CASE(ccoins_reset_guard)
     BOOST_CHECK(!root_cache.HaveCoinInCache(outpoint));
 }
 
+/** Coins view whose writes block until released, and optionally fail once. */
+class BlockingCoinsView : public CCoinsView
+{
+public:
+    std::map<COutPoint, Coin> m_coins;
+    uint256 m_best_block;
+    std::shared_future<void> m_release;
+    bool m_fail_once{false};
+
+    std::optional<Coin> GetCoin(const COutPoint& outpoint) const override
+    {
+        if (auto it{m_coins.find(outpoint)}; it != m_coins.end()) return it->second;
+        return std::nullopt;
+    }
+
+    uint256 GetBestBlock() const override { return m_best_block; }
+
+    void BatchWrite(CoinsViewCacheCursor& cursor, const uint256& hashBlock) override
+    {
+        if (m_release.valid()) m_release.wait();
+        if (std::exchange(m_fail_once, false)) throw std::runtime_error("write error");
+        for (auto it{cursor.Begin()}; it != cursor.End(); it = cursor.NextAndMaybeErase(*it)) {
+            if (it->second.coin.IsSpent()) {
+                m_coins.erase(it->first);
+            } else {
+                m_coins[it->first] = it->second.coin;
+            }
+        }
+        m_best_block = hashBlock;
+    }
+};
+
+BOOST_AUTO_TEST_CASE(ccoins_flush_buffer)
+{
+    BlockingCoinsView db;
+    const COutPoint spent{Txid::FromUint256(m_rng.rand256()), 0};
+    const COutPoint added{Txid::FromUint256(m_rng.rand256()), 1};
+    const Coin coin{CTxOut{m_rng.randrange(10), CScript{} << m_rng.randbytes(CScriptBase::STATIC_SIZE + 1)}, 1, false};
+    db.m_coins.emplace(spent, coin);
+    db.m_best_block = m_rng.rand256();
+
+    CCoinsViewFlushBuffer buffer{&db};
+    CCoinsViewCache cache{&buffer};
+    const uint256 best_block{m_rng.rand256()};
+    BOOST_CHECK(cache.SpendCoin(spent));
+    cache.AddCoin(added, Coin{coin}, /*possible_overwrite=*/false);
+    cache.SetBestBlock(best_block);
+
+    std::promise<void> release;
+    db.m_release = release.get_future().share();
+    cache.Flush();
+
+    // While the write is blocked, the flushed state is served from the buffer.
+    BOOST_CHECK(buffer.IsWriting());
+    BOOST_CHECK_GT(buffer.DynamicMemoryUsage(), 0U);
+    BOOST_CHECK_EQUAL(cache.GetCacheSize(), 0U);
+    BOOST_CHECK(!cache.HaveCoin(spent));
+    BOOST_CHECK(cache.AccessCoin(added) == coin);
+    BOOST_CHECK_EQUAL(cache.GetBestBlock(), best_block);
+    buffer.ReleaseWritten();
+    BOOST_CHECK(buffer.IsWriting());
+
+    release.set_value();
+    buffer.WaitForWrite();
+    BOOST_CHECK(!buffer.IsWriting());
+    BOOST_CHECK_EQUAL(buffer.DynamicMemoryUsage(), 0U);
+    BOOST_CHECK(!db.m_coins.contains(spent));
+    BOOST_CHECK(db.m_coins.at(added) == coin);
+    BOOST_CHECK_EQUAL(db.m_best_block, best_block);
+    BOOST_CHECK_EQUAL(buffer.GetBestBlock(), best_block);
+}
+
+BOOST_AUTO_TEST_CASE(ccoins_flush_buffer_write_error)
+{
+    BlockingCoinsView db;
+    db.m_best_block = m_rng.rand256();
+    db.m_fail_once = true;
+
+    CCoinsViewFlushBuffer buffer{&db};
+    CCoinsViewCache cache{&buffer};
+    const COutPoint outpoint{Txid::FromUint256(m_rng.rand256()), 0};
+    const Coin coin{CTxOut{m_rng.randrange(10), CScript{} << m_rng.randbytes(CScriptBase::STATIC_SIZE + 1)}, 1, false};
+    cache.AddCoin(outpoint, Coin{coin}, /*possible_overwrite=*/false);
+    cache.SetBestBlock(m_rng.rand256());
+    cache.Flush();
+
+    // A failed write keeps the coins readable, and is retried by the next wait.
+    BOOST_CHECK_THROW(buffer.WaitForWrite(), std::runtime_error);
+    BOOST_CHECK(buffer.HaveCoin(outpoint));
+    BOOST_CHECK(db.m_coins.empty());
+    buffer.WaitForWrite();
+    BOOST_CHECK(db.m_coins.at(outpoint) == coin);
+    BOOST_CHECK(buffer.HaveCoin(outpoint));
+
+    // A failed write nobody waited for is not lost silently on destruction.
+    db.m_fail_once = true;
+    ASSERT_DEBUG_LOG("Failed to write coins up to block");
+    CCoinsViewFlushBuffer unwaited_buffer{&db};
+    CCoinsViewCache unwaited_cache{&unwaited_buffer};
+    unwaited_cache.AddCoin(COutPoint{Txid::FromUint256(m_rng.rand256()), 0}, Coin{coin}, /*possible_overwrite=*/false);
+    unwaited_cache.SetBestBlock(m_rng.rand256());
+    unwaited_cache.Flush();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
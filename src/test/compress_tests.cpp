@@ -3,7 +3,10 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <compressor.h>
+#include <consensus/amount.h>
+#include <primitives/block.h>
 #include <script/script.h>
+#include <streams.h>
 #include <test/util/random.h>
 #include <test/util/setup_common.h>
 
@@ -164,4 +167,51 @@ BOOST_AUTO_TEST_CASE(compress_p2pk_scripts_not_on_curve)
     }
 }
 
+BOOST_AUTO_TEST_CASE(compress_transactions)
+{
+    CMutableTransaction coinbase;
+    coinbase.vin.emplace_back(COutPoint{});
+    coinbase.vin[0].scriptSig = CScript() << 1234 << OP_0;
+    coinbase.vout.emplace_back(50 * COIN, CScript() << OP_DUP << OP_HASH160 << m_rng.randbytes(20) << OP_EQUALVERIFY << OP_CHECKSIG);
+
+    CMutableTransaction spend;
+    spend.version = 2;
+    spend.nLockTime = 1234;
+    for (uint32_t sequence : {CTxIn::SEQUENCE_FINAL, CTxIn::MAX_SEQUENCE_NONFINAL, uint32_t{0}}) {
+        spend.vin.emplace_back(COutPoint{Txid::FromUint256(m_rng.rand256()), m_rng.rand32()}, CScript{}, sequence);
+        spend.vin.back().scriptWitness.stack = {m_rng.randbytes(72), m_rng.randbytes(33)};
+    }
+    spend.vout.emplace_back(COIN / 3, CScript() << OP_HASH160 << m_rng.randbytes(20) << OP_EQUAL);
+    spend.vout.emplace_back(0, CScript() << OP_RETURN << m_rng.randbytes(40));
+    spend.vout.emplace_back(MAX_MONEY, CScript() << OP_0 << m_rng.randbytes(32));
+
+    CBlock block;
+    block.nTime = 1231006505;
+    block.vtx = {MakeTransactionRef(coinbase), MakeTransactionRef(spend)};
+    BOOST_REQUIRE(IsBlockCompressible(block));
+
+    DataStream compressed;
+    compressed << Using<BlockCompression>(block);
+    BOOST_CHECK_LT(compressed.size(), GetSerializeSize(TX_WITH_WITNESS(block)));
+
+    CBlock decompressed;
+    compressed >> Using<BlockCompression>(decompressed);
+    BOOST_CHECK(compressed.empty());
+    BOOST_CHECK_EQUAL(decompressed.GetHash(), block.GetHash());
+    BOOST_REQUIRE_EQUAL(decompressed.vtx.size(), block.vtx.size());
+    for (size_t i{0}; i < block.vtx.size(); ++i) {
+        BOOST_CHECK_EQUAL(decompressed.vtx[i]->GetWitnessHash(), block.vtx[i]->GetWitnessHash());
+    }
+
+    // Outputs that do not round trip make the transaction not compressible
+    spend.vout.emplace_back(-1, CScript{});
+    BOOST_CHECK(!IsTxCompressible(CTransaction{spend}));
+    CScript oversized;
+    oversized.resize(MAX_SCRIPT_SIZE + 1);
+    spend.vout.back() = CTxOut{0, oversized};
+    BOOST_CHECK(!IsTxCompressible(CTransaction{spend}));
+    block.vtx.push_back(MakeTransactionRef(spend));
+    BOOST_CHECK(!IsBlockCompressible(block));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -3,9 +3,11 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <dbwrapper.h>
+#include <logdb.h>
 #include <test/util/random.h>
 #include <test/util/setup_common.h>
 #include <uint256.h>
+#include <util/fs_helpers.h>
 #include <util/string.h>
 
 #include <memory>
@@ -422,5 +424,61 @@ BOOST_AUTO_TEST_CASE(unicodepath)
     BOOST_CHECK(fs::exists(lockPath));
 }
 
+#ifndef WIN32
+BOOST_AUTO_TEST_CASE(dbwrapper_engine_migration)
+{
+    const fs::path path{m_args.GetDataDirBase() / "dbwrapper_migration"};
+    Obfuscation obfuscation;
+    std::vector<std::pair<uint32_t, uint256>> key_values;
+    {
+        CDBWrapper dbw{{.path = path, .cache_bytes = 1 << 20, .obfuscate = true}};
+        obfuscation = dbwrapper_private::GetObfuscation(dbw);
+        for (uint32_t i{0}; i < 1000; ++i) {
+            key_values.emplace_back(i, m_rng.rand256());
+            dbw.Write(key_values.back().first, key_values.back().second);
+        }
+    }
+
+    // Opening a database with another engine keeps it as is unless it is
+    // asked to be migrated.
+    {
+        CDBWrapper dbw{{.path = path, .cache_bytes = 1 << 20, .obfuscate = true, .options = {.engine = DBEngine::LOGDB}}};
+        BOOST_CHECK(!LogDB::IsLogDB(path));
+        BOOST_CHECK(dbw.Engine() == DBEngine::LEVELDB);
+        uint256 res;
+        BOOST_CHECK(dbw.Read(key_values.front().first, res));
+        BOOST_CHECK_EQUAL(res.ToString(), key_values.front().second.ToString());
+    }
+
+    // Migrating converts it, and back again.
+    for (const DBEngine engine : {DBEngine::LOGDB, DBEngine::LEVELDB, DBEngine::LOGDB}) {
+        CDBWrapper dbw{{.path = path, .cache_bytes = 1 << 20, .obfuscate = true, .options = {.engine = engine, .migrate = true}}};
+        BOOST_CHECK_EQUAL(LogDB::IsLogDB(path), engine == DBEngine::LOGDB);
+        BOOST_CHECK(dbw.Engine() == engine);
+        BOOST_CHECK(!fs::exists(fs::PathFromString(fs::PathToString(path) + ".migrate")));
+        BOOST_CHECK_EQUAL(obfuscation, dbwrapper_private::GetObfuscation(dbw));
+        for (const auto& [key, value] : key_values) {
+            uint256 res;
+            BOOST_CHECK(dbw.Read(key, res));
+            BOOST_CHECK_EQUAL(res.ToString(), value.ToString());
+        }
+        dbw.Erase(key_values.back().first);
+        key_values.pop_back();
+    }
+
+    // An incomplete migration is discarded on startup.
+    const fs::path tmp_path{fs::PathFromString(fs::PathToString(path) + ".migrate")};
+    TryCreateDirectories(tmp_path);
+    {
+        CDBWrapper dbw{{.path = path, .cache_bytes = 1 << 20, .obfuscate = true, .options = {.engine = DBEngine::LOGDB}}};
+        BOOST_CHECK(!fs::exists(tmp_path));
+        BOOST_CHECK_GT(dbw.EstimateSize(uint32_t{0}, uint32_t{1000}), 0U);
+    }
+
+    BOOST_CHECK(DestroyDB(fs::PathToString(path)));
+    BOOST_CHECK(!fs::exists(path));
+}
+#endif // WIN32
+
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -16,6 +16,8 @@
 #include <cassert>
 #include <cstdint>
 #include <iosfwd>
+#include <optional>
+#include <span>
 #include <unordered_set>
 #include <vector>
 
@@ -80,6 +82,19 @@ FUZZ_TARGET(golomb_rice)
 
     assert(encoded_deltas == decoded_deltas);
 
+    {
+        SpanReader stream{golomb_rice_data};
+        const uint32_t n = static_cast<uint32_t>(ReadCompactSize(stream));
+        GolombRiceDecoder decoder{std::span{golomb_rice_data}.last(stream.size())};
+        decoded_deltas.clear();
+        for (uint32_t i = 0; i < n; ++i) {
+            decoded_deltas.push_back(decoder.Decode(BASIC_FILTER_P));
+        }
+        assert(decoder.BytesRead() == stream.size());
+    }
+
+    assert(encoded_deltas == decoded_deltas);
+
     {
         const std::vector<uint8_t> random_bytes = ConsumeRandomLengthByteVector(fuzzed_data_provider, 1024);
         SpanReader stream{random_bytes};
@@ -89,12 +104,20 @@ FUZZ_TARGET(golomb_rice)
         } catch (const std::ios_base::failure&) {
             return;
         }
+        GolombRiceDecoder decoder{std::span{random_bytes}.last(stream.size())};
         BitStreamReader bitreader{stream};
         for (uint32_t i = 0; i < std::min<uint32_t>(n, 1024); ++i) {
+            std::optional<uint64_t> value;
+            try {
+                value = GolombRiceDecode(bitreader, BASIC_FILTER_P);
+            } catch (const std::ios_base::failure&) {
+            }
             try {
-                (void)GolombRiceDecode(bitreader, BASIC_FILTER_P);
+                assert(decoder.Decode(BASIC_FILTER_P) == value);
             } catch (const std::ios_base::failure&) {
+                assert(!value);
             }
+            if (!value) break;
         }
     }
 }
@@ -112,6 +112,8 @@ const std::vector<std::string> RPC_COMMANDS_SAFE_FOR_FUZZING{
     "generate",
     "generateblock",
     "getaddednodeinfo",
+    "getaddressbalance",
+    "getaddresshistory",
     "getaddrmaninfo",
     "getbestblockhash",
     "getblock",
@@ -123,6 +125,7 @@ const std::vector<std::string> RPC_COMMANDS_SAFE_FOR_FUZZING{
     "getblockheader",
     "getblockstats",
     "getblocktemplate",
+    "getblockvalidationstats",
     "getchaintips",
     "getchainstates",
     "getchaintxstats",
@@ -147,6 +150,7 @@ const std::vector<std::string> RPC_COMMANDS_SAFE_FOR_FUZZING{
     "getorphantxs",
     "getpeerinfo",
     "getprioritisedtransactions",
+    "getrandomxinfo",
     "getrawaddrman",
     "getrawmempool",
     "getrawtransaction",
@@ -0,0 +1,203 @@
+// Copyright (c) 2026-present The Botcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <coins.h>
+#include <inputfetcher.h>
+#include <primitives/block.h>
+#include <primitives/transaction.h>
+#include <script/script.h>
+#include <sync.h>
+#include <test/util/random.h>
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+/** Read-only coins view that records which outpoints were looked up. */
+class RecordingCoinsView : public CCoinsView
+{
+public:
+    std::map<COutPoint, Coin> m_coins;
+    mutable Mutex m_mutex;
+    mutable std::multiset<COutPoint> m_lookups GUARDED_BY(m_mutex);
+    bool m_throw{false};
+
+    std::optional<Coin> GetCoin(const COutPoint& outpoint) const override
+    {
+        WITH_LOCK(m_mutex, m_lookups.insert(outpoint));
+        if (m_throw) throw std::runtime_error("read error");
+        if (auto it{m_coins.find(outpoint)}; it != m_coins.end()) return it->second;
+        return std::nullopt;
+    }
+
+    size_t m_written{0};
+
+    void BatchWrite(CoinsViewCacheCursor& cursor, const uint256& hashBlock) override
+    {
+        for (auto it{cursor.Begin()}; it != cursor.End(); it = cursor.NextAndMaybeErase(*it)) ++m_written;
+    }
+};
+
+Coin MakeCoin(CAmount value)
+{
+    return Coin{CTxOut{value, CScript{} << OP_TRUE}, /*nHeightIn=*/1, /*fCoinBaseIn=*/false};
+}
+
+CTransactionRef MakeSpend(const std::vector<COutPoint>& prevouts)
+{
+    CMutableTransaction tx;
+    for (const auto& prevout : prevouts) tx.vin.emplace_back(prevout);
+    tx.vout.emplace_back(1, CScript{} << OP_TRUE);
+    tx.vout.emplace_back(2, CScript{} << OP_TRUE);
+    return MakeTransactionRef(std::move(tx));
+}
+
+CTransactionRef MakeCoinbase()
+{
+    CMutableTransaction tx;
+    tx.vin.emplace_back(COutPoint{});
+    tx.vin[0].scriptSig = CScript{} << 1 << OP_0;
+    tx.vout.emplace_back(50, CScript{} << OP_TRUE);
+    return MakeTransactionRef(std::move(tx));
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(inputfetcher_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(fetch_block_inputs)
+{
+    RecordingCoinsView db;
+    std::vector<COutPoint> db_outpoints;
+    for (int i{0}; i < 200; ++i) {
+        db_outpoints.emplace_back(Txid::FromUint256(m_rng.rand256()), i % 3);
+        db.m_coins.emplace(db_outpoints.back(), MakeCoin(i + 1));
+    }
+    const COutPoint missing{Txid::FromUint256(m_rng.rand256()), 0};
+
+    CBlock block;
+    block.vtx.push_back(MakeCoinbase());
+    for (size_t i{0}; i < db_outpoints.size(); i += 4) {
+        block.vtx.push_back(MakeSpend({db_outpoints.begin() + i, db_outpoints.begin() + i + 4}));
+    }
+    // Spend outputs created earlier in the same block, and one that does not exist.
+    const CTransactionRef parent{block.vtx[1]};
+    block.vtx.push_back(MakeSpend({COutPoint{parent->GetHash(), 0}, COutPoint{parent->GetHash(), 1}, missing}));
+
+    for (int threads : {0, 1, 4}) {
+        InputFetcher fetcher{/*batch_size=*/8, threads};
+        CCoinsViewCache view{&db};
+        BOOST_CHECK(view.HaveCoin(db_outpoints[0]));
+        WITH_LOCK(db.m_mutex, db.m_lookups.clear());
+        const auto stats{fetcher.FetchInputs(view, db, block)};
+
+        LOCK(db.m_mutex);
+        if (threads == 0) {
+            BOOST_CHECK_EQUAL(stats.inputs, 0U);
+            BOOST_CHECK(db.m_lookups.empty());
+            BOOST_CHECK_EQUAL(view.GetCacheSize(), 1U);
+            continue;
+        }
+        // Only the inputs missing from the cache are read, each once.
+        BOOST_CHECK_EQUAL(stats.inputs, db_outpoints.size() + 1);
+        BOOST_CHECK_EQUAL(stats.cache_hits, 1U);
+        BOOST_CHECK_EQUAL(db.m_lookups.size(), db_outpoints.size());
+        BOOST_CHECK_EQUAL(db.m_lookups.count(db_outpoints[0]), 0U);
+        BOOST_CHECK_EQUAL(db.m_lookups.count(missing), 1U);
+        BOOST_CHECK_EQUAL(db.m_lookups.count(COutPoint{parent->GetHash(), 0}), 0U);
+        for (size_t i{1}; i < db_outpoints.size(); ++i) {
+            BOOST_CHECK_EQUAL(db.m_lookups.count(db_outpoints[i]), 1U);
+        }
+        for (const auto& outpoint : db_outpoints) {
+            BOOST_CHECK(view.HaveCoinInCache(outpoint));
+        }
+        BOOST_CHECK(!view.HaveCoinInCache(missing));
+    }
+
+    // Fetching into a cache holding an unflushed spend must not resurrect the coin.
+    CCoinsViewCache cache{&db};
+    BOOST_CHECK(cache.HaveCoin(db_outpoints[0]));
+    BOOST_CHECK(cache.SpendCoin(db_outpoints[1]));
+    InputFetcher fetcher{/*batch_size=*/8, /*worker_threads_num=*/2};
+    fetcher.FetchInputs(cache, db, block);
+    BOOST_CHECK(cache.HaveCoinInCache(db_outpoints[0]));
+    BOOST_CHECK(!cache.HaveCoin(db_outpoints[1]));
+    for (size_t i{2}; i < db_outpoints.size(); ++i) {
+        BOOST_CHECK(cache.HaveCoinInCache(db_outpoints[i]));
+        BOOST_CHECK(cache.AccessCoin(db_outpoints[i]).out == db.m_coins.at(db_outpoints[i]).out);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(fetch_inputs_pending)
+{
+    RecordingCoinsView db;
+    const COutPoint in_db{Txid::FromUint256(m_rng.rand256()), 0};
+    const COutPoint in_pending{Txid::FromUint256(m_rng.rand256()), 0};
+    db.m_coins.emplace(in_db, MakeCoin(1));
+
+    CBlock block;
+    block.vtx.push_back(MakeCoinbase());
+    block.vtx.push_back(MakeSpend({in_db, in_pending}));
+
+    // Outputs created by blocks whose changes have not reached the cache
+    // yet are not looked up in the database.
+    CCoinsViewCache cache{&db};
+    CCoinsViewCache pending{&cache};
+    pending.AddCoin(in_pending, MakeCoin(2), /*possible_overwrite=*/false);
+    InputFetcher fetcher{/*batch_size=*/1, /*worker_threads_num=*/2};
+    const auto stats{fetcher.FetchInputs(cache, db, block, &pending)};
+    BOOST_CHECK_EQUAL(stats.inputs, 2U);
+    BOOST_CHECK_EQUAL(stats.cache_hits, 1U);
+    BOOST_CHECK(cache.HaveCoinInCache(in_db));
+    BOOST_CHECK(!cache.HaveCoinInCache(in_pending));
+    LOCK(db.m_mutex);
+    BOOST_CHECK_EQUAL(db.m_lookups.count(in_db), 1U);
+    BOOST_CHECK_EQUAL(db.m_lookups.count(in_pending), 0U);
+}
+
+BOOST_AUTO_TEST_CASE(fetch_inputs_not_dirty)
+{
+    RecordingCoinsView db;
+    const COutPoint outpoint{Txid::FromUint256(m_rng.rand256()), 0};
+    db.m_coins.emplace(outpoint, MakeCoin(1));
+
+    CBlock block;
+    block.vtx.push_back(MakeCoinbase());
+    block.vtx.push_back(MakeSpend({outpoint}));
+
+    CCoinsViewCache cache{&db};
+    InputFetcher fetcher{/*batch_size=*/1, /*worker_threads_num=*/2};
+    fetcher.FetchInputs(cache, db, block);
+    BOOST_CHECK(cache.HaveCoinInCache(outpoint));
+
+    // Prefetched coins are clean, so flushing writes nothing to the database.
+    cache.Flush();
+    BOOST_CHECK_EQUAL(db.m_written, 0U);
+}
+
+BOOST_AUTO_TEST_CASE(fetch_inputs_read_error)
+{
+    RecordingCoinsView db;
+    db.m_throw = true;
+    const COutPoint outpoint{Txid::FromUint256(m_rng.rand256()), 0};
+
+    CBlock block;
+    block.vtx.push_back(MakeCoinbase());
+    block.vtx.push_back(MakeSpend({outpoint}));
+
+    CCoinsViewCache cache{&db};
+    InputFetcher fetcher{/*batch_size=*/1, /*worker_threads_num=*/2};
+    // Read errors are left for ConnectBlock to run into.
+    fetcher.FetchInputs(cache, db, block);
+    BOOST_CHECK(!cache.HaveCoinInCache(outpoint));
+    BOOST_CHECK_EQUAL(WITH_LOCK(db.m_mutex, return db.m_lookups.size()), 1U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -334,6 +334,59 @@ BOOST_AUTO_TEST_CASE(bip340_test_vectors)
     }
 }
 
+BOOST_AUTO_TEST_CASE(bip340_batch_verification)
+{
+    SchnorrSignatureBatch batch{m_rng.rand256()};
+    // An empty batch is valid.
+    BOOST_CHECK(batch.Verify());
+
+    // Batches of up to three times the signatures held at once, half of them
+    // with a signature of another message.
+    for (size_t round = 0; round < 8; ++round) {
+        const size_t count{1 + m_rng.randrange(3 * SchnorrSignatureBatch::MAX_SIGS)};
+        const bool valid{round % 2 == 0};
+        const size_t invalid{m_rng.randrange(count)};
+        for (size_t i = 0; i < count; ++i) {
+            const CKey key{GenerateRandomKey()};
+            const uint256 msg{m_rng.rand256()};
+            unsigned char sig[64];
+            BOOST_REQUIRE(key.SignSchnorr(msg, sig, nullptr, m_rng.rand256()));
+            BOOST_CHECK(batch.Add(XOnlyPubKey{key.GetPubKey()}, valid || i != invalid ? msg : m_rng.rand256(), sig));
+        }
+        BOOST_CHECK_EQUAL(batch.Verify(), valid);
+    }
+
+    // The BIP340 test vectors, each in a batch of its own and in a batch with
+    // the valid ones. Some are rejected as soon as they are added.
+    const std::vector<std::array<std::string, 3>> valid_vectors{
+        {"F9308A019258C31049344F85F89D5229B531C845836F99B08601F113BCE036F9", "0000000000000000000000000000000000000000000000000000000000000000", "E907831F80848D1069A5371B402410364BDF1C5F8307B0084C55F1CE2DCA821525F66A4A85EA8B71E482A74F382D2CE5EBEEE8FDB2172F477DF4900D310536C0"},
+        {"D69C3509BB99E412E68B0FE8544E72837DFA30746D8BE2AA65975F29D22DC7B9", "4DF3C3F68FCC83B27E9D42C90431A72499F17875C81A599B566C9889B9696703", "00000000000000000000003B78CE563F89A0ED9414F5AA28AD0D96D6795F9C6376AFB1548AF603B3EB45C9F8207DEE1060CB71C04E80F593060B07D28308D7F4"},
+    };
+    const std::vector<std::array<std::string, 3>> invalid_vectors{
+        {"DFF1D77F2A671C5F36183726DB2341BE58FEAE1DA2DECED843240F7B502BA659", "243F6A8885A308D313198A2E03707344A4093822299F31D0082EFA98EC4E6C89", "FFF97BD5755EEEA420453A14355235D382F6472F8568A18B2F057A14602975563CC27944640AC607CD107AE10923D9EF7A73C643E166BE5EBEAFA34B1AC553E2"},
+        {"DFF1D77F2A671C5F36183726DB2341BE58FEAE1DA2DECED843240F7B502BA659", "243F6A8885A308D313198A2E03707344A4093822299F31D0082EFA98EC4E6C89", "1FA62E331EDBC21C394792D2AB1100A7B432B013DF3F6FF4F99FCB33E0E1515F28890B3EDB6E7189B630448B515CE4F8622A954CFE545735AAEA5134FCCDB2BD"},
+        {"DFF1D77F2A671C5F36183726DB2341BE58FEAE1DA2DECED843240F7B502BA659", "243F6A8885A308D313198A2E03707344A4093822299F31D0082EFA98EC4E6C89", "0000000000000000000000000000000000000000000000000000000000000000123DDA8328AF9C23A94C1FEECFD123BA4FB73476F0D594DCB65C6425BD186051"},
+        {"DFF1D77F2A671C5F36183726DB2341BE58FEAE1DA2DECED843240F7B502BA659", "243F6A8885A308D313198A2E03707344A4093822299F31D0082EFA98EC4E6C89", "4A298DACAE57395A15D0795DDBFD1DCB564DA82B0F269BC70A74F8220429BA1D69E89B4C5564D00349106B8497785DD7D1D713A8AE82B32FA79D5F7FC407D39B"},
+        {"DFF1D77F2A671C5F36183726DB2341BE58FEAE1DA2DECED843240F7B502BA659", "243F6A8885A308D313198A2E03707344A4093822299F31D0082EFA98EC4E6C89", "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEFFFFFC2F69E89B4C5564D00349106B8497785DD7D1D713A8AE82B32FA79D5F7FC407D39B"},
+        {"DFF1D77F2A671C5F36183726DB2341BE58FEAE1DA2DECED843240F7B502BA659", "243F6A8885A308D313198A2E03707344A4093822299F31D0082EFA98EC4E6C89", "6CFF5C3BA86C69EA4B7376F31A9BCB4F74C1976089B2D9963DA2E5543E177769FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEBAAEDCE6AF48A03BBFD25E8CD0364141"},
+        {"FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEFFFFFC30", "243F6A8885A308D313198A2E03707344A4093822299F31D0082EFA98EC4E6C89", "6CFF5C3BA86C69EA4B7376F31A9BCB4F74C1976089B2D9963DA2E5543E17776969E89B4C5564D00349106B8497785DD7D1D713A8AE82B32FA79D5F7FC407D39B"},
+    };
+    const auto add{[&](const std::array<std::string, 3>& vector) {
+        return batch.Add(XOnlyPubKey{ParseHex(vector[0])}, uint256{ParseHex(vector[1])}, ParseHex(vector[2]));
+    }};
+    for (const auto& vector : valid_vectors) {
+        BOOST_CHECK(add(vector));
+        BOOST_CHECK(batch.Verify());
+    }
+    for (const auto& vector : invalid_vectors) {
+        add(vector);
+        BOOST_CHECK(!batch.Verify());
+        for (const auto& valid_vector : valid_vectors) BOOST_CHECK(add(valid_vector));
+        add(vector);
+        BOOST_CHECK(!batch.Verify());
+    }
+}
+
 BOOST_AUTO_TEST_CASE(key_ellswift)
 {
     for (const auto& secret : {strSecret1, strSecret2, strSecret1C, strSecret2C}) {
@@ -0,0 +1,263 @@
+// Copyright (c) 2026-present The Botcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <logdb.h>
+#include <span.h>
+#include <test/util/random.h>
+#include <test/util/setup_common.h>
+#include <util/fs.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+#ifndef WIN32
+
+namespace {
+
+std::span<const std::byte> Bytes(const std::string& s) { return MakeByteSpan(s); }
+
+std::string ToString(std::span<const std::byte> s) { return {reinterpret_cast<const char*>(s.data()), s.size()}; }
+
+void Put(LogDB& db, const std::string& key, const std::string& value, bool sync = false)
+{
+    LogDB::Batch batch;
+    batch.Put(Bytes(key), Bytes(value));
+    db.Write(batch, sync);
+}
+
+std::map<std::string, std::string> Contents(const LogDB& db)
+{
+    std::map<std::string, std::string> contents;
+    const auto it{db.NewIterator()};
+    for (it->SeekToFirst(); it->Valid(); it->Next()) {
+        contents.emplace(ToString(it->Key()), ToString(it->Value()));
+    }
+    return contents;
+}
+
+size_t CountSegments(const fs::path& path)
+{
+    size_t count{0};
+    for (const auto& entry : fs::directory_iterator(path)) {
+        if (fs::PathToString(entry.path().extension()) == ".seg") ++count;
+    }
+    return count;
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(logdb_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(logdb_read_write)
+{
+    const fs::path path{m_args.GetDataDirBase() / "logdb"};
+    {
+        LogDB db{path};
+        BOOST_CHECK(LogDB::IsLogDB(path));
+        BOOST_CHECK(!db.Read(Bytes("a")));
+
+        LogDB::Batch batch;
+        batch.Put(Bytes("a"), Bytes("1"));
+        batch.Put(Bytes("b"), Bytes("2"));
+        batch.Put(Bytes("c"), Bytes("3"));
+        batch.Delete(Bytes("b"));
+        batch.Put(Bytes("a"), Bytes("4"));
+        db.Write(batch, /*sync=*/true);
+
+        BOOST_CHECK_EQUAL(*db.Read(Bytes("a")), "4");
+        BOOST_CHECK(!db.Exists(Bytes("b")));
+        BOOST_CHECK(db.Exists(Bytes("c")));
+        BOOST_CHECK_EQUAL(db.EstimateSize(Bytes("a"), Bytes("b")), db.EstimateSize(Bytes("a"), Bytes("z")) - db.EstimateSize(Bytes("c"), Bytes("d")));
+
+        // Values may be empty, and keys may contain any byte.
+        Put(db, std::string{"\0\xff", 2}, "");
+        BOOST_CHECK_EQUAL(*db.Read(Bytes(std::string{"\0\xff", 2})), "");
+
+        // A database can only be opened once.
+        BOOST_CHECK_THROW(LogDB{path}, std::runtime_error);
+    }
+
+    // The log is replayed on reopening.
+    LogDB db{path};
+    const std::map<std::string, std::string> expected{{std::string{"\0\xff", 2}, ""}, {"a", "4"}, {"c", "3"}};
+    BOOST_CHECK(Contents(db) == expected);
+}
+
+BOOST_AUTO_TEST_CASE(logdb_incomplete_record)
+{
+    const fs::path path{m_args.GetDataDirBase() / "logdb"};
+    {
+        LogDB db{path};
+        Put(db, "a", "1", /*sync=*/true);
+        Put(db, "b", "2", /*sync=*/true);
+    }
+    const fs::path segment{path / "000001.seg"};
+    const uint64_t size{fs::file_size(segment)};
+
+    // A write torn by a crash is dropped along with everything after it.
+    fs::resize_file(segment, size - 1);
+    {
+        LogDB db{path};
+        BOOST_CHECK_EQUAL(*db.Read(Bytes("a")), "1");
+        BOOST_CHECK(!db.Exists(Bytes("b")));
+        Put(db, "c", "3", /*sync=*/true);
+    }
+    LogDB db{path};
+    BOOST_CHECK_EQUAL(*db.Read(Bytes("a")), "1");
+    BOOST_CHECK(!db.Exists(Bytes("b")));
+    BOOST_CHECK_EQUAL(*db.Read(Bytes("c")), "3");
+}
+
+BOOST_AUTO_TEST_CASE(logdb_corrupt_segment)
+{
+    const fs::path path{m_args.GetDataDirBase() / "logdb"};
+    {
+        LogDB db{path, /*segment_size=*/64};
+        for (int i{0}; i < 10; ++i) Put(db, "key" + std::to_string(i), std::string(40, 'x'));
+    }
+    BOOST_REQUIRE_GT(CountSegments(path), 2U);
+
+    // Corruption anywhere but at the end of the log is an error.
+    FILE* file{fsbridge::fopen(path / "000001.seg", "r+b")};
+    BOOST_REQUIRE(file);
+    BOOST_REQUIRE_EQUAL(std::fseek(file, 10, SEEK_SET), 0);
+    BOOST_REQUIRE_EQUAL(std::fputc('y', file), 'y');
+    std::fclose(file);
+    BOOST_CHECK_THROW(LogDB{path}, std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(logdb_iterator_snapshot)
+{
+    const fs::path path{m_args.GetDataDirBase() / "logdb"};
+    LogDB db{path, /*segment_size=*/256};
+    for (int i{0}; i < 10; ++i) Put(db, "key" + std::to_string(i), "old");
+    const auto before{Contents(db)};
+
+    const auto it{db.NewIterator()};
+    it->Seek(Bytes("key3"));
+    BOOST_REQUIRE(it->Valid());
+    BOOST_CHECK_EQUAL(ToString(it->Key()), "key3");
+
+    // Writes after the creation of an iterator, including compactions of
+    // the segments it reads from, are not visible to it.
+    for (int round{0}; round < 20; ++round) {
+        LogDB::Batch batch;
+        for (int i{0}; i < 10; ++i) {
+            if (i % 3 == 0) {
+                batch.Delete(Bytes("key" + std::to_string(i)));
+            } else {
+                batch.Put(Bytes("key" + std::to_string(i)), Bytes("new" + std::to_string(round)));
+            }
+        }
+        batch.Put(Bytes("key35"), Bytes("inserted"));
+        db.Write(batch, /*sync=*/false);
+    }
+
+    std::map<std::string, std::string> seen;
+    for (it->SeekToFirst(); it->Valid(); it->Next()) seen.emplace(ToString(it->Key()), ToString(it->Value()));
+    BOOST_CHECK(seen == before);
+
+    const auto after{Contents(db)};
+    BOOST_CHECK_EQUAL(after.size(), 7U);
+    BOOST_CHECK(!after.contains("key0"));
+    BOOST_CHECK_EQUAL(after.at("key1"), "new19");
+    BOOST_CHECK_EQUAL(after.at("key35"), "inserted");
+}
+
+BOOST_AUTO_TEST_CASE(logdb_iterator_versions)
+{
+    const fs::path path{m_args.GetDataDirBase() / "logdb"};
+    std::map<std::string, std::string> first_expected, second_expected;
+    size_t usage;
+    {
+        LogDB db{path, /*segment_size=*/256};
+        for (int i{0}; i < 10; ++i) Put(db, "key" + std::to_string(i), "v0");
+        first_expected = Contents(db);
+
+        auto first{db.NewIterator()};
+        first->SeekToFirst();
+        BOOST_REQUIRE(first->Valid());
+
+        // Deleting the key an iterator is positioned at does not move it.
+        LogDB::Batch batch;
+        batch.Delete(Bytes("key0"));
+        batch.Delete(Bytes("key1"));
+        db.Write(batch, /*sync=*/false);
+        Put(db, "key05", "v1");
+        Put(db, "key2", "v1");
+        second_expected = Contents(db);
+        auto second{db.NewIterator()};
+
+        batch.Clear();
+        batch.Delete(Bytes("key2"));
+        db.Write(batch, /*sync=*/false);
+        Put(db, "key0", "v2");
+        for (int round{0}; round < 20; ++round) Put(db, "key3", "v" + std::to_string(round));
+
+        std::map<std::string, std::string> seen;
+        for (; first->Valid(); first->Next()) seen.emplace(ToString(first->Key()), ToString(first->Value()));
+        BOOST_CHECK(seen == first_expected);
+        seen.clear();
+        for (second->SeekToFirst(); second->Valid(); second->Next()) seen.emplace(ToString(second->Key()), ToString(second->Value()));
+        BOOST_CHECK(seen == second_expected);
+
+        // Versions and deleted keys are dropped once no iterator needs them.
+        const size_t usage_open{db.DynamicMemoryUsage()};
+        first.reset();
+        second.reset();
+        db.Write(LogDB::Batch{}, /*sync=*/false);
+        usage = db.DynamicMemoryUsage();
+        BOOST_CHECK_LT(usage, usage_open);
+        BOOST_CHECK(!db.Exists(Bytes("key1")));
+        BOOST_CHECK_EQUAL(Contents(db).at("key3"), "v19");
+    }
+    LogDB db{path, /*segment_size=*/256};
+    BOOST_CHECK_EQUAL(db.DynamicMemoryUsage(), usage);
+}
+
+BOOST_AUTO_TEST_CASE(logdb_compaction)
+{
+    const fs::path path{m_args.GetDataDirBase() / "logdb"};
+    std::map<std::string, std::string> expected;
+    {
+        LogDB db{path, /*segment_size=*/1024};
+        for (int i{0}; i < 2000; ++i) {
+            const std::string key{"key" + std::to_string(m_rng.randrange(50))};
+            if (m_rng.randrange(4) == 0) {
+                LogDB::Batch batch;
+                batch.Delete(Bytes(key));
+                db.Write(batch, /*sync=*/false);
+                expected.erase(key);
+            } else {
+                const std::string value(m_rng.randrange(100), char('a' + m_rng.randrange(26)));
+                Put(db, key, value);
+                expected[key] = value;
+            }
+        }
+        // Overwritten values are dropped as the log grows, so its size is
+        // bounded by the live data rather than by the number of writes.
+        BOOST_CHECK_LT(CountSegments(path), 30U);
+        BOOST_CHECK(Contents(db) == expected);
+
+        db.Compact();
+        BOOST_CHECK(Contents(db) == expected);
+    }
+
+    // Deleted keys do not reappear when the compacted log is replayed.
+    {
+        LogDB db{path, /*segment_size=*/1024};
+        BOOST_CHECK(Contents(db) == expected);
+    }
+
+    LogDB::Destroy(path);
+    BOOST_CHECK(!fs::exists(path));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif // WIN32
@@ -0,0 +1,93 @@
+// Copyright (c) 2026-present The Botcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <primitives/block.h>
+#include <primitives/transaction.h>
+#include <streams.h>
+#include <support/allocators/monotonic.h>
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+BOOST_FIXTURE_TEST_SUITE(monotonic_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(basic_allocating)
+{
+    MonotonicResource resource{64};
+    BOOST_CHECK_EQUAL(resource.NumAllocatedChunks(), 1U);
+
+    // Allocations are carved out of the chunk back to back, respecting alignment
+    auto* a = static_cast<std::byte*>(resource.Allocate(1, 1));
+    auto* b = static_cast<std::byte*>(resource.Allocate(8, 8));
+    BOOST_CHECK_EQUAL(reinterpret_cast<std::uintptr_t>(b) % 8, 0U);
+    BOOST_CHECK(b > a && b - a <= 8);
+    BOOST_CHECK_EQUAL(resource.NumAllocatedChunks(), 1U);
+
+    // Deallocation does not make memory available again
+    resource.Deallocate(b, 8, 8);
+    auto* c = static_cast<std::byte*>(resource.Allocate(8, 8));
+    BOOST_CHECK(c != b);
+
+    // Exhausting the chunk allocates a new one
+    resource.Allocate(48, 8);
+    BOOST_CHECK_EQUAL(resource.NumAllocatedChunks(), 2U);
+
+    // Allocations larger than a chunk get their own chunk
+    resource.Allocate(1000, 8);
+    BOOST_CHECK_EQUAL(resource.NumAllocatedChunks(), 3U);
+}
+
+BOOST_AUTO_TEST_CASE(shared_ownership)
+{
+    auto resource{std::make_shared<MonotonicResource>(256)};
+    MonotonicAllocator<uint64_t> alloc{resource};
+    std::vector<uint64_t, MonotonicAllocator<uint64_t>> vec(alloc);
+    vec.assign(10, 42);
+    BOOST_CHECK(vec.get_allocator() == MonotonicAllocator<int>{resource});
+
+    // Objects allocated with allocate_shared keep the resource alive
+    auto obj{std::allocate_shared<const uint64_t>(alloc, 7)};
+    resource.reset();
+    vec = {};
+    BOOST_CHECK_EQUAL(*obj, 7U);
+}
+
+BOOST_AUTO_TEST_CASE(unserialize_block_in_arena)
+{
+    CBlock block;
+    block.nVersion = 4;
+    block.nTime = 1234;
+    for (int i = 0; i < 10; ++i) {
+        CMutableTransaction mtx;
+        mtx.vin.resize(1 + i % 3);
+        mtx.vin[0].prevout.n = i;
+        mtx.vin[0].scriptWitness.stack.assign(i % 2, std::vector<unsigned char>(i + 1, 0x51));
+        mtx.vout.resize(2);
+        mtx.vout[1].nValue = i;
+        block.vtx.push_back(MakeTransactionRef(std::move(mtx)));
+    }
+    DataStream stream;
+    stream << TX_WITH_WITNESS(block);
+
+    CBlock arena_block;
+    UnserializeBlockInArena(stream, arena_block);
+    BOOST_CHECK(stream.empty());
+    BOOST_CHECK_EQUAL(arena_block.GetHash(), block.GetHash());
+    BOOST_REQUIRE_EQUAL(arena_block.vtx.size(), block.vtx.size());
+    for (size_t i = 0; i < block.vtx.size(); ++i) {
+        BOOST_CHECK_EQUAL(arena_block.vtx[i]->GetWitnessHash(), block.vtx[i]->GetWitnessHash());
+    }
+
+    // A transaction taken from the block outlives it
+    const CTransactionRef tx{arena_block.vtx[5]};
+    arena_block.SetNull();
+    BOOST_CHECK_EQUAL(tx->GetWitnessHash(), block.vtx[5]->GetWitnessHash());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
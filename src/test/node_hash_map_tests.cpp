@@ -0,0 +1,140 @@
+// Copyright (c) 2026-present The Botcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <memusage.h>
+#include <support/allocators/pool.h>
+#include <test/util/random.h>
+#include <test/util/setup_common.h>
+#include <util/node_hash_map.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+
+namespace {
+
+struct IdentityHasher {
+    size_t operator()(uint64_t key) const noexcept { return key; }
+};
+
+/** Maps keys onto a handful of hashes, to exercise long probe sequences. */
+struct CollidingHasher {
+    size_t operator()(uint64_t key) const noexcept { return (key % 5) * 0x9e3779b97f4a7c15ULL; }
+};
+
+template <typename Hasher>
+using TestMap = NodeHashMap<uint64_t, std::string, Hasher, std::equal_to<uint64_t>, std::allocator<std::pair<const uint64_t, std::string>>>;
+
+/** Apply random operations to a NodeHashMap and a std::unordered_map and compare them. */
+template <typename Hasher>
+void CheckAgainstUnorderedMap(FastRandomContext& rng, uint64_t key_range)
+{
+    TestMap<Hasher> map{0, Hasher{}, {}, {}};
+    std::unordered_map<uint64_t, std::string> real;
+
+    for (int i{0}; i < 20000; ++i) {
+        const uint64_t key{rng.randrange(key_range)};
+        switch (rng.randrange(6)) {
+        case 0: {
+            const auto [it, inserted]{map.try_emplace(key, std::to_string(key))};
+            BOOST_CHECK_EQUAL(inserted, real.try_emplace(key, std::to_string(key)).second);
+            BOOST_CHECK_EQUAL(it->first, key);
+            break;
+        }
+        case 1: {
+            const auto [it, inserted]{map.emplace(key, "emplaced")};
+            const auto [real_it, real_inserted]{real.emplace(key, "emplaced")};
+            BOOST_CHECK_EQUAL(inserted, real_inserted);
+            BOOST_CHECK_EQUAL(it->second, real_it->second);
+            break;
+        }
+        case 2:
+            BOOST_CHECK_EQUAL(map.erase(key), real.erase(key));
+            break;
+        case 3:
+            if (auto it{map.find(key)}; it != map.end()) {
+                map.erase(it);
+                real.erase(key);
+            }
+            break;
+        default: {
+            const auto it{map.find(key)};
+            const auto real_it{real.find(key)};
+            BOOST_REQUIRE_EQUAL(it == map.end(), real_it == real.end());
+            if (it != map.end()) BOOST_CHECK_EQUAL(it->second, real_it->second);
+        }
+        }
+        BOOST_REQUIRE_EQUAL(map.size(), real.size());
+    }
+
+    size_t count{0};
+    for (const auto& [key, value] : map) {
+        BOOST_CHECK_EQUAL(real.at(key), value);
+        ++count;
+    }
+    BOOST_CHECK_EQUAL(count, real.size());
+
+    // Erasing while iterating visits every element once.
+    for (auto it{map.begin()}; it != map.end();) {
+        if (it->first % 2) {
+            BOOST_CHECK_EQUAL(real.erase(it->first), 1U);
+            it = map.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    BOOST_CHECK_EQUAL(map.size(), real.size());
+    for (const auto& [key, value] : real) BOOST_CHECK(map.find(key) != map.end());
+
+    map.clear();
+    BOOST_CHECK(map.empty());
+    BOOST_CHECK(map.begin() == map.end());
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(node_hash_map_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(node_hash_map_random_operations)
+{
+    CheckAgainstUnorderedMap<IdentityHasher>(m_rng, 100);
+    CheckAgainstUnorderedMap<IdentityHasher>(m_rng, 100000);
+    CheckAgainstUnorderedMap<CollidingHasher>(m_rng, 500);
+}
+
+BOOST_AUTO_TEST_CASE(node_hash_map_reference_stability)
+{
+    TestMap<IdentityHasher> map{0, IdentityHasher{}, {}, {}};
+    const std::string* value{&map.try_emplace(0, "first").first->second};
+    for (uint64_t i{1}; i < 10000; ++i) {
+        map.try_emplace(i, "");
+        if (i % 3 == 0) map.erase(i - 1);
+    }
+    // Growing and rebuilding the index does not move nodes.
+    BOOST_CHECK_EQUAL(*value, "first");
+    BOOST_CHECK_EQUAL(&map.find(0)->second, value);
+}
+
+BOOST_AUTO_TEST_CASE(node_hash_map_reserve)
+{
+    using PoolMap = NodeHashMap<uint64_t, uint64_t, IdentityHasher, std::equal_to<uint64_t>,
+                                PoolAllocator<std::pair<const uint64_t, uint64_t>, sizeof(std::pair<const uint64_t, uint64_t>)>>;
+    PoolMap::allocator_type::ResourceType resource;
+    PoolMap map{0, IdentityHasher{}, {}, &resource};
+    BOOST_CHECK_EQUAL(map.bucket_count(), 0U);
+
+    map.reserve(1000);
+    const size_t buckets{map.bucket_count()};
+    const size_t usage{memusage::DynamicUsage(map)};
+    BOOST_CHECK_GE(buckets, 1000U);
+    for (uint64_t i{0}; i < 1000; ++i) map[i] = i;
+    // Reserved space is enough: neither the index nor the pool grew.
+    BOOST_CHECK_EQUAL(map.bucket_count(), buckets);
+    BOOST_CHECK_EQUAL(memusage::DynamicUsage(map), usage);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -5,9 +5,12 @@
 #include <chain.h>
 #include <chainparams.h>
 #include <pow.h>
+#include <powcache.h>
+#include <primitives/block.h>
 #include <test/util/random.h>
 #include <test/util/setup_common.h>
 #include <util/chaintype.h>
+#include <validation.h>
 
 #include <boost/test/unit_test.hpp>
 
@@ -179,6 +182,64 @@ BOOST_AUTO_TEST_CASE(GetBlockProofEquivalentTime_test)
     }
 }
 
+BOOST_AUTO_TEST_CASE(pow_cache_entries)
+{
+    PowCache cache{DEFAULT_POW_CACHE_BYTES};
+    const uint256 block_hash{m_rng.rand256()};
+    const uint256 seed1{m_rng.rand256()};
+    const uint256 seed2{m_rng.rand256()};
+
+    const uint256 entry1{cache.ComputeEntry(block_hash, seed1)};
+    const uint256 entry2{cache.ComputeEntry(block_hash, seed2)};
+    BOOST_CHECK(entry1 != entry2);
+    BOOST_CHECK_EQUAL(entry1, cache.ComputeEntry(block_hash, seed1));
+
+    BOOST_CHECK(!cache.Get(entry1));
+    cache.Set(entry1);
+    BOOST_CHECK(cache.Get(entry1));
+    // A verdict is only valid under the seed it was computed with
+    BOOST_CHECK(!cache.Get(entry2));
+
+    // Entries are salted per cache instance
+    PowCache other{DEFAULT_POW_CACHE_BYTES};
+    BOOST_CHECK(other.ComputeEntry(block_hash, seed1) != entry1);
+}
+
+BOOST_AUTO_TEST_CASE(HasValidProofOfWork_cache)
+{
+    const auto consensus = CreateChainParams(*m_node.args, ChainType::REGTEST)->GetConsensus();
+    const uint256 seed_hash{GetNextRandomXSeedHash(nullptr)};
+
+    // Grind a few headers that meet the regtest target
+    std::vector<CBlockHeader> headers(5);
+    for (size_t i = 0; i < headers.size(); ++i) {
+        headers[i].nVersion = 0x20000000;
+        headers[i].nTime = 1296688602 + i;
+        headers[i].nBits = 0x207fffff;
+        while (!CheckProofOfWork(GetBlockPoWHash(headers[i], seed_hash), headers[i].nBits, consensus)) {
+            ++headers[i].nNonce;
+        }
+    }
+
+    PowCache cache{DEFAULT_POW_CACHE_BYTES};
+    BOOST_CHECK(HasValidProofOfWork(headers, consensus));
+    BOOST_CHECK(HasValidProofOfWork(headers, consensus, &cache, /*lanes=*/3));
+    for (const auto& header : headers) {
+        BOOST_CHECK(cache.Get(cache.ComputeEntry(header.GetHash(), seed_hash)));
+    }
+    // Cached headers still pass
+    BOOST_CHECK(HasValidProofOfWork(headers, consensus, &cache, /*lanes=*/3));
+
+    // Find a header that fails its target; it must fail and must not be cached
+    CBlockHeader bad{headers.back()};
+    do {
+        ++bad.nNonce;
+    } while (CheckProofOfWork(GetBlockPoWHash(bad, seed_hash), bad.nBits, consensus));
+    headers.push_back(bad);
+    BOOST_CHECK(!HasValidProofOfWork(headers, consensus, &cache, /*lanes=*/2));
+    BOOST_CHECK(!cache.Get(cache.ComputeEntry(bad.GetHash(), seed_hash)));
+}
+
 void sanity_check_chainparams(const ArgsManager& args, ChainType chain_type)
 {
     const auto chainParams = CreateChainParams(args, chain_type);
@@ -12,6 +12,7 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <thread>
 #include <vector>
 
 BOOST_FIXTURE_TEST_SUITE(randomx_tests, BasicTestingSetup)
@@ -278,4 +279,101 @@ BOOST_AUTO_TEST_CASE(randomx_context_seed_update)
     BOOST_CHECK_EQUAL(hash1, hash3);
 }
 
+/**
+ * Test: Batch hashing over several lanes matches one-by-one hashing.
+ * Acceptance: Results are identical and returned in input order, for any lane count.
+ */
+BOOST_AUTO_TEST_CASE(randomx_hash_batch)
+{
+    uint256 seed = Hash(std::string("Botcoin Genesis Seed"));
+
+    std::vector<std::vector<unsigned char>> inputs;
+    for (unsigned char i = 0; i < 7; ++i) {
+        inputs.emplace_back(80, i);
+    }
+
+    std::vector<uint256> expected;
+    for (const auto& input : inputs) {
+        expected.push_back(RandomXHash(input, seed));
+    }
+
+    for (unsigned int lanes : {0U, 1U, 3U, 16U}) {
+        std::vector<uint256> hashes = RandomXHashBatch(inputs, seed, lanes);
+        BOOST_CHECK(hashes == expected);
+    }
+
+    // A different seed must reinitialize the lane VMs as well
+    uint256 seed2 = Hash(std::string("Seed Two"));
+    std::vector<uint256> hashes2 = RandomXHashBatch(inputs, seed2, 3);
+    BOOST_REQUIRE_EQUAL(hashes2.size(), inputs.size());
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        BOOST_CHECK_EQUAL(hashes2[i], RandomXHash(inputs[i], seed2));
+    }
+
+    BOOST_CHECK(RandomXHashBatch({}, seed, 4).empty());
+
+    // Batches do not hold the context lock while hashing, so single hashes
+    // and batches for another seed may run alongside them.
+    // Boost.Test assertions are not thread-safe, so only record the results.
+    bool other_ok{true};
+    std::thread other{[&] {
+        for (int i = 0; i < 3; ++i) {
+            other_ok &= RandomXHashBatch(inputs, seed2, 2) == hashes2;
+            other_ok &= RandomXHash(inputs[i], seed) == expected[i];
+        }
+    }};
+    for (int i = 0; i < 3; ++i) {
+        BOOST_CHECK(RandomXHashBatch(inputs, seed, 3) == expected);
+    }
+    other.join();
+    BOOST_CHECK(other_ok);
+}
+
+/**
+ * Test: Next seed switch height is consistent with the seed schedule.
+ * Acceptance: The seed height is constant up to the reported switch height and
+ *             changes exactly there; no switch is reported if the seed is fixed.
+ */
+BOOST_AUTO_TEST_CASE(next_seed_switch_height)
+{
+    for (uint64_t height : {0ULL, 1ULL, 2111ULL, 2112ULL, 2113ULL, 4159ULL, 4160ULL, 1000000ULL}) {
+        const auto switch_height = GetNextRandomXSeedSwitchHeight(height);
+        if (!switch_height) {
+            // No switch within the next epoch means the seed is fixed
+            BOOST_CHECK_EQUAL(GetRandomXSeedHeight(height + RANDOMX_EPOCH_LENGTH), GetRandomXSeedHeight(height));
+            continue;
+        }
+        BOOST_CHECK_GT(*switch_height, height);
+        BOOST_CHECK_LE(*switch_height, height + RANDOMX_EPOCH_LENGTH);
+        BOOST_CHECK_EQUAL(*switch_height % RANDOMX_EPOCH_LENGTH, RANDOMX_EPOCH_LAG);
+        BOOST_CHECK_EQUAL(GetRandomXSeedHeight(*switch_height - 1), GetRandomXSeedHeight(height));
+        BOOST_CHECK(GetRandomXSeedHeight(*switch_height) != GetRandomXSeedHeight(height));
+    }
+}
+
+/**
+ * Test: Context stats reflect the loaded seed.
+ * Acceptance: After hashing, the light VM is reported as initialized for that
+ * seed, and the lanes of a batch as created.
+ */
+BOOST_AUTO_TEST_CASE(randomx_context_stats)
+{
+    RandomXContext& ctx = RandomXContext::GetInstance();
+    uint256 seed = Hash(std::string("Botcoin Genesis Seed"));
+
+    std::vector<uint8_t> data(80, 0);
+    const uint256 hash{ctx.Hash(data, seed)};
+    // Lanes are only created by batches, which other tests may not have run
+    const std::vector<std::vector<unsigned char>> inputs(2, std::vector<unsigned char>(data.begin(), data.end()));
+    const std::vector<uint256> hashes{ctx.HashBatch(inputs, seed, /*lanes=*/2)};
+    BOOST_REQUIRE_EQUAL(hashes.size(), 2U);
+    BOOST_CHECK(hashes[0] == hash && hashes[1] == hash);
+
+    const RandomXContext::Stats stats = ctx.GetStats();
+    BOOST_CHECK(stats.seed_hash == seed);
+    BOOST_CHECK(stats.light_initialized);
+    BOOST_CHECK_GE(stats.batch_lanes, 1U);
+    BOOST_CHECK_GT(stats.memory_bytes, 0U);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,79 @@
+// Copyright (c) 2026-present The Botcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <addresstype.h>
+#include <chain.h>
+#include <consensus/validation.h>
+#include <index/txospenderindex.h>
+#include <interfaces/chain.h>
+#include <script/script.h>
+#include <sync.h>
+#include <test/util/setup_common.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <optional>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(txospenderindex_tests)
+
+BOOST_FIXTURE_TEST_CASE(txospenderindex_lookup_and_reorg, TestChain100Setup)
+{
+    TxoSpenderIndex index(interfaces::MakeChain(m_node), 1 << 20, true);
+    BOOST_REQUIRE(index.Init());
+
+    const CScript coinbase_script{CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG};
+    std::vector<CMutableTransaction> spends;
+    std::vector<COutPoint> outpoints;
+    for (size_t i = 0; i < 3; ++i) {
+        spends.push_back(CreateValidMempoolTransaction(m_coinbase_txns[i], 0, i + 1, coinbaseKey, coinbase_script, 1 * COIN, /*submit=*/false));
+        outpoints.emplace_back(m_coinbase_txns[i]->GetHash(), 0);
+    }
+    // An output that is never spent
+    outpoints.emplace_back(m_coinbase_txns[3]->GetHash(), 0);
+
+    // The spends of the first two outputs are indexed by the initial sync, the
+    // last one once the index follows the chain. The empty block lets the
+    // spent coinbase outputs mature.
+    CreateAndProcessBlock({}, coinbase_script);
+    CreateAndProcessBlock({spends[0], spends[1]}, coinbase_script);
+    index.Sync();
+    CreateAndProcessBlock({spends[2]}, coinbase_script);
+    BOOST_REQUIRE(index.BlockUntilSyncedToCurrentChain());
+
+    std::vector<std::optional<TxoSpender>> spenders;
+    BOOST_REQUIRE(index.FindSpenders(outpoints, spenders));
+    BOOST_REQUIRE_EQUAL(spenders.size(), outpoints.size());
+    for (size_t i = 0; i < spends.size(); ++i) {
+        BOOST_REQUIRE(spenders[i]);
+        BOOST_CHECK(spenders[i]->txid == spends[i].GetHash());
+        BOOST_CHECK_EQUAL(spenders[i]->vin, 0U);
+        BOOST_CHECK_EQUAL(spenders[i]->height, i < 2 ? 102 : 103);
+        BOOST_CHECK_EQUAL(spenders[i]->block_hash, WITH_LOCK(::cs_main, return m_node.chainman->ActiveChain()[spenders[i]->height]->GetBlockHash()));
+    }
+    BOOST_CHECK(!spenders[3]);
+
+    // Reorging out the last block removes its spend once the block of the
+    // new chain is connected.
+    {
+        BlockValidationState state;
+        CBlockIndex* tip{WITH_LOCK(::cs_main, return m_node.chainman->ActiveChain().Tip())};
+        BOOST_REQUIRE(m_node.chainman->ActiveChainstate().InvalidateBlock(state, tip));
+    }
+    CreateAndProcessBlock({}, coinbase_script);
+    BOOST_REQUIRE(index.BlockUntilSyncedToCurrentChain());
+
+    BOOST_REQUIRE(index.FindSpenders(outpoints, spenders));
+    BOOST_CHECK(spenders[0] && spenders[1]);
+    BOOST_CHECK(!spenders[2]);
+
+    // It is not safe to stop and destroy the index until it finishes handling
+    // the last notification, see txindex_tests.
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+
+    index.Stop();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
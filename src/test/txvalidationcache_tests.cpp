@@ -4,6 +4,7 @@
 
 #include <consensus/validation.h>
 #include <key.h>
+#include <node/validation_cache_persist.h>
 #include <random.h>
 #include <script/sigcache.h>
 #include <script/sign.h>
@@ -385,4 +386,52 @@ BOOST_FIXTURE_TEST_CASE(checkinputs_test, Dersig100Setup)
     }
 }
 
+BOOST_FIXTURE_TEST_CASE(validation_cache_persist, BasicTestingSetup)
+{
+    ValidationCache cache{1 << 20, 1 << 20};
+    const CKey key{GenerateRandomKey()};
+    const uint256 sighash{m_rng.rand256()};
+    const std::vector<unsigned char> sig{m_rng.randbytes(64)};
+    const uint256 txid{m_rng.rand256()};
+
+    const auto compute_entries{[&](ValidationCache& validation_cache) {
+        std::array<uint256, 3> entries;
+        validation_cache.m_signature_cache.ComputeEntryECDSA(entries[0], sighash, sig, key.GetPubKey());
+        validation_cache.m_signature_cache.ComputeEntrySchnorr(entries[1], sighash, sig, XOnlyPubKey{key.GetPubKey()});
+        validation_cache.ScriptExecutionCacheHasher().Write(txid.begin(), 32).Finalize(entries[2].begin());
+        return entries;
+    }};
+    const auto entries{compute_entries(cache)};
+    cache.m_signature_cache.Set(entries[0]);
+    cache.m_signature_cache.Set(entries[1]);
+    WITH_LOCK(cs_main, cache.m_script_execution_cache.insert(entries[2]));
+    // Entries marked for erasure, such as those used by a block, are not dumped.
+    BOOST_CHECK(cache.m_signature_cache.Get(entries[1], /*erase=*/true));
+
+    const fs::path path{m_args.GetDataDirNet() / "validationcache.dat"};
+    BOOST_REQUIRE(node::DumpValidationCache(cache, path));
+
+    // The restored cache keeps its own fresh nonces, and finds the dumped
+    // signatures among its restored entries instead.
+    ValidationCache restored{1 << 20, 1 << 20};
+    BOOST_CHECK(!restored.m_signature_cache.GetRestoredECDSA(sighash, sig, key.GetPubKey(), /*erase=*/false));
+    BOOST_REQUIRE(node::LoadValidationCache(restored, path));
+    const auto restored_entries{compute_entries(restored)};
+    for (size_t i = 0; i < entries.size(); ++i) BOOST_CHECK(restored_entries[i] != entries[i]);
+    BOOST_CHECK(!restored.m_signature_cache.Get(restored_entries[0], /*erase=*/false));
+    BOOST_CHECK(restored.m_signature_cache.GetRestoredECDSA(sighash, sig, key.GetPubKey(), /*erase=*/false));
+    BOOST_CHECK(!restored.m_signature_cache.GetRestoredECDSA(m_rng.rand256(), sig, key.GetPubKey(), /*erase=*/false));
+    BOOST_CHECK(!restored.m_signature_cache.GetRestoredSchnorr(sighash, sig, XOnlyPubKey{key.GetPubKey()}, /*erase=*/false));
+    // The script execution cache is not persisted.
+    BOOST_CHECK(!WITH_LOCK(cs_main, return restored.m_script_execution_cache.contains(entries[2], /*erase=*/false)));
+    BOOST_CHECK(!WITH_LOCK(cs_main, return restored.m_script_execution_cache.contains(restored_entries[2], /*erase=*/false)));
+
+    // Restored entries are not dumped again unless they were carried over to
+    // the entries of this run.
+    BOOST_CHECK(restored.m_signature_cache.GetEntries().second.empty());
+    BOOST_CHECK(restored.m_signature_cache.GetEntries().first != cache.m_signature_cache.GetEntries().first);
+
+    BOOST_CHECK(!node::LoadValidationCache(restored, m_args.GetDataDirNet() / "missing.dat"));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -10,6 +10,7 @@
 #include <node/miner.h>
 #include <pow.h>
 #include <random.h>
+#include <test/util/logging.h>
 #include <test/util/random.h>
 #include <test/util/script.h>
 #include <test/util/setup_common.h>
@@ -97,8 +98,10 @@ std::shared_ptr<CBlock> MinerTestingSetup::FinalizeBlock(std::shared_ptr<CBlock>
     m_node.chainman->GenerateCoinbaseCommitment(*pblock, prev_block);
 
     pblock->hashMerkleRoot = BlockMerkleRoot(*pblock);
+    pblock->nBits = GetNextWorkRequired(prev_block, pblock.get(), Params().GetConsensus());
 
-    while (!CheckProofOfWork(pblock->GetHash(), pblock->nBits, Params().GetConsensus())) {
+    const uint256 seed_hash{GetRandomXSeedHash(prev_block)};
+    while (!CheckProofOfWork(GetBlockPoWHash(*pblock, seed_hash), pblock->nBits, Params().GetConsensus())) {
         ++(pblock->nNonce);
     }
 
@@ -329,6 +332,89 @@ BOOST_AUTO_TEST_CASE(mempool_locks_reorg)
     }
 }
 
+/**
+ * Test that a script failure in a block whose scripts are checked together
+ * with those of the blocks around it during IBD leaves the chain at its parent,
+ * and that the blocks after it neither become the tip nor take their
+ * transactions out of the mempool.
+ *
+ * The blocks are submitted in reverse order so that they all become
+ * connectable at once, and are connected within a single script check
+ * pipeline.
+ */
+BOOST_AUTO_TEST_CASE(script_check_pipeline)
+{
+    bool ignored;
+    auto ProcessBlock = [&](std::shared_ptr<const CBlock> block) -> bool {
+        return Assert(m_node.chainman)->ProcessNewBlock(block, /*force_processing=*/true, /*min_pow_checked=*/true, /*new_block=*/&ignored);
+    };
+    BOOST_REQUIRE(m_node.chainman->IsInitialBlockDownload());
+
+    BOOST_REQUIRE(ProcessBlock(std::make_shared<CBlock>(Params().GenesisBlock())));
+    const auto funding{GoodBlock(Params().GenesisBlock().GetHash())};
+    BOOST_REQUIRE(ProcessBlock(funding));
+    const auto second{GoodBlock(funding->GetHash())};
+    BOOST_REQUIRE(ProcessBlock(second));
+    auto last_mined{second};
+    for (int j = COINBASE_MATURITY - 1; j > 0; --j) {
+        last_mined = GoodBlock(last_mined->GetHash());
+        BOOST_REQUIRE(ProcessBlock(last_mined));
+    }
+
+    // A valid spend of the second coinbase, mined after the invalid block.
+    CMutableTransaction mempool_spend;
+    mempool_spend.vin.emplace_back(COutPoint{second->vtx[0]->GetHash(), 1}, CScript{});
+    mempool_spend.vin[0].scriptWitness.stack.push_back(WITNESS_STACK_ELEM_OP_TRUE);
+    mempool_spend.vout.push_back(second->vtx[0]->vout[1]);
+    mempool_spend.vout[0].nValue -= 1000;
+    const CTransactionRef mempool_tx{MakeTransactionRef(mempool_spend)};
+
+    // Spend the mature coinbase output without the witness it requires in
+    // the tenth of twenty blocks.
+    const size_t invalid{9};
+    std::vector<std::shared_ptr<const CBlock>> chain;
+    for (size_t i{0}; i < 20; ++i) {
+        const uint256 prev_hash{chain.empty() ? last_mined->GetHash() : chain.back()->GetHash()};
+        if (i == invalid + 1) {
+            auto pblock{Block(prev_hash)};
+            pblock->vtx.push_back(mempool_tx);
+            chain.push_back(FinalizeBlock(pblock));
+            continue;
+        }
+        if (i != invalid) {
+            chain.push_back(GoodBlock(prev_hash));
+            continue;
+        }
+        auto pblock{Block(prev_hash)};
+        CMutableTransaction spend;
+        spend.vin.emplace_back(COutPoint{funding->vtx[0]->GetHash(), 1}, CScript{});
+        spend.vout.push_back(funding->vtx[0]->vout[1]);
+        spend.vout[0].nValue -= 1000;
+        pblock->vtx.push_back(MakeTransactionRef(spend));
+        chain.push_back(FinalizeBlock(pblock));
+    }
+
+    {
+        LOCK(cs_main);
+        BOOST_REQUIRE(m_node.chainman->ProcessTransaction(mempool_tx).m_result_type == MempoolAcceptResult::ResultType::VALID);
+    }
+
+    {
+        ASSERT_DEBUG_LOG("Script verification failed in blocks");
+        for (auto it{chain.rbegin()}; it != chain.rend(); ++it) ProcessBlock(*it);
+    }
+    BOOST_CHECK(m_node.mempool->exists(mempool_tx->GetHash()));
+
+    LOCK(cs_main);
+    BOOST_CHECK_EQUAL(m_node.chainman->ActiveChain().Tip()->GetBlockHash(), chain[invalid - 1]->GetHash());
+    BOOST_CHECK(m_node.chainman->m_blockman.LookupBlockIndex(chain[invalid]->GetHash())->nStatus & BLOCK_FAILED_VALID);
+    for (size_t i{0}; i < invalid; ++i) {
+        BOOST_CHECK(m_node.chainman->m_blockman.LookupBlockIndex(chain[i]->GetHash())->IsValid(BLOCK_VALID_SCRIPTS));
+    }
+    BOOST_CHECK_EQUAL(m_node.chainman->ActiveChainstate().CoinsTip().GetBestBlock(), chain[invalid - 1]->GetHash());
+    BOOST_CHECK(!m_node.chainman->ActiveChainstate().CoinsTip().HaveCoin(COutPoint{chain[invalid + 1]->vtx[0]->GetHash(), 1}));
+}
+
 BOOST_AUTO_TEST_CASE(witness_commitment_index)
 {
     LOCK(Assert(m_node.chainman)->GetMutex());
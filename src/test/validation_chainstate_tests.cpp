@@ -33,6 +33,7 @@ BOOST_AUTO_TEST_CASE(validation_chainstate_resize_caches)
         /*cache_size_bytes=*/1 << 23, /*in_memory=*/true, /*should_wipe=*/false);
     WITH_LOCK(::cs_main, c1.InitCoinsCache(1 << 23));
     BOOST_REQUIRE(c1.LoadGenesisBlock()); // Need at least one block loaded to be able to flush caches
+    BOOST_CHECK(WITH_LOCK(::cs_main, return c1.CoinsDBCacheAdaptive()));
 
     // Add a coin to the in-memory cache, upsize once, then downsize.
     {
@@ -58,8 +59,28 @@ BOOST_AUTO_TEST_CASE(validation_chainstate_resize_caches)
             1 << 23  // upsizing the coinsdb cache
         );
 
+        // The coins still fit in the downsized cache, so it was not flushed.
+        BOOST_CHECK(c1.CoinsTip().HaveCoinInCache(outpoint));
+
+        c1.ResizeCoinsCaches(
+            c1.CoinsTip().DynamicMemoryUsage() / 2,  // downsizing the coinsview cache below its usage
+            1 << 24  // upsizing the coinsdb cache
+        );
+
         // The view cache should be empty since we had to destruct to downsize.
         BOOST_CHECK(!c1.CoinsTip().HaveCoinInCache(outpoint));
+
+        // The coinsdb is not reopened under an open cursor, so neither cache
+        // is resized until the cursor is closed.
+        const size_t coinstip_size{c1.m_coinstip_cache_size_bytes};
+        auto cursor{c1.CoinsDB().Cursor()};
+        BOOST_CHECK(c1.ResizeCoinsCaches(1 << 23, 1 << 22));
+        BOOST_CHECK_EQUAL(c1.m_coinstip_cache_size_bytes, coinstip_size);
+        BOOST_CHECK_EQUAL(c1.m_coinsdb_cache_size_bytes, size_t{1 << 24});
+        cursor.reset();
+        BOOST_CHECK(c1.ResizeCoinsCaches(1 << 23, 1 << 22));
+        BOOST_CHECK_EQUAL(c1.m_coinstip_cache_size_bytes, size_t{1 << 23});
+        BOOST_CHECK_EQUAL(c1.m_coinsdb_cache_size_bytes, size_t{1 << 22});
     }
 }
 
@@ -163,6 +163,31 @@ BOOST_FIXTURE_TEST_CASE(chainstatemanager_rebalance_caches, TestChain100Setup)
     BOOST_CHECK_CLOSE(double(c2.m_coinsdb_cache_size_bytes), max_cache * 0.95, 1);
 }
 
+//! Test that a validation profile is kept for every connected block.
+BOOST_FIXTURE_TEST_CASE(chainstatemanager_block_validation_profiles, TestChain100Setup)
+{
+    ChainstateManager& manager = *m_node.chainman;
+    const CScript script_pub_key{CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG};
+    const CMutableTransaction spend{CreateValidMempoolTransaction(m_coinbase_txns[0], /*input_vout=*/0, /*input_height=*/1, coinbaseKey, script_pub_key, /*output_amount=*/1 * COIN, /*submit=*/false)};
+    const CBlock block{CreateAndProcessBlock({spend}, script_pub_key)};
+
+    LOCK(::cs_main);
+    const std::vector<BlockValidationProfile> profiles{manager.GetBlockValidationProfiles()};
+    BOOST_REQUIRE_GE(profiles.size(), 101U);
+    for (size_t i{profiles.size() - 100}; i < profiles.size(); ++i) {
+        BOOST_CHECK_EQUAL(profiles[i].height, profiles[i - 1].height + 1);
+    }
+
+    const BlockValidationProfile& profile{profiles.back()};
+    BOOST_CHECK_EQUAL(profile.hash, block.GetHash());
+    BOOST_CHECK_EQUAL(profile.height, manager.ActiveHeight());
+    BOOST_CHECK_EQUAL(profile.tx_count, 2U);
+    BOOST_CHECK_EQUAL(profile.input_count, 1U);
+    BOOST_CHECK_EQUAL(profile.script_check_busy.size(), manager.GetCheckQueue().BusyTimes().size());
+    BOOST_CHECK(profile.total >= profile.read + profile.verify + profile.flush + profile.chainstate + profile.post_connect);
+    BOOST_CHECK(profile.verify >= profile.connect);
+}
+
 BOOST_FIXTURE_TEST_CASE(chainstatemanager_ibd_exit_after_loading_blocks, ChainTestingSetup)
 {
     CBlockIndex tip;
@@ -450,6 +475,100 @@ BOOST_FIXTURE_TEST_CASE(chainstatemanager_activate_snapshot, SnapshotTestSetup)
     this->SetupSnapshot();
 }
 
+//! Test how the coins of a snapshot are loaded and checked, depending on
+//! their order and on the file matching its metadata.
+BOOST_FIXTURE_TEST_CASE(chainstatemanager_snapshot_coins, TestChain100Setup)
+{
+    ChainstateManager& chainman{*Assert(m_node.chainman)};
+    // Height 110 has an assumeutxo value
+    mineBlocks(10);
+
+    const fs::path snapshot_path{m_path_root / "snapshot.dat"};
+    CreateUTXOSnapshot(m_node, chainman.ActiveChainstate(), AutoFile{fsbridge::fopen(snapshot_path, "wb")}, snapshot_path, snapshot_path);
+
+    // The coins of the snapshot, by txid, in file order
+    SnapshotMetadata metadata{chainman.GetParams().MessageStart()};
+    std::vector<std::pair<Txid, std::vector<std::pair<uint32_t, Coin>>>> txids;
+    {
+        AutoFile file{fsbridge::fopen(snapshot_path, "rb")};
+        file >> metadata;
+        for (uint64_t coins{0}; coins < metadata.m_coins_count;) {
+            auto& [txid, txid_coins]{txids.emplace_back()};
+            file >> txid;
+            txid_coins.resize(ReadCompactSize(file));
+            for (auto& [n, coin] : txid_coins) {
+                n = ReadCompactSize(file);
+                file >> coin;
+                ++coins;
+            }
+        }
+    }
+    BOOST_REQUIRE_GT(txids.size(), 1U);
+
+    const auto activate{[&](const SnapshotMetadata& meta, const decltype(txids)& coins, size_t truncate = 0) {
+        DataStream data;
+        data << meta;
+        for (const auto& [txid, txid_coins] : coins) {
+            data << txid;
+            WriteCompactSize(data, txid_coins.size());
+            for (const auto& [n, coin] : txid_coins) {
+                WriteCompactSize(data, n);
+                data << coin;
+            }
+        }
+        data.resize(data.size() - truncate);
+        {
+            AutoFile file{fsbridge::fopen(snapshot_path, "wb")};
+            file << std::span{data};
+            BOOST_REQUIRE_EQUAL(file.fclose(), 0);
+        }
+
+        AutoFile file{fsbridge::fopen(snapshot_path, "rb")};
+        SnapshotMetadata read_meta{chainman.GetParams().MessageStart()};
+        file >> read_meta;
+        // The snapshot chainstate has to be ahead of the active one.
+        Chainstate& active{chainman.ActiveChainstate()};
+        CBlockIndex* tip{WITH_LOCK(::cs_main, return active.m_chain.Tip())};
+        active.m_chain.SetTip(*Assert(tip->pprev));
+        auto res{chainman.ActivateSnapshot(file, read_meta, /*in_memory=*/true)};
+        active.m_chain.SetTip(*tip);
+        return res;
+    }};
+    const auto check_error{[](const util::Result<CBlockIndex*>& res, const std::string& error) {
+        BOOST_REQUIRE(!res);
+        BOOST_CHECK_MESSAGE(util::ErrorString(res).original.find(error) != std::string::npos, util::ErrorString(res).original);
+    }};
+
+    // Truncated, or not matching the number of coins in the metadata
+    check_error(activate(metadata, txids, /*truncate=*/5), "truncated snapshot");
+    SnapshotMetadata more_coins{metadata};
+    more_coins.m_coins_count += 1;
+    check_error(activate(more_coins, txids), "truncated snapshot");
+    SnapshotMetadata fewer_coins{metadata};
+    fewer_coins.m_coins_count -= 1;
+    check_error(activate(fewer_coins, txids), "coins left over");
+
+    // A changed coin is caught whether the coins are hashed while loading
+    // them, as when they are sorted, or from the coins database.
+    auto changed{txids};
+    changed.back().second.front().second.out.nValue -= 1;
+    check_error(activate(metadata, changed), "Bad snapshot content hash");
+    std::ranges::reverse(changed);
+    {
+        ASSERT_DEBUG_LOG("coins are not sorted by outpoint");
+        check_error(activate(metadata, changed), "Bad snapshot content hash");
+    }
+
+    // Coins out of order are fine, but hashed from the coins database
+    auto unsorted{txids};
+    std::ranges::reverse(unsorted);
+    {
+        ASSERT_DEBUG_LOG("coins are not sorted by outpoint");
+        BOOST_CHECK(activate(metadata, unsorted));
+    }
+    BOOST_CHECK(WITH_LOCK(::cs_main, return chainman.CurrentChainstate().m_from_snapshot_blockhash));
+}
+
 //! Test LoadBlockIndex behavior when multiple chainstates are in use.
 //!
 //! - First, verify that setBlockIndexCandidates is as expected when using a single,
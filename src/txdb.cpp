@@ -51,8 +51,12 @@ CCoinsViewDB::CCoinsViewDB(DBParams db_params, CoinsViewOptions options) :
     m_options{std::move(options)},
     m_db{std::make_unique<CDBWrapper>(m_db_params)} { }
 
-void CCoinsViewDB::ResizeCache(size_t new_cache_size)
+bool CCoinsViewDB::ResizeCache(size_t new_cache_size)
 {
+    // Cursors may be iterated without cs_main, for example by
+    // gettxoutsetinfo, so their database must stay open.
+    LOCK(m_cursors_mutex);
+    if (m_open_cursors.load() > 0) return false;
     // We can't do this operation with an in-memory DB since we'll lose all the coins upon
     // reset.
     if (!m_db_params.memory_only) {
@@ -63,6 +67,12 @@ void CCoinsViewDB::ResizeCache(size_t new_cache_size)
         m_db_params.wipe_data = false;
         m_db = std::make_unique<CDBWrapper>(m_db_params);
     }
+    return true;
+}
+
+size_t CCoinsViewDB::DynamicMemoryUsage() const
+{
+    return m_db->DynamicMemoryUsage();
 }
 
 std::optional<Coin> CCoinsViewDB::GetCoin(const COutPoint& outpoint) const
@@ -168,27 +178,32 @@ class CCoinsViewDBCursor: public CCoinsViewCursor
 public:
     // Prefer using CCoinsViewDB::Cursor() since we want to perform some
     // cache warmup on instantiation.
-    CCoinsViewDBCursor(CDBIterator* pcursorIn, const uint256&hashBlockIn):
-        CCoinsViewCursor(hashBlockIn), pcursor(pcursorIn) {}
-    ~CCoinsViewDBCursor() = default;
+    CCoinsViewDBCursor(CDBIterator* pcursorIn, const uint256&hashBlockIn, std::atomic<size_t>& open_cursors):
+        CCoinsViewCursor(hashBlockIn), pcursor(pcursorIn), m_open_cursors(open_cursors) { ++m_open_cursors; }
+    ~CCoinsViewDBCursor() { pcursor.reset(); --m_open_cursors; }
 
     bool GetKey(COutPoint &key) const override;
     bool GetValue(Coin &coin) const override;
 
     bool Valid() const override;
     void Next() override;
+    void Seek(const COutPoint& outpoint) override;
 
 private:
     std::unique_ptr<CDBIterator> pcursor;
     std::pair<char, COutPoint> keyTmp;
+    std::atomic<size_t>& m_open_cursors;
+
+    void CacheKey();
 
     friend class CCoinsViewDB;
 };
 
 std::unique_ptr<CCoinsViewCursor> CCoinsViewDB::Cursor() const
 {
+    LOCK(m_cursors_mutex);
     auto i = std::make_unique<CCoinsViewDBCursor>(
-        const_cast<CDBWrapper&>(*m_db).NewIterator(), GetBestBlock());
+        const_cast<CDBWrapper&>(*m_db).NewIterator(), GetBestBlock(), m_open_cursors);
     /* It seems that there are no "const iterators" for LevelDB.  Since we
        only need read operations on it, use a const-cast to get around
        that restriction.  */
@@ -227,6 +242,17 @@ bool CCoinsViewDBCursor::Valid() const
 void CCoinsViewDBCursor::Next()
 {
     pcursor->Next();
+    CacheKey();
+}
+
+void CCoinsViewDBCursor::Seek(const COutPoint& outpoint)
+{
+    pcursor->Seek(CoinEntry(&outpoint));
+    CacheKey();
+}
+
+void CCoinsViewDBCursor::CacheKey()
+{
     CoinEntry entry(&keyTmp.second);
     if (!pcursor->Valid() || !pcursor->GetKey(entry)) {
         keyTmp.first = 0; // Invalidate cached key after last record so that Valid() and GetKey() return false
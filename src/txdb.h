@@ -13,6 +13,7 @@
 #include <sync.h>
 #include <util/fs.h>
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
@@ -37,6 +38,11 @@ protected:
     DBParams m_db_params;
     CoinsViewOptions m_options;
     std::unique_ptr<CDBWrapper> m_db;
+    //! Held while creating a cursor or reopening m_db, as cursors may be
+    //! created without cs_main.
+    mutable Mutex m_cursors_mutex;
+    //! Number of cursors iterating over m_db, which ResizeCache() must not reopen meanwhile
+    mutable std::atomic<size_t> m_open_cursors{0};
 public:
     explicit CCoinsViewDB(DBParams db_params, CoinsViewOptions options);
 
@@ -45,14 +51,20 @@ public:
     uint256 GetBestBlock() const override;
     std::vector<uint256> GetHeadBlocks() const override;
     void BatchWrite(CoinsViewCacheCursor& cursor, const uint256& hashBlock) override;
-    std::unique_ptr<CCoinsViewCursor> Cursor() const override;
+    std::unique_ptr<CCoinsViewCursor> Cursor() const override EXCLUSIVE_LOCKS_REQUIRED(!m_cursors_mutex);
 
     //! Whether an unsupported database format is used.
     bool NeedsUpgrade();
     size_t EstimateSize() const override;
 
-    //! Dynamically alter the underlying leveldb cache size.
-    void ResizeCache(size_t new_cache_size) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+    //! Dynamically alter the underlying leveldb cache size. This reopens the
+    //! database, so return false, leaving it as it is, while any cursor is open.
+    [[nodiscard]] bool ResizeCache(size_t new_cache_size) EXCLUSIVE_LOCKS_REQUIRED(cs_main, !m_cursors_mutex);
+
+    //! Memory held by the storage engine, including the in-memory index of LogDB.
+    size_t DynamicMemoryUsage() const;
+
+    DBEngine Engine() const { return m_db->Engine(); }
 };
 
 #endif // BITCOIN_TXDB_H
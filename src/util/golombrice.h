@@ -5,11 +5,16 @@
 #ifndef BITCOIN_UTIL_GOLOMBRICE_H
 #define BITCOIN_UTIL_GOLOMBRICE_H
 
+#include <crypto/common.h>
 #include <util/fastrange.h>
 
 #include <streams.h>
 
+#include <bit>
+#include <cstddef>
 #include <cstdint>
+#include <ios>
+#include <span>
 
 template <typename OStream>
 void GolombRiceEncode(BitStreamWriter<OStream>& bitwriter, uint8_t P, uint64_t x)
@@ -42,4 +47,95 @@ uint64_t GolombRiceDecode(BitStreamReader<IStream>& bitreader, uint8_t P)
     return (q << P) + r;
 }
 
+/**
+ * Decodes a stream of Golomb-Rice coded values, like GolombRiceDecode(), but
+ * reads the underlying bytes a 64-bit word at a time and decodes each unary
+ * quotient with a single count of leading one bits, instead of going bit by
+ * bit. Throws std::ios_base::failure when reading past the end of the data.
+ */
+class GolombRiceDecoder
+{
+private:
+    std::span<const unsigned char> m_data;
+    /// Offset of the first byte of m_data not loaded into m_buffer yet.
+    size_t m_pos{0};
+    /// Bits loaded but not consumed yet, left-aligned. Lower bits are zero.
+    uint64_t m_buffer{0};
+    /// Number of valid bits in m_buffer.
+    int m_bits{0};
+
+    /// Load as many whole bytes into m_buffer as fit.
+    void Refill()
+    {
+        const int nbytes{(64 - m_bits) / 8};
+        if (nbytes == 0) return;
+        if (m_data.size() - m_pos >= 8) {
+            const int nbits{m_bits + nbytes * 8};
+            m_buffer |= ReadBE64(m_data.data() + m_pos) >> m_bits;
+            if (nbits < 64) m_buffer &= ~uint64_t{0} << (64 - nbits);
+            m_bits = nbits;
+            m_pos += nbytes;
+            return;
+        }
+        for (int i = 0; i < nbytes && m_pos < m_data.size(); ++i) {
+            m_buffer |= uint64_t{m_data[m_pos++]} << (56 - m_bits);
+            m_bits += 8;
+        }
+    }
+
+    void Consume(int nbits)
+    {
+        m_buffer = nbits == 64 ? 0 : m_buffer << nbits;
+        m_bits -= nbits;
+    }
+
+    /// Read 0 to 56 bits.
+    uint64_t ReadBits(int nbits)
+    {
+        if (nbits == 0) return 0;
+        if (m_bits < nbits) {
+            Refill();
+            if (m_bits < nbits) throw std::ios_base::failure("GolombRiceDecoder: end of data");
+        }
+        const uint64_t value{m_buffer >> (64 - nbits)};
+        Consume(nbits);
+        return value;
+    }
+
+public:
+    explicit GolombRiceDecoder(std::span<const unsigned char> data) : m_data{data} {}
+
+    uint64_t Decode(uint8_t P)
+    {
+        // Read unary-encoded quotient: q 1's followed by one 0.
+        uint64_t q{0};
+        while (true) {
+            if (m_bits == 0) {
+                Refill();
+                if (m_bits == 0) throw std::ios_base::failure("GolombRiceDecoder: end of data");
+            }
+            const int ones{std::countl_one(m_buffer)};
+            if (ones < m_bits) {
+                q += ones;
+                Consume(ones + 1);
+                break;
+            }
+            q += m_bits;
+            Consume(m_bits);
+        }
+
+        uint64_t r;
+        if (P <= 56) {
+            r = ReadBits(P);
+        } else {
+            r = ReadBits(P - 32) << 32;
+            r |= ReadBits(32);
+        }
+        return (q << P) + r;
+    }
+
+    /// Number of bytes of the data the values decoded so far were read from.
+    size_t BytesRead() const { return (m_pos * 8 - m_bits + 7) / 8; }
+};
+
 #endif // BITCOIN_UTIL_GOLOMBRICE_H
@@ -0,0 +1,436 @@
+// Copyright (c) 2026-present The Botcoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BOTCOIN_UTIL_NODE_HASH_MAP_H
+#define BOTCOIN_UTIL_NODE_HASH_MAP_H
+
+#include <util/check.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/**
+ * Hash map with an open-addressing index over individually allocated nodes.
+ *
+ * The index is a flat array of one control byte per slot, holding 7 bits of
+ * the key's hash for occupied slots, next to a flat array of node pointers.
+ * A lookup probes 16 control bytes at a time (with SSE2 where available) and
+ * only dereferences nodes whose hash bits match, instead of walking a
+ * std::unordered_map bucket chain. Nodes do not carry a chain pointer, and the
+ * index costs 9 bytes per slot at a maximum load factor of 7/8 compared to a
+ * pointer per bucket plus one per node.
+ *
+ * Values live in separately allocated nodes rather than in the slot array,
+ * so like std::unordered_map, references and pointers to elements stay valid
+ * until the element is erased, even across rehashes. Iterators are invalidated
+ * by rehashing (insertions) but not by erasing other elements.
+ *
+ * Supports the subset of the std::unordered_map interface used by CCoinsMap.
+ * Iteration order is unspecified.
+ */
+template <typename Key, typename T, typename Hash, typename KeyEqual, typename Allocator>
+class NodeHashMap
+{
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<const Key, T>;
+    using size_type = size_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using allocator_type = Allocator;
+
+    //! Number of control bytes probed at once.
+    static constexpr size_t GROUP_WIDTH{16};
+
+private:
+    using AllocTraits = typename std::allocator_traits<Allocator>::template rebind_traits<value_type>;
+    using NodeAllocator = typename AllocTraits::allocator_type;
+
+    //! Control byte values. Occupied slots hold the low 7 bits of the hash (0..127).
+    static constexpr int8_t CTRL_EMPTY{-128};
+    static constexpr int8_t CTRL_DELETED{-2};
+    static constexpr size_t NPOS{size_t(-1)};
+
+    /**
+     * Control bytes, m_capacity of them followed by a copy of the first
+     * GROUP_WIDTH so a group can be loaded from any slot without wrapping.
+     */
+    std::vector<int8_t> m_ctrl;
+    std::vector<value_type*> m_slots;
+    //! Number of slots; 0 or a power of two no smaller than GROUP_WIDTH.
+    size_t m_capacity{0};
+    size_t m_size{0};
+    //! Number of empty slots that can still be filled before the table has to grow.
+    size_t m_growth_left{0};
+
+    [[no_unique_address]] Hash m_hash;
+    [[no_unique_address]] KeyEqual m_key_equal;
+    NodeAllocator m_alloc;
+
+    static size_t MaxLoad(size_t capacity) noexcept { return capacity - capacity / 8; }
+    static int8_t H2(size_t hash) noexcept { return static_cast<int8_t>(hash & 0x7f); }
+    static size_t H1(size_t hash) noexcept { return hash >> 7; }
+
+    //! Bitmask of the slots in the group starting at ctrl whose control byte equals tag.
+    static uint32_t MatchByte(const int8_t* ctrl, int8_t tag) noexcept
+    {
+#ifdef __SSE2__
+        const __m128i group{_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl))};
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(tag), group)));
+#else
+        uint32_t mask{0};
+        for (size_t i{0}; i < GROUP_WIDTH; ++i) {
+            if (ctrl[i] == tag) mask |= uint32_t{1} << i;
+        }
+        return mask;
+#endif
+    }
+
+    //! Bitmask of the slots in the group starting at ctrl that are empty or deleted.
+    static uint32_t MatchFree(const int8_t* ctrl) noexcept
+    {
+#ifdef __SSE2__
+        // Free control bytes are exactly the negative ones.
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl))));
+#else
+        uint32_t mask{0};
+        for (size_t i{0}; i < GROUP_WIDTH; ++i) {
+            if (ctrl[i] < 0) mask |= uint32_t{1} << i;
+        }
+        return mask;
+#endif
+    }
+
+    void SetCtrl(size_t index, int8_t value) noexcept
+    {
+        m_ctrl[index] = value;
+        if (index < GROUP_WIDTH) m_ctrl[m_capacity + index] = value;
+    }
+
+    bool IsFull(size_t index) const noexcept { return m_ctrl[index] >= 0; }
+
+    /**
+     * Call fn(group_start) for the groups in the probe sequence of hash until
+     * it returns true. Groups are visited at triangular offsets, which reach
+     * every slot of a power-of-two table.
+     */
+    template <typename Fn>
+    void Probe(size_t hash, Fn&& fn) const
+    {
+        const size_t mask{m_capacity - 1};
+        size_t pos{H1(hash) & mask};
+        for (size_t step{0};; step += GROUP_WIDTH) {
+            pos = (pos + step) & mask;
+            if (fn(pos)) return;
+        }
+    }
+
+    size_t FindIndex(const Key& key, size_t hash) const
+    {
+        if (m_capacity == 0) return NPOS;
+        const int8_t h2{H2(hash)};
+        const size_t mask{m_capacity - 1};
+        size_t ret{NPOS};
+        Probe(hash, [&](size_t pos) {
+            const int8_t* group{&m_ctrl[pos]};
+            for (uint32_t match{MatchByte(group, h2)}; match; match &= match - 1) {
+                const size_t index{(pos + std::countr_zero(match)) & mask};
+                if (m_key_equal(m_slots[index]->first, key)) {
+                    ret = index;
+                    return true;
+                }
+            }
+            // An empty slot in the group means the key was never pushed further.
+            return MatchByte(group, CTRL_EMPTY) != 0;
+        });
+        return ret;
+    }
+
+    //! Find the slot a new element with this hash goes into. The table must have room.
+    size_t FindFreeIndex(size_t hash) const noexcept
+    {
+        const size_t mask{m_capacity - 1};
+        size_t ret{NPOS};
+        Probe(hash, [&](size_t pos) {
+            if (const uint32_t match{MatchFree(&m_ctrl[pos])}) {
+                ret = (pos + std::countr_zero(match)) & mask;
+                return true;
+            }
+            return false;
+        });
+        return ret;
+    }
+
+    //! Rebuild the index with the given number of slots, dropping deleted markers.
+    void Rehash(size_t capacity)
+    {
+        Assume(capacity >= GROUP_WIDTH && std::has_single_bit(capacity) && MaxLoad(capacity) >= m_size);
+        // Allocate both arrays before touching the current index.
+        std::vector<int8_t> old_ctrl(capacity + GROUP_WIDTH, CTRL_EMPTY);
+        std::vector<value_type*> old_slots(capacity, nullptr);
+        m_ctrl.swap(old_ctrl);
+        m_slots.swap(old_slots);
+        const size_t old_capacity{m_capacity};
+        m_capacity = capacity;
+        for (size_t i{0}; i < old_capacity; ++i) {
+            if (old_ctrl[i] < 0) continue;
+            const size_t hash{m_hash(old_slots[i]->first)};
+            const size_t index{FindFreeIndex(hash)};
+            SetCtrl(index, H2(hash));
+            m_slots[index] = old_slots[i];
+        }
+        m_growth_left = MaxLoad(m_capacity) - m_size;
+    }
+
+    static size_t CapacityFor(size_t count) noexcept
+    {
+        size_t capacity{GROUP_WIDTH};
+        while (MaxLoad(capacity) < count) capacity *= 2;
+        return capacity;
+    }
+
+    //! Make sure one more element can be inserted without exceeding the maximum load.
+    void PrepareInsert()
+    {
+        if (m_growth_left > 0) return;
+        // If at most half the load is live elements, the rest are deleted
+        // markers and rebuilding at the same size frees enough space.
+        if (m_capacity > 0 && m_size <= MaxLoad(m_capacity) / 2) {
+            Rehash(m_capacity);
+        } else {
+            Rehash(m_capacity == 0 ? GROUP_WIDTH : m_capacity * 2);
+        }
+    }
+
+    //! Link a constructed node into the table. The table must have room (PrepareInsert).
+    size_t InsertNode(value_type* node, size_t hash) noexcept
+    {
+        const size_t index{FindFreeIndex(hash)};
+        if (m_ctrl[index] == CTRL_EMPTY) --m_growth_left;
+        SetCtrl(index, H2(hash));
+        m_slots[index] = node;
+        ++m_size;
+        return index;
+    }
+
+    template <typename... Args>
+    value_type* NewNode(Args&&... args)
+    {
+        value_type* node{AllocTraits::allocate(m_alloc, 1)};
+        try {
+            AllocTraits::construct(m_alloc, node, std::forward<Args>(args)...);
+        } catch (...) {
+            AllocTraits::deallocate(m_alloc, node, 1);
+            throw;
+        }
+        return node;
+    }
+
+    void DeleteNode(value_type* node) noexcept
+    {
+        AllocTraits::destroy(m_alloc, node);
+        AllocTraits::deallocate(m_alloc, node, 1);
+    }
+
+    size_t NextFull(size_t index) const noexcept
+    {
+        while (index < m_capacity && !IsFull(index)) ++index;
+        return index;
+    }
+
+    void EraseIndex(size_t index) noexcept
+    {
+        DeleteNode(m_slots[index]);
+        m_slots[index] = nullptr;
+        --m_size;
+        // The slot can go back to empty if no probe sequence can have passed
+        // over it, i.e. if every group window containing it has an empty slot.
+        const size_t mask{m_capacity - 1};
+        const uint32_t empty_after{MatchByte(&m_ctrl[index], CTRL_EMPTY)};
+        const uint32_t empty_before{MatchByte(&m_ctrl[(index - GROUP_WIDTH) & mask], CTRL_EMPTY)};
+        const bool was_never_full{empty_after && empty_before &&
+                                  size_t(std::countr_zero(empty_after) + std::countl_zero(empty_before << (32 - GROUP_WIDTH))) < GROUP_WIDTH};
+        if (was_never_full) {
+            SetCtrl(index, CTRL_EMPTY);
+            ++m_growth_left;
+        } else {
+            SetCtrl(index, CTRL_DELETED);
+        }
+    }
+
+public:
+    template <bool IsConst>
+    class Iterator
+    {
+        friend class NodeHashMap;
+        using Map = std::conditional_t<IsConst, const NodeHashMap, NodeHashMap>;
+        Map* m_map{nullptr};
+        size_t m_index{0};
+
+        Iterator(Map* map, size_t index) noexcept : m_map{map}, m_index{index} {}
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = NodeHashMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<IsConst, const value_type*, value_type*>;
+        using reference = std::conditional_t<IsConst, const value_type&, value_type&>;
+
+        Iterator() noexcept = default;
+        //! Allow iterator to const_iterator conversion.
+        template <bool OtherConst, typename = std::enable_if_t<IsConst && !OtherConst>>
+        Iterator(const Iterator<OtherConst>& other) noexcept : m_map{other.m_map}, m_index{other.m_index} {}
+
+        reference operator*() const noexcept { return *m_map->m_slots[m_index]; }
+        pointer operator->() const noexcept { return m_map->m_slots[m_index]; }
+        Iterator& operator++() noexcept
+        {
+            m_index = m_map->NextFull(m_index + 1);
+            return *this;
+        }
+        Iterator operator++(int) noexcept
+        {
+            Iterator ret{*this};
+            ++*this;
+            return ret;
+        }
+        friend bool operator==(const Iterator& a, const Iterator& b) noexcept { return a.m_index == b.m_index; }
+
+        template <bool>
+        friend class Iterator;
+    };
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    explicit NodeHashMap(size_t bucket_count, const Hash& hash, const KeyEqual& key_equal, const Allocator& alloc)
+        : m_hash{hash}, m_key_equal{key_equal}, m_alloc{alloc}
+    {
+        if (bucket_count > 0) reserve(bucket_count);
+    }
+
+    NodeHashMap(const NodeHashMap&) = delete;
+    NodeHashMap& operator=(const NodeHashMap&) = delete;
+
+    ~NodeHashMap() { clear(); }
+
+    iterator begin() noexcept { return {this, NextFull(0)}; }
+    const_iterator begin() const noexcept { return {this, NextFull(0)}; }
+    iterator end() noexcept { return {this, m_capacity}; }
+    const_iterator end() const noexcept { return {this, m_capacity}; }
+
+    size_t size() const noexcept { return m_size; }
+    bool empty() const noexcept { return m_size == 0; }
+    //! Number of slots in the index.
+    size_t bucket_count() const noexcept { return m_capacity; }
+
+    allocator_type get_allocator() const noexcept { return allocator_type{m_alloc}; }
+    hasher hash_function() const { return m_hash; }
+    key_equal key_eq() const { return m_key_equal; }
+
+    iterator find(const Key& key)
+    {
+        const size_t index{FindIndex(key, m_hash(key))};
+        return {this, index == NPOS ? m_capacity : index};
+    }
+
+    const_iterator find(const Key& key) const
+    {
+        const size_t index{FindIndex(key, m_hash(key))};
+        return {this, index == NPOS ? m_capacity : index};
+    }
+
+    size_t count(const Key& key) const { return find(key) != end(); }
+
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args)
+    {
+        const size_t hash{m_hash(key)};
+        if (const size_t index{FindIndex(key, hash)}; index != NPOS) return {{this, index}, false};
+        PrepareInsert();
+        value_type* node{NewNode(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...))};
+        return {{this, InsertNode(node, hash)}, true};
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(Key&& key, Args&&... args)
+    {
+        const size_t hash{m_hash(key)};
+        if (const size_t index{FindIndex(key, hash)}; index != NPOS) return {{this, index}, false};
+        PrepareInsert();
+        value_type* node{NewNode(std::piecewise_construct, std::forward_as_tuple(std::move(key)), std::forward_as_tuple(std::forward<Args>(args)...))};
+        return {{this, InsertNode(node, hash)}, true};
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(Args&&... args)
+    {
+        value_type* node{NewNode(std::forward<Args>(args)...)};
+        const size_t hash{m_hash(node->first)};
+        if (const size_t index{FindIndex(node->first, hash)}; index != NPOS) {
+            DeleteNode(node);
+            return {{this, index}, false};
+        }
+        try {
+            PrepareInsert();
+        } catch (...) {
+            DeleteNode(node);
+            throw;
+        }
+        return {{this, InsertNode(node, hash)}, true};
+    }
+
+    T& operator[](const Key& key) { return try_emplace(key).first->second; }
+
+    iterator erase(const_iterator pos) noexcept
+    {
+        Assume(pos.m_map == this && pos.m_index < m_capacity && IsFull(pos.m_index));
+        EraseIndex(pos.m_index);
+        return {this, NextFull(pos.m_index + 1)};
+    }
+
+    iterator erase(iterator pos) noexcept { return erase(const_iterator{pos}); }
+
+    size_t erase(const Key& key)
+    {
+        const size_t index{FindIndex(key, m_hash(key))};
+        if (index == NPOS) return 0;
+        EraseIndex(index);
+        return 1;
+    }
+
+    /** Destroy all elements. Like std::unordered_map, the index keeps its size. */
+    void clear() noexcept
+    {
+        if (m_capacity == 0) return;
+        for (size_t i{0}; i < m_capacity; ++i) {
+            if (IsFull(i)) DeleteNode(m_slots[i]);
+        }
+        std::fill(m_ctrl.begin(), m_ctrl.end(), CTRL_EMPTY);
+        std::fill(m_slots.begin(), m_slots.end(), nullptr);
+        m_size = 0;
+        m_growth_left = MaxLoad(m_capacity);
+    }
+
+    /** Size the index so that count elements fit without rehashing. */
+    void reserve(size_t count)
+    {
+        if (m_capacity > 0 && count <= m_size + m_growth_left) return;
+        Rehash(std::max(CapacityFor(std::max(count, m_size)), m_capacity));
+    }
+};
+
+#endif // BOTCOIN_UTIL_NODE_HASH_MAP_H
@@ -11,6 +11,7 @@
 #include <chain.h>
 #include <checkqueue.h>
 #include <clientversion.h>
+#include <compressor.h>
 #include <consensus/amount.h>
 #include <consensus/consensus.h>
 #include <consensus/merkle.h>
@@ -20,6 +21,7 @@
 #include <cuckoocache.h>
 #include <flatfile.h>
 #include <hash.h>
+#include <kernel/caches.h>
 #include <kernel/chainparams.h>
 #include <kernel/coinstats.h>
 #include <kernel/disconnected_transactions.h>
@@ -59,20 +61,25 @@
 #include <util/signalinterrupt.h>
 #include <util/strencodings.h>
 #include <util/string.h>
+#include <util/threadnames.h>
 #include <util/time.h>
 #include <util/trace.h>
 #include <util/translation.h>
 #include <validationinterface.h>
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <chrono>
+#include <condition_variable>
 #include <deque>
+#include <map>
 #include <numeric>
 #include <optional>
 #include <ranges>
 #include <span>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <utility>
 
@@ -81,12 +88,14 @@ using kernel::ChainstateRole;
 using kernel::CoinStatsHashType;
 using kernel::ComputeUTXOStats;
 using kernel::Notifications;
+using kernel::SerializeCoinForHash;
 
 using fsbridge::FopenFn;
 using node::BlockManager;
 using node::BlockMap;
 using node::CBlockIndexHeightOnlyComparator;
 using node::CBlockIndexWorkComparator;
+using node::COMPRESSED_BLOCK_FLAG;
 using node::SnapshotMetadata;
 
 /** Size threshold for warning about slow UTXO set flush to disk. */
@@ -97,6 +106,8 @@ static constexpr size_t WARN_FLUSH_COINS_SIZE = 1 << 30; // 1 GiB
 */
 static constexpr auto DATABASE_WRITE_INTERVAL_MIN{50min};
 static constexpr auto DATABASE_WRITE_INTERVAL_MAX{70min};
+/** Time between adjustments of the split between the coins cache and the coins database cache */
+static constexpr auto COINS_CACHE_ADAPT_INTERVAL{1h};
 /** Maximum age of our tip for us to be considered current for fee estimation */
 static constexpr std::chrono::hours MAX_FEE_ESTIMATION_TIP_AGE{3};
 const std::vector<std::string> CHECKLEVEL_DOC {
@@ -1860,7 +1871,8 @@ CAmount GetBlockSubsidy(int nHeight, const Consensus::Params& consensusParams)
 
 CoinsViews::CoinsViews(DBParams db_params, CoinsViewOptions options)
     : m_dbview{std::move(db_params), std::move(options)},
-      m_catcherview(&m_dbview) {}
+      m_flushview(&m_dbview),
+      m_catcherview(&m_flushview) {}
 
 void CoinsViews::InitCache()
 {
@@ -2025,11 +2037,11 @@ void UpdateCoins(const CTransaction& tx, CCoinsViewCache& inputs, CTxUndo &txund
     AddCoins(inputs, tx, nHeight);
 }
 
-std::optional<std::pair<ScriptError, std::string>> CScriptCheck::operator()() {
+std::optional<std::pair<ScriptError, std::string>> CScriptCheck::operator()(DeferredSignatureChecks* deferred) {
     const CScript &scriptSig = ptxTo->vin[nIn].scriptSig;
     const CScriptWitness *witness = &ptxTo->vin[nIn].scriptWitness;
     ScriptError error{SCRIPT_ERR_UNKNOWN_ERROR};
-    if (VerifyScript(scriptSig, m_tx_out.scriptPubKey, witness, m_flags, CachingTransactionSignatureChecker(ptxTo, nIn, m_tx_out.nValue, cacheStore, *m_signature_cache, *txdata), &error)) {
+    if (VerifyScript(scriptSig, m_tx_out.scriptPubKey, witness, m_flags, CachingTransactionSignatureChecker(ptxTo, nIn, m_tx_out.nValue, cacheStore, *m_signature_cache, *txdata, deferred), &error)) {
         return std::nullopt;
     } else {
         auto debug_str = strprintf("input %i of %s (wtxid %s), spending %s:%i", nIn, ptxTo->GetHash().ToString(), ptxTo->GetWitnessHash().ToString(), ptxTo->vin[nIn].prevout.hash.ToString(), ptxTo->vin[nIn].prevout.n);
@@ -2307,10 +2319,11 @@ script_verify_flags GetBlockScriptFlags(const CBlockIndex& block_index, const Ch
  *  Validity checks that depend on the UTXO set are also done; ConnectBlock()
  *  can fail if those validity checks fail (among other reasons). */
 bool Chainstate::ConnectBlock(const CBlock& block, BlockValidationState& state, CBlockIndex* pindex,
-                               CCoinsViewCache& view, bool fJustCheck)
+                               CCoinsViewCache& view, bool fJustCheck, ScriptCheckPipeline* pipeline)
 {
     AssertLockHeld(cs_main);
     assert(pindex);
+    assert(!fJustCheck || !pipeline);
 
     uint256 block_hash{block.GetHash()};
     assert(*pindex->phashBlock == block_hash);
@@ -2398,6 +2411,7 @@ bool Chainstate::ConnectBlock(const CBlock& block, BlockValidationState& state,
 
     const auto time_1{SteadyClock::now()};
     m_chainman.time_check += time_1 - time_start;
+    m_chainman.m_block_profile.check = time_1 - time_start;
     LogDebug(BCLog::BENCH, "    - Sanity checks: %.2fms [%.2fs (%.2fms/blk)]\n",
              Ticks<MillisecondsDouble>(time_1 - time_start),
              Ticks<SecondsDouble>(m_chainman.time_check),
@@ -2500,6 +2514,7 @@ bool Chainstate::ConnectBlock(const CBlock& block, BlockValidationState& state,
 
     const auto time_2{SteadyClock::now()};
     m_chainman.time_forks += time_2 - time_1;
+    m_chainman.m_block_profile.forks = time_2 - time_1;
     LogDebug(BCLog::BENCH, "    - Fork checks: %.2fms [%.2fs (%.2fms/blk)]\n",
              Ticks<MillisecondsDouble>(time_2 - time_1),
              Ticks<SecondsDouble>(m_chainman.time_forks),
@@ -2524,11 +2539,21 @@ bool Chainstate::ConnectBlock(const CBlock& block, BlockValidationState& state,
     // until after `control` has run the script checks (potentially
     // in multiple threads). Preallocate the vector size so a new allocation
     // doesn't invalidate pointers into the vector, and keep txsdata in scope
-    // for as long as `control`.
-    std::optional<CCheckQueueControl<CScriptCheck>> control;
-    if (auto& queue = m_chainman.GetCheckQueue(); queue.HasThreads() && fScriptChecks) control.emplace(queue);
-
-    std::vector<PrecomputedTransactionData> txsdata(block.vtx.size());
+    // for as long as `control`. A pipeline holds on to txsdata itself, as its
+    // checks outlive this call. Without worker threads (-par=1), the checks
+    // still go through the queue, whose Complete() then runs them all on this
+    // thread, so that Schnorr signatures are batch verified there as well.
+    std::optional<CCheckQueueControl<CScriptCheck>> own_control;
+    CCheckQueueControl<CScriptCheck>* control{nullptr};
+    if (pipeline) {
+        if (fScriptChecks) control = &*pipeline->control;
+    } else if (fScriptChecks) {
+        control = &own_control.emplace(m_chainman.GetCheckQueue());
+    }
+
+    std::vector<PrecomputedTransactionData> own_txsdata;
+    std::vector<PrecomputedTransactionData>& txsdata{pipeline ? pipeline->txsdata.emplace_back() : own_txsdata};
+    txsdata.resize(block.vtx.size());
 
     std::vector<int> prevheights;
     CAmount nFees = 0;
@@ -2615,6 +2640,9 @@ bool Chainstate::ConnectBlock(const CBlock& block, BlockValidationState& state,
     }
     const auto time_3{SteadyClock::now()};
     m_chainman.time_connect += time_3 - time_2;
+    m_chainman.m_block_profile.connect = time_3 - time_2;
+    m_chainman.m_block_profile.tx_count = block.vtx.size();
+    m_chainman.m_block_profile.input_count = nInputs - 1;
     LogDebug(BCLog::BENCH, "      - Connect %u transactions: %.2fms (%.3fms/tx, %.3fms/txin) [%.2fs (%.2fms/blk)]\n", (unsigned)block.vtx.size(),
              Ticks<MillisecondsDouble>(time_3 - time_2), Ticks<MillisecondsDouble>(time_3 - time_2) / block.vtx.size(),
              nInputs <= 1 ? 0 : Ticks<MillisecondsDouble>(time_3 - time_2) / (nInputs - 1),
@@ -2626,8 +2654,8 @@ bool Chainstate::ConnectBlock(const CBlock& block, BlockValidationState& state,
         state.Invalid(BlockValidationResult::BLOCK_CONSENSUS, "bad-cb-amount",
                       strprintf("coinbase pays too much (actual=%d vs limit=%d)", block.vtx[0]->GetValueOut(), blockReward));
     }
-    if (control) {
-        auto parallel_result = control->Complete();
+    if (own_control) {
+        auto parallel_result = own_control->Complete();
         if (parallel_result.has_value() && state.IsValid()) {
             state.Invalid(BlockValidationResult::BLOCK_CONSENSUS, strprintf("block-script-verify-flag-failed (%s)", ScriptErrorString(parallel_result->first)), parallel_result->second);
         }
@@ -2638,6 +2666,7 @@ bool Chainstate::ConnectBlock(const CBlock& block, BlockValidationState& state,
     }
     const auto time_4{SteadyClock::now()};
     m_chainman.time_verify += time_4 - time_2;
+    m_chainman.m_block_profile.verify = time_4 - time_2;
     LogDebug(BCLog::BENCH, "    - Verify %u txins: %.2fms (%.3fms/txin) [%.2fs (%.2fms/blk)]\n", nInputs - 1,
              Ticks<MillisecondsDouble>(time_4 - time_2),
              nInputs <= 1 ? 0 : Ticks<MillisecondsDouble>(time_4 - time_2) / (nInputs - 1),
@@ -2654,12 +2683,13 @@ bool Chainstate::ConnectBlock(const CBlock& block, BlockValidationState& state,
 
     const auto time_5{SteadyClock::now()};
     m_chainman.time_undo += time_5 - time_4;
+    m_chainman.m_block_profile.undo = time_5 - time_4;
     LogDebug(BCLog::BENCH, "    - Write undo data: %.2fms [%.2fs (%.2fms/blk)]\n",
              Ticks<MillisecondsDouble>(time_5 - time_4),
              Ticks<SecondsDouble>(m_chainman.time_undo),
              Ticks<MillisecondsDouble>(m_chainman.time_undo) / m_chainman.num_blocks_total);
 
-    if (!pindex->IsValid(BLOCK_VALID_SCRIPTS)) {
+    if (!pipeline && !pindex->IsValid(BLOCK_VALID_SCRIPTS)) {
         pindex->RaiseValidity(BLOCK_VALID_SCRIPTS);
         m_blockman.m_dirty_blockindex.insert(pindex);
     }
@@ -2669,6 +2699,7 @@ bool Chainstate::ConnectBlock(const CBlock& block, BlockValidationState& state,
 
     const auto time_6{SteadyClock::now()};
     m_chainman.time_index += time_6 - time_5;
+    m_chainman.m_block_profile.index = time_6 - time_5;
     LogDebug(BCLog::BENCH, "    - Index writing: %.2fms [%.2fs (%.2fms/blk)]\n",
              Ticks<MillisecondsDouble>(time_6 - time_5),
              Ticks<SecondsDouble>(m_chainman.time_index),
@@ -2700,9 +2731,22 @@ CoinsCacheSizeState Chainstate::GetCoinsCacheSizeState(
 {
     AssertLockHeld(::cs_main);
     const int64_t nMempoolUsage = m_mempool ? m_mempool->DynamicMemoryUsage() : 0;
+    // Coins that are still being written to disk have a budget of their
+    // own, which they cannot exceed as they were the coins cache when it was
+    // flushed. Counting them here would make the next block flush again and
+    // wait for the write, which is what writing in the background avoids.
     int64_t cacheSize = CoinsTip().DynamicMemoryUsage();
     int64_t nTotalSpace =
         max_coins_cache_size_bytes + std::max<int64_t>(int64_t(max_mempool_size_bytes) - nMempoolUsage, 0);
+    // The coins database may hold more than its share of -dbcache, as LogDB
+    // keeps every key in memory. The excess is taken from the coins cache,
+    // but never more than half of it, as flushing does not shrink the index.
+    // Both engines report their usage safely alongside a background write,
+    // so do not wait for one through CoinsDB().
+    const int64_t coinsdb_usage = m_coins_views->m_dbview.DynamicMemoryUsage();
+    if (coinsdb_usage > int64_t(m_coinsdb_cache_size_bytes)) {
+        cacheSize += std::min<int64_t>(coinsdb_usage - m_coinsdb_cache_size_bytes, nTotalSpace / 2);
+    }
 
     if (cacheSize > nTotalSpace) {
         LogInfo("Cache size (%s) exceeds total space (%s)\n", cacheSize, nTotalSpace);
@@ -2730,6 +2774,9 @@ bool Chainstate::FlushStateToDisk(
     {
         bool fFlushForPrune = false;
 
+        // Free the coins of a previous flush once they have been written.
+        CoinsFlushBuffer().ReleaseWritten();
+
         CoinsCacheSizeState cache_state = GetCoinsCacheSizeState();
         LOCK(m_blockman.cs_LastBlockFile);
         if (m_blockman.IsPruneMode() && (m_blockman.m_check_for_pruning || nManualPruneHeight > 0) && m_chainman.m_blockman.m_blockfiles_indexed) {
@@ -2807,12 +2854,24 @@ bool Chainstate::FlushStateToDisk(
             {
                 LOG_TIME_MILLIS_WITH_CATEGORY("write block index to disk", BCLog::BENCH);
 
-                m_blockman.WriteBlockIndexDB();
+                if (!m_blockman.WriteBlockIndexDB()) {
+                    return FatalError(m_chainman.GetNotifications(), state, _("Failed to write to block index database."));
+                }
+                // The PoW verdicts table would grow by an entry per header
+                // forever, so drop the verdicts below the assumevalid block.
+                const CBlockIndex* assumed_valid{m_blockman.LookupBlockIndex(m_chainman.AssumedValidBlock())};
+                if (assumed_valid && m_chainman.m_best_header &&
+                    m_chainman.m_best_header->GetAncestor(assumed_valid->nHeight) == assumed_valid) {
+                    m_blockman.PrunePowVerdicts(assumed_valid->nHeight);
+                }
             }
             // Finally remove any pruned files
             if (fFlushForPrune) {
                 LOG_TIME_MILLIS_WITH_CATEGORY("unlink pruned files", BCLog::BENCH);
 
+                // The coins database must not be left on a head blocks marker
+                // whose blocks are pruned, so finish the previous write first.
+                CoinsFlushBuffer().WaitForWrite();
                 m_blockman.UnlinkPrunedFiles(setFilesToPrune);
             }
 
@@ -2830,7 +2889,13 @@ bool Chainstate::FlushStateToDisk(
                     return FatalError(m_chainman.GetNotifications(), state, _("Disk space is too low!"));
                 }
                 // Flush the chainstate (which may refer to block index entries).
+                // The coins are written in the background, unless the caller
+                // relies on them being on disk, or pruning may already have
+                // removed blocks needed to replay them after a crash.
                 empty_cache ? CoinsTip().Flush() : CoinsTip().Sync();
+                if (mode == FlushStateMode::FORCE_FLUSH || mode == FlushStateMode::FORCE_SYNC || fFlushForPrune) {
+                    CoinsFlushBuffer().WaitForWrite();
+                }
                 full_flush_completed = true;
                 TRACEPOINT(utxocache, flush,
                     int64_t{Ticks<std::chrono::microseconds>(NodeClock::now() - nNow)},
@@ -2952,12 +3017,12 @@ bool Chainstate::DisconnectTip(BlockValidationState& state, DisconnectedBlockTra
     assert(pindexDelete);
     assert(pindexDelete->pprev);
     // Read block from disk.
-    std::shared_ptr<CBlock> pblock = std::make_shared<CBlock>();
-    CBlock& block = *pblock;
-    if (!m_blockman.ReadBlock(block, *pindexDelete)) {
+    std::shared_ptr<const CBlock> pblock{m_blockman.ReadBlock(*pindexDelete)};
+    if (!pblock) {
         LogError("DisconnectTip(): Failed to read block\n");
         return false;
     }
+    const CBlock& block = *pblock;
     // Apply the block atomically to the chain state.
     const auto time_start{SteadyClock::now()};
     {
@@ -3052,27 +3117,36 @@ public:
  * Connect a new block to m_chain. block_to_connect is either nullptr or a pointer to a CBlock
  * corresponding to pindexNew, to bypass loading it again from disk.
  *
- * The block is added to connectTrace if connection succeeds.
+ * The block is added to connectTrace once it becomes the tip. If pipeline is
+ * set, the block's script checks are left running, its changes to the UTXO
+ * set go to the pipeline's view, and it only becomes the tip once its checks
+ * have passed; see CompleteScriptCheckPipeline().
  */
 bool Chainstate::ConnectTip(
     BlockValidationState& state,
     CBlockIndex* pindexNew,
     std::shared_ptr<const CBlock> block_to_connect,
     ConnectTrace& connectTrace,
-    DisconnectedBlockTransactions& disconnectpool)
+    DisconnectedBlockTransactions& disconnectpool,
+    ScriptCheckPipeline* pipeline)
 {
     AssertLockHeld(cs_main);
     if (m_mempool) AssertLockHeld(m_mempool->cs);
 
-    assert(pindexNew->pprev == m_chain.Tip());
+    assert(pindexNew->pprev == (pipeline && !pipeline->blocks.empty() ? pipeline->blocks.back().first : m_chain.Tip()));
+    BlockValidationProfile& profile{m_chainman.m_block_profile};
+    profile = {};
+    profile.hash = pindexNew->GetBlockHash();
+    profile.height = pindexNew->nHeight;
+    profile.pipelined = pipeline != nullptr;
+    const auto busy_start{m_chainman.GetCheckQueue().BusyTimes()};
     // Read block from disk.
     const auto time_1{SteadyClock::now()};
     if (!block_to_connect) {
-        std::shared_ptr<CBlock> pblockNew = std::make_shared<CBlock>();
-        if (!m_blockman.ReadBlock(*pblockNew, *pindexNew)) {
+        block_to_connect = m_blockman.ReadBlock(*pindexNew);
+        if (!block_to_connect) {
             return FatalError(m_chainman.GetNotifications(), state, _("Failed to read block."));
         }
-        block_to_connect = std::move(pblockNew);
     } else {
         LogDebug(BCLog::BENCH, "  - Using cached block\n");
     }
@@ -3084,10 +3158,20 @@ bool Chainstate::ConnectTip(
     LogDebug(BCLog::BENCH, "  - Load block from disk: %.2fms\n",
              Ticks<MillisecondsDouble>(time_2 - time_1));
     {
-        CCoinsViewCache& view{*m_coins_views->m_connect_block_view};
+        // Read the inputs missing from the coins cache on the input fetcher's
+        // threads, rather than one at a time while connecting the block.
+        profile.fetch_stats = m_chainman.GetInputFetcher().FetchInputs(CoinsTip(), CoinsFlushBuffer(), *block_to_connect, pipeline ? &pipeline->view : nullptr);
+        profile.fetch = SteadyClock::now() - time_2;
+        std::optional<CCoinsViewCache> pipeline_block_view;
+        if (pipeline) {
+            pipeline->block_data.push_back(block_to_connect);
+            pipeline_block_view.emplace(&pipeline->view);
+        }
+        CCoinsViewCache& view{pipeline ? *pipeline_block_view : *m_coins_views->m_connect_block_view};
         const auto reset_guard{view.CreateResetGuard()};
-        bool rv = ConnectBlock(*block_to_connect, state, pindexNew, view);
-        if (m_chainman.m_options.signals) {
+        bool rv = ConnectBlock(*block_to_connect, state, pindexNew, view, /*fJustCheck=*/false, pipeline);
+        // A pipelined block is only checked once its scripts are.
+        if (m_chainman.m_options.signals && !(pipeline && rv)) {
             m_chainman.m_options.signals->BlockChecked(block_to_connect, state);
         }
         if (!rv) {
@@ -3107,33 +3191,42 @@ bool Chainstate::ConnectTip(
     }
     const auto time_4{SteadyClock::now()};
     m_chainman.time_flush += time_4 - time_3;
+    profile.flush = time_4 - time_3;
     LogDebug(BCLog::BENCH, "  - Flush: %.2fms [%.2fs (%.2fms/blk)]\n",
              Ticks<MillisecondsDouble>(time_4 - time_3),
              Ticks<SecondsDouble>(m_chainman.time_flush),
              Ticks<MillisecondsDouble>(m_chainman.time_flush) / m_chainman.num_blocks_total);
-    // Write the chain state to disk, if necessary.
-    if (!FlushStateToDisk(state, FlushStateMode::IF_NEEDED)) {
+    // Write the chain state to disk, if necessary. The changes of pipelined
+    // blocks only reach the coins tip once their scripts are checked, so the
+    // caller writes them after that.
+    if (!pipeline && !FlushStateToDisk(state, FlushStateMode::IF_NEEDED)) {
         return false;
     }
     const auto time_5{SteadyClock::now()};
     m_chainman.time_chainstate += time_5 - time_4;
+    profile.chainstate = time_5 - time_4;
     LogDebug(BCLog::BENCH, "  - Writing chainstate: %.2fms [%.2fs (%.2fms/blk)]\n",
              Ticks<MillisecondsDouble>(time_5 - time_4),
              Ticks<SecondsDouble>(m_chainman.time_chainstate),
              Ticks<MillisecondsDouble>(m_chainman.time_chainstate) / m_chainman.num_blocks_total);
-    // Remove conflicting transactions from the mempool.;
-    if (m_mempool) {
-        m_mempool->removeForBlock(block_to_connect->vtx, pindexNew->nHeight);
-        disconnectpool.removeForBlock(block_to_connect->vtx);
-    }
-    // Update m_chain & related variables.
-    m_chain.SetTip(*pindexNew);
-    m_chainman.UpdateIBDStatus();
-    UpdateTip(pindexNew);
+    if (!pipeline) FinishConnectTip(pindexNew, *block_to_connect, disconnectpool);
 
     const auto time_6{SteadyClock::now()};
     m_chainman.time_post_connect += time_6 - time_5;
     m_chainman.time_total += time_6 - time_1;
+    profile.read = time_2 - time_1;
+    profile.post_connect = time_6 - time_5;
+    profile.total = time_6 - time_1;
+    profile.pow = m_chainman.time_pow - m_chainman.m_block_profile_time_pow;
+    m_chainman.m_block_profile_time_pow = m_chainman.time_pow;
+    const auto busy_end{m_chainman.GetCheckQueue().BusyTimes()};
+    for (size_t i{0}; i < busy_end.size(); ++i) {
+        profile.script_check_busy.push_back(busy_end[i] - busy_start[i]);
+    }
+    m_chainman.m_block_profiles.push_back(std::move(profile));
+    if (m_chainman.m_block_profiles.size() > MAX_BLOCK_VALIDATION_PROFILES) {
+        m_chainman.m_block_profiles.pop_front();
+    }
     LogDebug(BCLog::BENCH, "  - Connect postprocess: %.2fms [%.2fs (%.2fms/blk)]\n",
              Ticks<MillisecondsDouble>(time_6 - time_5),
              Ticks<SecondsDouble>(m_chainman.time_post_connect),
@@ -3155,10 +3248,85 @@ bool Chainstate::ConnectTip(
     Chainstate& current_cs{m_chainman.CurrentChainstate()};
     m_chainman.MaybeValidateSnapshot(*this, current_cs);
 
-    connectTrace.BlockConnected(pindexNew, std::move(block_to_connect));
+    if (pipeline) {
+        pipeline->blocks.emplace_back(pindexNew, std::move(block_to_connect));
+    } else {
+        connectTrace.BlockConnected(pindexNew, std::move(block_to_connect));
+    }
     return true;
 }
 
+void Chainstate::FinishConnectTip(CBlockIndex* pindexNew, const CBlock& block, DisconnectedBlockTransactions& disconnectpool)
+{
+    AssertLockHeld(cs_main);
+    if (m_mempool) AssertLockHeld(m_mempool->cs);
+
+    // Remove conflicting transactions from the mempool.
+    if (m_mempool) {
+        m_mempool->removeForBlock(block.vtx, pindexNew->nHeight);
+        disconnectpool.removeForBlock(block.vtx);
+    }
+    // Update m_chain & related variables.
+    m_chain.SetTip(*pindexNew);
+    m_chainman.UpdateIBDStatus();
+    UpdateTip(pindexNew);
+}
+
+bool Chainstate::CompleteScriptCheckPipeline(ScriptCheckPipeline& pipeline, ConnectTrace& connectTrace, DisconnectedBlockTransactions& disconnectpool)
+{
+    AssertLockHeld(cs_main);
+    if (m_mempool) AssertLockHeld(m_mempool->cs);
+
+    const auto busy_start{m_chainman.GetCheckQueue().BusyTimes()};
+    const auto time_start{SteadyClock::now()};
+    const auto result{pipeline.control->Complete()};
+    m_chainman.time_verify += SteadyClock::now() - time_start;
+    LogDebug(BCLog::BENCH, "- Verify scripts of %u pipelined blocks: %.2fms\n", pipeline.blocks.size(),
+             Ticks<MillisecondsDouble>(SteadyClock::now() - time_start));
+    if (pipeline.blocks.empty()) return true;
+
+    if (auto& profiles{m_chainman.m_block_profiles}; !profiles.empty() && profiles.back().hash == pipeline.blocks.back().first->GetBlockHash()) {
+        BlockValidationProfile& profile{profiles.back()};
+        profile.verify += SteadyClock::now() - time_start;
+        profile.total += SteadyClock::now() - time_start;
+        const auto busy_end{m_chainman.GetCheckQueue().BusyTimes()};
+        for (size_t i{0}; i < busy_end.size(); ++i) {
+            profile.script_check_busy[i] += busy_end[i] - busy_start[i];
+        }
+    }
+
+    if (!result) {
+        pipeline.view.Flush(/*reallocate_cache=*/false);
+        for (const auto& [pindex, pblock] : pipeline.blocks) {
+            if (!pindex->IsValid(BLOCK_VALID_SCRIPTS)) {
+                pindex->RaiseValidity(BLOCK_VALID_SCRIPTS);
+                m_blockman.m_dirty_blockindex.insert(pindex);
+            }
+            if (m_chainman.m_options.signals) {
+                m_chainman.m_options.signals->BlockChecked(pblock, BlockValidationState{});
+            }
+            FinishConnectTip(pindex, *pblock, disconnectpool);
+            connectTrace.BlockConnected(pindex, pblock);
+        }
+        pipeline.blocks.clear();
+        PruneBlockIndexCandidates();
+        return true;
+    }
+
+    // Checks of several blocks ran together, so it is not known which block
+    // failed. Their changes never reached the coins tip, the chain or the
+    // mempool, so dropping the pipeline's view is all it takes to undo them.
+    // They are then connected again without pipelining.
+    CBlockIndex* const first{pipeline.blocks.front().first};
+    CBlockIndex* const last{pipeline.blocks.back().first};
+    LogInfo("Script verification failed in blocks %d to %d (%s), connecting them again one at a time",
+            first->nHeight, last->nHeight, ScriptErrorString(result->first));
+    assert(m_chain.Tip() == first->pprev);
+    m_script_check_pipeline_stop_height = last->nHeight;
+    pipeline.blocks.clear();
+    return false;
+}
+
 /**
  * Return the tip of the chain with the most work in it, that isn't
  * known to be invalid (it's however far from certain to be valid).
@@ -3266,6 +3434,14 @@ bool Chainstate::ActivateBestChainStep(BlockValidationState& state, CBlockIndex*
         fBlocksDisconnected = true;
     }
 
+    // During IBD, keep connecting blocks while the script checks of the
+    // previous ones run, rather than waiting for them after every block.
+    std::optional<ScriptCheckPipeline> pipeline;
+    if (m_chainman.IsInitialBlockDownload() && m_chainman.GetCheckQueue().HasThreads() &&
+        !m_target_blockhash && m_chain.Height() >= m_script_check_pipeline_stop_height) {
+        pipeline.emplace(m_chainman.GetCheckQueue(), CoinsTip());
+    }
+
     // Build list of new blocks to connect (in descending height order).
     std::vector<CBlockIndex*> vpindexToConnect;
     bool fContinue = true;
@@ -3285,7 +3461,7 @@ bool Chainstate::ActivateBestChainStep(BlockValidationState& state, CBlockIndex*
 
         // Connect new blocks.
         for (CBlockIndex* pindexConnect : vpindexToConnect | std::views::reverse) {
-            if (!ConnectTip(state, pindexConnect, pindexConnect == pindexMostWork ? pblock : std::shared_ptr<const CBlock>(), connectTrace, disconnectpool)) {
+            if (!ConnectTip(state, pindexConnect, pindexConnect == pindexMostWork ? pblock : std::shared_ptr<const CBlock>(), connectTrace, disconnectpool, pipeline ? &*pipeline : nullptr)) {
                 if (state.IsInvalid()) {
                     // The block violates a consensus rule.
                     if (state.GetResult() != BlockValidationResult::BLOCK_MUTATED) {
@@ -3299,20 +3475,34 @@ bool Chainstate::ActivateBestChainStep(BlockValidationState& state, CBlockIndex*
                     // A system error occurred (disk space, database error, ...).
                     // Make the mempool consistent with the current tip, just in case
                     // any observers try to use it before shutdown.
+                    if (pipeline) CompleteScriptCheckPipeline(*pipeline, connectTrace, disconnectpool);
                     MaybeUpdateMempoolForReorg(disconnectpool, false);
                     return false;
                 }
             } else {
-                PruneBlockIndexCandidates();
-                if (!pindexOldTip || m_chain.Tip()->nChainWork > pindexOldTip->nChainWork) {
-                    // We're in a better position than we were. Return temporarily to release the lock.
-                    fContinue = false;
-                    break;
+                // Pipelined blocks only become the tip once their scripts are checked.
+                if (!pipeline) PruneBlockIndexCandidates();
+                const CBlockIndex* new_tip{pipeline ? pipeline->blocks.back().first : m_chain.Tip()};
+                if (!pindexOldTip || new_tip->nChainWork > pindexOldTip->nChainWork) {
+                    // We're in a better position than we were. Return temporarily to release the lock,
+                    // unless there is room for more blocks in the pipeline.
+                    if (!pipeline || pipeline->blocks.size() >= SCRIPT_CHECK_PIPELINE_BLOCKS) {
+                        fContinue = false;
+                        break;
+                    }
                 }
             }
         }
     }
 
+    if (pipeline) {
+        CompleteScriptCheckPipeline(*pipeline, connectTrace, disconnectpool);
+        pipeline.reset();
+        if (!FlushStateToDisk(state, FlushStateMode::IF_NEEDED)) {
+            return false;
+        }
+    }
+
     if (fBlocksDisconnected) {
         // If any blocks were disconnected, disconnectpool may be non empty.  Add
         // any disconnected transactions back to the mempool.
@@ -3449,7 +3639,14 @@ bool Chainstate::ActivateBestChain(BlockValidationState& state, std::shared_ptr<
                 for (const PerBlockConnectTrace& trace : connectTrace.GetBlocksConnected()) {
                     assert(trace.pblock && trace.pindex);
                     if (m_chainman.m_options.signals) {
+                        const auto time_start{SteadyClock::now()};
                         m_chainman.m_options.signals->BlockConnected(chainstate_role, trace.pblock, trace.pindex);
+                        const auto it{std::find_if(m_chainman.m_block_profiles.rbegin(), m_chainman.m_block_profiles.rend(),
+                                                   [&](const auto& profile) { return profile.hash == trace.pindex->GetBlockHash(); })};
+                        if (it != m_chainman.m_block_profiles.rend()) {
+                            it->notify = SteadyClock::now() - time_start;
+                            it->total += it->notify;
+                        }
                     }
                 }
 
@@ -3504,6 +3701,7 @@ bool Chainstate::ActivateBestChain(BlockValidationState& state, std::shared_ptr<
                 // allocation of caches once a chainstate exits initial block download.
                 m_chainman.MaybeRebalanceCaches();
             }
+            m_chainman.MaybeAdaptCoinsCaches();
 
             // Write changes periodically to disk, after relay.
             if (!FlushStateToDisk(state, FlushStateMode::PERIODIC)) {
@@ -4091,25 +4289,38 @@ std::vector<unsigned char> ChainstateManager::GenerateCoinbaseCommitment(CBlock&
 }
 
 
-// Forward declaration for RandomX PoW hash
-uint256 GetBlockPoWHash(const CBlockHeader& header, const uint256& seed_hash);
-
-bool HasValidProofOfWork(std::span<const CBlockHeader> headers, const Consensus::Params& consensusParams)
+bool HasValidProofOfWork(std::span<const CBlockHeader> headers, const Consensus::Params& consensusParams, PowCache* pow_cache, unsigned int lanes)
 {
     // For header validation, we need to use RandomX PoW
     // For genesis epoch (blocks 0-2111), use the genesis seed
-    uint256 genesis_seed = Hash(std::string("Botcoin Genesis Seed"));
-    
+    // TODO: Handle seed rotation for blocks >= 2112
+    const uint256 seed_hash{GetNextRandomXSeedHash(nullptr)};
+
+    // Skip headers whose PoW was already verified, e.g. during PRESYNC
+    std::vector<CBlockHeader> to_check;
+    std::vector<uint256> entries;
+    to_check.reserve(headers.size());
     for (const auto& header : headers) {
-        // For now, assume we are in genesis epoch (seed_height = 0)
-        // TODO: Handle seed rotation for blocks >= 2112
-        uint256 seed_hash = genesis_seed;
-        
-        uint256 pow_hash = GetBlockPoWHash(header, seed_hash);
-        if (!CheckProofOfWork(pow_hash, header.nBits, consensusParams)) {
+        if (pow_cache) {
+            uint256 entry{pow_cache->ComputeEntry(header.GetHash(), seed_hash)};
+            if (pow_cache->Get(entry)) continue;
+            entries.push_back(entry);
+        }
+        to_check.push_back(header);
+    }
+
+    const std::vector<uint256> pow_hashes{GetBlockPoWHashes(to_check, seed_hash, lanes)};
+    for (size_t i = 0; i < to_check.size(); ++i) {
+        if (!CheckProofOfWork(pow_hashes[i], to_check[i].nBits, consensusParams)) {
             return false;
         }
     }
+
+    if (pow_cache) {
+        for (const uint256& entry : entries) {
+            pow_cache->Set(entry);
+        }
+    }
     return true;
 }
 
@@ -4166,7 +4377,7 @@ arith_uint256 CalculateClaimedHeadersWork(std::span<const CBlockHeader> headers)
  *  v0.12 and v0.15 (when no additional protection was in place) whereby an attacker could unboundedly
  *  grow our in-memory block index. See https://bitcoincore.org/en/2024/07/03/disclose-header-spam.
  */
-static bool ContextualCheckBlockHeader(const CBlockHeader& block, BlockValidationState& state, BlockManager& blockman, const ChainstateManager& chainman, const CBlockIndex* pindexPrev, bool fCheckPow = true) EXCLUSIVE_LOCKS_REQUIRED(::cs_main)
+static bool ContextualCheckBlockHeader(const CBlockHeader& block, BlockValidationState& state, BlockManager& blockman, ChainstateManager& chainman, const CBlockIndex* pindexPrev, bool fCheckPow = true) EXCLUSIVE_LOCKS_REQUIRED(::cs_main)
 {
     AssertLockHeld(::cs_main);
     assert(pindexPrev != nullptr);
@@ -4179,8 +4390,27 @@ static bool ContextualCheckBlockHeader(const CBlockHeader& block, BlockValidatio
 
     // Check RandomX proof of work hash meets target
     // Skip PoW check when fCheckPow is false (e.g., for block templates)
-    if (fCheckPow && !CheckBlockProofOfWork(block, pindexPrev, consensusParams))
-        return state.Invalid(BlockValidationResult::BLOCK_INVALID_HEADER, "high-hash", "RandomX proof of work failed");
+    // Headers whose PoW was already verified during headers sync are found
+    // in the PoW cache and not hashed again.
+    if (fCheckPow) {
+        const uint256 seed_hash{GetNextRandomXSeedHash(pindexPrev)};
+        const uint256 block_hash{block.GetHash()};
+        const uint256 entry{chainman.m_pow_cache.ComputeEntry(block_hash, seed_hash)};
+        if (!chainman.m_pow_cache.Get(entry)) {
+            // Verdicts persisted by an earlier run let -reindex and
+            // -loadblock skip the RandomX hash as well.
+            if (!blockman.HasPowVerdict(block_hash, seed_hash, nHeight)) {
+                const auto time_start{SteadyClock::now()};
+                const uint256 pow_hash{GetBlockPoWHash(block, seed_hash)};
+                chainman.time_pow += SteadyClock::now() - time_start;
+                if (!CheckProofOfWorkImpl(pow_hash, block.nBits, consensusParams)) {
+                    return state.Invalid(BlockValidationResult::BLOCK_INVALID_HEADER, "high-hash", "RandomX proof of work failed");
+                }
+                blockman.AddPowVerdict(block_hash, seed_hash, nHeight);
+            }
+            chainman.m_pow_cache.Set(entry);
+        }
+    }
 
     // Check timestamp against prev
     if (block.GetBlockTime() <= pindexPrev->GetMedianTimePast())
@@ -4753,7 +4983,7 @@ VerifyDBResult CVerifyDB::VerifyDB(
         }
         CBlock block;
         // check level 0: read from disk
-        if (!chainstate.m_blockman.ReadBlock(block, *pindex)) {
+        if (!chainstate.m_blockman.ReadBlock(block, *pindex, /*use_arena=*/true)) {
             LogError("Verification error: ReadBlock failed at %d, hash=%s", pindex->nHeight, pindex->GetBlockHash().ToString());
             return VerifyDBResult::CORRUPTED_BLOCK_DB;
         }
@@ -4819,7 +5049,7 @@ VerifyDBResult CVerifyDB::VerifyDB(
             m_notifications.progress(_("Verifying blocks…"), percentageDone, false);
             pindex = chainstate.m_chain.Next(pindex);
             CBlock block;
-            if (!chainstate.m_blockman.ReadBlock(block, *pindex)) {
+            if (!chainstate.m_blockman.ReadBlock(block, *pindex, /*use_arena=*/true)) {
                 LogError("Verification error: ReadBlock failed at %d, hash=%s", pindex->nHeight, pindex->GetBlockHash().ToString());
                 return VerifyDBResult::CORRUPTED_BLOCK_DB;
             }
@@ -4848,7 +5078,7 @@ bool Chainstate::RollforwardBlock(const CBlockIndex* pindex, CCoinsViewCache& in
     AssertLockHeld(cs_main);
     // TODO: merge with ConnectBlock
     CBlock block;
-    if (!m_blockman.ReadBlock(block, *pindex)) {
+    if (!m_blockman.ReadBlock(block, *pindex, /*use_arena=*/true)) {
         LogError("ReplayBlock(): ReadBlock failed at %d, hash=%s\n", pindex->nHeight, pindex->GetBlockHash().ToString());
         return false;
     }
@@ -5069,6 +5299,7 @@ void ChainstateManager::LoadExternalBlockFile(
             nRewind++; // start one byte further next time, in case of failure
             blkdat.SetLimit(); // remove former limit
             unsigned int nSize = 0;
+            bool compressed{false};
             try {
                 // locate a header
                 MessageStartChars buf;
@@ -5080,6 +5311,8 @@ void ChainstateManager::LoadExternalBlockFile(
                 }
                 // read size
                 blkdat >> nSize;
+                compressed = (nSize & COMPRESSED_BLOCK_FLAG) != 0;
+                nSize &= ~COMPRESSED_BLOCK_FLAG;
                 if (nSize < 80 || nSize > MAX_BLOCK_SERIALIZED_SIZE)
                     continue;
             } catch (const std::exception&) {
@@ -5121,7 +5354,13 @@ void ChainstateManager::LoadExternalBlockFile(
                         // This block can be processed immediately; rewind to its start, read and deserialize it.
                         blkdat.SetPos(nBlockPos);
                         pblock = std::make_shared<CBlock>();
-                        blkdat >> TX_WITH_WITNESS(*pblock);
+                        if (compressed) {
+                            std::vector<std::byte> block_data(nSize);
+                            blkdat.read(block_data);
+                            SpanReader{block_data} >> Using<BlockCompression>(*pblock);
+                        } else {
+                            blkdat >> TX_WITH_WITNESS(*pblock);
+                        }
                         nRewind = blkdat.GetPos();
 
                         BlockValidationState state;
@@ -5556,10 +5795,15 @@ bool Chainstate::ResizeCoinsCaches(size_t coinstip_size, size_t coinsdb_size)
         // Cache sizes are unchanged, no need to continue.
         return true;
     }
-    size_t old_coinstip_size = m_coinstip_cache_size_bytes;
+    // Resizing the coinsdb cache reopens the database, which has to wait
+    // for any cursor over it to be closed. Keep both sizes until then, so
+    // that the total stays within budget.
+    if (coinsdb_size != m_coinsdb_cache_size_bytes && !CoinsDB().ResizeCache(coinsdb_size)) {
+        LogInfo("[%s] not resizing coinsdb cache while a cursor over it is open", this->ToString());
+        return true;
+    }
     m_coinstip_cache_size_bytes = coinstip_size;
     m_coinsdb_cache_size_bytes = coinsdb_size;
-    CoinsDB().ResizeCache(coinsdb_size);
 
     LogInfo("[%s] resized coinsdb cache to %.1f MiB",
         this->ToString(), coinsdb_size * (1.0 / 1024 / 1024));
@@ -5569,8 +5813,8 @@ bool Chainstate::ResizeCoinsCaches(size_t coinstip_size, size_t coinsdb_size)
     BlockValidationState state;
     bool ret;
 
-    if (coinstip_size > old_coinstip_size) {
-        // Likely no need to flush if cache sizes have grown.
+    if (CoinsTip().DynamicMemoryUsage() <= coinstip_size) {
+        // No need to flush while the coins cache still fits.
         ret = FlushStateToDisk(state, FlushStateMode::IF_NEEDED);
     } else {
         // Otherwise, flush state to disk and deallocate the in-memory coins map.
@@ -5830,6 +6074,265 @@ static void SnapshotUTXOHashBreakpoint(const util::SignalInterrupt& interrupt)
     if (interrupt) throw StopHashingException();
 }
 
+namespace {
+/**
+ * Reads the coins of a UTXO snapshot in a pipeline. A reader thread splits the
+ * file into chunks of whole txids, worker threads decode and check the
+ * chunks, and the caller takes the decoded chunks in file order to add them
+ * to the coins cache. This keeps reading, decoding and inserting busy at the
+ * same time.
+ */
+class SnapshotCoinsLoader
+{
+public:
+    struct Chunk {
+        uint64_t seq{0};
+        //! Index of the first coin of the chunk in the snapshot
+        uint64_t first_coin{0};
+        //! Coins as they are serialized in the snapshot
+        DataStream data;
+        //! Decoded coins, sorted by outpoint
+        std::vector<std::pair<COutPoint, Coin>> coins;
+        //! Whether the coins follow the ones of the previous txid in the chunk in outpoint order
+        bool sorted{true};
+        //! Set if the snapshot is bad at or after the coins of this chunk
+        std::optional<std::string> error;
+    };
+
+private:
+    //! Coins per chunk, roughly. Chunks do not split the coins of a txid.
+    static constexpr uint64_t CHUNK_COINS{50'000};
+
+    AutoFile& m_file;
+    const uint64_t m_coins_count;
+    const int m_base_height;
+    //! Maximum number of chunks read but not taken yet, bounding memory usage
+    const size_t m_max_chunks;
+
+    Mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<std::shared_ptr<Chunk>> m_to_decode GUARDED_BY(m_mutex);
+    std::map<uint64_t, std::shared_ptr<Chunk>> m_decoded GUARDED_BY(m_mutex);
+    size_t m_in_flight GUARDED_BY(m_mutex){0};
+    uint64_t m_next_seq GUARDED_BY(m_mutex){0};
+    bool m_read_done GUARDED_BY(m_mutex){false};
+    bool m_stop GUARDED_BY(m_mutex){false};
+
+    std::thread m_reader;
+    std::vector<std::thread> m_workers;
+
+    /** Copy one coin from the file to the chunk, without decompressing its script. */
+    template <typename Stream>
+    static void CopyCoin(Stream& file, DataStream& data)
+    {
+        uint32_t code;
+        uint64_t amount;
+        unsigned int script_size;
+        file >> VARINT(code) >> VARINT(amount) >> VARINT(script_size);
+        data << VARINT(code) << VARINT(amount);
+        if (script_size < ScriptCompression::nSpecialScripts) {
+            data << VARINT(script_size);
+            std::array<std::byte, 32> special;
+            const auto bytes{std::span{special}.first(GetSpecialScriptSize(script_size))};
+            file.read(bytes);
+            data.write(bytes);
+            return;
+        }
+        const size_t len{script_size - ScriptCompression::nSpecialScripts};
+        if (len > MAX_SCRIPT_SIZE) {
+            // Skip the script here, as ScriptCompression would, and pass on
+            // the OP_RETURN it replaces it with.
+            std::array<std::byte, 4096> skipped;
+            for (size_t left{len}; left > 0; left -= std::min(left, skipped.size())) {
+                file.read(std::span{skipped}.first(std::min(left, skipped.size())));
+            }
+            data << VARINT(ScriptCompression::nSpecialScripts + 1) << uint8_t{OP_RETURN};
+            return;
+        }
+        data << VARINT(script_size);
+        const size_t pos{data.size()};
+        data.resize(pos + len);
+        file.read(std::span{data}.subspan(pos));
+    }
+
+    void ReaderThread() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        BufferedReader file{std::move(m_file), /*size=*/1 << 20};
+        uint64_t coins_left{m_coins_count};
+        bool done{false};
+        while (!done) {
+            auto chunk{std::make_shared<Chunk>()};
+            {
+                WAIT_LOCK(m_mutex, lock);
+                m_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return m_stop || m_in_flight < m_max_chunks; });
+                if (m_stop) return;
+            }
+            chunk->first_coin = m_coins_count - coins_left;
+            uint64_t chunk_coins{0};
+            try {
+                while (coins_left > 0 && chunk_coins < CHUNK_COINS) {
+                    Txid txid;
+                    file >> txid;
+                    const uint64_t coins_per_txid{ReadCompactSize(file)};
+                    if (coins_per_txid > coins_left) {
+                        chunk->error = "Mismatch in coins count in snapshot metadata and actual snapshot data";
+                        break;
+                    }
+                    chunk->data << txid;
+                    WriteCompactSize(chunk->data, coins_per_txid);
+                    for (uint64_t i{0}; i < coins_per_txid; ++i) {
+                        // Only pass on complete coins. Decoding the chunk then
+                        // finds the truncation, unless it finds an earlier problem.
+                        const size_t coin_pos{chunk->data.size()};
+                        try {
+                            WriteCompactSize(chunk->data, ReadCompactSize(file));
+                            CopyCoin(file, chunk->data);
+                        } catch (const std::ios_base::failure&) {
+                            chunk->data.resize(coin_pos);
+                            throw;
+                        }
+                        ++chunk_coins;
+                        --coins_left;
+                    }
+                }
+            } catch (const std::ios_base::failure&) {
+                chunk->error = strprintf("Bad snapshot format or truncated snapshot after deserializing %d coins",
+                                         m_coins_count - coins_left);
+            }
+            if (!chunk->error && coins_left == 0) {
+                try {
+                    std::byte left_over_byte;
+                    file >> left_over_byte;
+                    chunk->error = strprintf("Bad snapshot - coins left over after deserializing %d coins", m_coins_count);
+                } catch (const std::ios_base::failure&) {
+                    // We expect an exception since we should be out of coins.
+                }
+            }
+            done = chunk->error || coins_left == 0;
+            {
+                LOCK(m_mutex);
+                chunk->seq = m_next_seq++;
+                ++m_in_flight;
+                m_to_decode.push_back(std::move(chunk));
+                m_read_done = done;
+            }
+            m_cv.notify_all();
+        }
+    }
+
+    void Decode(Chunk& chunk) const
+    {
+        std::optional<Txid> prev_txid;
+        try {
+            while (!chunk.data.empty()) {
+                Txid txid;
+                chunk.data >> txid;
+                const size_t coins_per_txid{ReadCompactSize(chunk.data)};
+                const size_t first{chunk.coins.size()};
+                for (size_t i = 0; i < coins_per_txid; i++) {
+                    const uint64_t coin_index{chunk.first_coin + chunk.coins.size()};
+                    COutPoint outpoint;
+                    Coin coin;
+                    outpoint.n = static_cast<uint32_t>(ReadCompactSize(chunk.data));
+                    outpoint.hash = txid;
+                    chunk.data >> coin;
+                    if (coin.nHeight > m_base_height ||
+                        outpoint.n >= std::numeric_limits<decltype(outpoint.n)>::max() // Avoid integer wrap-around in coinstats.cpp:ApplyHash
+                    ) {
+                        chunk.error = strprintf("Bad snapshot data after deserializing %d coins", coin_index);
+                        return;
+                    }
+                    if (!MoneyRange(coin.out.nValue)) {
+                        chunk.error = strprintf("Bad snapshot data after deserializing %d coins - bad tx out value", coin_index);
+                        return;
+                    }
+                    chunk.coins.emplace_back(std::move(outpoint), std::move(coin));
+                }
+                // Coins are hashed sorted by outpoint, which is how snapshots
+                // are written. Only the order of a txid's coins may differ.
+                const auto txid_coins{std::span{chunk.coins}.subspan(first)};
+                std::ranges::sort(txid_coins, {}, [](const auto& entry) { return entry.first.n; });
+                if ((prev_txid && !(*prev_txid < txid)) ||
+                    std::ranges::adjacent_find(txid_coins, {}, [](const auto& entry) { return entry.first.n; }) != txid_coins.end()) {
+                    chunk.sorted = false;
+                }
+                prev_txid = txid;
+            }
+        } catch (const std::ios_base::failure&) {
+            chunk.error = strprintf("Bad snapshot format or truncated snapshot after deserializing %d coins", chunk.first_coin + chunk.coins.size());
+            return;
+        }
+        chunk.data = DataStream{};
+    }
+
+    void WorkerThread() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        while (true) {
+            std::shared_ptr<Chunk> chunk;
+            {
+                WAIT_LOCK(m_mutex, lock);
+                m_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return m_stop || m_read_done || !m_to_decode.empty(); });
+                if (m_stop || m_to_decode.empty()) return;
+                chunk = std::move(m_to_decode.front());
+                m_to_decode.pop_front();
+            }
+            Decode(*chunk);
+            {
+                LOCK(m_mutex);
+                m_decoded.emplace(chunk->seq, std::move(chunk));
+            }
+            m_cv.notify_all();
+        }
+    }
+
+public:
+    SnapshotCoinsLoader(AutoFile& file, uint64_t coins_count, int base_height, int num_workers)
+        : m_file{file},
+          m_coins_count{coins_count},
+          m_base_height{base_height},
+          m_max_chunks{2 * static_cast<size_t>(num_workers) + 2}
+    {
+        m_reader = std::thread([this] {
+            util::ThreadRename("snapshotread");
+            ReaderThread();
+        });
+        for (int i{0}; i < num_workers; ++i) {
+            m_workers.emplace_back([this, i] {
+                util::ThreadRename(strprintf("snapshotdec.%i", i));
+                WorkerThread();
+            });
+        }
+    }
+
+    ~SnapshotCoinsLoader()
+    {
+        WITH_LOCK(m_mutex, m_stop = true);
+        m_cv.notify_all();
+        m_reader.join();
+        for (auto& worker : m_workers) worker.join();
+    }
+
+    /** Return the next decoded chunk in file order, or nullptr after the last one. */
+    std::shared_ptr<Chunk> Take(uint64_t seq) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        std::shared_ptr<Chunk> chunk;
+        {
+            WAIT_LOCK(m_mutex, lock);
+            m_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) {
+                return m_decoded.contains(seq) || (m_read_done && seq >= m_next_seq);
+            });
+            const auto it{m_decoded.find(seq)};
+            if (it == m_decoded.end()) return nullptr;
+            chunk = std::move(it->second);
+            m_decoded.erase(it);
+            --m_in_flight;
+        }
+        m_cv.notify_all();
+        return chunk;
+    }
+};
+} // namespace
+
 util::Result<void> ChainstateManager::PopulateAndValidateSnapshot(
     Chainstate& snapshot_chainstate,
     AutoFile& coins_file,
@@ -5868,76 +6371,65 @@ util::Result<void> ChainstateManager::PopulateAndValidateSnapshot(
     }
 
     const uint64_t coins_count = metadata.m_coins_count;
-    uint64_t coins_left = metadata.m_coins_count;
 
-    LogInfo("[snapshot] loading %d coins from snapshot %s", coins_left, base_blockhash.ToString());
-    int64_t coins_processed{0};
+    LogInfo("[snapshot] loading %d coins from snapshot %s", coins_count, base_blockhash.ToString());
+    uint64_t coins_processed{0};
+    // Hash the coins while loading them, as long as they are sorted
+    HashWriter hasher{};
+    std::vector<unsigned char> hash_data;
+    bool sorted{true};
+    std::optional<COutPoint> last_outpoint;
 
-    while (coins_left > 0) {
-        try {
-            Txid txid;
-            coins_file >> txid;
-            size_t coins_per_txid{0};
-            coins_per_txid = ReadCompactSize(coins_file);
-
-            if (coins_per_txid > coins_left) {
-                return util::Error{Untranslated("Mismatch in coins count in snapshot metadata and actual snapshot data")};
+    {
+        SnapshotCoinsLoader loader{coins_file, coins_count, base_height,
+                                   std::max(1, std::clamp(m_options.worker_threads_num, 0, MAX_SCRIPTCHECK_THREADS))};
+        for (uint64_t seq{0};; ++seq) {
+            const auto chunk{loader.Take(seq)};
+            if (!chunk) break;
+            if (chunk->error) {
+                return util::Error{Untranslated(*chunk->error)};
             }
-
-            for (size_t i = 0; i < coins_per_txid; i++) {
-                COutPoint outpoint;
-                Coin coin;
-                outpoint.n = static_cast<uint32_t>(ReadCompactSize(coins_file));
-                outpoint.hash = txid;
-                coins_file >> coin;
-                if (coin.nHeight > base_height ||
-                    outpoint.n >= std::numeric_limits<decltype(outpoint.n)>::max() // Avoid integer wrap-around in coinstats.cpp:ApplyHash
-                ) {
-                    return util::Error{Untranslated(strprintf("Bad snapshot data after deserializing %d coins",
-                              coins_count - coins_left))};
-                }
-                if (!MoneyRange(coin.out.nValue)) {
-                    return util::Error{Untranslated(strprintf("Bad snapshot data after deserializing %d coins - bad tx out value",
-                              coins_count - coins_left))};
+            if (chunk->coins.empty()) continue;
+            sorted = sorted && chunk->sorted && (!last_outpoint || *last_outpoint < chunk->coins.front().first);
+            last_outpoint = chunk->coins.back().first;
+            for (auto& [outpoint, coin] : chunk->coins) {
+                coins_cache.EmplaceCoinInternalDANGER(COutPoint{outpoint}, std::move(coin));
+            }
+            if (sorted) {
+                // Hash the coins as the cache holds them, which is what is
+                // written to the coins database, rather than as they were read.
+                hash_data.clear();
+                for (const auto& [outpoint, coin] : chunk->coins) {
+                    SerializeCoinForHash(hash_data, outpoint, coins_cache.AccessCoin(outpoint));
                 }
-                coins_cache.EmplaceCoinInternalDANGER(std::move(outpoint), std::move(coin));
-
-                --coins_left;
-                ++coins_processed;
+                hasher.write(std::as_bytes(std::span{hash_data}));
+            }
+            const uint64_t prev_processed{std::exchange(coins_processed, coins_processed + chunk->coins.size())};
 
-                if (coins_processed % 1000000 == 0) {
-                    LogInfo("[snapshot] %d coins loaded (%.2f%%, %.2f MB)",
-                        coins_processed,
-                        static_cast<float>(coins_processed) * 100 / static_cast<float>(coins_count),
-                        coins_cache.DynamicMemoryUsage() / (1000 * 1000));
-                }
+            if (coins_processed / 1000000 != prev_processed / 1000000) {
+                LogInfo("[snapshot] %d coins loaded (%.2f%%, %.2f MB)",
+                    coins_processed,
+                    static_cast<float>(coins_processed) * 100 / static_cast<float>(coins_count),
+                    coins_cache.DynamicMemoryUsage() / (1000 * 1000));
+            }
 
-                // Batch write and flush (if we need to) every so often.
-                //
-                // If our average Coin size is roughly 41 bytes, checking every 120,000 coins
-                // means <5MB of memory imprecision.
-                if (coins_processed % 120000 == 0) {
-                    if (m_interrupt) {
-                        return util::Error{Untranslated("Aborting after an interrupt was requested")};
-                    }
+            // Batch write and flush (if we need to) after every chunk.
+            if (m_interrupt) {
+                return util::Error{Untranslated("Aborting after an interrupt was requested")};
+            }
 
-                    const auto snapshot_cache_state = WITH_LOCK(::cs_main,
-                        return snapshot_chainstate.GetCoinsCacheSizeState());
+            const auto snapshot_cache_state = WITH_LOCK(::cs_main,
+                return snapshot_chainstate.GetCoinsCacheSizeState());
 
-                    if (snapshot_cache_state >= CoinsCacheSizeState::CRITICAL) {
-                        // This is a hack - we don't know what the actual best block is, but that
-                        // doesn't matter for the purposes of flushing the cache here. We'll set this
-                        // to its correct value (`base_blockhash`) below after the coins are loaded.
-                        coins_cache.SetBestBlock(GetRandHash());
+            if (snapshot_cache_state >= CoinsCacheSizeState::CRITICAL) {
+                // This is a hack - we don't know what the actual best block is, but that
+                // doesn't matter for the purposes of flushing the cache here. We'll set this
+                // to its correct value (`base_blockhash`) below after the coins are loaded.
+                coins_cache.SetBestBlock(GetRandHash());
 
-                        // No need to acquire cs_main since this chainstate isn't being used yet.
-                        FlushSnapshotToDisk(coins_cache, /*snapshot_loaded=*/false);
-                    }
-                }
+                // No need to acquire cs_main since this chainstate isn't being used yet.
+                FlushSnapshotToDisk(coins_cache, /*snapshot_loaded=*/false);
             }
-        } catch (const std::ios_base::failure&) {
-            return util::Error{Untranslated(strprintf("Bad snapshot format or truncated snapshot after deserializing %d coins",
-                      coins_processed))};
         }
     }
 
@@ -5948,19 +6440,6 @@ util::Result<void> ChainstateManager::PopulateAndValidateSnapshot(
     // method.
     coins_cache.SetBestBlock(base_blockhash);
 
-    bool out_of_coins{false};
-    try {
-        std::byte left_over_byte;
-        coins_file >> left_over_byte;
-    } catch (const std::ios_base::failure&) {
-        // We expect an exception since we should be out of coins.
-        out_of_coins = true;
-    }
-    if (!out_of_coins) {
-        return util::Error{Untranslated(strprintf("Bad snapshot - coins left over after deserializing %d coins",
-            coins_count))};
-    }
-
     LogInfo("[snapshot] loaded %d (%.2f MB) coins from snapshot %s",
         coins_count,
         coins_cache.DynamicMemoryUsage() / (1000 * 1000),
@@ -5971,26 +6450,35 @@ util::Result<void> ChainstateManager::PopulateAndValidateSnapshot(
 
     assert(coins_cache.GetBestBlock() == base_blockhash);
 
-    // As above, okay to immediately release cs_main here since no other context knows
-    // about the snapshot_chainstate.
-    CCoinsViewDB* snapshot_coinsdb = WITH_LOCK(::cs_main, return &snapshot_chainstate.CoinsDB());
+    uint256 hash_serialized;
+    if (sorted) {
+        // The coins were sorted by outpoint and unique, so they were hashed
+        // like ComputeUTXOStats would hash the coins database.
+        hash_serialized = hasher.GetHash();
+    } else {
+        LogInfo("[snapshot] coins are not sorted by outpoint, hashing the coins database");
+        // As above, okay to immediately release cs_main here since no other context knows
+        // about the snapshot_chainstate.
+        CCoinsViewDB* snapshot_coinsdb = WITH_LOCK(::cs_main, return &snapshot_chainstate.CoinsDB());
 
-    std::optional<CCoinsStats> maybe_stats;
+        std::optional<CCoinsStats> maybe_stats;
 
-    try {
-        maybe_stats = ComputeUTXOStats(
-            CoinStatsHashType::HASH_SERIALIZED, snapshot_coinsdb, m_blockman, [&interrupt = m_interrupt] { SnapshotUTXOHashBreakpoint(interrupt); });
-    } catch (StopHashingException const&) {
-        return util::Error{Untranslated("Aborting after an interrupt was requested")};
-    }
-    if (!maybe_stats.has_value()) {
-        return util::Error{Untranslated("Failed to generate coins stats")};
+        try {
+            maybe_stats = ComputeUTXOStats(
+                CoinStatsHashType::HASH_SERIALIZED, snapshot_coinsdb, m_blockman, [&interrupt = m_interrupt] { SnapshotUTXOHashBreakpoint(interrupt); });
+        } catch (StopHashingException const&) {
+            return util::Error{Untranslated("Aborting after an interrupt was requested")};
+        }
+        if (!maybe_stats.has_value()) {
+            return util::Error{Untranslated("Failed to generate coins stats")};
+        }
+        hash_serialized = maybe_stats->hashSerialized;
     }
 
     // Assert that the deserialized chainstate contents match the expected assumeutxo value.
-    if (AssumeutxoHash{maybe_stats->hashSerialized} != au_data.hash_serialized) {
+    if (AssumeutxoHash{hash_serialized} != au_data.hash_serialized) {
         return util::Error{Untranslated(strprintf("Bad snapshot content hash: expected %s, got %s",
-            au_data.hash_serialized.ToString(), maybe_stats->hashSerialized.ToString()))};
+            au_data.hash_serialized.ToString(), hash_serialized.ToString()))};
     }
 
     snapshot_chainstate.m_chain.SetTip(*snapshot_start_block);
@@ -6170,12 +6658,12 @@ void ChainstateManager::MaybeRebalanceCaches()
     if (!historical_cs && !current_cs.m_from_snapshot_blockhash) {
         // Allocate everything to the IBD chainstate. This will always happen
         // when we are not using a snapshot.
-        current_cs.ResizeCoinsCaches(m_total_coinstip_cache, m_total_coinsdb_cache);
+        current_cs.ResizeCoinsCaches(m_total_coinstip_cache - m_coinsdb_cache_shift, m_total_coinsdb_cache + m_coinsdb_cache_shift);
     } else if (!historical_cs) {
         // If background validation has completed and snapshot is our active chain...
         LogInfo("[snapshot] allocating all cache to the snapshot chainstate");
         // Allocate everything to the snapshot chainstate.
-        current_cs.ResizeCoinsCaches(m_total_coinstip_cache, m_total_coinsdb_cache);
+        current_cs.ResizeCoinsCaches(m_total_coinstip_cache - m_coinsdb_cache_shift, m_total_coinsdb_cache + m_coinsdb_cache_shift);
     } else {
         // If both chainstates exist, determine who needs more cache based on IBD status.
         //
@@ -6194,6 +6682,43 @@ void ChainstateManager::MaybeRebalanceCaches()
     }
 }
 
+void ChainstateManager::MaybeAdaptCoinsCaches()
+{
+    AssertLockHeld(::cs_main);
+    if (HistoricalChainstate() || IsInitialBlockDownload()) return;
+    const auto now{NodeClock::now()};
+    if (m_next_coins_cache_adapt && now < *m_next_coins_cache_adapt) return;
+
+    Chainstate& cs{CurrentChainstate()};
+    if (!cs.CoinsDBCacheAdaptive()) return;
+    const CCoinsViewCache& coins_tip{cs.CoinsTip()};
+    const uint64_t hits{coins_tip.GetCacheHits()};
+    const uint64_t misses{coins_tip.GetCacheMisses()};
+    // The first call, and one after the coins cache was replaced, only record the counters.
+    const bool have_window{m_next_coins_cache_adapt && hits >= m_coins_cache_adapt_hits && misses >= m_coins_cache_adapt_misses};
+    const uint64_t window_hits{hits - m_coins_cache_adapt_hits};
+    const uint64_t window_misses{misses - m_coins_cache_adapt_misses};
+    m_coins_cache_adapt_hits = hits;
+    m_coins_cache_adapt_misses = misses;
+    m_next_coins_cache_adapt = now + COINS_CACHE_ADAPT_INTERVAL;
+    if (!have_window) return;
+
+    const size_t coinsdb_size{kernel::AdaptCoinsDBCache(
+        cs.m_coinsdb_cache_size_bytes, m_total_coinsdb_cache, m_total_coinstip_cache + m_total_coinsdb_cache,
+        window_hits, window_misses,
+        /*coins_cache_warm=*/coins_tip.DynamicMemoryUsage() >= cs.m_coinstip_cache_size_bytes / 2)};
+    if (coinsdb_size == cs.m_coinsdb_cache_size_bytes) return;
+
+    LogInfo("Coins cache missed %d of %d lookups, changing coinsdb cache from %.1f MiB to %.1f MiB",
+            window_misses, window_hits + window_misses,
+            cs.m_coinsdb_cache_size_bytes * (1.0 / 1024 / 1024), coinsdb_size * (1.0 / 1024 / 1024));
+    const size_t old_shift{m_coinsdb_cache_shift};
+    m_coinsdb_cache_shift = coinsdb_size - m_total_coinsdb_cache;
+    MaybeRebalanceCaches();
+    // Try again next time if an open cursor kept the database from being reopened
+    if (cs.m_coinsdb_cache_size_bytes != coinsdb_size) m_coinsdb_cache_shift = old_shift;
+}
+
 void ChainstateManager::ResetChainstates()
 {
     m_chainstates.clear();
@@ -6214,10 +6739,12 @@ static ChainstateManager::Options&& Flatten(ChainstateManager::Options&& opts)
 
 ChainstateManager::ChainstateManager(const util::SignalInterrupt& interrupt, Options options, node::BlockManager::Options blockman_options)
     : m_script_check_queue{/*batch_size=*/128, std::clamp(options.worker_threads_num, 0, MAX_SCRIPTCHECK_THREADS)},
+      m_input_fetcher{/*batch_size=*/16, std::clamp(options.worker_threads_num, 0, MAX_SCRIPTCHECK_THREADS)},
       m_interrupt{interrupt},
       m_options{Flatten(std::move(options))},
       m_blockman{interrupt, std::move(blockman_options)},
-      m_validation_cache{m_options.script_execution_cache_bytes, m_options.signature_cache_bytes}
+      m_validation_cache{m_options.script_execution_cache_bytes, m_options.signature_cache_bytes},
+      m_pow_cache{m_options.pow_cache_bytes}
 {
 }
 
@@ -6278,6 +6805,19 @@ bool IsBIP30Unspendable(const uint256& block_hash, int block_height)
            (block_height==91812 && block_hash == uint256{"00000000000af0aed4792b1acee3d966af36cf5def14935db8de83d6f9306f2f"});
 }
 
+void Chainstate::ResetCoinsViews()
+{
+    AssertLockHeld(::cs_main);
+    if (m_coins_views) {
+        try {
+            m_coins_views->m_flushview.WaitForWrite();
+        } catch (const std::runtime_error& e) {
+            m_chainman.GetNotifications().fatalError(strprintf(_("System error while flushing: %s"), e.what()));
+        }
+    }
+    m_coins_views.reset();
+}
+
 util::Result<void> Chainstate::InvalidateCoinsDBOnDisk()
 {
     // Should never be called on a non-snapshot chainstate.
@@ -13,6 +13,7 @@
 #include <consensus/amount.h>
 #include <cuckoocache.h>
 #include <deploymentstatus.h>
+#include <inputfetcher.h>
 #include <kernel/chain.h>
 #include <kernel/chainparams.h>
 #include <kernel/chainstatemanager_opts.h>
@@ -21,6 +22,7 @@
 #include <policy/feerate.h>
 #include <policy/packages.h>
 #include <policy/policy.h>
+#include <powcache.h>
 #include <script/script_error.h>
 #include <script/sigcache.h>
 #include <script/verify_flags.h>
@@ -40,6 +42,7 @@
 #include <algorithm>
 #include <atomic>
 #include <cstdint>
+#include <deque>
 #include <map>
 #include <memory>
 #include <optional>
@@ -87,6 +90,10 @@ static const uint64_t MIN_DISK_SPACE_FOR_BLOCK_FILES = 550 * 1024 * 1024;
 
 /** Maximum number of dedicated script-checking threads allowed */
 static constexpr int MAX_SCRIPTCHECK_THREADS{15};
+/** Maximum number of blocks connected during IBD before waiting for their script checks */
+static constexpr size_t SCRIPT_CHECK_PIPELINE_BLOCKS{16};
+/** Number of most recently connected blocks whose validation profile is kept */
+static constexpr size_t MAX_BLOCK_VALIDATION_PROFILES{1000};
 
 /** Current sync state passed to tip changed callbacks. */
 enum class SynchronizationState {
@@ -354,7 +361,11 @@ public:
     CScriptCheck(CScriptCheck&&) = default;
     CScriptCheck& operator=(CScriptCheck&&) = default;
 
-    std::optional<std::pair<ScriptError, std::string>> operator()();
+    //! Schnorr signature checks deferred by CCheckQueue workers
+    using Batch = DeferredSignatureChecks;
+
+    //! If deferred is set, the check only succeeds if it verifies afterwards.
+    std::optional<std::pair<ScriptError, std::string>> operator()(DeferredSignatureChecks* deferred = nullptr);
 };
 
 // CScriptCheck is used a lot in std::vector, make sure that's efficient
@@ -362,6 +373,31 @@ static_assert(std::is_nothrow_move_assignable_v<CScriptCheck>);
 static_assert(std::is_nothrow_move_constructible_v<CScriptCheck>);
 static_assert(std::is_nothrow_destructible_v<CScriptCheck>);
 
+/**
+ * Blocks connected during IBD whose script checks have not completed yet.
+ *
+ * The script check threads keep verifying these blocks while the next ones are
+ * connected. Their changes to the UTXO set are kept apart from the coins tip,
+ * and they do not become the chain tip, until all of their checks have passed.
+ */
+struct ScriptCheckPipeline {
+    //! Keep what the queued checks refer to alive, including the data of
+    //! blocks that failed to connect after queueing some of their checks.
+    std::vector<std::shared_ptr<const CBlock>> block_data;
+    std::deque<std::vector<PrecomputedTransactionData>> txsdata;
+
+    //! The connected blocks, in order.
+    std::vector<std::pair<CBlockIndex*, std::shared_ptr<const CBlock>>> blocks;
+
+    //! Changes of the connected blocks to the coins tip.
+    CCoinsViewCache view;
+
+    //! Declared last, so it waits for the checks before the data above is destroyed.
+    std::optional<CCheckQueueControl<CScriptCheck>> control;
+
+    ScriptCheckPipeline(CCheckQueue<CScriptCheck>& queue, CCoinsView& tip) : view{&tip} { control.emplace(queue); }
+};
+
 /**
  * Convenience class for initializing and passing the script execution cache
  * and signature cache.
@@ -385,6 +421,45 @@ public:
     CSHA256 ScriptExecutionCacheHasher() const { return m_script_execution_cache_hasher; }
 };
 
+/**
+ * How long the phases of connecting a block to a chainstate took. This is the
+ * per-block counterpart of the BCLog::BENCH timers.
+ */
+struct BlockValidationProfile {
+    uint256 hash;
+    int height{0};
+    size_t tx_count{0};
+    size_t input_count{0};
+    //! Whether the block's script checks were left running while later blocks were connected
+    bool pipelined{false};
+
+    //! RandomX hashing since the previous block was connected: of headers
+    //! accepted into the block index, checked during headers sync, or
+    //! verified ahead of -reindex. Mostly spent on other blocks than this one.
+    SteadyClock::duration pow{};
+    SteadyClock::duration read{};
+    SteadyClock::duration fetch{};
+    InputFetcher::FetchStats fetch_stats;
+    SteadyClock::duration check{};
+    SteadyClock::duration forks{};
+    SteadyClock::duration connect{};
+    //! From the start of connecting the transactions until their scripts are verified
+    SteadyClock::duration verify{};
+    //! Time each script check thread spent running checks while the block was
+    //! connected, the thread connecting the block last. The checks of a
+    //! pipelined block may run while later blocks are connected; the wait for
+    //! the remaining ones is added to the last block of the pipeline.
+    std::vector<std::chrono::nanoseconds> script_check_busy;
+    SteadyClock::duration undo{};
+    SteadyClock::duration index{};
+    SteadyClock::duration flush{};
+    SteadyClock::duration chainstate{};
+    SteadyClock::duration post_connect{};
+    //! Queueing the BlockConnected notification
+    SteadyClock::duration notify{};
+    SteadyClock::duration total{};
+};
+
 /** Functions for validating blocks and updating the block tree */
 
 /** Context-independent validity checks */
@@ -413,8 +488,15 @@ BlockValidationState TestBlockValidity(
     bool check_pow,
     bool check_merkle_root) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
-/** Check that the proof of work on each blockheader matches the value in nBits */
-bool HasValidProofOfWork(std::span<const CBlockHeader> headers, const Consensus::Params& consensusParams);
+/**
+ * Check that the proof of work on each blockheader matches the value in nBits.
+ *
+ * Headers whose verdict is already in pow_cache are not hashed again; the
+ * remaining ones are hashed over up to `lanes` parallel RandomX VMs and, if
+ * all of them pass, added to pow_cache.
+ */
+bool HasValidProofOfWork(std::span<const CBlockHeader> headers, const Consensus::Params& consensusParams,
+                         PowCache* pow_cache = nullptr, unsigned int lanes = 1);
 
 /** Check if a block has been mutated (with respect to its merkle root and witness commitments). */
 bool IsBlockMutated(const CBlock& block, bool check_witness_root);
@@ -482,6 +564,9 @@ public:
     //! All unspent coins reside in this store.
     CCoinsViewDB m_dbview GUARDED_BY(cs_main);
 
+    //! Holds the coins of the last flush while they are written to m_dbview in the background.
+    CCoinsViewFlushBuffer m_flushview GUARDED_BY(cs_main);
+
     //! This view wraps access to the leveldb instance and handles read errors gracefully.
     CCoinsViewErrorCatcher m_catcherview GUARDED_BY(cs_main);
 
@@ -571,6 +656,10 @@ protected:
 
     std::optional<const char*> m_last_script_check_reason_logged GUARDED_BY(::cs_main){};
 
+    //! Blocks up to this height are connected without pipelining their script
+    //! checks, after pipelined checks of blocks up to it failed.
+    int m_script_check_pipeline_stop_height GUARDED_BY(::cs_main){-1};
+
 public:
     //! Reference to a BlockManager instance which itself is shared across all
     //! Chainstate instances.
@@ -688,12 +777,37 @@ public:
         Assert(m_coins_views);
         return *Assert(m_coins_views->m_cacheview);
     }
+    const CCoinsViewCache& CoinsTip() const EXCLUSIVE_LOCKS_REQUIRED(::cs_main)
+    {
+        AssertLockHeld(::cs_main);
+        Assert(m_coins_views);
+        return *Assert(m_coins_views->m_cacheview);
+    }
 
-    //! @returns A reference to the on-disk UTXO set database.
+    //! @returns A reference to the on-disk UTXO set database, after waiting
+    //!     for any background write to it to finish.
     CCoinsViewDB& CoinsDB() EXCLUSIVE_LOCKS_REQUIRED(::cs_main)
     {
         AssertLockHeld(::cs_main);
-        return Assert(m_coins_views)->m_dbview;
+        Assert(m_coins_views)->m_flushview.WaitForWrite();
+        return m_coins_views->m_dbview;
+    }
+
+    //! Whether the coinsdb cache size adapts to the coins cache hit rate, see
+    //! ChainstateManager::MaybeAdaptCoinsCaches(). LogDB ignores the cache
+    //! size, and would replay its whole log on every resize.
+    bool CoinsDBCacheAdaptive() const EXCLUSIVE_LOCKS_REQUIRED(::cs_main)
+    {
+        AssertLockHeld(::cs_main);
+        return Assert(m_coins_views)->m_dbview.Engine() != DBEngine::LOGDB;
+    }
+
+    //! @returns A reference to the view holding coins that are being written
+    //!     to the on-disk database in the background.
+    CCoinsViewFlushBuffer& CoinsFlushBuffer() EXCLUSIVE_LOCKS_REQUIRED(::cs_main)
+    {
+        AssertLockHeld(::cs_main);
+        return Assert(m_coins_views)->m_flushview;
     }
 
     //! @returns A pointer to the mempool.
@@ -710,8 +824,9 @@ public:
         return Assert(m_coins_views)->m_catcherview;
     }
 
-    //! Destructs all objects related to accessing the UTXO set.
-    void ResetCoinsViews() { m_coins_views.reset(); }
+    //! Destructs all objects related to accessing the UTXO set, after waiting
+    //! for any background write to the coins database to finish.
+    void ResetCoinsViews() EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
 
     //! The cache size of the on-disk coins view.
     size_t m_coinsdb_cache_size_bytes{0};
@@ -777,8 +892,13 @@ public:
     // Block (dis)connection on a given view:
     DisconnectResult DisconnectBlock(const CBlock& block, const CBlockIndex* pindex, CCoinsViewCache& view)
         EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
+    /**
+     * Apply the effects of a block on the UTXO set in view. If pipeline is
+     * set, the script checks of the block are queued to it rather than
+     * waited for, and the block is not marked as BLOCK_VALID_SCRIPTS.
+     */
     bool ConnectBlock(const CBlock& block, BlockValidationState& state, CBlockIndex* pindex,
-                      CCoinsViewCache& view, bool fJustCheck = false) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+                      CCoinsViewCache& view, bool fJustCheck = false, ScriptCheckPipeline* pipeline = nullptr) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
     // Apply the effects of a block disconnection on the UTXO set.
     bool DisconnectTip(BlockValidationState& state, DisconnectedBlockTransactions* disconnectpool) EXCLUSIVE_LOCKS_REQUIRED(cs_main, m_mempool->cs);
@@ -852,7 +972,22 @@ protected:
         CBlockIndex* pindexNew,
         std::shared_ptr<const CBlock> block_to_connect,
         ConnectTrace& connectTrace,
-        DisconnectedBlockTransactions& disconnectpool) EXCLUSIVE_LOCKS_REQUIRED(cs_main, m_mempool->cs);
+        DisconnectedBlockTransactions& disconnectpool,
+        ScriptCheckPipeline* pipeline = nullptr) EXCLUSIVE_LOCKS_REQUIRED(cs_main, m_mempool->cs);
+
+    //! Make pindexNew, whose block was just connected to the coins tip, the
+    //! chain tip, and remove the block's transactions from the mempool.
+    void FinishConnectTip(CBlockIndex* pindexNew, const CBlock& block, DisconnectedBlockTransactions& disconnectpool) EXCLUSIVE_LOCKS_REQUIRED(cs_main, m_mempool->cs);
+
+    /**
+     * Wait for the script checks of the blocks in pipeline. If all of them
+     * passed, apply their changes to the coins tip and make the last of them
+     * the chain tip. Otherwise, drop them, so that they are connected again
+     * one at a time and the invalid one is found.
+     *
+     * @returns whether the blocks were kept
+     */
+    bool CompleteScriptCheckPipeline(ScriptCheckPipeline& pipeline, ConnectTrace& connectTrace, DisconnectedBlockTransactions& disconnectpool) EXCLUSIVE_LOCKS_REQUIRED(cs_main, m_mempool->cs);
 
     void InvalidBlockFound(CBlockIndex* pindex, const BlockValidationState& state) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
     CBlockIndex* FindMostWorkChain() EXCLUSIVE_LOCKS_REQUIRED(cs_main);
@@ -972,6 +1107,9 @@ private:
     //! A queue for script verifications that have to be performed by worker threads.
     CCheckQueue<CScriptCheck> m_script_check_queue;
 
+    //! Reads block inputs into the coins cache on worker threads ahead of ConnectBlock().
+    InputFetcher m_input_fetcher;
+
     //! Timers and counters used for benchmarking validation in both background
     //! and active chainstates.
     SteadyClock::duration GUARDED_BY(::cs_main) time_check{};
@@ -987,6 +1125,13 @@ private:
     SteadyClock::duration GUARDED_BY(::cs_main) time_chainstate{};
     SteadyClock::duration GUARDED_BY(::cs_main) time_post_connect{};
 
+    //! Profile of the block being connected, filled in as it is connected
+    BlockValidationProfile m_block_profile GUARDED_BY(::cs_main);
+    //! Profiles of the most recently connected blocks, oldest first
+    std::deque<BlockValidationProfile> m_block_profiles GUARDED_BY(::cs_main);
+    //! time_pow when the previous block was connected
+    SteadyClock::duration m_block_profile_time_pow GUARDED_BY(::cs_main){};
+
 protected:
     CBlockIndex* m_best_invalid GUARDED_BY(::cs_main){nullptr};
 
@@ -1034,6 +1179,12 @@ public:
 
     ValidationCache m_validation_cache;
 
+    //! RandomX proof-of-work verdicts shared by headers sync and block index acceptance.
+    PowCache m_pow_cache;
+    //! Time spent computing RandomX hashes of headers, when they are accepted
+    //! into the block index, during headers sync and ahead of -reindex
+    SteadyClock::duration GUARDED_BY(::cs_main) time_pow{};
+
     /**
      * Whether initial block download (IBD) is ongoing.
      *
@@ -1080,6 +1231,16 @@ public:
     //! coins databases. This will be split somehow across chainstates.
     size_t m_total_coinsdb_cache{0};
 
+    //! Bytes of the coins cache budget moved from the in-memory coins cache
+    //! to the leveldb coins database cache by MaybeAdaptCoinsCaches().
+    size_t m_coinsdb_cache_shift GUARDED_BY(::cs_main){0};
+
+    //! Coins cache lookup counters when MaybeAdaptCoinsCaches() last looked
+    //! at them, and when it will do so next.
+    uint64_t m_coins_cache_adapt_hits GUARDED_BY(::cs_main){0};
+    uint64_t m_coins_cache_adapt_misses GUARDED_BY(::cs_main){0};
+    std::optional<NodeClock::time_point> m_next_coins_cache_adapt GUARDED_BY(::cs_main);
+
     //! Instantiate a new chainstate.
     //!
     //! @param[in] mempool              The mempool to pass to the chainstate
@@ -1302,6 +1463,11 @@ public:
     //! ResizeCoinsCaches() as needed.
     void MaybeRebalanceCaches() EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
 
+    //! Outside of initial block download, move part of the in-memory coins
+    //! cache budget to the leveldb coins database cache, or back, based on
+    //! the coins cache hit rate. See kernel::AdaptCoinsDBCache().
+    void MaybeAdaptCoinsCaches() EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
+
     /**
      * Update uncommitted block structures (currently: only the witness reserved
      * value). This is safe for submitted blocks as long as they honor
@@ -1355,6 +1521,13 @@ public:
     void RecalculateBestHeader() EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
 
     CCheckQueue<CScriptCheck>& GetCheckQueue() { return m_script_check_queue; }
+    InputFetcher& GetInputFetcher() { return m_input_fetcher; }
+
+    //! Return the profiles of the most recently connected blocks, oldest first.
+    std::vector<BlockValidationProfile> GetBlockValidationProfiles() const EXCLUSIVE_LOCKS_REQUIRED(::cs_main)
+    {
+        return {m_block_profiles.begin(), m_block_profiles.end()};
+    }
 
     ~ChainstateManager();
 
@@ -332,13 +332,27 @@ public:
             if (current_range_end > last_range_end) {
                 AddScriptPubKeys(desc_spkm, last_range_end);
                 m_last_range_ends.at(desc_spkm->GetID()) = current_range_end;
+                // matches of the old filter set may miss the new scripts
+                m_matches.clear();
             }
         }
     }
 
-    std::optional<bool> MatchesBlock(const uint256& block_hash) const
+    std::optional<bool> MatchesBlock(const uint256& block_hash)
     {
-        return m_wallet.chain().blockFilterMatchesAny(BlockFilterType::BASIC, block_hash, m_filter_set);
+        auto it{m_matches.find(block_hash)};
+        if (it == m_matches.end()) {
+            // match the filters of the following blocks in one batch
+            m_matches.clear();
+            for (const auto& [hash, match] : m_wallet.chain().blockFiltersMatchAny(BlockFilterType::BASIC, block_hash, MATCH_BATCH_SIZE, m_filter_set)) {
+                m_matches.emplace(hash, match);
+            }
+            it = m_matches.find(block_hash);
+            if (it == m_matches.end()) {
+                return m_wallet.chain().blockFilterMatchesAny(BlockFilterType::BASIC, block_hash, m_filter_set);
+            }
+        }
+        return it->second;
     }
 
 private:
@@ -351,6 +365,10 @@ private:
       */
     std::map<uint256, int32_t> m_last_range_ends;
     GCSFilter::ElementSet m_filter_set;
+    //! Number of blocks whose filters are matched at once.
+    static constexpr int MATCH_BATCH_SIZE{1000};
+    //! Whether the filters of the blocks of the current batch match m_filter_set.
+    std::unordered_map<uint256, bool, SaltedUint256Hasher> m_matches;
 
     void AddScriptPubKeys(const DescriptorScriptPubKeyMan* desc_spkm, int32_t last_range_end = 0)
     {